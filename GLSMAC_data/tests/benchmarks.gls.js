@@ -65,6 +65,15 @@ test.assert(timeof('creating scope and variable 10000 times', () => {
 	}
 }) < 500000000);
 
+let point = {x: 0, y: 0, z: 0};
+test.assert(timeof('reading and writing object properties 10000 times', () => {
+	idx = 0;
+	while (idx++ < 10000) {
+		point.x = point.y + point.z + idx;
+	}
+}) < 500000000);
+test.assert(point.x == 10000);
+
 const recursivefunc = (x, times) => {
 	if (times == 0) {
 		return x;
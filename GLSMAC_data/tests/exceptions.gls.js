@@ -184,3 +184,7 @@ testcatch('GSEMathError', () => {
 testcatch('GSEMathError', () => {
 	5.0 / 0.0;
 });
+testcatch('GSEOperationNotSupported', () => {
+	const a = [1, 2, 3];
+	a[0:1][0];
+});
@@ -24,3 +24,26 @@ test.assert(a == 3);
 {
 	;
 }
+
+let b = 1;
+const get_b = () => {
+	return b;
+};
+{
+	const get_inner_b = () => {
+		return b;
+	};
+	test.assert(get_inner_b() == 1); // not declared in this scope yet
+	let b = 2;
+	test.assert(get_inner_b() == 2);
+	test.assert(get_b() == 1);
+}
+const get_c = () => {
+	return c;
+};
+let c = 3;
+test.assert(get_c() == 3);
+for (i in [1, 2, 3]) {
+	let d = i;
+	test.assert(d == i);
+}
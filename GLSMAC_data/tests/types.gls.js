@@ -293,6 +293,27 @@ test.assert(arr == [
 	'\tat ' + test.get_script_path() + ':272: failfunc();'
 ]);
 
+const get_second = (o) => {
+	return o.second;
+};
+test.assert(get_second({first: 1, second: 2}) == 2);
+test.assert(get_second({second: 3, first: 4}) == 3);
+test.assert(get_second({first: 5}) == undefined);
+test.assert(get_second({first: 6, second: 7}) == 7);
+test.assert({first: 1, second: 2} == {second: 2, first: 1});
+
+// properties added during for..in are not visited, and don't shift keys that weren't visited yet
+const o2 = {b: 1, d: 2};
+arr = [];
+for (k in o2) {
+	arr []= k;
+	if (k == 'b') {
+		o2.a = 5;
+	}
+}
+test.assert(arr == ['b', 'd']);
+test.assert(o2 == {a: 5, b: 1, d: 2});
+
 test.assert(#to_string(2 + 3) + ' (five)' == '5 (five)');
 test.assert(#to_string(#to_float(#to_string(#to_int('1' + '2') + 55) + '1')) == '671.000000');
 test.assert(#to_int(#to_string(2 + 3) + '2') * 123 == 6396);
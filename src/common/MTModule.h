@@ -1,18 +1,20 @@
 #pragma once
 
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
 #include <functional>
-#include <map>
-#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <chrono>
 
 #include "Module.h"
 #include "MTTypes.h"
 
 namespace common {
 
-static std::mutex s_next_mt_id_mutex;
-static mt_id_t s_next_mt_id = 0;
+// shared by all modules and translation units so that ids are unique process-wide
+inline std::atomic< mt_id_t > s_next_mt_id = 0;
 
 // requests and responses should be structs that contain operation type and unions of variables for every op type
 // if you need to pass something non-trivial - use raw pointers
@@ -25,53 +27,85 @@ class MTModule : public Module {
 public:
 
 	virtual void Iterate() {
-		mt_request_map_t requests = MT_GetRequests();
-		if ( !requests.empty() ) {
-			//Log( "MT Processing " + to_string( requests.size() ) + " requests" );
-			mt_response_map_t responses = {};
-			for ( auto& request : requests ) {
-				ASSERT( !m_current_request_id, "m_current_request_id already set to something" );
-				m_mt_states_mutex.lock();
-				m_current_request_id = request.first;
-				m_is_canceled = false;
+		// most of iterations have nothing to do, so check without locking first
+		if ( !m_mt_has_pending ) {
+			return;
+		}
+
+		m_mt_states_mutex.lock();
+		ASSERT( m_mt_processing_ids.empty(), "processing ids not empty" );
+		m_mt_processing_ids.swap( m_mt_pending_ids );
+		m_mt_has_pending = false;
+		m_mt_states_mutex.unlock();
+
+		//Log( "MT Processing " + to_string( m_mt_processing_ids.size() ) + " requests" );
+		REQUEST_TYPE request = {};
+		for ( const auto mt_id : m_mt_processing_ids ) {
+			m_mt_states_mutex.lock();
+			auto it = m_mt_states.find( mt_id );
+			if ( it == m_mt_states.end() ) {
+				// canceled before it got to processing
 				m_mt_states_mutex.unlock();
-				responses[ request.first ] = ProcessRequest( request.second, m_is_canceled );
-				m_current_request_id = 0;
+				continue;
 			}
-			MT_SetResponses( responses );
+			ASSERT( !m_current_request_id, "m_current_request_id already set to something" );
+			it->second.is_processing = true;
+			request = it->second.request;
+			m_current_request_id = mt_id;
+			m_is_canceled = false;
+			m_mt_states_mutex.unlock();
+
+			const auto response = ProcessRequest( request, m_is_canceled );
+
+			// every response is published as soon as it's ready, without waiting for rest of requests
+			m_mt_states_mutex.lock();
+			m_current_request_id = 0;
+			it = m_mt_states.find( mt_id );
+			ASSERT( it != m_mt_states.end(), "invalid response mt_id" );
+			ASSERT( it->second.is_processing, "setting response on non-processed request" );
+			it->second.response = response;
+			it->second.is_executed = true;
+			it->second.is_processing = false;
+			//Log( "MT Request " + to_string( mt_id ) + " executed" );
+			m_mt_states_mutex.unlock();
+			m_mt_states_cv.notify_all();
 		}
+		m_mt_processing_ids.clear();
 	}
 
 	// use these to pass data from/to other threads
 	mt_id_t MT_CreateRequest( const REQUEST_TYPE& data ) {
+		const mt_id_t mt_id = ++s_next_mt_id;
 		mt_state_t state = {};
-		s_next_mt_id_mutex.lock();
-		mt_id_t mt_id = ++s_next_mt_id;
-		s_next_mt_id_mutex.unlock();
 		state.is_executed = false;
 		state.request = data;
 		m_mt_states_mutex.lock();
 		ASSERT( m_mt_states.find( mt_id ) == m_mt_states.end(), "duplicate mt_id" );
 		m_mt_states[ mt_id ] = state;
+		m_mt_pending_ids.push_back( mt_id );
+		m_mt_has_pending = true;
 		m_mt_states_mutex.unlock();
+		OnRequestCreated();
 		//Log( "MT Request " + to_string( mt_id ) + " created" );
 		return mt_id;
 	}
 
+	// returns empty response if request wasn't executed yet
 	const RESPONSE_TYPE MT_GetResponse( const mt_id_t mt_id ) {
-		RESPONSE_TYPE response = {};
-		m_mt_states_mutex.lock();
-		auto it = m_mt_states.find( mt_id );
-		ASSERT( it != m_mt_states.end(), "GetResponse() mt_id not found" );
-		if ( it->second.is_executed ) {
-			response = it->second.response;
-			DestroyRequest( it->second.request );
-			m_mt_states.erase( it );
-			//Log( "MT Request " + to_string( mt_id ) + " result returned" );
-		}
-		m_mt_states_mutex.unlock();
+		std::lock_guard< std::mutex > guard( m_mt_states_mutex );
+		return GetResponseLocked( mt_id );
+	}
 
-		return response;
+	// same as MT_GetResponse but waits up to timeout_ms for request to be executed
+	const RESPONSE_TYPE MT_WaitResponse( const mt_id_t mt_id, const size_t timeout_ms ) {
+		std::unique_lock< std::mutex > lock( m_mt_states_mutex );
+		m_mt_states_cv.wait_for(
+			lock, std::chrono::milliseconds( timeout_ms ), [ this, mt_id ]() -> bool {
+				const auto it = m_mt_states.find( mt_id );
+				return it == m_mt_states.end() || it->second.is_executed;
+			}
+		);
+		return GetResponseLocked( mt_id );
 	}
 
 	// TODO: better way?
@@ -80,7 +114,7 @@ public:
 	}
 
 	void MT_Cancel( const mt_id_t mt_id ) {
-		m_mt_states_mutex.lock();
+		std::unique_lock< std::mutex > lock( m_mt_states_mutex );
 		auto it = m_mt_states.find( mt_id );
 		ASSERT( it != m_mt_states.end(), "MT_Cancel() mt_id not found" );
 		if ( mt_id == m_current_request_id ) {
@@ -89,18 +123,18 @@ public:
 		if ( !it->second.is_executed ) {
 			if ( it->second.is_processing ) {
 				Log( "Waiting for MT Request " + std::to_string( mt_id ) + " to finish" );
-				while ( it->second.is_processing ) {
-					m_mt_states_mutex.unlock();
-					std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
-					m_mt_states_mutex.lock();
-				}
+				m_mt_states_cv.wait(
+					lock, [ this, mt_id ]() -> bool {
+						return !m_mt_states.at( mt_id ).is_processing;
+					}
+				);
+				it = m_mt_states.find( mt_id ); // map could have been rehashed while waiting
 			}
 			//Log( "MT Request " + to_string( mt_id ) + " canceled" );
 			DestroyRequest( it->second.request );
 			DestroyResponse( it->second.response );
 			m_mt_states.erase( it );
 		}
-		m_mt_states_mutex.unlock();
 	}
 
 protected:
@@ -110,6 +144,9 @@ protected:
 	virtual void DestroyRequest( const REQUEST_TYPE& request ) = 0;
 	virtual void DestroyResponse( const RESPONSE_TYPE& response ) = 0;
 
+	// called from requesting thread after request was queued, override to wake up module if it's sleeping in Iterate()
+	virtual void OnRequestCreated() {}
+
 private:
 
 	struct mt_state_t {
@@ -118,41 +155,32 @@ private:
 		bool is_executed = false;
 		RESPONSE_TYPE response = {};
 	};
-	typedef std::map< mt_id_t, REQUEST_TYPE > mt_request_map_t;
-	typedef std::map< mt_id_t, RESPONSE_TYPE > mt_response_map_t;
-
-	mt_request_map_t MT_GetRequests() {
-		mt_request_map_t result = {};
-		m_mt_states_mutex.lock();
-		for ( auto& it : m_mt_states ) {
-			if ( !it.second.is_executed && !it.second.is_processing ) {
-				it.second.is_processing = true;
-				result[ it.first ] = it.second.request;
-			}
-		}
-		m_mt_states_mutex.unlock();
-		return result;
-	}
 
-	void MT_SetResponses( const mt_response_map_t& responses ) {
-		if ( !responses.empty() ) {
-			m_mt_states_mutex.lock();
-			for ( auto& response : responses ) {
-				auto it = m_mt_states.find( response.first );
-				ASSERT( it != m_mt_states.end(), "invalid response mt_id" );
-				ASSERT( it->second.is_processing, "setting response on non-processed request" );
-				it->second.response = response.second;
-				it->second.is_executed = true;
-				it->second.is_processing = false;
-				//Log( "MT Request " + to_string( response.first ) + " executed" );
-			}
-			m_mt_states_mutex.unlock();
+	// m_mt_states_mutex must be locked
+	const RESPONSE_TYPE GetResponseLocked( const mt_id_t mt_id ) {
+		RESPONSE_TYPE response = {};
+		auto it = m_mt_states.find( mt_id );
+		ASSERT( it != m_mt_states.end(), "GetResponse() mt_id not found" );
+		if ( it->second.is_executed ) {
+			response = it->second.response;
+			DestroyRequest( it->second.request );
+			m_mt_states.erase( it );
+			//Log( "MT Request " + to_string( mt_id ) + " result returned" );
 		}
+		return response;
 	}
 
-	typedef std::map< mt_id_t, mt_state_t > mt_states_t;
+	typedef std::unordered_map< mt_id_t, mt_state_t > mt_states_t;
 	std::mutex m_mt_states_mutex;
+	std::condition_variable m_mt_states_cv; // notified when request stops processing
 	mt_states_t m_mt_states = {};
+
+	// requests are queued in order of creation, processing thread takes whole queue at once
+	// two vectors are swapped back and forth so that nothing is reallocated in steady state
+	std::vector< mt_id_t > m_mt_pending_ids = {};
+	std::vector< mt_id_t > m_mt_processing_ids = {};
+	std::atomic< bool > m_mt_has_pending = false;
+
 	mt_flag_t m_is_canceled = false;
 	std::atomic< mt_id_t > m_current_request_id = 0;
 };
@@ -25,8 +25,14 @@ Thread::~Thread() {
 }
 
 void Thread::SetIPS( const float ips ) {
+	ASSERT( ips > 0.0f, "ips must be positive, use SetUnthrottled() to disable throttling" );
 	m_ips = ips;
 }
+
+void Thread::SetUnthrottled() {
+	m_ips = 0.0f;
+}
+
 void Thread::AddModule( Module* module ) {
 	ASSERT( module, "null module added" );
 	m_modules.push_back( module );
@@ -99,33 +105,35 @@ void Thread::Run() {
 
 		auto nsdiff = std::chrono::duration_cast< std::chrono::nanoseconds >( finish - start ).count();
 
-		step_len = 1000000000 / m_ips - step_diff;
-		if ( nsdiff > step_len ) {
+		if ( m_ips > 0.0f ) { // unthrottled otherwise
+			step_len = 1000000000 / m_ips - step_diff;
+			if ( nsdiff > step_len ) {
 #ifdef DEBUG
 /*	TODO: fix and add stats to debug overlay			
-				Log( "Thread lag detected!" );
-				for ( modules_t::iterator it = m_modules.begin() ; it != m_modules.end() ; ++it ) {
-					Log( (*it)->GetName() + " " + std::to_string( modulensdiff[ it - m_modules.begin() ] ) + "ns ( " + std::to_string( (float) modulensdiff[ it - m_modules.begin() ] * 100 / step_len ) + "%)");
-				}
-				*/
+					Log( "Thread lag detected!" );
+					for ( modules_t::iterator it = m_modules.begin() ; it != m_modules.end() ; ++it ) {
+						Log( (*it)->GetName() + " " + std::to_string( modulensdiff[ it - m_modules.begin() ] ) + "ns ( " + std::to_string( (float) modulensdiff[ it - m_modules.begin() ] * 100 / step_len ) + "%)");
+					}
+					*/
 #endif
-			step_diff = 0.0f;
-			// TODO: change ips?
-		}
-		else {
-			step_len -= nsdiff;
-			step_len_rounded = ceil( step_len );
-			step_diff = step_len_rounded - step_len;
+				step_diff = 0.0f;
+				// TODO: change ips?
+			}
+			else {
+				step_len -= nsdiff;
+				step_len_rounded = ceil( step_len );
+				step_diff = step_len_rounded - step_len;
 
 #ifdef DEBUG
-			m_icounter++;
+				m_icounter++;
 /*				Log( "frame " + std::to_string( m_icounter ) + ": sleeping " + std::to_string( step_len_rounded) + "ns (nsdiff: " + std::to_string( nsdiff ) + ", stepdiff: " + std::to_string( step_diff ) + ")" );
-				for ( modules_t::iterator it = m_modules.begin() ; it != m_modules.end() ; ++it ) {
-					Log( (*it)->GetName() + " " + std::to_string( modulensdiff[ it - m_modules.begin() ] ) + "ns ( " + std::to_string( (float) modulensdiff[ it - m_modules.begin() ] * 100 / step_len ) + "%)");
-				}*/
+					for ( modules_t::iterator it = m_modules.begin() ; it != m_modules.end() ; ++it ) {
+						Log( (*it)->GetName() + " " + std::to_string( modulensdiff[ it - m_modules.begin() ] ) + "ns ( " + std::to_string( (float) modulensdiff[ it - m_modules.begin() ] * 100 / step_len ) + "%)");
+					}*/
 #endif
 
-			std::this_thread::sleep_for( std::chrono::nanoseconds( step_len_rounded ) );
+				std::this_thread::sleep_for( std::chrono::nanoseconds( step_len_rounded ) );
+			}
 		}
 
 		switch ( m_command ) {
@@ -28,6 +28,8 @@ CLASS( Thread, Class )
 	~Thread();
 
 	void SetIPS( const float ips );
+	// iterate without sleeping in between, for modules that block by themselves ( or for benchmarking )
+	void SetUnthrottled();
 	void AddModule( Module* module );
 
 	void T_Start();
@@ -45,7 +47,7 @@ protected:
 	std::atomic< thread_state_t > m_state = STATE_INACTIVE;
 	std::atomic< thread_command_t > m_command = COMMAND_NONE;
 	modules_t m_modules = {};
-	float m_ips = 10;
+	float m_ips = 10; // 0 means unthrottled
 
 #ifdef DEBUG
 
@@ -55,12 +55,36 @@ Config::Config( const int argc, const char* argv[] )
 			m_launch_flags |= LF_SHOWFPS;
 		}
 	);
+	m_parser->AddRule(
+		"dedicated-server", "Host multiplayer game without window, sound or input (game starts when all connected players are ready)", AH( this ) {
+			m_launch_flags |= LF_DEDICATED_SERVER;
+		}
+	);
+	m_parser->AddRule(
+		"gse-runner", "RUNNER", "Runner for scripts: interpreter (default) or vm (compiles to bytecode first)", AH( this ) {
+			if ( value == "interpreter" ) {
+				m_gse_runner_type = gse::runner::RT_INTERPRETER;
+			}
+			else if ( value == "vm" ) {
+				m_gse_runner_type = gse::runner::RT_VM;
+			}
+			else {
+				Error( "Unknown GSE runner: " + value + " (expected interpreter or vm)" );
+			}
+		}
+	);
 	m_parser->AddRule(
 		"help", "Show this message", AH( this ) {
 			std::cout << m_parser->GetHelpString() << std::endl;
 			exit( EXIT_SUCCESS );
 		}
 	);
+	m_parser->AddRule(
+		"network-stats", "CSV_FILE", "Append network statistics (round-trip time, traffic, queues) to CSV file every second", AH( this ) {
+			m_network_stats_file = value;
+			m_launch_flags |= LF_NETWORK_STATS;
+		}
+	);
 	m_parser->AddRule(
 		"nosound", "Start without sound", AH( this ) {
 			m_launch_flags |= LF_NOSOUND;
@@ -263,6 +287,16 @@ Config::Config( const int argc, const char* argv[] )
 			m_gse_tests_script = value;
 		}
 	);
+	m_parser->AddRule(
+		"benchmark-checksum", "Measure turn checksum throughput and exit", AH( this ) {
+			m_debug_flags |= DF_BENCHMARK_CHECKSUM;
+		}
+	);
+	m_parser->AddRule(
+		"benchmark-network", "Measure in-process network throughput and exit", AH( this ) {
+			m_debug_flags |= DF_BENCHMARK_NETWORK;
+		}
+	);
 
 #endif
 
@@ -328,6 +362,14 @@ const types::Vec2< size_t >& Config::GetWindowSize() const {
 	return m_window_size;
 }
 
+const std::string& Config::GetNetworkStatsFile() const {
+	return m_network_stats_file;
+}
+
+const gse::runner::runner_type_t Config::GetGSERunnerType() const {
+	return m_gse_runner_type;
+}
+
 #ifdef DEBUG
 
 const bool Config::HasDebugFlag( const debug_flag_t flag ) const {
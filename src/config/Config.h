@@ -7,6 +7,7 @@
 #include "util/random/Types.h"
 #include "game/settings/Types.h"
 #include "types/Vec2.h"
+#include "gse/runner/Types.h"
 
 namespace util {
 class ArgParser;
@@ -27,7 +28,9 @@ CLASS( Config, common::Module )
 		LF_NOSOUND = 1 << 2,
 		LF_SKIPINTRO = 1 << 3,
 		LF_WINDOWED = 1 << 4,
-		LF_WINDOW_SIZE = 1 << 5
+		LF_WINDOW_SIZE = 1 << 5,
+		LF_DEDICATED_SERVER = 1 << 6,
+		LF_NETWORK_STATS = 1 << 7,
 	};
 
 #ifdef DEBUG
@@ -51,6 +54,8 @@ CLASS( Config, common::Module )
 		DF_GSE_TESTS_SCRIPT = 1 << 15,
 		DF_GSE_PROMPT_JS = 1 << 16,
 		DF_NOPINGS = 1 << 17,
+		DF_BENCHMARK_CHECKSUM = 1 << 18,
+		DF_BENCHMARK_NETWORK = 1 << 19,
 	};
 #endif
 
@@ -67,6 +72,8 @@ CLASS( Config, common::Module )
 
 	const bool HasLaunchFlag( const launch_flag_t flag ) const;
 	const types::Vec2< size_t >& GetWindowSize() const;
+	const std::string& GetNetworkStatsFile() const;
+	const gse::runner::runner_type_t GetGSERunnerType() const;
 
 #ifdef DEBUG
 
@@ -104,6 +111,8 @@ private:
 
 	uint8_t m_launch_flags = LF_NONE;
 	types::Vec2< size_t > m_window_size = {};
+	std::string m_network_stats_file = "";
+	gse::runner::runner_type_t m_gse_runner_type = gse::runner::RT_INTERPRETER;
 
 #ifdef DEBUG
 
@@ -4,6 +4,7 @@
 
 #include "engine/Engine.h"
 #include "config/Config.h"
+#include "network/Network.h"
 #include "loader/font/FontLoader.h"
 #include "types/texture/Texture.h"
 #include "ui/UI.h"
@@ -19,6 +20,7 @@ void DebugOverlay::Start() {
 
 	m_font_size = 16;
 	m_memory_stats_lines = 10;
+	m_network_stats_lines = 6;
 
 	m_stats_font = g_engine->GetFontLoader()->LoadFont( resource::TTF_ARIALN, m_font_size );
 
@@ -68,6 +70,13 @@ void DebugOverlay::Show() {
 		DEBUG_STATS;
 #undef D
 
+		for ( int i = 0 ; i < m_network_stats_lines ; i++ ) {
+			NEWV( label, ui::object::Label );
+			ActivateLabel( label, 3, (stat_line++) * ( m_font_size + 1 ) );
+			m_network_stats_labels.push_back( label );
+		}
+		m_last_network_stats.clear();
+
 		for ( int i = 0 ; i < m_memory_stats_lines ; i++ ) {
 			NEWV( label, ui::object::Label );
 			ActivateLabel( label, 340, i * ( m_font_size + 1 ) );
@@ -125,6 +134,11 @@ void DebugOverlay::Hide() {
 		}
 		m_memory_stats_labels.clear();
 
+		for ( auto& it : m_network_stats_labels ) {
+			g_engine->GetUI()->RemoveObject( it );
+		}
+		m_network_stats_labels.clear();
+
 #define D( _stat ) \
             g_engine->GetUI()->RemoveObject( m_##_stats_label_##_stat );
 		DEBUG_STATS;
@@ -198,9 +212,68 @@ void DebugOverlay::Iterate() {
 			Refresh();
 
 			ClearStats();
+
+			if ( !m_network_stats_mt_id ) {
+				m_network_stats_mt_id = g_engine->GetNetwork()->MT_GetStats();
+			}
+		}
+
+	}
+
+	if ( m_network_stats_mt_id ) {
+		const auto response = g_engine->GetNetwork()->MT_GetResult( m_network_stats_mt_id );
+		if ( response.result != network::R_NONE ) {
+			m_network_stats_mt_id = 0;
+			if ( m_is_visible && response.result == network::R_SUCCESS ) {
+				RefreshNetworkStats( response.stats );
+			}
 		}
+	}
+}
+
+void DebugOverlay::RefreshNetworkStats( const network::stats_t& stats ) {
+	DEBUG_STATS_SET_RO();
+
+	m_network_stats_labels[ 0 ]->SetText(
+		"network : events " + std::to_string( stats.events_in ) + "/" + std::to_string( stats.events_out ) +
+			", game events " + std::to_string( stats.pending_game_events )
+	);
 
+	// stats are requested once per second, so difference from previous ones is rate per second
+	const auto f_kb = []( const uint64_t bytes ) -> std::string {
+		return std::to_string( bytes / 1024 ) + "kb";
+	};
+	std::unordered_map< network::cid_t, network::connection_stats_t > last_stats = {};
+	size_t line = 1;
+	for ( const auto& c : stats.connections ) {
+		last_stats[ c.cid ] = c;
+		if ( line >= m_network_stats_lines ) {
+			continue;
+		}
+		const auto it = m_last_network_stats.find( c.cid );
+		const auto& prev = it != m_last_network_stats.end()
+			? it->second
+			: c;
+		m_network_stats_labels[ line++ ]->SetText(
+			"#" + std::to_string( c.cid ) +
+				" rtt:" + ( c.rtt_ms >= 0
+				? std::to_string( c.rtt_ms ) + "ms"
+				: "?"
+			) +
+				" in:" + f_kb( c.bytes_in - prev.bytes_in ) + "/" + std::to_string( c.packets_in - prev.packets_in ) +
+				" out:" + f_kb( c.bytes_out - prev.bytes_out ) + "/" + std::to_string( c.packets_out - prev.packets_out ) +
+				" q:" + std::to_string( c.queued_packets )
+		);
+	}
+	if ( stats.connections.size() >= m_network_stats_lines ) {
+		m_network_stats_labels[ m_network_stats_lines - 1 ]->SetText( "... " + std::to_string( stats.connections.size() - m_network_stats_lines + 2 ) + " connections more" );
 	}
+	for ( ; line < m_network_stats_lines ; line++ ) {
+		m_network_stats_labels[ line ]->SetText( "" );
+	}
+	m_last_network_stats.swap( last_stats );
+
+	DEBUG_STATS_SET_RW();
 }
 
 // not using themes because overlay should be independent of them
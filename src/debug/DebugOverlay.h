@@ -2,10 +2,12 @@
 
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 #include "common/Task.h"
 
 #include "util/Timer.h"
+#include "network/Types.h"
 
 namespace types {
 class Font;
@@ -55,6 +57,14 @@ protected:
 #undef D
 
 	std::vector< ui::object::Label* > m_memory_stats_labels = {};
+
+	// first line is summary, rest are connections
+	size_t m_network_stats_lines = 0;
+	std::vector< ui::object::Label* > m_network_stats_labels = {};
+	common::mt_id_t m_network_stats_mt_id = 0;
+	std::unordered_map< network::cid_t, network::connection_stats_t > m_last_network_stats = {}; // to calculate rates
+	void RefreshNetworkStats( const network::stats_t& stats );
+
 	void ActivateLabel( ui::object::Label* label, const size_t left, const size_t top );
 
 private:
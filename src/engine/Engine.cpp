@@ -20,6 +20,8 @@
 
 // TODO: move to config
 const size_t g_max_fps = 500;
+// nothing is rendered in headless mode, threads only need to keep up with network and game logic
+const size_t g_dedicated_server_ips = 50;
 
 engine::Engine* g_engine = NULL;
 
@@ -62,7 +64,10 @@ Engine::Engine(
 
 	NEWV( t_main, common::Thread, "MAIN" );
 	if ( m_config->HasLaunchFlag( config::Config::LF_BENCHMARK ) ) {
-		t_main->SetIPS( 999999.9f );
+		t_main->SetUnthrottled();
+	}
+	else if ( m_config->HasLaunchFlag( config::Config::LF_DEDICATED_SERVER ) ) {
+		t_main->SetIPS( g_dedicated_server_ips );
 	}
 	else {
 		t_main->SetIPS( g_max_fps );
@@ -73,10 +78,7 @@ Engine::Engine(
 	t_main->AddModule( m_texture_loader );
 	t_main->AddModule( m_sound_loader );
 	t_main->AddModule( m_logger );
-#ifdef DEBUG
-	if ( !m_config->HasDebugFlag( config::Config::DF_GSE_ONLY ) )
-#endif
-	{
+	if ( m_resource_manager ) { // not needed in gse-only and headless modes
 		m_resource_manager->Init( m_config->GetPossibleSMACPaths() );
 		t_main->AddModule( m_resource_manager );
 	}
@@ -88,13 +90,23 @@ Engine::Engine(
 	m_threads.push_back( t_main );
 
 	NEWV( t_network, common::Thread, "NETWORK" );
-	t_network->SetIPS( 100 );
+	if ( m_network->WaitsForActivity() ) {
+		// network module sleeps by itself until there is some activity, throttling would only add latency
+		t_network->SetUnthrottled();
+	}
+	else {
+		t_network->SetIPS( 100 );
+	}
 	t_network->AddModule( m_network );
 	m_threads.push_back( t_network );
 
 	if ( m_game ) {
 		NEWV( t_game, common::Thread, "GAME" );
-		t_game->SetIPS( g_max_fps );
+		t_game->SetIPS(
+			m_config->HasLaunchFlag( config::Config::LF_DEDICATED_SERVER )
+				? g_dedicated_server_ips
+				: g_max_fps
+		);
 		t_game->AddModule( m_game );
 		m_threads.push_back( t_game );
 	}
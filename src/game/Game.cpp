@@ -197,6 +197,11 @@ void Game::Iterate() {
 	MTModule::Iterate();
 
 	try {
+		if ( m_reconnect.timer.HasTicked() ) {
+			ASSERT( m_connection, "reconnecting without connection" );
+			m_connection->AsClient()->Reconnect();
+		}
+
 		if ( m_state ) {
 			m_state->Iterate();
 		}
@@ -282,7 +287,8 @@ void Game::Iterate() {
 					if (
 						!ec &&
 							config->HasDebugFlag( config::Config::DF_MAPDUMP ) &&
-							!config->HasDebugFlag( config::Config::DF_QUICKSTART_MAP_DUMP ) // no point saving if we just loaded it
+							!config->HasDebugFlag( config::Config::DF_QUICKSTART_MAP_DUMP ) && // no point saving if we just loaded it
+							!m_map->IsHeadless() // dump includes terrain textures and meshes, which headless map doesn't generate
 						) {
 						Log( (std::string)"Saving map dump to " + config->GetDebugPath() + map::s_consts.debug.lastdump_filename );
 						ui->SetLoaderText( "Saving dump", false );
@@ -292,25 +298,27 @@ void Game::Iterate() {
 
 					ASSERT( m_map, "map not set" );
 
-					NEW( m_response_map_data, response_map_data_t );
+					if ( !m_map->IsHeadless() ) { // otherwise there is nobody to render it
+						NEW( m_response_map_data, response_map_data_t );
 
-					m_response_map_data->map_width = m_map->GetWidth();
-					m_response_map_data->map_height = m_map->GetHeight();
+						m_response_map_data->map_width = m_map->GetWidth();
+						m_response_map_data->map_height = m_map->GetHeight();
 
-					ASSERT( m_map->m_textures.terrain, "map terrain texture not generated" );
-					m_response_map_data->terrain_texture = m_map->m_textures.terrain;
+						ASSERT( m_map->m_textures.terrain, "map terrain texture not generated" );
+						m_response_map_data->terrain_texture = m_map->m_textures.terrain;
 
-					ASSERT( m_map->m_meshes.terrain, "map terrain mesh not generated" );
-					m_response_map_data->terrain_mesh = m_map->m_meshes.terrain;
+						ASSERT( m_map->m_meshes.terrain, "map terrain mesh not generated" );
+						m_response_map_data->terrain_mesh = m_map->m_meshes.terrain;
 
-					ASSERT( m_map->m_meshes.terrain_data, "map terrain data mesh not generated" );
-					m_response_map_data->terrain_data_mesh = m_map->m_meshes.terrain_data;
+						ASSERT( m_map->m_meshes.terrain_data, "map terrain data mesh not generated" );
+						m_response_map_data->terrain_data_mesh = m_map->m_meshes.terrain_data;
 
-					m_response_map_data->sprites.actors = &m_map->m_sprite_actors;
-					m_response_map_data->sprites.instances = &m_map->m_sprite_instances;
+						m_response_map_data->sprites.actors = &m_map->m_sprite_actors;
+						m_response_map_data->sprites.instances = &m_map->m_sprite_instances;
 
-					m_response_map_data->tiles = m_map->GetTilesPtr()->GetTilesPtr();
-					m_response_map_data->tile_states = m_map->GetMapState()->GetTileStatesPtr();
+						m_response_map_data->tiles = m_map->GetTilesPtr()->GetTilesPtr();
+						m_response_map_data->tile_states = m_map->GetMapState()->GetTileStatesPtr();
+					}
 
 					if ( m_old_map ) {
 						Log( "Destroying old map state" );
@@ -470,7 +478,7 @@ const MT_Response Game::ProcessRequest( const MT_Request& request, MT_CANCELABLE
 					NEW( response.data.error.error_text, std::string, m_initialization_error );
 				}
 			}
-			else if ( m_response_map_data ) {
+			else if ( m_response_map_data || m_map->IsHeadless() ) { // headless map has nothing to return but still reports success
 				response.result = R_SUCCESS;
 				response.data.get_map_data = m_response_map_data;
 				m_response_map_data = nullptr;
@@ -515,6 +523,7 @@ const MT_Response Game::ProcessRequest( const MT_Request& request, MT_CANCELABLE
 			m_map_editor->SelectTool( request.data.edit_map.tool );
 			m_map_editor->SelectBrush( request.data.edit_map.brush );
 			const auto tiles_to_reload = m_map_editor->Draw( m_map->GetTile( request.data.edit_map.tile_x, request.data.edit_map.tile_y ), request.data.edit_map.draw_mode );
+			m_state_version++;
 
 			if ( !tiles_to_reload.empty() ) {
 				auto* graphics = g_engine->GetGraphics();
@@ -595,6 +604,8 @@ const MT_Response Game::ProcessRequest( const MT_Request& request, MT_CANCELABLE
 						const auto on_complete = it->second;
 						m_running_animations_callbacks.erase( it );
 						on_complete();
+						// callbacks can change state outside of events ( i.e. unit is moved to destination tile after animation )
+						m_state_version++;
 						break;
 					}
 					default:
@@ -607,7 +618,7 @@ const MT_Response Game::ProcessRequest( const MT_Request& request, MT_CANCELABLE
 		case OP_ADD_EVENT: {
 			const std::string* errmsg = nullptr;
 			event::Event* event = nullptr;
-			auto buf = types::Buffer( *request.data.add_event.serialized_event );
+			auto buf = types::BufferView( *request.data.add_event.serialized_event );
 			event = event::Event::Unserialize( buf );
 			if ( !m_current_turn.IsActive() && event->m_type != event::Event::ET_UNCOMPLETE_TURN ) {
 				errmsg = new std::string( "Turn not active" );
@@ -715,6 +726,38 @@ void Game::Quit( const std::string& reason ) {
 	AddFrontendRequest( fr );
 }
 
+const bool Game::ScheduleReconnect( connection::Client* connection ) {
+	if ( m_game_state != GS_RUNNING || !connection->CanResume() ) {
+		return false; // nothing to resume
+	}
+	if ( m_reconnect.timer.IsRunning() ) {
+		return true; // already scheduled ( i.e. error after disconnect )
+	}
+	if ( m_reconnect.attempts >= RECONNECT_ATTEMPTS_MAX ) {
+		return false;
+	}
+	m_reconnect.attempts++;
+	Log( "Scheduling reconnect attempt " + std::to_string( m_reconnect.attempts ) + "/" + std::to_string( RECONNECT_ATTEMPTS_MAX ) );
+	if ( m_reconnect.attempts == 1 ) {
+		Message( "Lost connection to server, reconnecting..." );
+	}
+	m_reconnect.timer.SetTimeout( RECONNECT_DELAY_MS );
+	return true;
+}
+
+void Game::ConnectionLost() {
+	m_reconnect.timer.Stop();
+	m_reconnect.attempts = 0;
+	m_state->DetachConnection();
+	m_connection = nullptr;
+	if ( m_game_state != GS_RUNNING ) {
+		m_initialization_error = "Lost connection to server";
+	}
+	else {
+		Quit( "Lost connection to server" );
+	}
+}
+
 void Game::OnGSEError( gse::Exception& err ) {
 	auto fr = FrontendRequest( FrontendRequest::FR_ERROR );
 	NEW( fr.data.error.what, std::string, (std::string)"Script error: " + err.what() );
@@ -785,6 +828,7 @@ void Game::DefineAnimation( animation::Def* def ) {
 			def
 		}
 	);
+	m_state_version++;
 
 	auto fr = FrontendRequest( FrontendRequest::FR_ANIMATION_DEFINE );
 	NEW( fr.data.animation_define.serialized_animation, std::string, animation::Def::Serialize( def ).ToString() );
@@ -1198,7 +1242,9 @@ void Game::UncompleteTurn( const size_t slot_num ) {
 }
 
 void Game::FinalizeTurn() {
-	m_turn_checksum = m_current_turn.FinalizeAndChecksum();
+	m_current_turn.Finalize();
+	UpdateStateHash();
+	m_turn_checksum = m_state_hash.Get();
 	AddEvent( new event::TurnFinalized( m_slot_num, m_turn_checksum ) );
 }
 
@@ -1268,7 +1314,12 @@ void Game::GlobalFinalizeTurn() {
 
 void Game::GlobalProcessTurnFinalized( const size_t slot_num, const util::crc32::crc_t checksum ) {
 	ASSERT( m_state->IsMaster(), "not master" );
-	ASSERT( m_turn_checksum == checksum, "turn checksum mismatch" );
+	if ( m_turn_checksum != checksum ) {
+		// desync, game state of that slot differs from ours; it's reported to host in every build but game goes on, server state stays authoritative
+		const std::string text = "Game state of slot " + std::to_string( slot_num ) + " is out of sync ( turn checksum " + std::to_string( checksum ) + " != " + std::to_string( m_turn_checksum ) + " )";
+		Log( text );
+		Message( text );
+	}
 	ASSERT( m_verified_turn_checksum_slots.find( slot_num ) == m_verified_turn_checksum_slots.end(), "duplicate turn finalization from " + std::to_string( slot_num ) );
 	m_verified_turn_checksum_slots.insert( slot_num );
 
@@ -1395,7 +1446,10 @@ const gse::Value Game::ProcessEvent( event::Event* event ) {
 	}
 
 	m_current_turn.AddEvent( event );
-	return event->Apply( this );
+	m_state_version++;
+	const auto result = event->Apply( this );
+	UpdateStateHash();
+	return result;
 }
 
 const types::Vec3 Game::GetTileRenderCoords( const map::tile::Tile* tile ) {
@@ -1419,28 +1473,28 @@ void Game::SerializeUnits( types::Buffer& buf ) const {
 	buf.WriteInt( m_unit_moralesets.size() );
 	for ( const auto& it : m_unit_moralesets ) {
 		buf.WriteString( it.first );
-		buf.WriteString( unit::MoraleSet::Serialize( it.second ).ToString() );
+		buf.WriteBuffer( unit::MoraleSet::Serialize( it.second ) );
 	}
 
 	Log( "Serializing " + std::to_string( m_unit_defs.size() ) + " unit defs" );
 	buf.WriteInt( m_unit_defs.size() );
 	for ( const auto& it : m_unit_defs ) {
 		buf.WriteString( it.first );
-		buf.WriteString( unit::Def::Serialize( it.second ).ToString() );
+		buf.WriteBuffer( unit::Def::Serialize( it.second ) );
 	}
 
 	Log( "Serializing " + std::to_string( m_units.size() ) + " units" );
 	buf.WriteInt( m_units.size() );
 	for ( const auto& it : m_units ) {
 		buf.WriteInt( it.first );
-		buf.WriteString( unit::Unit::Serialize( it.second ).ToString() );
+		buf.WriteBuffer( unit::Unit::Serialize( it.second ) );
 	}
 	buf.WriteInt( unit::Unit::GetNextId() );
 
 	Log( "Saved next unit id: " + std::to_string( unit::Unit::GetNextId() ) );
 }
 
-void Game::UnserializeUnits( types::Buffer& buf ) {
+void Game::UnserializeUnits( types::BufferView& buf ) {
 	ASSERT( m_unit_moralesets.empty(), "unit moralesets not empty" );
 	ASSERT( m_unit_defs.empty(), "unit defs not empty" );
 	ASSERT( m_units.empty(), "units not empty" );
@@ -1449,7 +1503,7 @@ void Game::UnserializeUnits( types::Buffer& buf ) {
 	Log( "Unserializing " + std::to_string( sz ) + " unit moralesets" );
 	for ( size_t i = 0 ; i < sz ; i++ ) {
 		const auto name = buf.ReadString();
-		auto b = types::Buffer( buf.ReadString() );
+		auto b = buf.ReadView();
 		DefineMoraleSet( unit::MoraleSet::Unserialize( b ) );
 	}
 
@@ -1457,7 +1511,7 @@ void Game::UnserializeUnits( types::Buffer& buf ) {
 	Log( "Unserializing " + std::to_string( sz ) + " unit defs" );
 	for ( size_t i = 0 ; i < sz ; i++ ) {
 		const auto name = buf.ReadString();
-		auto b = types::Buffer( buf.ReadString() );
+		auto b = buf.ReadView();
 		DefineUnit( unit::Def::Unserialize( b ) );
 	}
 
@@ -1466,7 +1520,7 @@ void Game::UnserializeUnits( types::Buffer& buf ) {
 	ASSERT( m_unprocessed_units.empty(), "unprocessed units not empty" );
 	for ( size_t i = 0 ; i < sz ; i++ ) {
 		const auto unit_id = buf.ReadInt();
-		auto b = types::Buffer( buf.ReadString() );
+		auto b = buf.ReadView();
 		SpawnUnit( unit::Unit::Unserialize( b, this ) );
 	}
 
@@ -1480,14 +1534,14 @@ void Game::SerializeBases( types::Buffer& buf ) const {
 	buf.WriteInt( m_bases.size() );
 	for ( const auto& it : m_bases ) {
 		buf.WriteInt( it.first );
-		buf.WriteString( base::Base::Serialize( it.second ).ToString() );
+		buf.WriteBuffer( base::Base::Serialize( it.second ) );
 	}
 	buf.WriteInt( base::Base::GetNextId() );
 
 	Log( "Saved next base id: " + std::to_string( base::Base::GetNextId() ) );
 }
 
-void Game::UnserializeBases( types::Buffer& buf ) {
+void Game::UnserializeBases( types::BufferView& buf ) {
 	ASSERT( m_bases.empty(), "bases not empty" );
 
 	const size_t sz = buf.ReadInt();
@@ -1495,7 +1549,7 @@ void Game::UnserializeBases( types::Buffer& buf ) {
 	ASSERT( m_unprocessed_bases.empty(), "unprocessed bases not empty" );
 	for ( size_t i = 0 ; i < sz ; i++ ) {
 		const auto base_id = buf.ReadInt();
-		auto b = types::Buffer( buf.ReadString() );
+		auto b = buf.ReadView();
 		SpawnBase( base::Base::Unserialize( b, this ) );
 	}
 
@@ -1508,16 +1562,16 @@ void Game::SerializeAnimations( types::Buffer& buf ) const {
 	buf.WriteInt( m_animation_defs.size() );
 	for ( const auto& it : m_animation_defs ) {
 		buf.WriteString( it.first );
-		buf.WriteString( animation::Def::Serialize( it.second ).ToString() );
+		buf.WriteBuffer( animation::Def::Serialize( it.second ) );
 	}
 }
 
-void Game::UnserializeAnimations( types::Buffer& buf ) {
+void Game::UnserializeAnimations( types::BufferView& buf ) {
 	size_t sz = buf.ReadInt();
 	Log( "Unserializing " + std::to_string( sz ) + " animation defs" );
 	for ( size_t i = 0 ; i < sz ; i++ ) {
 		const auto name = buf.ReadString();
-		auto b = types::Buffer( buf.ReadString() );
+		auto b = buf.ReadView();
 		DefineAnimation( animation::Def::Unserialize( b ) );
 	}
 }
@@ -1610,30 +1664,30 @@ void Game::InitGame( MT_Response& response, MT_CANCELABLE ) {
 						return "";
 					}
 					Log( "Preparing snapshot for download" );
-					types::Buffer buf;
+					types::Buffer buf( types::Buffer::F_COMPACT_CHECKSUMMED );
 
 					// map
 					m_map->SaveToBuffer( buf );
 
 					// units
 					{
-						types::Buffer b;
+						types::Buffer b( types::Buffer::F_COMPACT );
 						SerializeUnits( b );
-						buf.WriteString( b.ToString() );
+						buf.WriteBuffer( b );
 					}
 
 					// bases
 					{
-						types::Buffer b;
+						types::Buffer b( types::Buffer::F_COMPACT );
 						SerializeBases( b );
-						buf.WriteString( b.ToString() );
+						buf.WriteBuffer( b );
 					}
 
 					// animations
 					{
-						types::Buffer b;
+						types::Buffer b( types::Buffer::F_COMPACT );
 						SerializeAnimations( b );
-						buf.WriteString( b.ToString() );
+						buf.WriteBuffer( b );
 					}
 
 					// send turn info
@@ -1642,6 +1696,9 @@ void Game::InitGame( MT_Response& response, MT_CANCELABLE ) {
 
 					return buf.ToString();
 				};
+				connection->m_on_get_state_version = [ this ]() -> const size_t {
+					return m_state_version;
+				};
 
 				connection->SetGameState( connection::Connection::GS_INITIALIZING );
 			}
@@ -1649,22 +1706,30 @@ void Game::InitGame( MT_Response& response, MT_CANCELABLE ) {
 
 		m_connection->IfClient(
 			[ this ]( connection::Client* connection ) -> void {
-				connection->m_on_disconnect = [ this ]() -> bool {
+				connection->m_on_disconnect = [ this, connection ]() -> bool {
 					Log( "Connection lost" );
-					m_state->DetachConnection();
-					m_connection = nullptr;
-					if ( m_game_state != GS_RUNNING ) {
-						m_initialization_error = "Lost connection to server";
-					}
-					else {
-						Quit( "Lost connection to server" );
+					if ( ScheduleReconnect( connection ) ) {
+						return false;
 					}
+					ConnectionLost();
 					return true;
 				};
-				connection->m_on_error = [ this ]( const std::string& reason ) -> bool {
+				connection->m_on_error = [ this, connection ]( const std::string& reason ) -> bool {
+					if ( ScheduleReconnect( connection ) ) {
+						return false;
+					}
+					if ( m_connection && m_game_state == GS_RUNNING ) {
+						// last reconnect attempt failed
+						ConnectionLost();
+					}
 					m_initialization_error = reason;
 					return true;
 				};
+				connection->m_on_resume = [ this ]() -> void {
+					Log( "Connection restored" );
+					m_reconnect.attempts = 0;
+					Message( "Connection to server restored." );
+				};
 			}
 		);
 
@@ -1732,7 +1797,7 @@ void Game::InitGame( MT_Response& response, MT_CANCELABLE ) {
 			ASSERT( util::FS::FileExists( filename ), "map dump file \"" + filename + "\" not found" );
 			Log( (std::string)"Loading map dump from " + filename );
 			ui->SetLoaderText( "Loading dump", false );
-			m_map->Unserialize( types::Buffer( util::FS::ReadFile( filename ) ) );
+			m_map->Unserialize( types::BufferView( util::FS::ReadFile( filename ) ) );
 			ec = map::Map::EC_NONE;
 		}
 		else
@@ -1797,29 +1862,29 @@ void Game::InitGame( MT_Response& response, MT_CANCELABLE ) {
 						connection->m_on_download_complete = nullptr;
 						connection->m_on_download_progress = nullptr;
 						Log( "Unpacking world snapshot" );
-						auto buf = types::Buffer( serialized_snapshot );
+						auto buf = types::BufferView( serialized_snapshot );
 
 						// map
-						auto b = types::Buffer( buf.ReadString() );
+						auto b = buf.ReadView();
 						NEW( m_map, map::Map, this );
 						const auto ec = m_map->LoadFromBuffer( b );
 						if ( ec == map::Map::EC_NONE ) {
 
 							// units
 							{
-								auto ub = types::Buffer( buf.ReadString() );
+								auto ub = buf.ReadView();
 								UnserializeUnits( ub );
 							}
 
 							// bases
 							{
-								auto bb = types::Buffer( buf.ReadString() );
+								auto bb = buf.ReadView();
 								UnserializeBases( bb );
 							}
 
 							// animations
 							{
-								auto ab = types::Buffer( buf.ReadString() );
+								auto ab = buf.ReadView();
 								UnserializeAnimations( ab );
 							}
 
@@ -1921,6 +1986,10 @@ void Game::ResetGame() {
 	m_unit_updates.clear();
 	m_base_updates.clear();
 
+	m_state_hash.Reset();
+	m_changed_unit_ids.clear();
+	m_changed_base_ids.clear();
+
 	m_tile_lock_requests.clear();
 	m_tile_locks.clear();
 
@@ -1928,6 +1997,7 @@ void Game::ResetGame() {
 
 	m_current_turn.Reset();
 	m_is_turn_complete = false;
+	m_state_version++;
 
 	if ( m_state ) {
 		// ui thread will reset state as needed
@@ -1938,6 +2008,8 @@ void Game::ResetGame() {
 			m_connection->ResetHandlers();
 		}
 		m_connection = nullptr;
+		m_reconnect.timer.Stop();
+		m_reconnect.attempts = 0;
 	}
 }
 
@@ -1968,6 +2040,8 @@ void Game::CheckTurnComplete() {
 }
 
 void Game::QueueUnitUpdate( const unit::Unit* unit, const unit_update_op_t op ) {
+	m_changed_unit_ids.insert( unit->m_id );
+	m_state_version++;
 	auto it = m_unit_updates.find( unit->m_id );
 	if ( it == m_unit_updates.end() ) {
 		it = m_unit_updates.insert(
@@ -1994,6 +2068,8 @@ void Game::QueueUnitUpdate( const unit::Unit* unit, const unit_update_op_t op )
 }
 
 void Game::QueueBaseUpdate( const base::Base* base, const base_update_op_t op ) {
+	m_changed_base_ids.insert( base->m_id );
+	m_state_version++;
 	auto it = m_base_updates.find( base->m_id );
 	if ( it == m_base_updates.end() ) {
 		it = m_base_updates.insert(
@@ -2019,6 +2095,39 @@ void Game::QueueBaseUpdate( const base::Base* base, const base_update_op_t op )
 	update.ops = (base_update_op_t)( (uint8_t)update.ops | (uint8_t)op );
 }
 
+void Game::UpdateStateHash() {
+	for ( const auto& unit_id : m_changed_unit_ids ) {
+		const auto it = m_units.find( unit_id );
+		if ( it == m_units.end() ) {
+			m_state_hash.Remove( turn::StateHash::OT_UNIT, unit_id );
+			continue;
+		}
+		const auto* unit = it->second;
+		// same as in unit snapshot, but only def id is needed
+		types::Buffer buf( types::Buffer::F_COMPACT );
+		buf.WriteString( unit->m_def->m_id );
+		buf.WriteInt( unit->m_owner->GetIndex() );
+		buf.WriteInt( unit->GetTile()->coord.x );
+		buf.WriteInt( unit->GetTile()->coord.y );
+		buf.WriteFloat( unit->m_movement );
+		buf.WriteInt( unit->m_morale );
+		buf.WriteFloat( unit->m_health );
+		buf.WriteBool( unit->m_moved_this_turn );
+		m_state_hash.Set( turn::StateHash::OT_UNIT, unit_id, buf );
+	}
+	m_changed_unit_ids.clear();
+
+	for ( const auto& base_id : m_changed_base_ids ) {
+		const auto it = m_bases.find( base_id );
+		if ( it == m_bases.end() ) {
+			m_state_hash.Remove( turn::StateHash::OT_BASE, base_id );
+			continue;
+		}
+		m_state_hash.Set( turn::StateHash::OT_BASE, base_id, base::Base::Serialize( it->second ) );
+	}
+	m_changed_base_ids.clear();
+}
+
 void Game::PushUnitUpdates() {
 	if ( m_game_state == GS_RUNNING && !m_unit_updates.empty() ) {
 		for ( const auto& it : m_unit_updates ) {
@@ -15,7 +15,9 @@
 #include "FrontendRequest.h"
 #include "BackendRequest.h"
 #include "game/turn/Turn.h"
+#include "game/turn/StateHash.h"
 #include "TileLock.h"
+#include "util/Timer.h"
 
 // TODO: remove those
 #include "map/tile/Tile.h"
@@ -60,6 +62,7 @@ class Player;
 
 namespace connection {
 class Connection;
+class Client;
 }
 
 namespace bindings {
@@ -371,15 +374,15 @@ private:
 	std::unordered_map< std::string, unit::Def* > m_unit_defs = {};
 	std::map< size_t, unit::Unit* > m_units = {};
 	void SerializeUnits( types::Buffer& buf ) const;
-	void UnserializeUnits( types::Buffer& buf );
+	void UnserializeUnits( types::BufferView& buf );
 
 	std::map< size_t, base::Base* > m_bases = {};
 	void SerializeBases( types::Buffer& buf ) const;
-	void UnserializeBases( types::Buffer& buf );
+	void UnserializeBases( types::BufferView& buf );
 
 	std::unordered_map< std::string, animation::Def* > m_animation_defs = {};
 	void SerializeAnimations( types::Buffer& buf ) const;
-	void UnserializeAnimations( types::Buffer& buf );
+	void UnserializeAnimations( types::BufferView& buf );
 
 	enum game_state_t {
 		GS_NONE,
@@ -400,6 +403,12 @@ private:
 	util::crc32::crc_t m_turn_checksum = 0;
 	std::unordered_set< size_t > m_verified_turn_checksum_slots = {};
 
+	// turn checksum is hash of world state, objects changed by events are rehashed after every event and before finalizing turn
+	turn::StateHash m_state_hash = {};
+	std::unordered_set< size_t > m_changed_unit_ids = {};
+	std::unordered_set< size_t > m_changed_base_ids = {};
+	void UpdateStateHash();
+
 	std::vector< FrontendRequest >* m_pending_frontend_requests = nullptr;
 	void AddFrontendRequest( const FrontendRequest& request );
 
@@ -411,6 +420,16 @@ private:
 	State* m_state = nullptr;
 	connection::Connection* m_connection = nullptr;
 
+	// client that lost connection to running game tries to resume it few times before giving up
+	const uint8_t RECONNECT_ATTEMPTS_MAX = 5;
+	const size_t RECONNECT_DELAY_MS = 2000;
+	struct {
+		util::Timer timer;
+		uint8_t attempts = 0;
+	} m_reconnect = {};
+	const bool ScheduleReconnect( connection::Client* connection );
+	void ConnectionLost();
+
 	map::Map* m_map = nullptr;
 	map::Map* m_old_map = nullptr; // to restore state, for example if loading of another map failed
 	map_editor::MapEditor* m_map_editor = nullptr;
@@ -422,6 +441,10 @@ private:
 
 	turn::Turn m_current_turn = {};
 
+	// bumped on every change of state that ends up in world snapshot, so that server can reuse snapshot for concurrent downloads
+	// ( not only on events - units and bases are also changed by scripts and by backend request callbacks )
+	size_t m_state_version = 0;
+
 	bool m_is_turn_complete = false;
 	void CheckTurnComplete();
 
@@ -94,23 +94,23 @@ const types::Buffer Player::Serialize() const {
 	buf.WriteInt( m_role );
 	buf.WriteBool( m_faction.has_value() );
 	if ( m_faction.has_value() ) {
-		buf.WriteString( m_faction->Serialize().ToString() );
+		buf.WriteBuffer( m_faction->Serialize() );
 	}
-	buf.WriteString( m_difficulty_level.Serialize().ToString() );
+	buf.WriteBuffer( m_difficulty_level.Serialize() );
 
 	return buf;
 }
 
-void Player::Unserialize( types::Buffer buf ) {
+void Player::Unserialize( types::BufferView buf ) {
 
 	m_name = buf.ReadString();
 	m_role = (role_t)buf.ReadInt();
 	m_faction = {};
 	if ( buf.ReadBool() ) {
 		m_faction = rules::Faction{};
-		m_faction->Unserialize( buf.ReadString() );
+		m_faction->Unserialize( buf.ReadView() );
 	}
-	m_difficulty_level.Unserialize( buf.ReadString() );
+	m_difficulty_level.Unserialize( buf.ReadView() );
 
 }
 
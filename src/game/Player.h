@@ -55,7 +55,7 @@ CLASS( Player, types::Serializable )
 	void UncompleteTurn();
 
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override;
 
 private:
 
@@ -23,7 +23,7 @@ Def::Def(
 }
 
 const types::Buffer Def::Serialize( const Def* def ) {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 	buf.WriteString( def->m_id );
 	buf.WriteInt( def->m_type );
 	buf.WriteFloat( def->m_scale_x );
@@ -41,7 +41,7 @@ const types::Buffer Def::Serialize( const Def* def ) {
 	return buf;
 }
 
-Def* Def::Unserialize( types::Buffer& buf ) {
+Def* Def::Unserialize( types::BufferView& buf ) {
 	const auto id = buf.ReadString();
 	const auto type = (animation_type_t)buf.ReadInt();
 	const auto scale_x = buf.ReadFloat();
@@ -5,6 +5,7 @@
 
 #include "Types.h"
 #include "types/Buffer.h"
+#include "types/BufferView.h"
 
 namespace game {
 namespace animation {
@@ -32,7 +33,7 @@ public:
 	virtual const std::string ToString( const std::string& prefix = "" ) const = 0;
 
 	static const types::Buffer Serialize( const Def* def );
-	static Def* Unserialize( types::Buffer& buf );
+	static Def* Unserialize( types::BufferView& buf );
 
 };
 
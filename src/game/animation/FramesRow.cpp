@@ -75,7 +75,7 @@ void FramesRow::Serialize( types::Buffer& buf, const FramesRow* def ) {
 }
 
 FramesRow* FramesRow::Unserialize(
-	types::Buffer& buf,
+	types::BufferView& buf,
 	const std::string& id,
 	const float scale_x,
 	const float scale_y,
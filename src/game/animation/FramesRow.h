@@ -39,7 +39,7 @@ private:
 
 	static void Serialize( types::Buffer& buf, const FramesRow* def );
 	static FramesRow* Unserialize(
-		types::Buffer& buf,
+		types::BufferView& buf,
 		const std::string& id,
 		const float scale_x,
 		const float scale_y,
@@ -41,7 +41,7 @@ Base::Base(
 }
 
 const types::Buffer Base::Serialize( const Base* unit ) {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 	buf.WriteInt( unit->m_id );
 	buf.WriteInt( unit->m_owner->GetIndex() );
 	buf.WriteInt( unit->m_tile->coord.x );
@@ -49,7 +49,7 @@ const types::Buffer Base::Serialize( const Base* unit ) {
 	return buf;
 }
 
-Base* Base::Unserialize( types::Buffer& buf, Game* game ) {
+Base* Base::Unserialize( types::BufferView& buf, Game* game ) {
 	const auto id = buf.ReadInt();
 	auto* slot = game ? &game->GetState()->m_slots->GetSlot( buf.ReadInt() ) : nullptr;
 	const auto pos_x = buf.ReadInt();
@@ -6,6 +6,7 @@
 #include "game/MapObject.h"
 
 #include "types/Buffer.h"
+#include "types/BufferView.h"
 
 namespace game {
 
@@ -37,7 +38,7 @@ public:
 	slot::Slot* m_owner;
 
 	static const types::Buffer Serialize( const Base* unit );
-	static Base* Unserialize( types::Buffer& buf, Game* game );
+	static Base* Unserialize( types::BufferView& buf, Game* game );
 
 	WRAPDEFS_DYNAMIC( Base );
 
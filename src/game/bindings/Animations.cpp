@@ -13,6 +13,7 @@
 #include "game/event/DefineAnimation.h"
 #include "game/animation/FramesRow.h"
 #include "engine/Engine.h"
+#include "config/Config.h"
 #include "loader/sound/SoundLoader.h"
 
 namespace game {
@@ -43,7 +44,10 @@ BINDING_IMPL( animations ) {
 					N_GETPROP_OPT( float, scale_y, animation_def, "scale_y", Float, 1.0f );
 					N_GETPROP( duration_ms, animation_def, "duration_ms", Int );
 					N_GETPROP( sound, animation_def, "sound", String );
-					if ( !g_engine->GetSoundLoader()->LoadCustomSound( sound ) ) {
+					if (
+						!g_engine->GetConfig()->HasLaunchFlag( config::Config::LF_DEDICATED_SERVER ) && // headless server doesn't play sounds
+							!g_engine->GetSoundLoader()->LoadCustomSound( sound )
+						) {
 						ERROR( gse::EC.GAME_ERROR, "Failed to load animation sound '" + sound + "'" );
 					}
 					auto* def = new animation::FramesRow(
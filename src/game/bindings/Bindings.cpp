@@ -13,6 +13,8 @@
 #include "gse/type/Undefined.h"
 
 #include "game/State.h"
+#include "engine/Engine.h"
+#include "config/Config.h"
 
 namespace game {
 namespace bindings {
@@ -29,6 +31,8 @@ Bindings::Bindings( State* state )
 		)
 	) {
 	NEW( m_gse, gse::GSE );
+	m_gse->SetRunnerType( g_engine->GetConfig()->GetGSERunnerType() );
+	m_gse->SetProgramCachePath( g_engine->GetConfig()->GetPrefix() + "cache/gse/" );
 	m_gse->AddBindings( this );
 	m_gse_context = m_gse->CreateGlobalContext();
 	m_gse_context->IncRefs();
@@ -74,7 +78,7 @@ gse::Value Bindings::Call( const callback_slot_t slot, const callback_arguments_
 	const auto& it = m_callbacks.find( slot );
 	if ( it != m_callbacks.end() ) {
 		try {
-			gse::type::object_properties_t properties = arguments;
+			const gse::type::object_properties_t properties( arguments.begin(), arguments.end() );
 			const gse::Value result = ( (gse::type::Callable*)it->second.Get() )->Run(
 				m_gse_context, m_si_internal, {
 					VALUE( gse::type::Object, properties ),
@@ -1,6 +1,7 @@
 #include "Client.h"
 
 #include <algorithm>
+#include <chrono>
 
 #include "game/State.h"
 #include "game/slot/Slots.h"
@@ -26,7 +27,7 @@ void Client::ProcessEvent( const network::Event& event ) {
 			try {
 				if ( !event.data.packet_data.empty() ) {
 					types::Packet packet( types::Packet::PT_NONE );
-					packet.Unserialize( types::Buffer( event.data.packet_data ) );
+					packet.Unserialize( types::BufferView( event.data.packet_data ) );
 					switch ( packet.type ) {
 						case types::Packet::PT_REQUEST_AUTH: {
 							Log( "Authenticating" );
@@ -35,6 +36,14 @@ void Client::ProcessEvent( const network::Event& event ) {
 								m_settings->account.GetGSID(),
 								m_settings->player_name,
 							};
+							if ( m_event_stream.is_resuming ) {
+								p.udata.events.seq = m_event_stream.seq;
+								p.udata.events.hash = m_event_stream.hash;
+							}
+							else {
+								p.udata.events.seq = 0;
+								p.udata.events.hash = 0;
+							}
 							m_network->MT_SendPacket( &p );
 							break;
 						}
@@ -92,7 +101,7 @@ void Client::ProcessEvent( const network::Event& event ) {
 							if ( !ok ) {
 								break; // something went wrong
 							}
-							m_state->m_settings.global.Unserialize( types::Buffer( packet.data.str ) );
+							m_state->m_settings.global.Unserialize( types::BufferView( packet.data.str ) );
 							if ( m_on_global_settings_update ) {
 								m_on_global_settings_update();
 							}
@@ -179,18 +188,31 @@ void Client::ProcessEvent( const network::Event& event ) {
 								Log( "No download response received from server" );
 								Disconnect( "No download response received from server" );
 							}
+							else if ( packet.udata.download.size < DOWNLOAD_CHUNK_SIZE_MIN || packet.udata.download.size > DOWNLOAD_CHUNK_SIZE_MAX ) {
+								Error( "invalid download chunk size ( " + std::to_string( packet.udata.download.size ) + " )" );
+							}
+							else if ( packet.udata.download.codecs != DC_NONE && packet.udata.download.codecs != DC_LZ4 ) {
+								Error( "unsupported download codec ( " + std::to_string( packet.udata.download.codecs ) + " )" );
+							}
 							else {
 								m_download_state.total_size = packet.data.num;
-								Log( "Allocating download buffer (" + std::to_string( m_download_state.total_size ) + " bytes)" );
-								m_download_state.buffer.reserve( m_download_state.total_size );
-								DownloadNextChunk();
+								m_download_state.chunk_size = packet.udata.download.size;
+								m_download_state.codec = (download_codec_t)packet.udata.download.codecs;
+								m_download_state.downloaded_size = 0;
+								m_download_state.acked_size = 0;
+								m_download_state.decoder.Reset();
+								m_download_state.decode_time_us = 0;
+								Log( "Allocating download buffer (" + std::to_string( m_download_state.total_size ) + " bytes, chunk size " + std::to_string( m_download_state.chunk_size ) + ", codec " + std::to_string( m_download_state.codec ) + ")" );
+								m_download_state.buffer.clear();
+								m_download_state.buffer.reserve( m_download_state.total_size ); // decoded size isn't known yet, but it's at least that much
+								// server starts streaming chunks by itself
 							}
 							break;
 						}
 						case types::Packet::PT_DOWNLOAD_NEXT_CHUNK_RESPONSE: {
 							Log( "Downloaded next chunk ( offset=" + std::to_string( packet.udata.download.offset ) + " size=" + std::to_string( packet.udata.download.size ) + " )" );
 							const size_t end = packet.udata.download.offset + packet.udata.download.size;
-							if ( !m_download_state.is_downloading ) {
+							if ( !m_download_state.is_downloading || !m_download_state.chunk_size ) {
 								Error( "chunk received while not downloading" );
 							}
 							else if ( end > m_download_state.total_size ) {
@@ -200,28 +222,46 @@ void Client::ProcessEvent( const network::Event& event ) {
 								Error( "inconsistent chunk offset ( " + std::to_string( packet.udata.download.offset ) + " != " + std::to_string( m_download_state.downloaded_size ) + " )" );
 							}
 							else if (
-								packet.udata.download.size != DOWNLOAD_CHUNK_SIZE &&
+								packet.udata.download.size != m_download_state.chunk_size &&
 									end != m_download_state.total_size // last chunk can be smaller
 								) {
-								Error( "inconsistent map chunk size ( " );
+								Error( "inconsistent map chunk size ( " + std::to_string( packet.udata.download.size ) + " != " + std::to_string( m_download_state.chunk_size ) + " )" );
 							}
 							else {
 								ASSERT( packet.data.str.size() == packet.udata.download.size, "download buffer size mismatch" );
-								m_download_state.buffer.append( packet.data.str );
-								if ( end < m_download_state.total_size ) {
-									if ( m_on_download_progress ) {
-										m_on_download_progress( (float)m_download_state.downloaded_size / m_download_state.total_size );
-									}
-									m_download_state.downloaded_size = end;
-									DownloadNextChunk();
+								if ( !AppendDownloadedChunk( packet.data.str ) ) {
+									Error( "malformed compressed snapshot" );
+									break;
 								}
-								else {
+								if ( m_on_download_progress ) {
+									m_on_download_progress( (float)m_download_state.downloaded_size / m_download_state.total_size );
+								}
+								m_download_state.downloaded_size = end;
+								if (
+									end == m_download_state.total_size ||
+										end - m_download_state.acked_size >= m_download_state.chunk_size * DOWNLOAD_ACK_EVERY_CHUNKS
+									) {
+									AcknowledgeDownload();
+								}
+								if ( end == m_download_state.total_size ) {
+									if ( m_download_state.codec == DC_LZ4 ) {
+										if ( !m_download_state.decoder.IsFinished() ) {
+											Error( "truncated compressed snapshot" );
+											break;
+										}
+										Log(
+											"Decompressed snapshot ( " + std::to_string( m_download_state.total_size ) + " -> " + std::to_string( m_download_state.buffer.size() ) + " bytes, ratio=" +
+												std::to_string( (float)m_download_state.buffer.size() / m_download_state.total_size ) + " decode time=" + std::to_string( m_download_state.decode_time_us ) + "us )"
+										);
+									}
 									Log( "Download completed successfully" );
 									if ( m_on_download_complete ) {
 										m_on_download_complete( m_download_state.buffer );
 									}
 									m_download_state.buffer.clear();
+									m_download_state.decoder.Reset();
 									m_download_state.is_downloading = false;
+									m_download_state.chunk_size = 0;
 								}
 							}
 							break;
@@ -229,7 +269,7 @@ void Client::ProcessEvent( const network::Event& event ) {
 						case types::Packet::PT_GAME_EVENTS: {
 							Log( "Got game events packet" );
 							if ( m_on_game_event_validate && m_on_game_event_apply ) {
-								auto buf = types::Buffer( packet.data.str );
+								auto buf = types::BufferView( packet.data.str );
 								std::vector< game::event::Event* > game_events = {};
 								game::event::Event::UnserializeMultiple( buf, game_events );
 								for ( const auto& game_event : game_events ) {
@@ -237,12 +277,43 @@ void Client::ProcessEvent( const network::Event& event ) {
 									m_on_game_event_validate( game_event );
 									m_on_game_event_apply( game_event );
 								}
+								m_event_stream.seq = packet.udata.events.seq;
+								m_event_stream.hash = packet.udata.events.hash;
 							}
 							else {
 								Log( "WARNING: game event handler not set" );
 							}
 							break;
 						}
+						case types::Packet::PT_RESUME: {
+							if ( !m_event_stream.is_resuming ) {
+								Error( "unexpected resume response" );
+								break;
+							}
+							m_event_stream.is_resuming = false;
+							if ( !packet.data.boolean ) {
+								Log( "Server can't resume game from event #" + std::to_string( m_event_stream.seq ) );
+								m_event_stream.seq = 0;
+								m_event_stream.hash = 0;
+								m_event_stream.outgoing_events.clear();
+								Disconnect( "Server can't resume game" );
+								break;
+							}
+							Log( "Resumed game from event #" + std::to_string( m_event_stream.seq ) );
+							m_game_state = GS_RUNNING;
+							for ( const auto& serialized_events : m_event_stream.outgoing_events ) {
+								types::Packet p( types::Packet::PT_GAME_EVENTS );
+								p.data.str = serialized_events;
+								p.udata.events.seq = 0;
+								p.udata.events.hash = 0;
+								m_network->MT_SendPacket( &p );
+							}
+							m_event_stream.outgoing_events.clear();
+							if ( m_on_resume ) {
+								m_on_resume();
+							}
+							break;
+						}
 						default: {
 							Log( "WARNING: invalid packet type from server: " + std::to_string( packet.type ) );
 						}
@@ -269,12 +340,30 @@ void Client::ProcessEvent( const network::Event& event ) {
 }
 
 void Client::SendGameEvents( const game_events_t& game_events ) {
+	if ( m_event_stream.is_resuming ) {
+		Log( "Delaying " + std::to_string( game_events.size() ) + " game events until resumed" );
+		m_event_stream.outgoing_events.push_back( game::event::Event::SerializeMultiple( game_events ).ToString() );
+		return;
+	}
 	Log( "Sending " + std::to_string( game_events.size() ) + " game events" );
 	types::Packet p( types::Packet::PT_GAME_EVENTS );
 	p.data.str = game::event::Event::SerializeMultiple( game_events ).ToString();
+	p.udata.events.seq = 0; // only server keeps track of stream
+	p.udata.events.hash = 0;
 	m_network->MT_SendPacket( &p );
 }
 
+const bool Client::CanResume() const {
+	return m_event_stream.seq > 0;
+}
+
+void Client::Reconnect() {
+	ASSERT( CanResume(), "reconnect without game events received" );
+	Log( "Reconnecting to resume from event #" + std::to_string( m_event_stream.seq ) );
+	m_event_stream.is_resuming = true;
+	ConnectInBackground();
+}
+
 void Client::UpdateSlot( const size_t slot_num, slot::Slot* slot, const bool only_flags ) {
 	if ( only_flags ) {
 		Log( "Sending flags update" );
@@ -309,6 +398,8 @@ void Client::RequestDownload() {
 	ASSERT( m_on_download_complete, "download requested but m_on_download_complete is not set" );
 	m_download_state.is_downloading = true;
 	types::Packet p( types::Packet::PT_DOWNLOAD_REQUEST );
+	p.udata.download.size = DOWNLOAD_CHUNK_SIZE_MAX;
+	p.udata.download.codecs = 1 << DC_LZ4;
 	m_network->MT_SendPacket( &p );
 }
 
@@ -316,6 +407,7 @@ void Client::ResetHandlers() {
 	Connection::ResetHandlers();
 	m_on_players_list_update = nullptr;
 	m_on_game_state_change = nullptr;
+	m_on_resume = nullptr;
 	m_on_download_progress = nullptr;
 	m_on_download_complete = nullptr;
 }
@@ -325,16 +417,31 @@ void Client::Error( const std::string& reason ) {
 	Disconnect( "Network protocol error" );
 }
 
-void Client::DownloadNextChunk() {
+void Client::AcknowledgeDownload() {
 	ASSERT( m_download_state.is_downloading, "download not initialized" );
-	ASSERT( m_download_state.buffer.size() == m_download_state.downloaded_size, "download buffer size mismatch" );
-	ASSERT( m_download_state.downloaded_size < m_download_state.total_size, "download already finished" );
-	const size_t size = std::min( DOWNLOAD_CHUNK_SIZE, m_download_state.total_size - m_download_state.downloaded_size );
-	Log( "Requesting next chunk ( offset=" + std::to_string( m_download_state.downloaded_size ) + " size=" + std::to_string( size ) + " )" );
+	Log( "Acknowledging download ( offset=" + std::to_string( m_download_state.downloaded_size ) + " )" );
 	types::Packet p( types::Packet::PT_DOWNLOAD_NEXT_CHUNK_REQUEST );
 	p.udata.download.offset = m_download_state.downloaded_size;
-	p.udata.download.size = size;
+	p.udata.download.size = 0;
 	m_network->MT_SendPacket( &p );
+	m_download_state.acked_size = m_download_state.downloaded_size;
+}
+
+const bool Client::AppendDownloadedChunk( const std::string& chunk ) {
+	switch ( m_download_state.codec ) {
+		case DC_NONE: {
+			m_download_state.buffer.append( chunk );
+			return true;
+		}
+		case DC_LZ4: {
+			const auto started_at = std::chrono::steady_clock::now();
+			const bool result = m_download_state.decoder.Feed( chunk.data(), chunk.size(), m_download_state.buffer );
+			m_download_state.decode_time_us += std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - started_at ).count();
+			return result;
+		}
+		default:
+			THROW( "unexpected download codec " + std::to_string( m_download_state.codec ) );
+	}
 }
 
 }
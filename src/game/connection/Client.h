@@ -2,6 +2,9 @@
 
 #include "Connection.h"
 
+#include "util/lz4/LZ4.h"
+#include "util/crc32/Types.h"
+
 namespace game {
 namespace connection {
 
@@ -13,6 +16,7 @@ CLASS( Client, Connection )
 	std::function< void( const game_state_t game_state ) > m_on_game_state_change = nullptr;
 	std::function< void( const float progress ) > m_on_download_progress = nullptr; // progress is from 0.0f to 1.0f
 	std::function< void( const std::string serialized_tiles ) > m_on_download_complete = nullptr;
+	std::function< void() > m_on_resume = nullptr; // reconnected to running game, missed game events follow
 
 	void UpdateSlot( const size_t slot_num, slot::Slot* slot, const bool only_flags = false ) override;
 	void SendMessage( const std::string& message ) override;
@@ -20,6 +24,10 @@ CLASS( Client, Connection )
 	const game_state_t GetGameState() const;
 	void RequestDownload();
 
+	// client that received game events can reconnect to running game and get only events it missed
+	const bool CanResume() const;
+	void Reconnect();
+
 	void ResetHandlers() override;
 
 protected:
@@ -31,13 +39,26 @@ private:
 
 	void Error( const std::string& reason );
 
+	struct {
+		uint64_t seq = 0; // of last received game event
+		util::crc32::crc_t hash = 0;
+		bool is_resuming = false;
+		std::vector< std::string > outgoing_events = {}; // server doesn't know who we are until resumed
+	} m_event_stream = {};
+
 	struct {
 		bool is_downloading = false;
 		int total_size = 0;
 		int downloaded_size = 0;
-		std::string buffer = "";
+		int acked_size = 0;
+		int chunk_size = 0;
+		download_codec_t codec = DC_NONE;
+		util::lz4::Decoder decoder; // compressed snapshot is decoded chunk by chunk while rest is still downloading
+		size_t decode_time_us = 0;
+		std::string buffer = ""; // decoded snapshot
 	} m_download_state = {};
-	void DownloadNextChunk();
+	void AcknowledgeDownload();
+	const bool AppendDownloadedChunk( const std::string& chunk );
 };
 
 }
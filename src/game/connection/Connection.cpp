@@ -53,16 +53,9 @@ Connection::~Connection() {
 }
 
 void Connection::Connect() {
-	ASSERT( !m_is_connected, "already connected" );
-	ASSERT( !m_mt_ids.connect, "connection already in progress" );
-
-	m_is_canceled = false;
-
 	m_game_state = GS_NONE;
 
-	Log( "Connecting..." );
-
-	m_mt_ids.connect = m_network->MT_Connect( m_connection_mode, m_settings->remote_address );
+	ConnectInBackground();
 
 	g_engine->GetUI()->ShowLoader(
 		m_connection_mode == network::CM_SERVER
@@ -80,6 +73,17 @@ void Connection::Connect() {
 	);
 }
 
+void Connection::ConnectInBackground() {
+	ASSERT( !m_is_connected, "already connected" );
+	ASSERT( !m_mt_ids.connect, "connection already in progress" );
+
+	m_is_canceled = false;
+
+	Log( "Connecting..." );
+
+	m_mt_ids.connect = m_network->MT_Connect( m_connection_mode, m_settings->remote_address );
+}
+
 void Connection::Iterate() {
 
 	if ( m_mt_ids.disconnect ) {
@@ -205,6 +209,7 @@ void Connection::SendGameEvent( game::event::Event* event ) {
 		m_pending_game_events.clear();
 	}
 	m_pending_game_events.push_back( event );
+	m_network->SetPendingGameEventsCount( m_pending_game_events.size() );
 }
 
 const bool Connection::IsConnected() const {
@@ -219,6 +224,10 @@ const bool Connection::IsClient() const {
 	return m_connection_mode == network::CM_CLIENT;
 }
 
+const size_t Connection::GetPendingGameEventsCount() const {
+	return m_pending_game_events.size();
+}
+
 const size_t Connection::GetSlotNum() const {
 	return m_slot;
 }
@@ -256,6 +265,7 @@ void Connection::ProcessPending() {
 	if ( !m_pending_game_events.empty() ) {
 		SendGameEvents( m_pending_game_events );
 		m_pending_game_events.clear();
+		m_network->SetPendingGameEventsCount( 0 );
 	}
 }
 
@@ -263,6 +273,8 @@ void Connection::ClearPending() {
 	for ( auto& it : m_pending_game_events ) {
 		delete it;
 	}
+	m_pending_game_events.clear();
+	m_network->SetPendingGameEventsCount( 0 );
 }
 
 }
@@ -82,6 +82,7 @@ CLASS( Connection, common::Module )
 	const bool IsConnected() const;
 	const bool IsServer() const;
 	const bool IsClient() const;
+	const size_t GetPendingGameEventsCount() const; // buffered and not passed to network yet
 	const size_t GetSlotNum() const;
 	const Player* GetPlayer() const;
 
@@ -89,12 +90,25 @@ CLASS( Connection, common::Module )
 	virtual void SendMessage( const std::string& message ) = 0;
 
 protected:
-	const int DOWNLOAD_CHUNK_SIZE = 16384;
+	// snapshot is streamed in chunks, server keeps up to DOWNLOAD_WINDOW_CHUNKS unacknowledged chunks in flight
+	// client proposes chunk size, server may lower it ( chunk must fit into network buffer with some headroom )
+	const int DOWNLOAD_CHUNK_SIZE_MIN = 1024;
+	const int DOWNLOAD_CHUNK_SIZE_MAX = 61440;
+	const int DOWNLOAD_WINDOW_CHUNKS = 8;
+	const int DOWNLOAD_ACK_EVERY_CHUNKS = 2; // should be less than window so that server never stalls
+	// snapshot may be compressed before chunking, client announces what it can decode and server picks one
+	enum download_codec_t : uint8_t {
+		DC_NONE = 0,
+		DC_LZ4 = 1,
+	};
 
 	network::Network* const m_network;
 
 	virtual void ProcessEvent( const network::Event& event );
 
+	// same as Connect() but without loader and keeps game state ( i.e. to reconnect to running game )
+	void ConnectInBackground();
+
 	bool m_is_connected = false;
 	bool m_is_canceled = false; // canceled by user
 
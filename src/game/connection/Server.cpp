@@ -1,5 +1,7 @@
 #include "Server.h"
 
+#include <chrono>
+
 #include "engine/Engine.h"
 #include "types/Packet.h"
 #include "network/Network.h"
@@ -7,13 +9,18 @@
 #include "game/State.h"
 #include "game/slot/Slots.h"
 #include "game/Player.h"
+#include "util/lz4/LZ4.h"
+#include "util/crc32/CRC32.h"
 
 namespace game {
 namespace connection {
 
 Server::Server( settings::LocalSettings* const settings )
 	: Connection( network::CM_SERVER, settings ) {
-	//
+	// seed event stream with server start time so that client can't resume into history of another ( or restarted ) server
+	const auto started_at = std::chrono::system_clock::now().time_since_epoch().count();
+	m_event_log.hash = util::crc32::CRC32::Calculate( &started_at, sizeof( started_at ) );
+	m_event_log.evicted_hash = m_event_log.hash;
 }
 
 void Server::ProcessEvent( const network::Event& event ) {
@@ -98,6 +105,7 @@ void Server::ProcessEvent( const network::Event& event ) {
 				const auto& download_data_it = m_download_data.find( event.cid );
 				if ( download_data_it != m_download_data.end() ) {
 					m_download_data.erase( download_data_it );
+					MaybeReleaseSnapshot();
 				}
 
 				if ( m_game_state == GS_LOBBY ) {
@@ -117,7 +125,7 @@ void Server::ProcessEvent( const network::Event& event ) {
 		case network::Event::ET_PACKET: {
 			try {
 				types::Packet packet( types::Packet::PT_NONE );
-				packet.Unserialize( types::Buffer( event.data.packet_data ) );
+				packet.Unserialize( types::BufferView( event.data.packet_data ) );
 				switch ( packet.type ) {
 					case types::Packet::PT_AUTH: {
 						ASSERT( packet.data.vec.size() == 2, "unexpected vec size of PT_AUTH" );
@@ -210,9 +218,16 @@ void Server::ProcessEvent( const network::Event& event ) {
 						slot.SetPlayer( player, event.cid, event.data.remote_address );
 						player->Connect();
 
-						SendGameState( event.cid );
-						SendPlayersList( event.cid, slot_num );
-						SendGlobalSettings( event.cid );
+						bool is_resumed = false;
+						if ( packet.udata.events.seq ) {
+							// client was in this game before and wants only events it missed
+							is_resumed = ResumeClient( event.cid, packet.udata.events.seq, packet.udata.events.hash );
+						}
+						if ( !is_resumed ) {
+							SendGameState( event.cid );
+							SendPlayersList( event.cid, slot_num );
+							SendGlobalSettings( event.cid );
+						}
 
 						SendSlotUpdate( slot_num, &slot, event.cid ); // notify others
 
@@ -276,55 +291,59 @@ void Server::ProcessEvent( const network::Event& event ) {
 						break;
 					}
 					case types::Packet::PT_DOWNLOAD_REQUEST: {
-						Log( "Got download request from " + std::to_string( event.cid ) );
+						Log( "Got download request from " + std::to_string( event.cid ) + " ( chunk size=" + std::to_string( packet.udata.download.size ) + " codecs=" + std::to_string( packet.udata.download.codecs ) + " )" );
 						types::Packet p( types::Packet::PT_DOWNLOAD_RESPONSE );
-						if ( m_on_download_request ) {
+						const download_codec_t codec = ( packet.udata.download.codecs & ( 1 << DC_LZ4 ) )
+							? DC_LZ4
+							: DC_NONE;
+						const auto snapshot = GetSnapshot( codec );
+						if ( snapshot ) {
 							m_download_data[ event.cid ] = download_data_t{ // override previous request
+								snapshot,
+								std::max( std::min( packet.udata.download.size, (size_t)DOWNLOAD_CHUNK_SIZE_MAX ), (size_t)DOWNLOAD_CHUNK_SIZE_MIN ),
 								0,
-								m_on_download_request()
+								0
 							};
-							p.data.num = m_download_data.at( event.cid ).serialized_snapshot.size();
+							p.data.num = snapshot->size();
+							p.udata.download.size = m_download_data.at( event.cid ).chunk_size;
+							p.udata.download.codecs = codec;
 						}
 						else {
 							// no handler set - no data to return
 							Log( "WARNING: download requested but no download handler was set, sending empty header" );
 							p.data.num = 0;
+							p.udata.download.size = 0;
+							p.udata.download.codecs = DC_NONE;
 						}
 						m_network->MT_SendPacket( &p, event.cid );
+						if ( p.data.num ) {
+							// start streaming right away
+							SendDownloadChunks( event.cid, m_download_data.at( event.cid ) );
+						}
 						break;
 					}
 					case types::Packet::PT_DOWNLOAD_NEXT_CHUNK_REQUEST: {
-						Log( "Got next chunk request from " + std::to_string( event.cid ) + " ( offset=" + std::to_string( packet.udata.download.offset ) + " size=" + std::to_string( packet.udata.download.size ) + " )" );
+						Log( "Got download acknowledgement from " + std::to_string( event.cid ) + " ( offset=" + std::to_string( packet.udata.download.offset ) + " )" );
 						const auto& it = m_download_data.find( event.cid );
-						const size_t end = packet.udata.download.offset + packet.udata.download.size;
 						if ( it == m_download_data.end() ) {
 							Error( event.cid, "download not initialized" );
 						}
-						else if ( end > it->second.serialized_snapshot.size() ) {
-							Error( event.cid, "download offset overflow ( " + std::to_string( packet.udata.download.offset ) + " + " + std::to_string( packet.udata.download.size ) + " >= " + std::to_string( it->second.serialized_snapshot.size() ) + " )" );
+						else if ( packet.udata.download.offset > it->second.sent_offset ) {
+							Error( event.cid, "acknowledged more than was sent ( " + std::to_string( packet.udata.download.offset ) + " > " + std::to_string( it->second.sent_offset ) + " )" );
 						}
-						else if ( packet.udata.download.offset != it->second.next_expected_offset ) {
-							Error( event.cid, "inconsistent download offset ( " + std::to_string( packet.udata.download.offset ) + " != " + std::to_string( it->second.next_expected_offset ) + " )" );
-						}
-						else if (
-							packet.udata.download.size != DOWNLOAD_CHUNK_SIZE &&
-								end != it->second.serialized_snapshot.size() // last chunk can be smaller
-							) {
-							Error( event.cid, "inconsistent download size ( " );
+						else if ( packet.udata.download.offset < it->second.acked_offset ) {
+							Error( event.cid, "inconsistent download acknowledgement ( " + std::to_string( packet.udata.download.offset ) + " < " + std::to_string( it->second.acked_offset ) + " )" );
 						}
 						else {
-							types::Packet p( types::Packet::PT_DOWNLOAD_NEXT_CHUNK_RESPONSE );
-							p.udata.download.offset = packet.udata.download.offset;
-							p.udata.download.size = packet.udata.download.size;
-							p.data.str = it->second.serialized_snapshot.substr( packet.udata.download.offset, packet.udata.download.size );
-							m_network->MT_SendPacket( &p, event.cid );
-							if ( end < it->second.serialized_snapshot.size() ) {
-								it->second.next_expected_offset = end;
+							it->second.acked_offset = packet.udata.download.offset;
+							if ( it->second.acked_offset < it->second.serialized_snapshot->size() ) {
+								SendDownloadChunks( event.cid, it->second );
 							}
 							else {
-								// snapshot was sent fully, can free memory now
+								// snapshot was received fully, can free memory now
 								Log( "Snapshot was sent successfully to " + std::to_string( event.cid ) + ", cleaning up" );
 								m_download_data.erase( it );
+								MaybeReleaseSnapshot();
 							}
 						}
 						break;
@@ -333,7 +352,7 @@ void Server::ProcessEvent( const network::Event& event ) {
 						Log( "Got game events packet" );
 						ASSERT( m_on_game_event_validate, "m_on_game_event_validate is not set" );
 						ASSERT( m_on_game_event_apply, "m_on_game_event_apply is not set" );
-						auto buf = types::Buffer( packet.data.str );
+						auto buf = types::BufferView( packet.data.str );
 						std::vector< game::event::Event* > game_events = {};
 						game::event::Event::UnserializeMultiple( buf, game_events );
 						const size_t slot = m_state->GetCidSlots().at( event.cid );
@@ -394,22 +413,14 @@ void Server::ProcessEvent( const network::Event& event ) {
 
 void Server::SendGameEvents( const game_events_t& game_events ) {
 	Log( "Sending " + std::to_string( game_events.size() ) + " game events" );
+	const size_t from_index = m_event_log.entries.size();
+	LogGameEvents( game_events );
 	Broadcast(
-		[ this, game_events ]( const network::cid_t cid ) -> void {
-			std::vector< game::event::Event* > events = {};
-			for ( const auto& e : game_events ) {
-				const auto slot_num = m_state->GetCidSlots().at( cid );
-				if ( e->IsSendableTo( slot_num ) ) {
-					Log( "Sending event to " + std::to_string( slot_num ) + ": " + e->ToString() );
-					events.push_back( e );
-				}
-			}
-			if ( !events.empty() ) {
-				const auto serialized_events = game::event::Event::SerializeMultiple( events ).ToString();
-				SendGameEventsTo( serialized_events, cid );
-			}
+		[ this, from_index ]( const network::cid_t cid ) -> void {
+			SendLoggedGameEvents( cid, from_index );
 		}
 	);
+	TrimEventLog();
 }
 
 void Server::Broadcast( std::function< void( const network::cid_t cid ) > callback ) {
@@ -479,6 +490,9 @@ void Server::ResetHandlers() {
 	Connection::ResetHandlers();
 	m_on_listen = nullptr;
 	m_on_download_request = nullptr;
+	m_on_get_state_version = nullptr;
+	m_snapshot_cache.snapshot = nullptr;
+	m_snapshot_cache.snapshot_lz4 = nullptr;
 }
 
 void Server::UpdateGameSettings() {
@@ -582,9 +596,173 @@ const std::string Server::FormatChatMessage( const Player* player, const std::st
 void Server::SendGameEventsTo( const std::string& serialized_events, const network::cid_t cid ) {
 	types::Packet p( types::Packet::PT_GAME_EVENTS );
 	p.data.str = serialized_events;
+	// client remembers position in stream to resume from it if connection is lost
+	p.udata.events.seq = m_event_log.seq;
+	p.udata.events.hash = m_event_log.hash;
 	m_network->MT_SendPacket( &p, cid );
 }
 
+void Server::LogGameEvents( const game_events_t& game_events ) {
+	const auto slots_count = m_state->m_slots->GetCount();
+	ASSERT( slots_count <= 64, "too many slots for event recipients mask" );
+	for ( const auto& e : game_events ) {
+		uint64_t recipients = 0;
+		for ( size_t slot_num = 0 ; slot_num < slots_count ; slot_num++ ) {
+			if ( e->IsSendableTo( slot_num ) ) {
+				recipients |= (uint64_t)1 << slot_num;
+			}
+		}
+		if ( !recipients ) {
+			continue; // nobody will ever receive it
+		}
+		event_log_entry_t entry = {
+			++m_event_log.seq,
+			0,
+			recipients,
+			game::event::Event::Serialize( e ).ToString(),
+		};
+		m_event_log.hash = util::crc32::CRC32::Calculate( entry.serialized.data(), entry.serialized.size(), m_event_log.hash );
+		entry.hash = m_event_log.hash;
+		m_event_log.size += entry.serialized.size();
+		Log( "Logged event #" + std::to_string( entry.seq ) + ": " + e->ToString() );
+		m_event_log.entries.push_back( std::move( entry ) );
+	}
+}
+
+void Server::TrimEventLog() {
+	while (
+		!m_event_log.entries.empty() && (
+			m_event_log.entries.size() > EVENT_LOG_MAX_EVENTS ||
+				m_event_log.size > EVENT_LOG_MAX_BYTES
+		)
+		) {
+		const auto& entry = m_event_log.entries.front();
+		m_event_log.evicted_seq = entry.seq;
+		m_event_log.evicted_hash = entry.hash;
+		m_event_log.size -= entry.serialized.size();
+		m_event_log.entries.pop_front();
+	}
+}
+
+void Server::SendLoggedGameEvents( const network::cid_t cid, const size_t from_index ) {
+	const auto slot_num = m_state->GetCidSlots().at( cid );
+	const uint64_t mask = (uint64_t)1 << slot_num;
+	std::vector< const event_log_entry_t* > entries = {};
+	for ( size_t i = from_index ; i < m_event_log.entries.size() ; i++ ) {
+		const auto& entry = m_event_log.entries.at( i );
+		if ( entry.recipients & mask ) {
+			entries.push_back( &entry );
+		}
+	}
+	if ( entries.empty() ) {
+		return;
+	}
+	Log( "Sending " + std::to_string( entries.size() ) + " events to " + std::to_string( slot_num ) );
+	// same format as Event::SerializeMultiple(), but events are already serialized
+	types::Buffer buf( types::Buffer::F_COMPACT );
+	buf.WriteInt( entries.size() );
+	for ( const auto& entry : entries ) {
+		buf.WriteString( entry->serialized );
+	}
+	SendGameEventsTo( buf.ToString(), cid );
+}
+
+const bool Server::ResumeClient( const network::cid_t cid, const uint64_t seq, const util::crc32::crc_t hash ) {
+	// logged seqs are contiguous, so entry index is known from seq
+	bool is_resumable = false;
+	size_t from_index = 0;
+	if ( seq == m_event_log.evicted_seq ) {
+		is_resumable = hash == m_event_log.evicted_hash;
+	}
+	else if ( seq > m_event_log.evicted_seq && seq <= m_event_log.seq ) {
+		from_index = seq - m_event_log.evicted_seq;
+		is_resumable = hash == m_event_log.entries.at( from_index - 1 ).hash;
+	}
+	if ( is_resumable ) {
+		Log( "Resuming cid " + std::to_string( cid ) + " from event #" + std::to_string( seq ) + " ( " + std::to_string( m_event_log.seq - seq ) + " events behind )" );
+	}
+	else {
+		Log( "Can't resume cid " + std::to_string( cid ) + " from event #" + std::to_string( seq ) + " ( log has #" + std::to_string( m_event_log.evicted_seq + 1 ) + "..#" + std::to_string( m_event_log.seq ) + " )" );
+	}
+	{
+		types::Packet p( types::Packet::PT_RESUME );
+		p.data.boolean = is_resumable;
+		m_network->MT_SendPacket( &p, cid );
+	}
+	if ( is_resumable ) {
+		SendLoggedGameEvents( cid, from_index );
+	}
+	return is_resumable;
+}
+
+const Server::snapshot_t Server::GetSnapshot( const download_codec_t codec ) {
+	if ( !m_on_download_request ) {
+		return nullptr;
+	}
+	const size_t state_version = m_on_get_state_version
+		? m_on_get_state_version()
+		: 0;
+	if ( !m_snapshot_cache.snapshot || !m_on_get_state_version || state_version != m_snapshot_cache.state_version ) {
+		auto serialized_snapshot = m_on_download_request();
+		if ( serialized_snapshot.empty() ) {
+			return nullptr;
+		}
+		Log( "Caching snapshot ( size=" + std::to_string( serialized_snapshot.size() ) + " state version=" + std::to_string( state_version ) + " )" );
+		m_snapshot_cache.snapshot = std::make_shared< const std::string >( std::move( serialized_snapshot ) );
+		m_snapshot_cache.snapshot_lz4 = nullptr;
+		m_snapshot_cache.state_version = state_version;
+	}
+	else {
+		Log( "Reusing cached snapshot ( state version=" + std::to_string( state_version ) + " )" );
+	}
+	switch ( codec ) {
+		case DC_NONE:
+			return m_snapshot_cache.snapshot;
+		case DC_LZ4: {
+			if ( !m_snapshot_cache.snapshot_lz4 ) {
+				const auto started_at = std::chrono::steady_clock::now();
+				m_snapshot_cache.snapshot_lz4 = std::make_shared< const std::string >( util::lz4::LZ4::Compress( *m_snapshot_cache.snapshot ) );
+				const auto us = std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - started_at ).count();
+				Log(
+					"Compressed snapshot ( " + std::to_string( m_snapshot_cache.snapshot->size() ) + " -> " + std::to_string( m_snapshot_cache.snapshot_lz4->size() ) + " bytes, ratio=" +
+						std::to_string( (float)m_snapshot_cache.snapshot->size() / m_snapshot_cache.snapshot_lz4->size() ) + " time=" + std::to_string( us ) + "us )"
+				);
+			}
+			return m_snapshot_cache.snapshot_lz4;
+		}
+		default:
+			THROW( "unsupported download codec " + std::to_string( codec ) );
+	}
+}
+
+void Server::MaybeReleaseSnapshot() {
+	// outdated snapshot isn't needed after last client finished downloading it
+	if ( !m_on_get_state_version || m_on_get_state_version() != m_snapshot_cache.state_version ) {
+		if ( m_snapshot_cache.snapshot && m_snapshot_cache.snapshot.use_count() == 1 ) {
+			Log( "Releasing outdated snapshot" );
+			m_snapshot_cache.snapshot = nullptr;
+		}
+		if ( m_snapshot_cache.snapshot_lz4 && m_snapshot_cache.snapshot_lz4.use_count() == 1 ) {
+			Log( "Releasing outdated compressed snapshot" );
+			m_snapshot_cache.snapshot_lz4 = nullptr;
+		}
+	}
+}
+
+void Server::SendDownloadChunks( const network::cid_t cid, download_data_t& download_data ) {
+	const size_t total_size = download_data.serialized_snapshot->size();
+	const size_t window_end = std::min( download_data.acked_offset + download_data.chunk_size * DOWNLOAD_WINDOW_CHUNKS, total_size );
+	while ( download_data.sent_offset < window_end ) {
+		types::Packet p( types::Packet::PT_DOWNLOAD_NEXT_CHUNK_RESPONSE );
+		p.udata.download.offset = download_data.sent_offset;
+		p.udata.download.size = std::min( download_data.chunk_size, total_size - download_data.sent_offset );
+		p.download_source = download_data.serialized_snapshot.get(); // chunk is serialized straight from shared snapshot
+		Log( "Sending chunk to " + std::to_string( cid ) + " ( offset=" + std::to_string( p.udata.download.offset ) + " size=" + std::to_string( p.udata.download.size ) + " )" );
+		m_network->MT_SendPacket( &p, cid );
+		download_data.sent_offset += p.udata.download.size;
+	}
+}
+
 void Server::ClearReadyFlags() {
 	ASSERT( m_game_state, "unexpected game state" );
 	// clear readyness of everyone when new player joins or leaves
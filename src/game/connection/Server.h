@@ -2,9 +2,13 @@
 
 #include <unordered_map>
 #include <string>
+#include <memory>
+#include <deque>
 
 #include "Connection.h"
 
+#include "util/crc32/Types.h"
+
 namespace game {
 
 namespace slot {
@@ -19,6 +23,7 @@ CLASS( Server, Connection )
 
 	std::function< void() > m_on_listen = nullptr;
 	std::function< const std::string() > m_on_download_request = nullptr; // return serialized snapshot of world
+	std::function< const size_t() > m_on_get_state_version = nullptr; // snapshot is reused for as long as this returns same value
 
 	void UpdateSlot( const size_t slot_num, slot::Slot* slot, const bool only_flags = false ) override;
 	void SendMessage( const std::string& message ) override;
@@ -50,11 +55,50 @@ private:
 	const std::string FormatChatMessage( const Player* player, const std::string& message ) const;
 	void SendGameEventsTo( const std::string& serialized_events, const network::cid_t cid );
 
+	// recently sent game events are kept so that client that lost connection can get only ones it missed after reconnecting
+	// every logged event gets next seq, and hash is crc of whole event stream up to and including it
+	// if client's position isn't in log anymore ( or hash doesn't match ) - it has to rejoin and download snapshot
+	const size_t EVENT_LOG_MAX_EVENTS = 4096;
+	const size_t EVENT_LOG_MAX_BYTES = 4 * 1024 * 1024;
+	struct event_log_entry_t {
+		uint64_t seq;
+		util::crc32::crc_t hash;
+		uint64_t recipients; // bitmask of slots event is sendable to
+		std::string serialized;
+	};
+	struct {
+		std::deque< event_log_entry_t > entries = {};
+		size_t size = 0; // total size of serialized events
+		uint64_t seq = 0; // of last logged event
+		util::crc32::crc_t hash = 0;
+		uint64_t evicted_seq = 0; // of last event that didn't fit in log anymore
+		util::crc32::crc_t evicted_hash = 0;
+	} m_event_log = {};
+	void LogGameEvents( const game_events_t& game_events );
+	void TrimEventLog();
+	void SendLoggedGameEvents( const network::cid_t cid, const size_t from_index );
+	const bool ResumeClient( const network::cid_t cid, const uint64_t seq, const util::crc32::crc_t hash );
+
+	// snapshot is serialized once per state version and shared by all clients that download it
+	// compressed variant is made on first request from client that supports it, and shared too
+	// clients that are still downloading older version keep it alive until they finish
+	typedef std::shared_ptr< const std::string > snapshot_t;
+	struct {
+		snapshot_t snapshot = nullptr;
+		snapshot_t snapshot_lz4 = nullptr;
+		size_t state_version = 0;
+	} m_snapshot_cache = {};
+	const snapshot_t GetSnapshot( const download_codec_t codec );
+	void MaybeReleaseSnapshot();
+
 	struct download_data_t {
-		size_t next_expected_offset = 0; // for extra consistency checks
-		std::string serialized_snapshot = "";
+		snapshot_t serialized_snapshot = nullptr;
+		size_t chunk_size = 0;
+		size_t sent_offset = 0;
+		size_t acked_offset = 0;
 	};
-	std::unordered_map< network::cid_t, download_data_t > m_download_data = {}; // cid -> serialized snapshot of world
+	std::unordered_map< network::cid_t, download_data_t > m_download_data = {}; // cid -> download state
+	void SendDownloadChunks( const network::cid_t cid, download_data_t& download_data );
 
 	void ClearReadyFlags();
 };
@@ -36,7 +36,7 @@ void AdvanceTurn::Serialize( types::Buffer& buf, const AdvanceTurn* event ) {
 	buf.WriteInt( event->m_turn_id );
 }
 
-AdvanceTurn* AdvanceTurn::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+AdvanceTurn* AdvanceTurn::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	const size_t turn_id = buf.ReadInt();
 	return new AdvanceTurn( initiator_slot, turn_id );
 }
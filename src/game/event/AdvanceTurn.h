@@ -19,7 +19,7 @@ private:
 	const size_t m_turn_id;
 
 	static void Serialize( types::Buffer& buf, const AdvanceTurn* event );
-	static AdvanceTurn* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static AdvanceTurn* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 };
 
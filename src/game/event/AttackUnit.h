@@ -18,7 +18,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const AttackUnit* event );
-	static AttackUnit* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static AttackUnit* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 private:
 	const size_t m_attacker_unit_id;
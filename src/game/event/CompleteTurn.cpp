@@ -39,7 +39,7 @@ void CompleteTurn::Serialize( types::Buffer& buf, const CompleteTurn* event ) {
 	buf.WriteInt( event->m_turn_id );
 }
 
-CompleteTurn* CompleteTurn::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+CompleteTurn* CompleteTurn::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	const size_t turn_id = buf.ReadInt();
 	return new CompleteTurn( initiator_slot, turn_id );
 }
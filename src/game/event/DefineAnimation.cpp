@@ -3,6 +3,7 @@
 #include "game/Game.h"
 
 #include "engine/Engine.h"
+#include "config/Config.h"
 #include "loader/sound/SoundLoader.h"
 #include "game/animation/Def.h"
 #include "gse/type/Undefined.h"
@@ -20,7 +21,10 @@ const std::string* DefineAnimation::Validate( Game* game ) const {
 	if ( m_initiator_slot != 0 ) {
 		return Error( "Only master is allowed to define animations" );
 	}
-	if ( !g_engine->GetSoundLoader()->LoadCustomSound( m_def->m_sound_file ) ) {
+	if (
+		!g_engine->GetConfig()->HasLaunchFlag( config::Config::LF_DEDICATED_SERVER ) && // headless server doesn't play sounds
+			!g_engine->GetSoundLoader()->LoadCustomSound( m_def->m_sound_file )
+		) {
 		return Error( "Failed to load animation sound '" + m_def->m_sound_file + "'" );
 	}
 	return Ok();
@@ -38,11 +42,11 @@ TS_BEGIN( DefineAnimation )
 TS_END()
 
 void DefineAnimation::Serialize( types::Buffer& buf, const DefineAnimation* event ) {
-	buf.WriteString( animation::Def::Serialize( event->m_def ).ToString() );
+	buf.WriteBuffer( animation::Def::Serialize( event->m_def ) );
 }
 
-DefineAnimation* DefineAnimation::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
-	auto b = types::Buffer( buf.ReadString() );
+DefineAnimation* DefineAnimation::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
+	auto b = buf.ReadView();
 	return new DefineAnimation( initiator_slot, animation::Def::Unserialize( b ) );
 }
 
@@ -22,7 +22,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const DefineAnimation* event );
-	static DefineAnimation* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static DefineAnimation* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 private:
 	animation::Def* m_def;
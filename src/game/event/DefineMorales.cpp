@@ -33,11 +33,11 @@ TS_BEGIN( DefineMorales )
 TS_END()
 
 void DefineMorales::Serialize( types::Buffer& buf, const DefineMorales* event ) {
-	buf.WriteString( unit::MoraleSet::Serialize( event->m_moraleset ).ToString() );
+	buf.WriteBuffer( unit::MoraleSet::Serialize( event->m_moraleset ) );
 }
 
-DefineMorales* DefineMorales::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
-	auto b = types::Buffer( buf.ReadString() );
+DefineMorales* DefineMorales::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
+	auto b = buf.ReadView();
 	return new DefineMorales( initiator_slot, unit::MoraleSet::Unserialize( b ) );
 }
 
@@ -22,7 +22,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const DefineMorales* event );
-	static DefineMorales* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static DefineMorales* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 private:
 	unit::MoraleSet* m_moraleset;
@@ -31,11 +31,11 @@ TS_BEGIN( DefineUnit )
 TS_END()
 
 void DefineUnit::Serialize( types::Buffer& buf, const DefineUnit* event ) {
-	buf.WriteString( unit::Def::Serialize( event->m_def ).ToString() );
+	buf.WriteBuffer( unit::Def::Serialize( event->m_def ) );
 }
 
-DefineUnit* DefineUnit::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
-	auto b = types::Buffer( buf.ReadString() );
+DefineUnit* DefineUnit::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
+	auto b = buf.ReadView();
 	return new DefineUnit( initiator_slot, unit::Def::Unserialize( b ) );
 }
 
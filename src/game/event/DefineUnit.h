@@ -22,7 +22,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const DefineUnit* event );
-	static DefineUnit* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static DefineUnit* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 private:
 	unit::Def* m_def;
@@ -35,7 +35,7 @@ void DespawnUnit::Serialize( types::Buffer& buf, const DespawnUnit* event ) {
 	buf.WriteInt( event->m_unit_id );
 }
 
-DespawnUnit* DespawnUnit::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+DespawnUnit* DespawnUnit::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	const auto unit_id = buf.ReadInt();
 	return new DespawnUnit( initiator_slot, unit_id );
 }
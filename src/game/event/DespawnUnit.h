@@ -17,7 +17,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const DespawnUnit* event );
-	static DespawnUnit* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static DespawnUnit* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 private:
 	const size_t m_unit_id;
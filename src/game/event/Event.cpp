@@ -29,7 +29,7 @@ Event::Event( const size_t initiator_slot, const event_type_t type )
 }
 
 const types::Buffer Event::Serialize( const Event* event ) {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 	buf.WriteInt( event->m_initiator_slot );
 	buf.WriteInt( event->m_type );
 #define SERIALIZE( _type, _class ) \
@@ -63,7 +63,7 @@ const types::Buffer Event::Serialize( const Event* event ) {
 	return buf;
 }
 
-Event* Event::Unserialize( types::Buffer& buf ) {
+Event* Event::Unserialize( types::BufferView& buf ) {
 	const auto initiator_slot = buf.ReadInt();
 	const auto type = buf.ReadInt();
 	Event* result = nullptr;
@@ -99,19 +99,18 @@ Event* Event::Unserialize( types::Buffer& buf ) {
 }
 
 const types::Buffer Event::SerializeMultiple( const std::vector< Event* >& events ) {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 	buf.WriteInt( events.size() );
 	for ( const auto& event : events ) {
-		buf.WriteString( game::event::Event::Serialize( event ).ToString() );
+		buf.WriteBuffer( game::event::Event::Serialize( event ) );
 	}
-	const auto serialized_events = buf.ToString();
 	return buf;
 }
 
-void Event::UnserializeMultiple( types::Buffer& buf, std::vector< Event* >& events_out ) {
+void Event::UnserializeMultiple( types::BufferView& buf, std::vector< Event* >& events_out ) {
 	const auto count = buf.ReadInt();
 	for ( auto i = 0 ; i < count ; i++ ) {
-		auto event_buf = types::Buffer( buf.ReadString() );
+		auto event_buf = buf.ReadView();
 		events_out.push_back( game::event::Event::Unserialize( event_buf ) );
 	}
 }
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "types/Buffer.h"
+#include "types/BufferView.h"
 #include "gse/Value.h"
 
 namespace game {
@@ -37,10 +38,10 @@ public:
 	virtual ~Event() = default;
 
 	static const types::Buffer Serialize( const Event* event );
-	static Event* Unserialize( types::Buffer& buf );
+	static Event* Unserialize( types::BufferView& buf );
 
 	static const types::Buffer SerializeMultiple( const std::vector< Event* >& events );
-	static void UnserializeMultiple( types::Buffer& buf, std::vector< Event* >& events_out );
+	static void UnserializeMultiple( types::BufferView& buf, std::vector< Event* >& events_out );
 
 	static const bool IsBroadcastable( const event_type_t type );
 
@@ -36,7 +36,7 @@ TS_END()
 void FinalizeTurn::Serialize( types::Buffer& buf, const FinalizeTurn* event ) {
 }
 
-FinalizeTurn* FinalizeTurn::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+FinalizeTurn* FinalizeTurn::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	return new FinalizeTurn( initiator_slot );
 }
 
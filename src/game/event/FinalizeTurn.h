@@ -17,7 +17,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const FinalizeTurn* event );
-	static FinalizeTurn* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static FinalizeTurn* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 };
 
@@ -34,7 +34,7 @@ void LockTiles::Serialize( types::Buffer& buf, const LockTiles* event ) {
 	TileLocksEvent::Serialize< LockTiles >( buf, event );
 }
 
-LockTiles* LockTiles::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+LockTiles* LockTiles::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	const auto lock_owner_slot = buf.ReadInt();
 	return TileLocksEvent::Unserialize< LockTiles >( buf, initiator_slot, lock_owner_slot );
 }
@@ -69,16 +69,16 @@ TS_END()
 void MoveUnit::Serialize( types::Buffer& buf, const MoveUnit* event ) {
 	buf.WriteInt( event->m_unit_id );
 	buf.WriteInt( event->m_direction );
-	types::Buffer b = {};
+	types::Buffer b( types::Buffer::F_COMPACT );
 	gse::Value::Serialize( &b, event->m_resolutions );
-	buf.WriteString( b.ToString() );
+	buf.WriteBuffer( b );
 }
 
-MoveUnit* MoveUnit::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+MoveUnit* MoveUnit::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	const auto unit_id = buf.ReadInt();
 	const auto direction = (map::tile::direction_t)buf.ReadInt();
 	auto* result = new MoveUnit( initiator_slot, unit_id, direction );
-	types::Buffer b( buf.ReadString() );
+	auto b = buf.ReadView();
 	result->m_resolutions = gse::Value::Unserialize( &b );
 	return result;
 }
@@ -20,7 +20,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const MoveUnit* event );
-	static MoveUnit* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static MoveUnit* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 private:
 	const size_t m_unit_id;
@@ -29,7 +29,7 @@ void RequestTileLocks::Serialize( types::Buffer& buf, const RequestTileLocks* ev
 	TileLocksEvent::Serialize< RequestTileLocks >( buf, event );
 }
 
-RequestTileLocks* RequestTileLocks::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+RequestTileLocks* RequestTileLocks::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	return TileLocksEvent::Unserialize< RequestTileLocks >( buf, initiator_slot, 0 );
 }
 
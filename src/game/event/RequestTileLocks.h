@@ -20,7 +20,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const RequestTileLocks* event );
-	static RequestTileLocks* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static RequestTileLocks* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 };
 
 }
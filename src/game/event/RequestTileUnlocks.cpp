@@ -29,7 +29,7 @@ void RequestTileUnlocks::Serialize( types::Buffer& buf, const RequestTileUnlocks
 	TileLocksEvent::Serialize< RequestTileUnlocks >( buf, event );
 }
 
-RequestTileUnlocks* RequestTileUnlocks::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+RequestTileUnlocks* RequestTileUnlocks::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	return TileLocksEvent::Unserialize< RequestTileUnlocks >( buf, initiator_slot, 0 );
 }
 
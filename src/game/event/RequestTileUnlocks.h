@@ -20,7 +20,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const RequestTileUnlocks* event );
-	static RequestTileUnlocks* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static RequestTileUnlocks* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 };
 
 }
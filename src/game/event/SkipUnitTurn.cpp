@@ -50,7 +50,7 @@ void SkipUnitTurn::Serialize( types::Buffer& buf, const SkipUnitTurn* event ) {
 	buf.WriteInt( event->m_unit_id );
 }
 
-SkipUnitTurn* SkipUnitTurn::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+SkipUnitTurn* SkipUnitTurn::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	const auto unit_id = buf.ReadInt();
 	return new SkipUnitTurn( initiator_slot, unit_id );
 }
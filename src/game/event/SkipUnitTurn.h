@@ -17,7 +17,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const SkipUnitTurn* event );
-	static SkipUnitTurn* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static SkipUnitTurn* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 private:
 	const size_t m_unit_id;
@@ -61,7 +61,7 @@ void SpawnBase::Serialize( types::Buffer& buf, const SpawnBase* event ) {
 	buf.WriteInt( event->m_pos_y );
 }
 
-SpawnBase* SpawnBase::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+SpawnBase* SpawnBase::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	const auto owner_slot = buf.ReadInt();
 	const auto pos_x = buf.ReadInt();
 	const auto pos_y = buf.ReadInt();
@@ -24,7 +24,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const SpawnBase* event );
-	static SpawnBase* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static SpawnBase* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 private:
 	const size_t m_owner_slot;
@@ -78,7 +78,7 @@ void SpawnUnit::Serialize( types::Buffer& buf, const SpawnUnit* event ) {
 	buf.WriteFloat( event->m_health );
 }
 
-SpawnUnit* SpawnUnit::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+SpawnUnit* SpawnUnit::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	const auto unit_def = buf.ReadString();
 	const auto owner_slot = buf.ReadInt();
 	const auto pos_x = buf.ReadInt();
@@ -27,7 +27,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const SpawnUnit* event );
-	static SpawnUnit* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static SpawnUnit* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 private:
 	std::string m_unit_def;
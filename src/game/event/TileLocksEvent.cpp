@@ -40,7 +40,7 @@ void TileLocksEvent::Serialize( types::Buffer& buf, const T* event ) {
 }
 
 template< class T >
-T* TileLocksEvent::Unserialize( types::Buffer& buf, const size_t initiator_slot, const size_t lock_owner_slot ) {
+T* TileLocksEvent::Unserialize( types::BufferView& buf, const size_t initiator_slot, const size_t lock_owner_slot ) {
 	const auto positions_count = buf.ReadInt();
 	map::tile::positions_t positions = {};
 	positions.reserve( positions_count );
@@ -87,7 +87,7 @@ const std::string* TileLocksEvent::ValidateTilePositions( const Game* game, cons
 
 #define TEMPLATIZE( _class ) \
     template void TileLocksEvent::Serialize( types::Buffer& buf, const _class* event ); \
-    template _class* TileLocksEvent::Unserialize( types::Buffer& buf, const size_t initiator_slot, const size_t lock_owner_slot );
+    template _class* TileLocksEvent::Unserialize( types::BufferView& buf, const size_t initiator_slot, const size_t lock_owner_slot );
 
 TEMPLATIZE( RequestTileLocks );
 TEMPLATIZE( LockTiles );
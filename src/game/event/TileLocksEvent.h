@@ -31,7 +31,7 @@ private:
 	template< class T >
 	static void Serialize( types::Buffer& buf, const T* event );
 	template< class T >
-	static T* Unserialize( types::Buffer& buf, const size_t initiator_slot, const size_t lock_owner_slot );
+	static T* Unserialize( types::BufferView& buf, const size_t initiator_slot, const size_t lock_owner_slot );
 
 protected:
 	const map::tile::positions_t m_tile_positions;
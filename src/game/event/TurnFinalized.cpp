@@ -43,7 +43,7 @@ void TurnFinalized::Serialize( types::Buffer& buf, const TurnFinalized* event )
 	buf.WriteInt( event->m_checksum );
 }
 
-TurnFinalized* TurnFinalized::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+TurnFinalized* TurnFinalized::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	const util::crc32::crc_t checksum = buf.ReadInt();
 	return new TurnFinalized( initiator_slot, checksum );
 }
@@ -21,7 +21,7 @@ private:
 	const util::crc32::crc_t m_checksum;
 
 	static void Serialize( types::Buffer& buf, const TurnFinalized* event );
-	static TurnFinalized* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static TurnFinalized* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 };
 
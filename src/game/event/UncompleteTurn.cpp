@@ -38,7 +38,7 @@ void UncompleteTurn::Serialize( types::Buffer& buf, const UncompleteTurn* event
 	buf.WriteInt( event->m_turn_id );
 }
 
-UncompleteTurn* UncompleteTurn::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+UncompleteTurn* UncompleteTurn::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	const size_t turn_id = buf.ReadInt();
 	return new UncompleteTurn( initiator_slot, turn_id );
 }
@@ -34,7 +34,7 @@ void UnlockTiles::Serialize( types::Buffer& buf, const UnlockTiles* event ) {
 	TileLocksEvent::Serialize< UnlockTiles >( buf, event );
 }
 
-UnlockTiles* UnlockTiles::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
+UnlockTiles* UnlockTiles::Unserialize( types::BufferView& buf, const size_t initiator_slot ) {
 	const auto lock_owner_slot = buf.ReadInt();
 	return TileLocksEvent::Unserialize< UnlockTiles >( buf, initiator_slot, lock_owner_slot );
 }
@@ -20,7 +20,7 @@ private:
 	friend class Event;
 
 	static void Serialize( types::Buffer& buf, const UnlockTiles* event );
-	static UnlockTiles* Unserialize( types::Buffer& buf, const size_t initiator_slot );
+	static UnlockTiles* Unserialize( types::BufferView& buf, const size_t initiator_slot );
 
 private:
 	const size_t m_lock_owner_slot;
@@ -495,6 +495,10 @@ struct Consts {
 		const std::string default_map_filename = "untitled";
 		const std::string default_map_extension = ".gsm";
 	} fs;
+	const struct {
+		const std::string directory = "cache/terrain/"; // relative to prefix
+		const uint64_t max_size = 2048ull * 1024 * 1024; // least recently used entries are evicted above this
+	} terrain_cache;
 	const std::unordered_map< settings::map_config_value_t, types::Vec2< size_t > > map_sizes = {
 		// original SMAC sizes (1:1)
 		/*
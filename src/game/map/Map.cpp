@@ -1,3 +1,7 @@
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
 #include "Map.h"
 
 #include "game/Game.h"
@@ -7,6 +11,9 @@
 #include "config/Config.h"
 #include "util/random/Random.h"
 #include "util/FS.h"
+#include "util/MappedFile.h"
+#include "util/Timer.h"
+#include "util/lz4/LZ4.h"
 #include "ui/UI.h"
 #include "loader/texture/TextureLoader.h"
 #include "module/Prepare.h"
@@ -25,15 +32,10 @@
 #include "types/mesh/Data.h"
 #include "game/State.h"
 #include "game/map/MapState.h"
+#include "game/map/TerrainCache.h"
 #include "game/map/tile/Tiles.h"
 #include "Consts.h"
 
-#ifdef DEBUG
-
-#include "util/Timer.h"
-
-#endif
-
 namespace game {
 namespace map {
 
@@ -49,7 +51,8 @@ static inline unsigned char S_to_binary_( const char* s ) {
 }
 
 Map::Map( Game* game )
-	: m_game( game ) {
+	: m_game( game )
+	, m_is_headless( g_engine->GetConfig()->HasLaunchFlag( config::Config::LF_DEDICATED_SERVER ) ) {
 	// add texture variant bitmap maps
 	CalculateTextureVariants(
 		TVT_TILES, {
@@ -92,9 +95,15 @@ Map::Map( Game* game )
 		}
 	);
 
-	// main source textures
-	m_textures.source.texture_pcx = g_engine->GetTextureLoader()->LoadTexture( resource::PCX_TEXTURE );
-	m_textures.source.ter1_pcx = g_engine->GetTextureLoader()->LoadTexture( resource::PCX_TER1 );
+	m_construction_random_state = GetRandom()->GetState();
+
+	if ( !m_is_headless ) {
+		NEW( m_terrain_cache, TerrainCache, g_engine->GetConfig()->GetPrefix() + s_consts.terrain_cache.directory, s_consts.terrain_cache.max_size );
+
+		// main source textures
+		m_textures.source.texture_pcx = g_engine->GetTextureLoader()->LoadTexture( resource::PCX_TEXTURE );
+		m_textures.source.ter1_pcx = g_engine->GetTextureLoader()->LoadTexture( resource::PCX_TER1 );
+	}
 
 	// add map modules
 	//   order of passes is important
@@ -110,6 +119,15 @@ Map::Map( Game* game )
 		m_modules.push_back( module_pass );
 	}
 
+	if ( m_is_headless ) {
+		// game logic only needs tile coordinates, everything else is for rendering
+		module_pass.clear();
+		NEW( m, module::CalculateCoords, this );
+		module_pass.push_back( m );
+		m_modules.push_back( module_pass );
+		return;
+	}
+
 	{ // needs to be in separate pass because moisture original textures need to be available for all tiles in next pass
 		module_pass.clear();
 		NEW( m, module::LandMoisture, this );
@@ -178,23 +196,44 @@ Map::~Map() {
 	if ( m_map_state ) {
 		DELETE( m_map_state );
 	}
+	if ( m_terrain_cache ) {
+		DELETE( m_terrain_cache );
+	}
 }
 
 const types::Buffer Map::Serialize() const {
 
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT_CHECKSUMMED );
+
+	buf.WriteString( m_tiles->SerializeColumnar() );
+	SerializeTerrain( buf );
+
+	return buf;
+}
+
+void Map::Unserialize( types::BufferView buf ) {
 
-	buf.WriteString( m_tiles->Serialize().ToString() );
-	buf.WriteString( m_map_state->Serialize().ToString() );
+	ASSERT( !m_tiles, "tiles already set" );
+	NEW( m_tiles, tile::Tiles );
+	m_tiles->Unserialize( buf.ReadView() );
 
-	buf.WriteString( m_meshes.terrain->Serialize().ToString() );
-	buf.WriteString( m_meshes.terrain_data->Serialize().ToString() );
+	ASSERT( !m_map_state, "map state already set" );
+	NEW( m_map_state, MapState );
+	UnserializeTerrain( buf );
+}
+
+void Map::SerializeTerrain( types::Buffer& buf ) const {
+
+	buf.WriteBuffer( m_map_state->Serialize() );
 
-	buf.WriteString( m_textures.terrain->Serialize().ToString() );
+	buf.WriteBuffer( m_meshes.terrain->Serialize() );
+	buf.WriteBuffer( m_meshes.terrain_data->Serialize() );
+
+	buf.WriteBuffer( m_textures.terrain->Serialize() );
 
 	buf.WriteInt( m_sprite_actors.size() );
 	for ( auto& it : m_sprite_actors ) {
-		buf.WriteString( SerializeSpriteActor( it.second ).ToString() );
+		buf.WriteBuffer( SerializeSpriteActor( it.second ) );
 		buf.WriteString( it.first );
 	}
 	buf.WriteInt( m_sprite_instances.size() );
@@ -204,29 +243,21 @@ const types::Buffer Map::Serialize() const {
 		buf.WriteInt( it.first );
 	}
 	buf.WriteInt( m_next_sprite_instance_id );
-
-	return buf;
 }
 
-void Map::Unserialize( types::Buffer buf ) {
+void Map::UnserializeTerrain( types::BufferView& buf ) {
 
-	ASSERT( !m_tiles, "tiles already set" );
-	NEW( m_tiles, tile::Tiles );
-	m_tiles->Unserialize( buf.ReadString() );
-
-	ASSERT( !m_map_state, "map state already set" );
-	NEW( m_map_state, MapState );
-	m_map_state->Unserialize( buf.ReadString() );
+	m_map_state->Unserialize( buf.ReadView() );
 
 	InitTextureAndMesh();
-	m_meshes.terrain->Unserialize( buf.ReadString() );
-	m_meshes.terrain_data->Unserialize( buf.ReadString() );
-	m_textures.terrain->Unserialize( buf.ReadString() );
+	m_meshes.terrain->Unserialize( buf.ReadView() );
+	m_meshes.terrain_data->Unserialize( buf.ReadView() );
+	m_textures.terrain->Unserialize( buf.ReadView() );
 
 	size_t sz = buf.ReadInt();
 	m_sprite_actors.clear();
 	for ( auto i = 0 ; i < sz ; i++ ) {
-		m_sprite_actors[ buf.ReadString() ] = UnserializeSpriteActor( buf.ReadString() );
+		m_sprite_actors[ buf.ReadString() ] = UnserializeSpriteActor( buf.ReadView() );
 	}
 
 	sz = buf.ReadInt();
@@ -281,20 +312,20 @@ const MapState* Map::GetMapState() const {
 
 void Map::ClearTexture() {
 	ASSERT( m_map_state, "map state not set" );
-	ASSERT( m_current_ts, "ClearTexture called outside of tile generation" );
+	ASSERT( s_processing_context.ts, "ClearTexture called outside of tile generation" );
 	for ( auto lt = 0 ; lt < tile::LAYER_MAX ; lt++ ) {
 		m_textures.terrain->Erase(
-			m_current_ts->tex_coord.x1,
-			lt * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + m_current_ts->tex_coord.y1,
-			m_current_ts->tex_coord.x2 - 1,
-			lt * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + m_current_ts->tex_coord.y2 - 1
+			s_processing_context.ts->tex_coord.x1,
+			lt * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + s_processing_context.ts->tex_coord.y1,
+			s_processing_context.ts->tex_coord.x2 - 1,
+			lt * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + s_processing_context.ts->tex_coord.y2 - 1
 		);
 	}
 }
 
 void Map::AddTexture( const tile::tile_layer_type_t tile_layer, const pcx_texture_coordinates_t& tc, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha, util::Perlin* perlin ) {
 	ASSERT( m_map_state, "map state not set" );
-	ASSERT( m_current_ts, "AddTexture called outside of tile generation" );
+	ASSERT( s_processing_context.ts, "AddTexture called outside of tile generation" );
 	m_textures.terrain->AddFrom(
 		m_textures.source.texture_pcx,
 		mode,
@@ -302,8 +333,8 @@ void Map::AddTexture( const tile::tile_layer_type_t tile_layer, const pcx_textur
 		tc.y,
 		tc.x + s_consts.tc.texture_pcx.dimensions.x - 1,
 		tc.y + s_consts.tc.texture_pcx.dimensions.y - 1,
-		m_current_ts->tex_coord.x1,
-		tile_layer * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + m_current_ts->tex_coord.y1,
+		s_processing_context.ts->tex_coord.x1,
+		tile_layer * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + s_processing_context.ts->tex_coord.y1,
 		rotate,
 		alpha,
 		GetRandom(),
@@ -313,7 +344,7 @@ void Map::AddTexture( const tile::tile_layer_type_t tile_layer, const pcx_textur
 
 void Map::CopyTextureFromLayer( const tile::tile_layer_type_t tile_layer_from, const size_t tx_from, const size_t ty_from, const tile::tile_layer_type_t tile_layer, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha, util::Perlin* perlin ) {
 	ASSERT( m_map_state, "map state not set" );
-	ASSERT( m_current_ts, "CopyTextureFromLayer called outside of tile generation" );
+	ASSERT( s_processing_context.ts, "CopyTextureFromLayer called outside of tile generation" );
 	m_textures.terrain->AddFrom(
 		m_textures.terrain,
 		mode,
@@ -321,8 +352,8 @@ void Map::CopyTextureFromLayer( const tile::tile_layer_type_t tile_layer_from, c
 		tile_layer_from * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + ty_from,
 		tx_from + s_consts.tc.texture_pcx.dimensions.x - 1,
 		tile_layer_from * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + ty_from + s_consts.tc.texture_pcx.dimensions.y - 1,
-		m_current_ts->tex_coord.x1,
-		tile_layer * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + m_current_ts->tex_coord.y1,
+		s_processing_context.ts->tex_coord.x1,
+		tile_layer * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + s_processing_context.ts->tex_coord.y1,
 		rotate,
 		alpha,
 		GetRandom(),
@@ -331,11 +362,11 @@ void Map::CopyTextureFromLayer( const tile::tile_layer_type_t tile_layer_from, c
 };
 
 void Map::CopyTexture( const tile::tile_layer_type_t tile_layer_from, const tile::tile_layer_type_t tile_layer, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha, util::Perlin* perlin ) {
-	ASSERT( m_current_ts, "CopyTexture called outside of tile generation" );
+	ASSERT( s_processing_context.ts, "CopyTexture called outside of tile generation" );
 	CopyTextureFromLayer(
 		tile_layer_from,
-		m_current_ts->tex_coord.x1,
-		m_current_ts->tex_coord.y1,
+		s_processing_context.ts->tex_coord.x1,
+		s_processing_context.ts->tex_coord.y1,
 		tile_layer,
 		mode,
 		rotate,
@@ -346,16 +377,17 @@ void Map::CopyTexture( const tile::tile_layer_type_t tile_layer_from, const tile
 
 void Map::CopyTextureDeferred( const tile::tile_layer_type_t tile_layer_from, const size_t tx_from, const size_t ty_from, const tile::tile_layer_type_t tile_layer, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha, util::Perlin* perlin ) {
 	ASSERT( m_map_state, "map state not set" );
-	ASSERT( m_current_ts, "CopyTextureDeferred called outside of tile generation" );
-	m_map_state->copy_from_after.push_back(
+	ASSERT( s_processing_context.ts, "CopyTextureDeferred called outside of tile generation" );
+	ASSERT( s_processing_context.band, "CopyTextureDeferred called outside of band processing" );
+	s_processing_context.band->copy_from_after.push_back(
 		{
 			mode,
 			tx_from,
 			tile_layer_from * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + ty_from,
 			tx_from + s_consts.tc.texture_pcx.dimensions.x - 1,
 			tile_layer_from * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + ty_from + s_consts.tc.texture_pcx.dimensions.y - 1,
-			(size_t)m_current_ts->tex_coord.x1,
-			tile_layer * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + (size_t)m_current_ts->tex_coord.y1,
+			(size_t)s_processing_context.ts->tex_coord.x1,
+			tile_layer * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + (size_t)s_processing_context.ts->tex_coord.y1,
 			rotate,
 			alpha,
 			perlin
@@ -364,7 +396,7 @@ void Map::CopyTextureDeferred( const tile::tile_layer_type_t tile_layer_from, co
 };
 
 void Map::GetTexture( types::texture::Texture* dest_texture, const pcx_texture_coordinates_t& tc, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha ) {
-	ASSERT( m_current_ts, "GetTexture called outside of tile generation" );
+	ASSERT( s_processing_context.ts, "GetTexture called outside of tile generation" );
 	ASSERT( dest_texture->m_width == s_consts.tc.texture_pcx.dimensions.x, "tile dest texture width mismatch" );
 	ASSERT( dest_texture->m_height == s_consts.tc.texture_pcx.dimensions.y, "tile dest texture height mismatch" );
 	dest_texture->AddFrom(
@@ -403,7 +435,7 @@ void Map::GetTextureFromLayer( types::texture::Texture* dest_texture, const tile
 
 void Map::SetTexture( const tile::tile_layer_type_t tile_layer, tile::TileState* ts, types::texture::Texture* src_texture, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha ) {
 	ASSERT( m_map_state, "map state not set" );
-	ASSERT( m_current_ts, "SetTexture called outside of tile generation" );
+	ASSERT( s_processing_context.ts, "SetTexture called outside of tile generation" );
 	ASSERT( src_texture->m_width == s_consts.tc.texture_pcx.dimensions.x, "tile src texture width mismatch" );
 	ASSERT( src_texture->m_height == s_consts.tc.texture_pcx.dimensions.y, "tile src texture height mismatch" );
 	m_textures.terrain->AddFrom(
@@ -422,11 +454,11 @@ void Map::SetTexture( const tile::tile_layer_type_t tile_layer, tile::TileState*
 }
 
 void Map::SetTexture( const tile::tile_layer_type_t tile_layer, types::texture::Texture* src_texture, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha ) {
-	SetTexture( tile_layer, m_current_ts, src_texture, mode, rotate, alpha );
+	SetTexture( tile_layer, s_processing_context.ts, src_texture, mode, rotate, alpha );
 }
 
 const Map::tile_texture_info_t Map::GetTileTextureInfo( const texture_variants_type_t type, const tile::Tile* tile, const tile_grouping_criteria_t criteria, const uint16_t value ) const {
-	ASSERT( m_current_ts, "GetTileTextureInfo called outside of tile generation" );
+	ASSERT( s_processing_context.ts, "GetTileTextureInfo called outside of tile generation" );
 	Map::tile_texture_info_t info;
 
 	bool matches[16];
@@ -512,7 +544,9 @@ const Map::tile_texture_info_t Map::GetTileTextureInfo( const texture_variants_t
 }
 
 util::random::Random* Map::GetRandom() const {
-	return m_game->GetRandom();
+	return s_processing_context.band
+		? s_processing_context.band->random
+		: m_game->GetRandom();
 }
 
 const size_t Map::GetWidth() const {
@@ -531,7 +565,7 @@ tile::Tiles* Map::GetTilesPtr() const {
 }
 
 const types::Buffer Map::SerializeSpriteActor( const sprite_actor_t& sprite_actor ) const {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 
 	buf.WriteString( sprite_actor.name );
 	buf.WriteVec2u( sprite_actor.tex_coords );
@@ -540,7 +574,7 @@ const types::Buffer Map::SerializeSpriteActor( const sprite_actor_t& sprite_acto
 	return buf;
 }
 
-const sprite_actor_t Map::UnserializeSpriteActor( types::Buffer buf ) const {
+const sprite_actor_t Map::UnserializeSpriteActor( types::BufferView buf ) const {
 	const auto name = buf.ReadString();
 	const auto tex_coords = buf.ReadVec2u();
 	const auto z_index = buf.ReadFloat();
@@ -649,14 +683,14 @@ const Map::error_code_t Map::Generate( settings::MapSettings* map_settings, MT_C
 	// if crash happens - it's handy to have a map file to reproduce it
 	if ( !c->HasDebugFlag( config::Config::DF_QUICKSTART_MAP_FILE ) ) { // no point saving if we just loaded it
 		Log( (std::string)"Saving map to " + c->GetDebugPath() + s_consts.debug.lastmap_filename );
-		util::FS::WriteFile( c->GetDebugPath() + s_consts.debug.lastmap_filename, m_tiles->Serialize().ToString() );
+		util::FS::WriteFile( c->GetDebugPath() + s_consts.debug.lastmap_filename, m_tiles->SerializeColumnar() );
 	}
 #endif
 
 	return EC_NONE;
 }
 
-const Map::error_code_t Map::LoadFromBuffer( types::Buffer& buffer ) {
+const Map::error_code_t Map::LoadFromBuffer( types::BufferView& buffer ) {
 	if ( m_tiles ) {
 		DELETE( m_tiles );
 	}
@@ -677,17 +711,44 @@ const Map::error_code_t Map::LoadFromFile( const std::string& path ) {
 	ASSERT( util::FS::FileExists( path ), "map file \"" + path + "\" not found" );
 
 	Log( "Loading map from " + path );
-	auto b = types::Buffer( util::FS::ReadFile( path ) );
-	return LoadFromBuffer( b );
+	try {
+		// tiles are read straight from mapped memory, no need to copy whole file
+		const util::MappedFile file( path );
+		if ( util::lz4::LZ4::IsCompressed( file.GetData(), file.GetSize() ) ) {
+			util::Timer timer;
+			timer.Start();
+			std::string data;
+			if ( !util::lz4::LZ4::Decompress( file.GetData(), file.GetSize(), data ) ) {
+				Log( "Malformed compressed map file" );
+				return EC_MAPFILE_FORMAT_ERROR;
+			}
+			Log(
+				"Decompressed map ( " + std::to_string( file.GetSize() ) + " -> " + std::to_string( data.size() ) + " bytes, ratio=" +
+					std::to_string( (float)data.size() / file.GetSize() ) + " decode time=" + std::to_string( timer.GetElapsed().count() ) + "ms )"
+			);
+			auto b = types::BufferView( data );
+			return LoadFromBuffer( b );
+		}
+		// uncompressed ( older ) map file
+		auto b = types::BufferView( file.GetData(), file.GetSize() );
+		return LoadFromBuffer( b );
+	}
+	catch ( std::runtime_error& e ) {
+		Log( e.what() );
+		return EC_MAPFILE_FORMAT_ERROR;
+	}
 }
 
 void Map::SaveToBuffer( types::Buffer& buffer ) const {
-	buffer.WriteString( m_tiles->Serialize().ToString() );
+	buffer.WriteString( m_tiles->SerializeColumnar() );
 }
 
 const Map::error_code_t Map::SaveToFile( const std::string& path ) const {
 	try {
-		util::FS::WriteFile( path, m_tiles->Serialize().ToString() );
+		const auto data = m_tiles->SerializeColumnar();
+		const auto compressed = util::lz4::LZ4::Compress( data );
+		Log( "Saving map to " + path + " ( " + std::to_string( data.size() ) + " -> " + std::to_string( compressed.size() ) + " bytes, ratio=" + std::to_string( (float)data.size() / compressed.size() ) + " )" );
+		util::FS::WriteFile( path, compressed );
 		return EC_NONE;
 	}
 	catch ( std::runtime_error& e ) {
@@ -700,6 +761,14 @@ const Map::error_code_t Map::Initialize( MT_CANCELABLE ) {
 	m_tiles->Validate( MT_C );
 	MT_RETIFV( EC_ABORTED );
 
+	uint64_t cache_key = 0;
+	if ( !m_is_headless ) {
+		cache_key = GetTerrainCacheKey();
+		if ( LoadFromTerrainCache( cache_key ) ) {
+			return EC_NONE;
+		}
+	}
+
 	Log( "Initializing map" );
 
 	if ( m_map_state ) {
@@ -723,8 +792,10 @@ const Map::error_code_t Map::Initialize( MT_CANCELABLE ) {
 	m_map_state->LinkTileStates( MT_C );
 	MT_RETIFV( EC_ABORTED );
 
-	InitTextureAndMesh();
-	MT_RETIFV( EC_ABORTED );
+	if ( !m_is_headless ) {
+		InitTextureAndMesh();
+		MT_RETIFV( EC_ABORTED );
+	}
 
 	// some processing is only done on first run
 	m_map_state->first_run = true;
@@ -735,6 +806,11 @@ const Map::error_code_t Map::Initialize( MT_CANCELABLE ) {
 	LoadTiles( tiles, MT_C );
 	MT_RETIFV( EC_ABORTED );
 
+	if ( m_is_headless ) {
+		m_map_state->first_run = false;
+		return EC_NONE;
+	}
+
 	m_meshes.terrain->Finalize();
 	MT_RETIFV( EC_ABORTED );
 	m_meshes.terrain_data->Finalize();
@@ -745,12 +821,91 @@ const Map::error_code_t Map::Initialize( MT_CANCELABLE ) {
 
 	m_map_state->first_run = false;
 
-	m_current_tile = nullptr;
-	m_current_ts = nullptr;
+	SaveToTerrainCache( cache_key );
 
 	return EC_NONE;
 }
 
+const bool Map::IsHeadless() const {
+	return m_is_headless;
+}
+
+const uint64_t Map::GetTerrainCacheKey() const {
+	auto key = TerrainCache::KEY_INITIAL;
+
+	const auto tiles = m_tiles->SerializeColumnar();
+	key = TerrainCache::UpdateKey( key, tiles.data(), tiles.size() );
+
+	for ( const auto* texture : { m_textures.source.texture_pcx, m_textures.source.ter1_pcx } ) {
+		key = TerrainCache::UpdateKey( key, texture->m_bitmap, texture->m_bitmap_size );
+	}
+
+	// modules use rng both when created and when processing tiles
+	key = TerrainCache::UpdateKey( key, &m_construction_random_state, sizeof( m_construction_random_state ) );
+	const auto random_state = GetRandom()->GetState();
+	key = TerrainCache::UpdateKey( key, &random_state, sizeof( random_state ) );
+
+	return key;
+}
+
+const bool Map::LoadFromTerrainCache( const uint64_t key ) {
+	types::BufferView buf;
+	if ( !m_terrain_cache->Load( key, buf ) ) {
+		Log( "Terrain cache miss ( " + TerrainCache::KeyToString( key ) + " )" );
+		return false;
+	}
+
+	Log( "Terrain cache hit ( " + TerrainCache::KeyToString( key ) + " )" );
+	g_engine->GetUI()->SetLoaderText( "Loading cached terrain" );
+
+	try {
+		if ( m_map_state ) {
+			DELETE( m_map_state );
+		}
+		NEW( m_map_state, MapState );
+		UnserializeTerrain( buf );
+
+		// continue with same rng state as if terrain was generated
+		util::random::state_t random_state = {};
+		random_state.a = buf.ReadInt();
+		random_state.b = buf.ReadInt();
+		random_state.c = buf.ReadInt();
+		random_state.d = buf.ReadInt();
+		GetRandom()->SetState( random_state );
+	}
+	catch ( std::runtime_error& e ) {
+		Log( "Discarding invalid terrain cache entry: " + (std::string)e.what() );
+		// meshes aren't linked to actors yet so nobody else will delete them
+		if ( m_meshes.terrain ) {
+			DELETE( m_meshes.terrain );
+			m_meshes.terrain = nullptr;
+		}
+		if ( m_meshes.terrain_data ) {
+			DELETE( m_meshes.terrain_data );
+			m_meshes.terrain_data = nullptr;
+		}
+		m_terrain_cache->Release();
+		m_terrain_cache->Remove( key );
+		return false;
+	}
+
+	m_terrain_cache->Release();
+	return true;
+}
+
+void Map::SaveToTerrainCache( const uint64_t key ) const {
+	types::Buffer buf( types::Buffer::F_COMPACT_CHECKSUMMED );
+	SerializeTerrain( buf );
+
+	const auto random_state = GetRandom()->GetState();
+	buf.WriteInt( random_state.a );
+	buf.WriteInt( random_state.b );
+	buf.WriteInt( random_state.c );
+	buf.WriteInt( random_state.d );
+
+	m_terrain_cache->Save( key, buf );
+}
+
 void Map::InitTextureAndMesh() {
 
 	if ( m_textures.terrain ) {
@@ -776,6 +931,8 @@ void Map::InitTextureAndMesh() {
 	m_map_state->ter1_pcx = m_textures.source.ter1_pcx;
 }
 
+thread_local Map::processing_context_t Map::s_processing_context = {};
+
 void Map::ProcessTiles( module_passes_t& module_passes, const tiles_t& tiles, MT_CANCELABLE ) {
 	ASSERT( m_map_state, "map state not set" );
 
@@ -787,7 +944,7 @@ void Map::ProcessTiles( module_passes_t& module_passes, const tiles_t& tiles, MT
 	std::string loading_text = "Processing tiles (" + sp + "%)";
 	const size_t percent_pos = loading_text.size() - 2 - sp.size();
 
-	size_t tile_i = 0;
+	std::atomic< size_t > tile_i = 0;
 	size_t total = 0;
 	for ( auto& module_pass : module_passes ) {
 		total += module_pass.size();
@@ -796,40 +953,170 @@ void Map::ProcessTiles( module_passes_t& module_passes, const tiles_t& tiles, MT
 
 	uint8_t percent = 0, last_percent = 0;
 
+	const auto f_update_progress = [ & ]() -> void {
+		percent = (uint8_t)ceil( ( (float)tile_i * 100.0f / total ) ) - 1;
+		if ( percent != last_percent ) {
+			last_percent = percent;
+			sp = std::to_string( percent );
+			if ( sp.size() < percent_len ) {
+				sp = std::string( percent_len - sp.size(), ' ' ) + sp;
+			}
+			loading_text.replace( percent_pos, sp.size(), sp.c_str() );
+			ui->SetLoaderText( loading_text );
+		}
+	};
+
 	size_t state_iterate_eta = ITERATE_STATE_EVERY_N_TILES;
+	const auto f_on_tile = [ & ]() -> void {
+		f_update_progress();
+		if ( !--state_iterate_eta ) {
+			// keep processing state (i.e. network events) while loading
+			m_game->GetState()->Iterate();
+			state_iterate_eta = ITERATE_STATE_EVERY_N_TILES;
+		}
+	};
 
-	for ( auto& module_pass : module_passes ) {
-		for ( const auto& tile : tiles ) {
-			m_current_tile = tile;
-			m_current_ts = GetTileState( tile->coord.x, tile->coord.y );
+	// split tiles into bands, seed rng streams in same order every time
+	std::vector< processing_band_t > bands = {};
+	for ( const auto& tile : tiles ) {
+		const size_t band_i = tile->coord.y / PROCESSING_BAND_ROWS;
+		if ( band_i >= bands.size() ) {
+			bands.resize( band_i + 1 );
+		}
+		bands[ band_i ].tiles.push_back( tile );
+	}
+	for ( auto& band : bands ) {
+		NEW( band.random, util::random::Random, GetRandom()->GetUInt( 1, UINT32_MAX - 1 ) ); // 0 would mean random seed
+	}
+	const auto f_cleanup = [ &bands ]() -> void {
+		for ( auto& band : bands ) {
+			DELETE( band.random );
+		}
+	};
 
-			for ( auto& m : module_pass ) {
+	const size_t max_threads = std::max< size_t >( std::thread::hardware_concurrency(), 1 );
+
+	try {
+		for ( auto& module_pass : module_passes ) {
+
+			bool is_parallelizable = true;
+			for ( const auto& m : module_pass ) {
+				if ( !m->IsParallelizable() ) {
+					is_parallelizable = false;
+					break;
+				}
+			}
 
-				m->GenerateTile( m_current_tile, m_current_ts, m_map_state );
+			// even bands first, then odd bands
+			// barrier after each half because next one touches same tiles
+			for ( uint8_t parity = 0 ; parity < 2 ; parity++ ) {
+
+				std::vector< processing_band_t* > phase_bands = {};
+				for ( size_t band_i = parity ; band_i < bands.size() ; band_i += 2 ) {
+					if ( !bands[ band_i ].tiles.empty() ) {
+						phase_bands.push_back( &bands[ band_i ] );
+					}
+				}
 
-				tile_i++;
-				percent = (uint8_t)ceil( ( (float)tile_i * 100.0f / total ) ) - 1;
+				const size_t threads_count = is_parallelizable
+					? std::min( max_threads, phase_bands.size() )
+					: 1;
 
-				if ( percent != last_percent ) {
-					last_percent = percent;
-					sp = std::to_string( percent );
-					if ( sp.size() < percent_len ) {
-						sp = std::string( percent_len - sp.size(), ' ' ) + sp;
+				if ( threads_count <= 1 ) {
+					for ( auto& band : phase_bands ) {
+						ProcessBand( module_pass, *band, tile_i, f_on_tile, MT_C );
+						if ( MT_C ) {
+							break;
+						}
+					}
+				}
+				else {
+					std::atomic< size_t > next_band_i = 0;
+					std::atomic< size_t > threads_running = threads_count;
+					std::vector< std::exception_ptr > errors( threads_count );
+					std::vector< std::thread > threads = {};
+					threads.reserve( threads_count );
+					for ( size_t thread_i = 0 ; thread_i < threads_count ; thread_i++ ) {
+						threads.push_back(
+							std::thread(
+								[ this, &module_pass, &phase_bands, &next_band_i, &threads_running, &errors, &tile_i, thread_i, &MT_C ]() -> void {
+									try {
+										size_t band_i;
+										while ( !MT_C && ( band_i = next_band_i++ ) < phase_bands.size() ) {
+											ProcessBand( module_pass, *phase_bands[ band_i ], tile_i, nullptr, MT_C );
+										}
+									}
+									catch ( ... ) {
+										errors[ thread_i ] = std::current_exception();
+									}
+									threads_running--;
+								}
+							)
+						);
+					}
+					// workers can't touch ui or state, so do it for them while waiting
+					while ( threads_running ) {
+						f_update_progress();
+						m_game->GetState()->Iterate();
+						std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+					}
+					for ( auto& thread : threads ) {
+						thread.join();
+					}
+					for ( const auto& error : errors ) {
+						if ( error ) {
+							std::rethrow_exception( error );
+						}
 					}
-					loading_text.replace( percent_pos, sp.size(), sp.c_str() );
-					ui->SetLoaderText( loading_text );
 				}
 
-				MT_RETIF();
+				// collect deferred copies in bands order so that they don't depend on threads timing
+				for ( auto& band : phase_bands ) {
+					m_map_state->copy_from_after.insert( m_map_state->copy_from_after.end(), band->copy_from_after.begin(), band->copy_from_after.end() );
+					band->copy_from_after.clear();
+				}
+
+				if ( MT_C ) {
+					f_cleanup();
+					return;
+				}
+			}
+		}
+	}
+	catch ( ... ) {
+		f_cleanup();
+		throw;
+	}
+
+	f_cleanup();
+}
+
+void Map::ProcessBand( module_pass_t& module_pass, processing_band_t& band, std::atomic< size_t >& modules_processed, const std::function< void() >& on_tile, MT_CANCELABLE ) {
+	s_processing_context.band = &band;
+	try {
+		for ( const auto& tile : band.tiles ) {
+			s_processing_context.tile = tile;
+			s_processing_context.ts = GetTileState( tile->coord.x, tile->coord.y );
+
+			for ( auto& m : module_pass ) {
+				m->GenerateTile( s_processing_context.tile, s_processing_context.ts, m_map_state );
+				modules_processed++;
+			}
+
+			if ( on_tile ) {
+				on_tile();
 			}
 
-			if ( !--state_iterate_eta ) {
-				// keep processing state (i.e. network events) while loading
-				m_game->GetState()->Iterate();
-				state_iterate_eta = ITERATE_STATE_EVERY_N_TILES;
+			if ( MT_C ) {
+				break;
 			}
 		}
 	}
+	catch ( ... ) {
+		s_processing_context = {};
+		throw;
+	}
+	s_processing_context = {};
 }
 
 void Map::LoadTiles( const tiles_t& tiles, MT_CANCELABLE ) {
@@ -849,92 +1136,163 @@ void Map::LoadTiles( const tiles_t& tiles, MT_CANCELABLE ) {
 	MT_RETIF();
 }
 
+// splits [ 0, count ) into contiguous ranges and processes them in parallel ( tiles are ordered by rows, so ranges are bands of rows )
+// small workloads ( i.e. editor strokes ) are processed in current thread, without spawning threads or allocating anything
+template< typename FUNC >
+static void ProcessRangesInParallel( const size_t count, const size_t min_per_thread, const FUNC& f ) {
+	const size_t threads_count = std::min< size_t >( std::max< size_t >( std::thread::hardware_concurrency(), 1 ), count / min_per_thread );
+	if ( threads_count <= 1 ) {
+		f( 0, count );
+		return;
+	}
+	const size_t per_thread = ( count + threads_count - 1 ) / threads_count;
+	std::vector< std::exception_ptr > errors( threads_count );
+	std::vector< std::thread > threads = {};
+	threads.reserve( threads_count );
+	for ( size_t thread_i = 0 ; thread_i < threads_count ; thread_i++ ) {
+		threads.push_back(
+			std::thread(
+				[ &f, &errors, thread_i, per_thread, count ]() -> void {
+					try {
+						const size_t begin = thread_i * per_thread;
+						f( begin, std::min( begin + per_thread, count ) );
+					}
+					catch ( ... ) {
+						errors[ thread_i ] = std::current_exception();
+					}
+				}
+			)
+		);
+	}
+	for ( auto& thread : threads ) {
+		thread.join();
+	}
+	for ( const auto& error : errors ) {
+		if ( error ) {
+			std::rethrow_exception( error );
+		}
+	}
+}
+
 void Map::FixNormals( const tiles_t& tiles, MT_CANCELABLE ) {
 	Log( "Fixing normals" );
 
 	g_engine->GetUI()->SetLoaderText( "Fixing normals" );
 
-	std::vector< types::mesh::surface_id_t > surfaces = {};
-
-	// avoiding reallocations is more important than saving memory
-	// worst case scenario: 4 surfaces per tile, 4 layers + overdraw column (only land layer)
-	surfaces.reserve( tiles.size() * 4 * 5 );
-
-	for ( auto& tile : tiles ) {
-		auto* ts = GetTileState( tile->coord.x, tile->coord.y );
+	ASSERT( m_map_state, "map state not set" );
+	auto* const mesh = m_meshes.terrain;
+
+	// every tile has its own vertices ( they are combined with neighbours' ones explicitly later ), so tiles can be processed independently
+	ProcessRangesInParallel(
+		tiles.size(), FIX_NORMALS_MIN_TILES_PER_THREAD, [ this, &tiles, mesh ]( const size_t begin, const size_t end ) -> void {
+			// worst case scenario: 4 surfaces per tile, 4 layers + overdraw column (only land layer)
+			types::mesh::surface_id_t surfaces[ 4 * 5 ];
+			size_t surfaces_count;
+			for ( size_t i = begin ; i < end ; i++ ) {
+				const auto* tile = tiles[ i ];
+				auto* ts = GetTileState( tile );
+				surfaces_count = 0;
 #define x( _layer ) \
-            surfaces.push_back( _layer.surfaces.left_top ); \
-            surfaces.push_back( _layer.surfaces.top_right ); \
-            surfaces.push_back( _layer.surfaces.right_bottom ); \
-            surfaces.push_back( _layer.surfaces.bottom_left )
-		x( ts->layers[ tile::LAYER_LAND ] );
-		if ( ts->has_water ) {
-			x( ts->layers[ tile::LAYER_WATER ] );
-			x( ts->layers[ tile::LAYER_WATER_SURFACE ] );
-			x( ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ] );
-		}
-		if ( tile->coord.x == 0 ) {
-			// also update overdraw column
-			x( ts->overdraw_column );
-		}
+                surfaces[ surfaces_count++ ] = _layer.surfaces.left_top; \
+                surfaces[ surfaces_count++ ] = _layer.surfaces.top_right; \
+                surfaces[ surfaces_count++ ] = _layer.surfaces.right_bottom; \
+                surfaces[ surfaces_count++ ] = _layer.surfaces.bottom_left
+				x( ts->layers[ tile::LAYER_LAND ] );
+				if ( ts->has_water ) {
+					x( ts->layers[ tile::LAYER_WATER ] );
+					x( ts->layers[ tile::LAYER_WATER_SURFACE ] );
+					x( ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ] );
+				}
+				if ( tile->coord.x == 0 ) {
+					// also update overdraw column
+					x( ts->overdraw_column );
+				}
 #undef x
-		MT_RETIF();
-	}
-	m_meshes.terrain->UpdateNormals( surfaces );
-
-	std::vector< types::mesh::index_t > v, vtmp;
-
-	// to prevent reallocations
-	vtmp.reserve( 4 );
-	v.reserve( 8 );
-
-	// normals will be combined at left vertex of tile
-	const auto f_combine_normals_at_left_vertex = [ this, &v, &vtmp ]( const tile::Tile* tile ) -> void {
-		auto* ts = GetTileState( tile->coord.x, tile->coord.y );
-#define x( _lt ) { \
-            ts->layers[ _lt ].indices.left, \
-            ts->NW->layers[ _lt ].indices.bottom, \
-            ts->W->layers[ _lt ].indices.right, \
-            ts->SW->layers[ _lt ].indices.top, \
-        }
-		v = x( tile::LAYER_LAND );
-		if ( tile->is_water_tile || tile->W->is_water_tile || tile->NW->is_water_tile ) {
-			vtmp = x( tile::LAYER_WATER );
-			v.insert( v.end(), vtmp.begin(), vtmp.end() );
+				mesh->CalculateNormals( surfaces, surfaces_count );
+			}
 		}
-#undef x
+	);
+	mesh->Update();
+	MT_RETIF();
 
-		m_meshes.terrain->CombineNormals( v );
+	// normals will be combined at left vertex of tile, collect every such tile only once
+	// bitmap and list are kept between calls, so that nothing is allocated on repeated small updates
+	const size_t visited_size = ( (size_t)m_map_state->dimensions.x * m_map_state->dimensions.y + 63 ) / 64;
+	if ( m_fix_normals_visited.size() != visited_size ) {
+		m_fix_normals_visited.assign( visited_size, 0 );
+	}
+	m_fix_normals_tiles.clear();
+	m_fix_normals_tiles.reserve( tiles.size() * 4 );
+	const auto f_visit = [ this ]( const tile::Tile* tile, const bool is_visited ) -> bool {
+		const size_t i = (size_t)tile->coord.y * m_map_state->dimensions.x + tile->coord.x;
+		const uint64_t bit = 1ull << ( i % 64 );
+		auto& word = m_fix_normals_visited[ i / 64 ];
+		const bool was_visited = ( word & bit ) != 0;
+		if ( is_visited ) {
+			word |= bit;
+		}
+		else {
+			word &= ~bit;
+		}
+		return was_visited;
 	};
-	std::unordered_set< const tile::Tile* > processed_tiles = {}; // to prevent duplicate combining
-	processed_tiles.reserve( tiles.size() * 4 ); // minimizing reallocations is more important than saving memory
-	const auto f_combine_normals_maybe = [ &f_combine_normals_at_left_vertex, &processed_tiles ]( const tile::Tile* tile ) -> void {
-		if ( processed_tiles.find( tile ) == processed_tiles.end() ) {
-			f_combine_normals_at_left_vertex( tile );
-			processed_tiles.insert( tile );
+	const auto f_add = [ this, &f_visit ]( const tile::Tile* tile ) -> void {
+		if ( !f_visit( tile, true ) ) {
+			m_fix_normals_tiles.push_back( tile );
 		}
 	};
-
 	for ( const auto& tile : tiles ) {
-		f_combine_normals_maybe( tile );
-		f_combine_normals_maybe( tile->NE );
-		f_combine_normals_maybe( tile->E );
-		f_combine_normals_maybe( tile->SE );
+		f_add( tile );
+		f_add( tile->NE );
+		f_add( tile->E );
+		f_add( tile->SE );
+	}
+	// clearing only what was set is much cheaper than clearing whole bitmap on small updates
+	for ( const auto& tile : m_fix_normals_tiles ) {
+		f_visit( tile, false );
 	}
 
+	// every vertex belongs to exactly one combined group, so groups can be processed independently too
+	ProcessRangesInParallel(
+		m_fix_normals_tiles.size(), FIX_NORMALS_MIN_TILES_PER_THREAD, [ this, mesh ]( const size_t begin, const size_t end ) -> void {
+			types::mesh::index_t v[ 8 ];
+			size_t v_count;
+			for ( size_t i = begin ; i < end ; i++ ) {
+				const auto* tile = m_fix_normals_tiles[ i ];
+				auto* ts = GetTileState( tile );
+				v_count = 0;
+#define x( _lt ) \
+                v[ v_count++ ] = ts->layers[ _lt ].indices.left; \
+                v[ v_count++ ] = ts->NW->layers[ _lt ].indices.bottom; \
+                v[ v_count++ ] = ts->W->layers[ _lt ].indices.right; \
+                v[ v_count++ ] = ts->SW->layers[ _lt ].indices.top
+				x( tile::LAYER_LAND );
+				if ( tile->is_water_tile || tile->W->is_water_tile || tile->NW->is_water_tile ) {
+					x( tile::LAYER_WATER );
+				}
+#undef x
+				mesh->CombineNormals( v, v_count );
+			}
+		}
+	);
+	MT_RETIF();
+
 	// average center normals
-	for ( const auto& tile : tiles ) {
-		auto* ts = GetTileState( tile->coord.x, tile->coord.y );
-
-		m_meshes.terrain->SetVertexNormal(
-			ts->layers[ tile::LAYER_LAND ].indices.center, (
-				m_meshes.terrain->GetVertexNormal( ts->layers[ tile::LAYER_LAND ].indices.left ) +
-					m_meshes.terrain->GetVertexNormal( ts->layers[ tile::LAYER_LAND ].indices.top ) +
-					m_meshes.terrain->GetVertexNormal( ts->layers[ tile::LAYER_LAND ].indices.right ) +
-					m_meshes.terrain->GetVertexNormal( ts->layers[ tile::LAYER_LAND ].indices.bottom )
-			) / 4
-		);
-	}
+	ProcessRangesInParallel(
+		tiles.size(), FIX_NORMALS_MIN_TILES_PER_THREAD, [ this, &tiles, mesh ]( const size_t begin, const size_t end ) -> void {
+			for ( size_t i = begin ; i < end ; i++ ) {
+				const auto& indices = GetTileState( tiles[ i ] )->layers[ tile::LAYER_LAND ].indices;
+				mesh->SetVertexNormal(
+					indices.center, (
+						mesh->GetVertexNormal( indices.left ) +
+							mesh->GetVertexNormal( indices.top ) +
+							mesh->GetVertexNormal( indices.right ) +
+							mesh->GetVertexNormal( indices.bottom )
+					) / 4
+				);
+			}
+		}
+	);
 }
 
 void Map::CalculateTextureVariants( const texture_variants_type_t type, const texture_variants_rules_t& rules ) {
@@ -3,6 +3,8 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include <atomic>
+#include <functional>
 
 #include "types/Serializable.h"
 
@@ -10,8 +12,10 @@
 #include "common/MTTypes.h"
 #include "game/map/tile/Types.h"
 #include "types/texture/Types.h"
+#include "util/random/Types.h"
 
 #include "types/Buffer.h"
+#include "MapState.h"
 
 namespace types {
 namespace texture {
@@ -47,6 +51,7 @@ class Tiles;
 }
 
 class MapState;
+class TerrainCache;
 
 namespace module {
 class Module;
@@ -67,15 +72,18 @@ CLASS( Map, types::Serializable )
 	};
 
 	const error_code_t Generate( settings::MapSettings* map_settings, MT_CANCELABLE );
-	const error_code_t LoadFromBuffer( types::Buffer& buffer );
+	const error_code_t LoadFromBuffer( types::BufferView& buffer );
 	const error_code_t LoadFromFile( const std::string& path );
 	void SaveToBuffer( types::Buffer& buffer ) const;
 	const error_code_t SaveToFile( const std::string& path ) const;
 
 	const error_code_t Initialize( MT_CANCELABLE );
 
+	// headless map only has tile states that game logic needs, without terrain texture, meshes or sprites
+	const bool IsHeadless() const;
+
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override;
 
 	static const std::string& GetErrorString( const error_code_t& code );
 
@@ -121,7 +129,7 @@ CLASS( Map, types::Serializable )
 	tile::Tiles* GetTilesPtr() const;
 
 	const types::Buffer SerializeSpriteActor( const sprite_actor_t& sprite_actor ) const;
-	const sprite_actor_t UnserializeSpriteActor( types::Buffer buf ) const;
+	const sprite_actor_t UnserializeSpriteActor( types::BufferView buf ) const;
 
 	const std::string GetTerrainSpriteActor( const std::string& name, const pcx_texture_coordinates_t& tex_coords, const float z_index );
 	const size_t AddTerrainSpriteActorInstance( const std::string& key, const types::Vec3& coords );
@@ -157,6 +165,7 @@ private:
 	const int ITERATE_STATE_EVERY_N_TILES = 64;
 
 	Game* m_game = nullptr;
+	const bool m_is_headless;
 
 	tile::Tiles* m_tiles = nullptr;
 	MapState* m_map_state = nullptr;
@@ -168,10 +177,42 @@ private:
 	module_passes_t m_modules; // before finalizing and deferred calls
 	module_passes_t m_modules_deferred; // after finalizing and deferred calls
 
+	// rng state before modules were created ( some of them take seeds from it )
+	util::random::state_t m_construction_random_state = {};
+
+	TerrainCache* m_terrain_cache = nullptr;
+	const uint64_t GetTerrainCacheKey() const;
+	const bool LoadFromTerrainCache( const uint64_t key );
+	void SaveToTerrainCache( const uint64_t key ) const;
+
+	// everything that is produced by Initialize()
+	void SerializeTerrain( types::Buffer& buf ) const;
+	void UnserializeTerrain( types::BufferView& buf );
+
 	void InitTextureAndMesh();
+
+	// tiles are processed in bands of rows, each with its own rng stream
+	// modules don't reach further than 2 rows from tile, so bands of same parity never touch same tile states or texture areas and can be processed in parallel
+	// results only depend on band layout and not on amount of threads, so they are same on every machine
+	const size_t PROCESSING_BAND_ROWS = 4;
+	struct processing_band_t {
+		tiles_t tiles = {};
+		util::random::Random* random = nullptr;
+		std::vector< MapState::copy_from_after_t > copy_from_after = {};
+	};
+	struct processing_context_t {
+		const tile::Tile* tile = nullptr;
+		tile::TileState* ts = nullptr;
+		processing_band_t* band = nullptr;
+	};
+	static thread_local processing_context_t s_processing_context; // tile that is being processed by current thread
 	void ProcessTiles( module_passes_t& module_passes, const tiles_t& tiles, MT_CANCELABLE );
+	void ProcessBand( module_pass_t& module_pass, processing_band_t& band, std::atomic< size_t >& modules_processed, const std::function< void() >& on_tile, MT_CANCELABLE );
 	void LoadTiles( const tiles_t& tiles, MT_CANCELABLE );
 	void FixNormals( const tiles_t& tiles, MT_CANCELABLE );
+	const size_t FIX_NORMALS_MIN_TILES_PER_THREAD = 256; // smaller updates ( i.e. from editor ) aren't worth spawning threads
+	std::vector< uint64_t > m_fix_normals_visited = {}; // 1 bit per tile
+	std::vector< const tile::Tile* > m_fix_normals_tiles = {};
 
 	// texture.pcx contains some textures grouped in certain way based on adjactent neighbours
 	// calculate all variants once and cache for faster lookups later
@@ -184,9 +225,6 @@ private:
 	std::unordered_map< texture_variants_type_t, texture_variants_t > m_texture_variants = {};
 	void CalculateTextureVariants( const texture_variants_type_t type, const texture_variants_rules_t& rules );
 
-	tile::TileState* m_current_ts = nullptr;
-	const tile::Tile* m_current_tile = nullptr;
-
 };
 
 }
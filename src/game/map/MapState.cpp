@@ -81,7 +81,7 @@ void MapState::LinkTileStates( MT_CANCELABLE ) {
 }
 
 const types::Buffer MapState::Serialize() const {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 
 	buf.WriteBool( first_run );
 	buf.WriteVec2f( coord );
@@ -101,7 +101,7 @@ const types::Buffer MapState::Serialize() const {
 	return buf;
 }
 
-void MapState::Unserialize( types::Buffer buf ) {
+void MapState::Unserialize( types::BufferView buf ) {
 
 	first_run = buf.ReadBool();
 	coord = buf.ReadVec2f();
@@ -114,7 +114,7 @@ void MapState::Unserialize( types::Buffer buf ) {
 
 	for ( auto y = 0 ; y < dimensions.y ; y++ ) {
 		for ( auto x = y & 1 ; x < dimensions.x ; x += 2 ) {
-			At( x, y )->Unserialize( buf.ReadString() );
+			At( x, y )->Unserialize( buf.ReadView() );
 		}
 	}
 
@@ -8,6 +8,7 @@
 
 #include "common/MTTypes.h"
 #include "types/Buffer.h"
+#include "types/BufferView.h"
 #include "types/Vec2.h"
 #include "tile/TileState.h"
 
@@ -59,7 +60,7 @@ CLASS( MapState, common::Class )
 	void LinkTileStates( MT_CANCELABLE );
 
 	const types::Buffer Serialize() const;
-	void Unserialize( types::Buffer buf );
+	void Unserialize( types::BufferView buf );
 
 private:
 	std::vector< tile::TileState > m_tiles = {};
@@ -0,0 +1,199 @@
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+#include <vector>
+
+#include "TerrainCache.h"
+
+#include "util/FS.h"
+#include "util/MappedFile.h"
+
+namespace game {
+namespace map {
+
+static const std::string s_entry_extension = ".gstc";
+
+const TerrainCache::key_t TerrainCache::UpdateKey( key_t key, const void* data, const size_t size ) {
+	const uint8_t* ptr = (const uint8_t*)data;
+	const uint8_t* const end = ptr + size;
+	while ( ptr < end ) {
+		key ^= *( ptr++ );
+		key *= 1099511628211ull;
+	}
+	return key;
+}
+
+const std::string TerrainCache::KeyToString( const key_t key ) {
+	std::stringstream ss;
+	ss << std::hex << std::setw( sizeof( key ) * 2 ) << std::setfill( '0' ) << key;
+	return ss.str();
+}
+
+TerrainCache::TerrainCache( const std::string& path, const uint64_t max_size )
+	: m_path( path )
+	, m_max_size( max_size ) {
+	//
+}
+
+TerrainCache::~TerrainCache() {
+	Release();
+}
+
+const bool TerrainCache::Load( const key_t key, types::BufferView& payload ) {
+	Release();
+
+	const auto path = GetEntryPath( key );
+	if ( !util::FS::FileExists( path ) ) {
+		return false;
+	}
+
+	try {
+		NEW( m_entry, util::MappedFile, path );
+	}
+	catch ( std::runtime_error& e ) {
+		Log( "Failed to read terrain cache entry: " + (std::string)e.what() );
+		return false;
+	}
+
+	entry_header_t header = {};
+	if (
+		m_entry->GetSize() < sizeof( header ) ||
+			m_entry->GetSize() - sizeof( header ) > UINT32_MAX
+		) {
+		Release();
+		Remove( key );
+		return false;
+	}
+	memcpy( &header, m_entry->GetData(), sizeof( header ) );
+	if (
+		memcmp( header.magic, ENTRY_MAGIC, sizeof( header.magic ) ) ||
+			header.version != ENTRY_VERSION ||
+			header.key != key
+		) {
+		// stale or foreign entry
+		Release();
+		Remove( key );
+		return false;
+	}
+
+	// entries are evicted by modification time, so bump it on every use
+	std::error_code ec;
+	std::filesystem::last_write_time( util::FS::NormalizePath( path, util::FS::PATH_SEPARATOR ), std::filesystem::file_time_type::clock::now(), ec );
+
+	payload = types::BufferView( m_entry->GetData() + sizeof( header ), m_entry->GetSize() - sizeof( header ) );
+	return true;
+}
+
+void TerrainCache::Release() {
+	if ( m_entry ) {
+		DELETE( m_entry );
+		m_entry = nullptr;
+	}
+}
+
+void TerrainCache::Save( const key_t key, const types::Buffer& payload ) {
+	if ( sizeof( entry_header_t ) + payload.lenw > m_max_size ) {
+		Log( "Terrain is too large to be cached ( " + std::to_string( payload.lenw ) + " bytes )" );
+		return;
+	}
+
+	entry_header_t header = {};
+	memcpy( header.magic, ENTRY_MAGIC, sizeof( header.magic ) );
+	header.version = ENTRY_VERSION;
+	header.key = key;
+
+	const auto path = GetEntryPath( key );
+	const auto tmp_path = path + ".tmp";
+
+	try {
+		util::FS::CreateDirectoryIfNotExists( m_path );
+
+		// write to temporary file first so that partially written entry is never picked up
+		{
+			std::ofstream out( util::FS::NormalizePath( tmp_path, util::FS::PATH_SEPARATOR ), std::ios_base::binary | std::ios_base::trunc );
+			if ( !out.is_open() ) {
+				THROW( "failed to open \"" + tmp_path + "\" for writing" );
+			}
+			out.write( (const char*)&header, sizeof( header ) );
+			out.write( (const char*)payload.data, payload.lenw );
+			if ( !out.good() ) {
+				THROW( "failed to write \"" + tmp_path + "\"" );
+			}
+		}
+		std::filesystem::rename(
+			util::FS::NormalizePath( tmp_path, util::FS::PATH_SEPARATOR ),
+			util::FS::NormalizePath( path, util::FS::PATH_SEPARATOR )
+		);
+	}
+	catch ( std::exception& e ) {
+		// cache is optional, failing to write it shouldn't break anything
+		Log( "Failed to write terrain cache entry: " + (std::string)e.what() );
+		std::error_code ec;
+		std::filesystem::remove( util::FS::NormalizePath( tmp_path, util::FS::PATH_SEPARATOR ), ec );
+		return;
+	}
+
+	Evict();
+}
+
+void TerrainCache::Remove( const key_t key ) {
+	std::error_code ec;
+	std::filesystem::remove( util::FS::NormalizePath( GetEntryPath( key ), util::FS::PATH_SEPARATOR ), ec );
+}
+
+const std::string TerrainCache::GetEntryPath( const key_t key ) const {
+	return m_path + KeyToString( key ) + s_entry_extension;
+}
+
+void TerrainCache::Evict() {
+	struct entry_t {
+		std::filesystem::path path;
+		uint64_t size;
+		std::filesystem::file_time_type time;
+	};
+	std::vector< entry_t > entries = {};
+	uint64_t total_size = 0;
+
+	std::error_code ec;
+	for ( const auto& it : std::filesystem::directory_iterator( util::FS::NormalizePath( m_path, util::FS::PATH_SEPARATOR ), ec ) ) {
+		if ( !it.is_regular_file( ec ) || it.path().extension() != s_entry_extension ) {
+			continue;
+		}
+		const entry_t entry = {
+			it.path(),
+			it.file_size( ec ),
+			it.last_write_time( ec ),
+		};
+		if ( ec ) {
+			continue;
+		}
+		total_size += entry.size;
+		entries.push_back( entry );
+	}
+
+	if ( total_size <= m_max_size ) {
+		return;
+	}
+
+	// oldest first
+	std::sort(
+		entries.begin(), entries.end(), []( const entry_t& a, const entry_t& b ) -> bool {
+			return a.time < b.time;
+		}
+	);
+	for ( const auto& entry : entries ) {
+		if ( total_size <= m_max_size ) {
+			break;
+		}
+		Log( "Evicting terrain cache entry " + entry.path.filename().string() );
+		if ( std::filesystem::remove( entry.path, ec ) ) {
+			total_size -= entry.size;
+		}
+	}
+}
+
+}
+}
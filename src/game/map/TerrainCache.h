@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "common/Common.h"
+
+#include "types/Buffer.h"
+#include "types/BufferView.h"
+
+namespace util {
+class MappedFile;
+}
+
+namespace game {
+namespace map {
+
+// persistent on-disk cache of terrain baked by Map::Initialize ( texture, meshes, sprites )
+// entries are keyed by hash of everything that affects baking, least recently used entries are evicted when cache exceeds size limit
+CLASS( TerrainCache, common::Class )
+
+	typedef uint64_t key_t;
+
+	static constexpr key_t KEY_INITIAL = 14695981039346656037ull; // FNV-1a
+	static const key_t UpdateKey( key_t key, const void* data, const size_t size );
+	static const std::string KeyToString( const key_t key );
+
+	TerrainCache( const std::string& path, const uint64_t max_size );
+	~TerrainCache();
+
+	// returns false if there is no valid entry for key
+	// otherwise payload points to mapped entry and stays valid until Release()
+	const bool Load( const key_t key, types::BufferView& payload );
+	void Release();
+
+	void Save( const key_t key, const types::Buffer& payload );
+	void Remove( const key_t key );
+
+private:
+	static constexpr char ENTRY_MAGIC[ 8 ] = { 'G', 'L', 'S', 'M', 'T', 'E', 'R', 'R' };
+	static constexpr uint32_t ENTRY_VERSION = 2; // bump when output of map modules changes
+	struct entry_header_t {
+		char magic[ 8 ];
+		uint32_t version;
+		uint32_t reserved;
+		key_t key;
+	};
+
+	const std::string m_path;
+	const uint64_t m_max_size;
+
+	util::MappedFile* m_entry = nullptr;
+
+	const std::string GetEntryPath( const key_t key ) const;
+	void Evict();
+
+};
+
+}
+}
@@ -13,6 +13,11 @@ CLASS( Finalize, Module )
 
 	void GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapState* ms ) override;
 
+	// adds vertices and surfaces to meshes
+	const bool IsParallelizable() const override {
+		return false;
+	}
+
 };
 
 }
@@ -12,6 +12,10 @@ Module::Module( Map* map )
 
 }
 
+const bool Module::IsParallelizable() const {
+	return true;
+}
+
 const uint8_t Module::RandomRotate() const {
 	return m_map->GetRandom()->GetUInt( 0, 3 );
 }
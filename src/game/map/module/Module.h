@@ -23,6 +23,9 @@ CLASS( Module, common::Class )
 
 	virtual void GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapState* ms ) = 0;
 
+	// modules that modify shared state ( meshes, sprites ) must not be run from multiple threads
+	virtual const bool IsParallelizable() const;
+
 protected:
 	Map* const m_map;
 
@@ -14,6 +14,11 @@ CLASS( Sprites, Module )
 		: Module( map ) {}
 	void GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapState* ms ) override;
 
+	// adds sprite actors and instances to map
+	const bool IsParallelizable() const override {
+		return false;
+	}
+
 private:
 	void GenerateSprite( const tile::Tile* tile, tile::TileState* ts, const std::string& name, const pcx_texture_coordinates_t& tex_coords, const float z_index );
 
@@ -99,7 +99,7 @@ const bool Tile::IsAdjactentTo( const Tile* other ) const {
 }
 
 const types::Buffer Tile::Serialize() const {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 
 	buf.WriteInt( coord.x );
 	buf.WriteInt( coord.y );
@@ -120,7 +120,7 @@ const types::Buffer Tile::Serialize() const {
 	return buf;
 }
 
-void Tile::Unserialize( types::Buffer buf ) {
+void Tile::Unserialize( types::BufferView buf ) {
 
 	coord.x = buf.ReadInt();
 	coord.y = buf.ReadInt();
@@ -129,7 +129,7 @@ void Tile::Unserialize( types::Buffer buf ) {
 	*elevation.left = buf.ReadInt();
 	*elevation.top = buf.ReadInt();
 	*elevation.right = buf.ReadInt();
-	*elevation.center = buf.ReadInt();
+	*elevation.bottom = buf.ReadInt();
 
 	moisture = buf.ReadInt();
 	rockiness = buf.ReadInt();
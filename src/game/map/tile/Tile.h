@@ -10,6 +10,7 @@
 #include "Types.h"
 
 #include "types/Buffer.h"
+#include "types/BufferView.h"
 
 namespace game {
 
@@ -93,7 +94,7 @@ public:
 	const bool IsAdjactentTo( const Tile* other ) const;
 
 	const types::Buffer Serialize() const;
-	void Unserialize( types::Buffer data );
+	void Unserialize( types::BufferView data );
 
 	const std::string ToString() const;
 
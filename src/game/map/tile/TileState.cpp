@@ -50,7 +50,7 @@ const types::Vec3& TileState::GetCenterCoords( tile_layer_type_t layer ) const {
 }
 
 const types::Buffer TileState::Serialize() const {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 
 	buf.WriteVec2f( coord );
 	buf.WriteFloat( tex_coord.x );
@@ -59,22 +59,22 @@ const types::Buffer TileState::Serialize() const {
 	buf.WriteFloat( tex_coord.y1 );
 	buf.WriteFloat( tex_coord.x2 );
 	buf.WriteFloat( tex_coord.y2 );
-	buf.WriteString( elevations.Serialize().ToString() );
+	buf.WriteBuffer( elevations.Serialize() );
 	buf.WriteInt( LAYER_MAX );
 	for ( auto i = 0 ; i < LAYER_MAX ; i++ ) {
-		buf.WriteString( layers[ i ].Serialize().ToString() );
+		buf.WriteBuffer( layers[ i ].Serialize() );
 	}
-	buf.WriteString( SerializeTileVertices( overdraw_column.coords ).ToString() );
-	buf.WriteString( overdraw_column.indices.Serialize().ToString() );
-	buf.WriteString( overdraw_column.surfaces.Serialize().ToString() );
-	buf.WriteString( SerializeTileVertices( data_mesh.coords ).ToString() );
-	buf.WriteString( data_mesh.indices.Serialize().ToString() );
+	buf.WriteBuffer( SerializeTileVertices( overdraw_column.coords ) );
+	buf.WriteBuffer( overdraw_column.indices.Serialize() );
+	buf.WriteBuffer( overdraw_column.surfaces.Serialize() );
+	buf.WriteBuffer( SerializeTileVertices( data_mesh.coords ) );
+	buf.WriteBuffer( data_mesh.indices.Serialize() );
 	buf.WriteBool( has_water );
 	buf.WriteBool( is_coastline_corner );
-	buf.WriteString( moisture_original->Serialize().ToString() );
+	buf.WriteBuffer( moisture_original->Serialize() );
 	if ( river_original ) {
 		buf.WriteBool( true );
-		buf.WriteString( river_original->Serialize().ToString() );
+		buf.WriteBuffer( river_original->Serialize() );
 	}
 	else {
 		buf.WriteBool( false );
@@ -92,7 +92,7 @@ const types::Buffer TileState::Serialize() const {
 }
 
 const types::Buffer TileState::tile_elevations_t::Serialize() const {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 
 	buf.WriteInt( center );
 	buf.WriteInt( left );
@@ -104,13 +104,13 @@ const types::Buffer TileState::tile_elevations_t::Serialize() const {
 }
 
 const types::Buffer TileState::tile_layer_t::Serialize() const {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 
-	buf.WriteString( SerializeTileVertices( coords ).ToString() );
-	buf.WriteString( indices.Serialize().ToString() );
-	buf.WriteString( surfaces.Serialize().ToString() );
-	buf.WriteString( SerializeTileTexCoords( tex_coords ).ToString() );
-	buf.WriteString( SerializeTileColors( colors ).ToString() );
+	buf.WriteBuffer( SerializeTileVertices( coords ) );
+	buf.WriteBuffer( indices.Serialize() );
+	buf.WriteBuffer( surfaces.Serialize() );
+	buf.WriteBuffer( SerializeTileTexCoords( tex_coords ) );
+	buf.WriteBuffer( SerializeTileColors( colors ) );
 	buf.WriteVec2f( texture_stretch );
 	buf.WriteBool( texture_stretch_at_edges );
 
@@ -118,7 +118,7 @@ const types::Buffer TileState::tile_layer_t::Serialize() const {
 }
 
 const types::Buffer TileState::tile_indices_t::Serialize() const {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 
 	buf.WriteInt( center );
 	buf.WriteInt( left );
@@ -130,7 +130,7 @@ const types::Buffer TileState::tile_indices_t::Serialize() const {
 }
 
 const types::Buffer TileState::tile_surfaces_t::Serialize() const {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 
 	buf.WriteInt( left_top );
 	buf.WriteInt( top_right );
@@ -140,7 +140,7 @@ const types::Buffer TileState::tile_surfaces_t::Serialize() const {
 	return buf;
 }
 
-void TileState::Unserialize( types::Buffer buf ) {
+void TileState::Unserialize( types::BufferView buf ) {
 	coord = buf.ReadVec2f();
 	tex_coord.x = buf.ReadFloat();
 	tex_coord.y = buf.ReadFloat();
@@ -148,18 +148,18 @@ void TileState::Unserialize( types::Buffer buf ) {
 	tex_coord.y1 = buf.ReadFloat();
 	tex_coord.x2 = buf.ReadFloat();
 	tex_coord.y2 = buf.ReadFloat();
-	elevations.Unserialize( buf.ReadString() );
+	elevations.Unserialize( buf.ReadView() );
 	if ( (tile_layer_type_t)buf.ReadInt() != LAYER_MAX ) {
 		THROW( "LAYER_MAX mismatch" );
 	}
 	for ( auto i = 0 ; i < LAYER_MAX ; i++ ) {
-		layers[ i ].Unserialize( buf.ReadString() );
+		layers[ i ].Unserialize( buf.ReadView() );
 	}
-	overdraw_column.coords = UnserializeTileVertices( buf.ReadString() );
-	overdraw_column.indices.Unserialize( buf.ReadString() );
-	overdraw_column.surfaces.Unserialize( buf.ReadString() );
-	data_mesh.coords = UnserializeTileVertices( buf.ReadString() );
-	data_mesh.indices.Unserialize( buf.ReadString() );
+	overdraw_column.coords = UnserializeTileVertices( buf.ReadView() );
+	overdraw_column.indices.Unserialize( buf.ReadView() );
+	overdraw_column.surfaces.Unserialize( buf.ReadView() );
+	data_mesh.coords = UnserializeTileVertices( buf.ReadView() );
+	data_mesh.indices.Unserialize( buf.ReadView() );
 	has_water = buf.ReadBool();
 	is_coastline_corner = buf.ReadBool();
 
@@ -167,11 +167,11 @@ void TileState::Unserialize( types::Buffer buf ) {
 	const auto h = s_consts.tc.texture_pcx.dimensions.y;
 
 	NEW( moisture_original, types::texture::Texture, "MoistureOriginal", w, h );
-	moisture_original->Unserialize( buf.ReadString() );
+	moisture_original->Unserialize( buf.ReadView() );
 	const bool has_river_original = buf.ReadBool();
 	if ( has_river_original ) {
 		NEW( river_original, types::texture::Texture, "RiverOriginal", w, h );
-		river_original->Unserialize( buf.ReadString() );
+		river_original->Unserialize( buf.ReadView() );
 	}
 
 	const size_t sprites_count = buf.ReadInt();
@@ -188,7 +188,7 @@ void TileState::Unserialize( types::Buffer buf ) {
 }
 
 const types::Buffer TileState::SerializeTileVertices( const tile_vertices_t& vertices ) {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 
 	buf.WriteVec3( vertices.center );
 	buf.WriteVec3( vertices.left );
@@ -199,7 +199,7 @@ const types::Buffer TileState::SerializeTileVertices( const tile_vertices_t& ver
 	return buf;
 }
 
-const tile_vertices_t TileState::UnserializeTileVertices( types::Buffer buf ) {
+const tile_vertices_t TileState::UnserializeTileVertices( types::BufferView buf ) {
 	const auto center = buf.ReadVec3();
 	const auto left = buf.ReadVec3();
 	const auto top = buf.ReadVec3();
@@ -215,7 +215,7 @@ const tile_vertices_t TileState::UnserializeTileVertices( types::Buffer buf ) {
 }
 
 const types::Buffer TileState::SerializeTileTexCoords( const tile_tex_coords_t& tex_coords ) {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 
 	buf.WriteVec2f( tex_coords.center );
 	buf.WriteVec2f( tex_coords.left );
@@ -226,7 +226,7 @@ const types::Buffer TileState::SerializeTileTexCoords( const tile_tex_coords_t&
 	return buf;
 }
 
-const tile_tex_coords_t TileState::UnserializeTileTexCoords( types::Buffer buf ) {
+const tile_tex_coords_t TileState::UnserializeTileTexCoords( types::BufferView buf ) {
 	const auto center = buf.ReadVec2f();
 	const auto left = buf.ReadVec2f();
 	const auto top = buf.ReadVec2f();
@@ -242,7 +242,7 @@ const tile_tex_coords_t TileState::UnserializeTileTexCoords( types::Buffer buf )
 }
 
 const types::Buffer TileState::SerializeTileColors( const tile_colors_t& colors ) {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 
 	buf.WriteColor( colors.center );
 	buf.WriteColor( colors.left );
@@ -253,7 +253,7 @@ const types::Buffer TileState::SerializeTileColors( const tile_colors_t& colors
 	return buf;
 }
 
-const tile_colors_t TileState::UnserializeTileColors( types::Buffer buf ) {
+const tile_colors_t TileState::UnserializeTileColors( types::BufferView buf ) {
 	const auto center = buf.ReadColor();
 	const auto left = buf.ReadColor();
 	const auto top = buf.ReadColor();
@@ -268,7 +268,7 @@ const tile_colors_t TileState::UnserializeTileColors( types::Buffer buf ) {
 	};
 }
 
-void TileState::tile_elevations_t::Unserialize( types::Buffer buf ) {
+void TileState::tile_elevations_t::Unserialize( types::BufferView buf ) {
 	center = buf.ReadInt();
 	left = buf.ReadInt();
 	top = buf.ReadInt();
@@ -276,17 +276,17 @@ void TileState::tile_elevations_t::Unserialize( types::Buffer buf ) {
 	bottom = buf.ReadInt();
 }
 
-void TileState::tile_layer_t::Unserialize( types::Buffer buf ) {
-	coords = UnserializeTileVertices( buf.ReadString() );
-	indices.Unserialize( buf.ReadString() );
-	surfaces.Unserialize( buf.ReadString() );
-	tex_coords = UnserializeTileTexCoords( buf.ReadString() );
-	colors = UnserializeTileColors( buf.ReadString() );
+void TileState::tile_layer_t::Unserialize( types::BufferView buf ) {
+	coords = UnserializeTileVertices( buf.ReadView() );
+	indices.Unserialize( buf.ReadView() );
+	surfaces.Unserialize( buf.ReadView() );
+	tex_coords = UnserializeTileTexCoords( buf.ReadView() );
+	colors = UnserializeTileColors( buf.ReadView() );
 	texture_stretch = buf.ReadVec2f();
 	texture_stretch_at_edges = buf.ReadBool();
 }
 
-void TileState::tile_indices_t::Unserialize( types::Buffer buf ) {
+void TileState::tile_indices_t::Unserialize( types::BufferView buf ) {
 	center = buf.ReadInt();
 	left = buf.ReadInt();
 	top = buf.ReadInt();
@@ -294,7 +294,7 @@ void TileState::tile_indices_t::Unserialize( types::Buffer buf ) {
 	bottom = buf.ReadInt();
 }
 
-void TileState::tile_surfaces_t::Unserialize( types::Buffer buf ) {
+void TileState::tile_surfaces_t::Unserialize( types::BufferView buf ) {
 	left_top = buf.ReadInt();
 	top_right = buf.ReadInt();
 	right_bottom = buf.ReadInt();
@@ -289,14 +289,14 @@ const std::vector< Tile* > Tiles::GetVector( MT_CANCELABLE ) {
 }
 
 const types::Buffer Tiles::Serialize() const {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT_CHECKSUMMED );
 
 	buf.WriteInt( m_width );
 	buf.WriteInt( m_height );
 
 	for ( auto y = 0 ; y < m_height ; y++ ) {
 		for ( auto x = y & 1 ; x < m_width ; x += 2 ) {
-			buf.WriteString( AtConst( x, y ).Serialize().ToString() );
+			buf.WriteBuffer( AtConst( x, y ).Serialize() );
 		}
 	}
 
@@ -305,7 +305,12 @@ const types::Buffer Tiles::Serialize() const {
 	return buf;
 }
 
-void Tiles::Unserialize( types::Buffer buf ) {
+void Tiles::Unserialize( types::BufferView buf ) {
+
+	if ( IsColumnar( buf.GetData(), buf.GetSize() ) ) {
+		UnserializeColumnar( buf.GetData(), buf.GetSize() );
+		return;
+	}
 
 	size_t width = buf.ReadInt();
 	size_t height = buf.ReadInt();
@@ -315,7 +320,7 @@ void Tiles::Unserialize( types::Buffer buf ) {
 
 	for ( auto y = 0 ; y < m_height ; y++ ) {
 		for ( auto x = y & 1 ; x < m_width ; x += 2 ) {
-			At( x, y ).Unserialize( types::Buffer( buf.ReadString() ) );
+			At( x, y ).Unserialize( buf.ReadView() );
 		}
 	}
 
@@ -327,6 +332,127 @@ void Tiles::Unserialize( types::Buffer buf ) {
 
 }
 
+const size_t Tiles::GetColumnarSize( const uint32_t width, const uint32_t height ) {
+	const size_t tiles_count = (size_t)width * height / 2;
+	return sizeof( columnar_header_t )
+		+ sizeof( columnar_elevation_t ) * width * 2 // top vertex row
+		+ sizeof( columnar_elevation_t ) * width // top right vertex row
+		+ sizeof( columnar_elevation_t ) * tiles_count // elevation centers
+		+ sizeof( columnar_elevation_t ) * tiles_count // elevation bottoms
+		+ sizeof( moisture_t ) * tiles_count
+		+ sizeof( rockiness_t ) * tiles_count
+		+ sizeof( bonus_t ) * tiles_count
+		+ sizeof( feature_t ) * tiles_count
+		+ sizeof( terraforming_t ) * tiles_count;
+}
+
+// tiles are stored in rows, only half of each row is used ( see At() )
+#define FOREACH_TILE( _code ) \
+	for ( size_t y = 0 ; y < m_height ; y++ ) { \
+		for ( size_t i = 0 ; i < m_width / 2 ; i++ ) { \
+			_code \
+		} \
+	}
+
+const std::string Tiles::SerializeColumnar() const {
+	std::string result;
+	result.resize( GetColumnarSize( m_width, m_height ) );
+	uint8_t* ptr = (uint8_t*)result.data();
+
+	columnar_header_t header = {};
+	memcpy( header.magic, COLUMNAR_MAGIC, sizeof( header.magic ) );
+	header.version = COLUMNAR_VERSION;
+	header.width = m_width;
+	header.height = m_height;
+	header.is_validated = m_is_validated
+		? 1
+		: 0;
+	memcpy( ptr, &header, sizeof( header ) );
+	ptr += sizeof( header );
+
+#define WRITE( _type, _value ) { \
+	const _type v = _value; \
+	memcpy( ptr, &v, sizeof( v ) ); \
+	ptr += sizeof( v ); \
+}
+	for ( const auto& e : m_top_vertex_row ) {
+		WRITE( columnar_elevation_t, e );
+	}
+	for ( const auto& e : m_top_right_vertex_row ) {
+		WRITE( columnar_elevation_t, e );
+	}
+	FOREACH_TILE( WRITE( columnar_elevation_t, m_data[ y * m_width + i ].elevation_data.center ) )
+	FOREACH_TILE( WRITE( columnar_elevation_t, m_data[ y * m_width + i ].elevation_data.bottom ) )
+	FOREACH_TILE( WRITE( moisture_t, m_data[ y * m_width + i ].moisture ) )
+	FOREACH_TILE( WRITE( rockiness_t, m_data[ y * m_width + i ].rockiness ) )
+	FOREACH_TILE( WRITE( bonus_t, m_data[ y * m_width + i ].bonus ) )
+	FOREACH_TILE( WRITE( feature_t, m_data[ y * m_width + i ].features ) )
+	FOREACH_TILE( WRITE( terraforming_t, m_data[ y * m_width + i ].terraforming ) )
+#undef WRITE
+
+	ASSERT( ptr == (uint8_t*)result.data() + result.size(), "columnar tiles size mismatch" );
+	return result;
+}
+
+const bool Tiles::IsColumnar( const uint8_t* data, const size_t size ) {
+	return size >= sizeof( COLUMNAR_MAGIC ) && !memcmp( data, COLUMNAR_MAGIC, sizeof( COLUMNAR_MAGIC ) );
+}
+
+void Tiles::UnserializeColumnar( const uint8_t* data, const size_t size ) {
+	ASSERT( IsColumnar( data, size ), "data is not in columnar format" );
+
+	// note: THROWs instead of ASSERTs, because malformed files must not cause out-of-bounds reads in release mode
+	columnar_header_t header;
+	if ( size < sizeof( header ) ) {
+		THROW( "columnar tiles data ends prematurely (while reading header)" );
+	}
+	memcpy( &header, data, sizeof( header ) );
+	if ( header.version != COLUMNAR_VERSION ) {
+		THROW( "unsupported columnar tiles version ( " + std::to_string( header.version ) + " != " + std::to_string( COLUMNAR_VERSION ) + " )" );
+	}
+	if ( !header.width || !header.height || ( header.width & 1 ) || ( header.height & 1 ) ) {
+		THROW( "invalid columnar tiles dimensions ( " + std::to_string( header.width ) + "x" + std::to_string( header.height ) + " )" );
+	}
+	const auto need_size = GetColumnarSize( header.width, header.height );
+	if ( size != need_size ) {
+		THROW( "columnar tiles size mismatch ( " + std::to_string( size ) + " != " + std::to_string( need_size ) + " )" );
+	}
+
+	m_width = m_height = 0;
+	Resize( header.width, header.height );
+
+	const uint8_t* ptr = data + sizeof( header );
+
+#define READ( _type, _to ) { \
+	_type v; \
+	memcpy( &v, ptr, sizeof( v ) ); \
+	ptr += sizeof( v ); \
+	_to = v; \
+}
+	for ( auto& e : m_top_vertex_row ) {
+		READ( columnar_elevation_t, e );
+	}
+	for ( auto& e : m_top_right_vertex_row ) {
+		READ( columnar_elevation_t, e );
+	}
+	FOREACH_TILE( READ( columnar_elevation_t, m_data[ y * m_width + i ].elevation_data.center ) )
+	FOREACH_TILE( READ( columnar_elevation_t, m_data[ y * m_width + i ].elevation_data.bottom ) )
+	FOREACH_TILE( READ( moisture_t, m_data[ y * m_width + i ].moisture ) )
+	FOREACH_TILE( READ( rockiness_t, m_data[ y * m_width + i ].rockiness ) )
+	FOREACH_TILE( READ( bonus_t, m_data[ y * m_width + i ].bonus ) )
+	FOREACH_TILE( READ( feature_t, m_data[ y * m_width + i ].features ) )
+	FOREACH_TILE( READ( terraforming_t, m_data[ y * m_width + i ].terraforming ) )
+#undef READ
+
+	ASSERT( ptr == data + size, "columnar tiles size mismatch" );
+
+	m_is_validated = header.is_validated != 0;
+
+	FOREACH_TILE( m_data[ y * m_width + i ].Update(); )
+}
+
+#undef FOREACH_TILE
+
 }
 }
 }
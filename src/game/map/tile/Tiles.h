@@ -44,9 +44,38 @@ CLASS( Tiles, types::Serializable )
 	const std::vector< Tile* > GetVector( MT_CANCELABLE );
 
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override; // accepts both legacy and columnar formats
+
+	// columnar format: header followed by one contiguous array per field
+	// can be read directly from memory-mapped file, without per-tile buffers or allocations
+	const std::string SerializeColumnar() const;
+	static const bool IsColumnar( const uint8_t* data, const size_t size );
+	void UnserializeColumnar( const uint8_t* data, const size_t size );
 
 private:
+
+	static constexpr char COLUMNAR_MAGIC[ 8 ] = {
+		'G',
+		'L',
+		'S',
+		'M',
+		'T',
+		'I',
+		'L',
+		'E'
+	};
+	static constexpr uint32_t COLUMNAR_VERSION = 1;
+	struct columnar_header_t {
+		char magic[ sizeof( COLUMNAR_MAGIC ) ];
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+		uint8_t is_validated;
+		uint8_t reserved[ 3 ];
+	};
+	typedef int32_t columnar_elevation_t; // elevations are well within int32 range, no need to store them as 64-bit
+	static const size_t GetColumnarSize( const uint32_t width, const uint32_t height );
+
 	uint32_t m_width = 0;
 	uint32_t m_height = 0;
 
@@ -22,7 +22,7 @@ const types::Buffer DifficultyLevel::Serialize() const {
 	return buf;
 }
 
-void DifficultyLevel::Unserialize( types::Buffer buf ) {
+void DifficultyLevel::Unserialize( types::BufferView buf ) {
 
 	m_name = buf.ReadString();
 	m_difficulty = buf.ReadInt();
@@ -16,7 +16,7 @@ CLASS( DifficultyLevel, types::Serializable )
 	int m_difficulty = 0;
 
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override;
 };
 
 }
@@ -42,7 +42,7 @@ const types::Buffer Faction::Serialize() const {
 	return buf;
 }
 
-void Faction::Unserialize( types::Buffer buf ) {
+void Faction::Unserialize( types::BufferView buf ) {
 
 	m_id = buf.ReadString();
 	m_name = buf.ReadString();
@@ -33,7 +33,7 @@ CLASS2( Faction, types::Serializable, gse::Wrappable )
 	bases_render_info_t m_bases_render = {};
 
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override;
 
 	WRAPDEFS_PTR( Faction )
 
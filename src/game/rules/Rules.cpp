@@ -17,26 +17,26 @@ const types::Buffer Rules::Serialize() const {
 	for ( auto& id : m_factions_order ) {
 		const auto& faction = m_factions.at( id );
 		buf.WriteString( id );
-		buf.WriteString( faction.Serialize().ToString() );
+		buf.WriteBuffer( faction.Serialize() );
 	}
 
 	buf.WriteInt( m_difficulty_levels.size() );
 	for ( auto& difficulty_level : m_difficulty_levels ) {
 		buf.WriteInt( difficulty_level.first );
-		buf.WriteString( difficulty_level.second.Serialize().ToString() );
+		buf.WriteBuffer( difficulty_level.second.Serialize() );
 	}
 
 	return buf;
 }
 
-void Rules::Unserialize( types::Buffer buf ) {
+void Rules::Unserialize( types::BufferView buf ) {
 
 	m_factions.clear();
 	m_factions_order.clear();
 	const size_t factions_count = buf.ReadInt();
 	for ( size_t i = 0 ; i < factions_count ; i++ ) {
 		const auto faction_id = buf.ReadString();
-		m_factions[ faction_id ].Unserialize( buf.ReadString() );
+		m_factions[ faction_id ].Unserialize( buf.ReadView() );
 		m_factions_order.push_back( faction_id );
 	}
 
@@ -44,7 +44,7 @@ void Rules::Unserialize( types::Buffer buf ) {
 	const size_t difficulty_levels_count = buf.ReadInt();
 	for ( size_t i = 0 ; i < difficulty_levels_count ; i++ ) {
 		const size_t difficulty_level_id = buf.ReadInt();
-		m_difficulty_levels[ difficulty_level_id ].Unserialize( buf.ReadString() );
+		m_difficulty_levels[ difficulty_level_id ].Unserialize( buf.ReadView() );
 	}
 
 	m_is_initialized = true;
@@ -24,7 +24,7 @@ CLASS( Rules, types::Serializable )
 	void Initialize();
 
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override;
 
 protected:
 	virtual void InitRules() = 0;
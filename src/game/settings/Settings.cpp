@@ -21,7 +21,7 @@ const types::Buffer MapSettings::Serialize() const {
 	return buf;
 }
 
-void MapSettings::Unserialize( types::Buffer buf ) {
+void MapSettings::Unserialize( types::BufferView buf ) {
 	type = (type_t)buf.ReadInt();
 	filename = buf.ReadString();
 	size = buf.ReadInt();
@@ -41,18 +41,18 @@ void GlobalSettings::Initialize() {
 const types::Buffer GlobalSettings::Serialize() const {
 	types::Buffer buf;
 
-	buf.WriteString( map.Serialize().ToString() );
-	buf.WriteString( game_rules.Serialize().ToString() );
-	buf.WriteString( global_difficulty.Serialize().ToString() );
+	buf.WriteBuffer( map.Serialize() );
+	buf.WriteBuffer( game_rules.Serialize() );
+	buf.WriteBuffer( global_difficulty.Serialize() );
 	buf.WriteString( game_name );
 
 	return buf;
 }
 
-void GlobalSettings::Unserialize( types::Buffer buf ) {
-	map.Unserialize( buf.ReadString() );
-	game_rules.Unserialize( buf.ReadString() );
-	global_difficulty.Unserialize( buf.ReadString() );
+void GlobalSettings::Unserialize( types::BufferView buf ) {
+	map.Unserialize( buf.ReadView() );
+	game_rules.Unserialize( buf.ReadView() );
+	global_difficulty.Unserialize( buf.ReadView() );
 	game_name = buf.ReadString();
 }
 
@@ -68,7 +68,7 @@ const types::Buffer LocalSettings::Serialize() const {
 	return buf;
 }
 
-void LocalSettings::Unserialize( types::Buffer buf ) {
+void LocalSettings::Unserialize( types::BufferView buf ) {
 	game_mode = (game_mode_t)buf.ReadInt();
 	network_type = (network_type_t)buf.ReadInt();
 	network_role = (network_role_t)buf.ReadInt();
@@ -79,15 +79,15 @@ void LocalSettings::Unserialize( types::Buffer buf ) {
 const types::Buffer Settings::Serialize() const {
 	types::Buffer buf;
 
-	buf.WriteString( global.Serialize().ToString() );
-	buf.WriteString( local.Serialize().ToString() );
+	buf.WriteBuffer( global.Serialize() );
+	buf.WriteBuffer( local.Serialize() );
 
 	return buf;
 }
 
-void Settings::Unserialize( types::Buffer buf ) {
-	global.Unserialize( types::Buffer( buf.ReadString() ) );
-	local.Unserialize( types::Buffer( buf.ReadString() ) );
+void Settings::Unserialize( types::BufferView buf ) {
+	global.Unserialize( buf.ReadView() );
+	local.Unserialize( buf.ReadView() );
 }
 
 }
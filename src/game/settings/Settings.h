@@ -60,7 +60,7 @@ CLASS( MapSettings, types::Serializable )
 	map_config_value_t clouds = MAP_CONFIG_CLOUDS_AVERAGE;
 
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override;
 };
 
 // settings that are synced between players (host has authority)
@@ -78,7 +78,7 @@ CLASS( GlobalSettings, types::Serializable )
 	// TODO: custom rules struct
 
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override;
 };
 
 // settings that aren't synced between players
@@ -112,7 +112,7 @@ public:
 	std::set< std::string > banned_addresses = {};
 
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override;
 };
 
 CLASS( Settings, types::Serializable )
@@ -121,7 +121,7 @@ CLASS( Settings, types::Serializable )
 	LocalSettings local;
 
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override;
 };
 
 }
@@ -135,7 +135,7 @@ const types::Buffer Slot::Serialize() const {
 
 	buf.WriteInt( m_slot_state );
 	if ( m_slot_state == SS_PLAYER ) {
-		buf.WriteString( m_player_data.player->Serialize().ToString() );
+		buf.WriteBuffer( m_player_data.player->Serialize() );
 		// not sending cid
 		// not sending remote address
 		buf.WriteInt( m_player_data.flags );
@@ -145,7 +145,7 @@ const types::Buffer Slot::Serialize() const {
 	return buf;
 }
 
-void Slot::Unserialize( types::Buffer buf ) {
+void Slot::Unserialize( types::BufferView buf ) {
 	m_slot_state = (slot_state_t)buf.ReadInt();
 	if ( m_slot_state == SS_PLAYER ) {
 		if ( !m_player_data.player ) {
@@ -153,7 +153,7 @@ void Slot::Unserialize( types::Buffer buf ) {
 			m_player_data.player->SetSlot( this );
 		}
 		else {
-			m_player_data.player->Unserialize( buf.ReadString() );
+			m_player_data.player->Unserialize( buf.ReadView() );
 		}
 		m_player_data.flags = buf.ReadInt();
 	}
@@ -47,7 +47,7 @@ CLASS2( Slot, types::Serializable, gse::Wrappable )
 	void SetPlayerFlags( const player_flag_t flags );
 
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override;
 
 	WRAPDEFS_PTR( Slot );
 
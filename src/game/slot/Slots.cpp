@@ -45,18 +45,18 @@ const types::Buffer Slots::Serialize() const {
 	buf.WriteInt( m_slots.size() );
 
 	for ( auto& slot : m_slots ) {
-		buf.WriteString( slot.Serialize().ToString() );
+		buf.WriteBuffer( slot.Serialize() );
 	}
 
 	return buf;
 }
 
-void Slots::Unserialize( types::Buffer buf ) {
+void Slots::Unserialize( types::BufferView buf ) {
 	ASSERT( m_slots.empty(), "unserialize on non-empty slots" );
 	Resize( buf.ReadInt() );
 
 	for ( auto& slot : m_slots ) {
-		slot.Unserialize( buf.ReadString() );
+		slot.Unserialize( buf.ReadView() );
 	}
 }
 
@@ -21,7 +21,7 @@ CLASS( Slots, types::Serializable )
 	void Clear();
 
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override;
 
 private:
 	const State* m_state;
@@ -0,0 +1,62 @@
+#include "StateHash.h"
+
+#include "util/crc32/CRC32.h"
+
+namespace game {
+namespace turn {
+
+// crc is linear, so xor of plain crcs could cancel out same change in two different objects; scramble bits first
+static const util::crc32::crc_t Scramble( util::crc32::crc_t h ) {
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+void StateHash::Set( const object_type_t type, const size_t id, const types::Buffer& state ) {
+	const uint64_t key[2] = {
+		type,
+		id
+	};
+	const auto hash = Scramble( util::crc32::CRC32::CalculateFromBuffer( state, util::crc32::CRC32::Calculate( key, sizeof( key ) ) ) );
+	auto& hashes = m_object_hashes[ type ];
+	const auto it = hashes.find( id );
+	if ( it != hashes.end() ) {
+		m_hash ^= it->second;
+		it->second = hash;
+	}
+	else {
+		hashes.insert(
+			{
+				id,
+				hash
+			}
+		);
+	}
+	m_hash ^= hash;
+}
+
+void StateHash::Remove( const object_type_t type, const size_t id ) {
+	auto& hashes = m_object_hashes[ type ];
+	const auto it = hashes.find( id );
+	if ( it != hashes.end() ) {
+		m_hash ^= it->second;
+		hashes.erase( it );
+	}
+}
+
+const util::crc32::crc_t StateHash::Get() const {
+	return m_hash;
+}
+
+void StateHash::Reset() {
+	m_hash = 0;
+	for ( auto& hashes : m_object_hashes ) {
+		hashes.clear();
+	}
+}
+
+}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+#include "util/crc32/Types.h"
+
+namespace types {
+class Buffer;
+}
+
+namespace game {
+namespace turn {
+
+// hash of whole world state that is updated incrementally, when objects change
+// every object contributes hash of its own state, they are combined with xor so that any object can be updated or removed in O(1)
+// if game states of two peers differ then ( almost certainly ) their hashes differ too
+class StateHash {
+public:
+
+	enum object_type_t : uint8_t {
+		OT_UNIT,
+		OT_BASE,
+		OT_MAX
+	};
+
+	void Set( const object_type_t type, const size_t id, const types::Buffer& state );
+	void Remove( const object_type_t type, const size_t id );
+
+	const util::crc32::crc_t Get() const;
+
+	void Reset();
+
+private:
+	util::crc32::crc_t m_hash = 0;
+	std::unordered_map< size_t, util::crc32::crc_t > m_object_hashes[OT_MAX] = {};
+
+};
+
+}
+}
@@ -25,10 +25,9 @@ void Turn::AdvanceTurn( const size_t turn_id ) {
 	m_is_active = true;
 }
 
-const util::crc32::crc_t Turn::FinalizeAndChecksum() {
+void Turn::Finalize() {
 	ASSERT_NOLOG( m_is_active, "turn not active" );
 	m_is_active = false;
-	return util::crc32::CRC32::CalculateFromBuffer( event::Event::SerializeMultiple( m_events ) );
 }
 
 void Turn::AddEvent( event::Event* event ) {
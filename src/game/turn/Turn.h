@@ -3,7 +3,6 @@
 #include <vector>
 
 #include "game/event/Event.h"
-#include "util/crc32/CRC32.h"
 
 namespace game {
 namespace turn {
@@ -19,7 +18,7 @@ public:
 	const size_t GetId() const;
 
 	void AdvanceTurn( const size_t turn_id );
-	const util::crc32::crc_t FinalizeAndChecksum();
+	void Finalize();
 
 	void AddEvent( event::Event* event );
 	const events_t* const GetEvents() const;
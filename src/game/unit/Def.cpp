@@ -19,9 +19,9 @@ Def::Def( const std::string& id, const MoraleSet* moraleset, const def_type_t ty
 }
 
 const types::Buffer Def::Serialize( const Def* def ) {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 	buf.WriteString( def->m_id );
-	buf.WriteString( MoraleSet::Serialize( def->m_moraleset ).ToString() );
+	buf.WriteBuffer( MoraleSet::Serialize( def->m_moraleset ) );
 	buf.WriteString( def->m_name );
 	buf.WriteInt( def->m_type );
 	switch ( def->m_type ) {
@@ -35,9 +35,9 @@ const types::Buffer Def::Serialize( const Def* def ) {
 	return buf;
 }
 
-Def* Def::Unserialize( types::Buffer& buf ) {
+Def* Def::Unserialize( types::BufferView& buf ) {
 	const auto id = buf.ReadString();
-	auto moralesetbuf = types::Buffer( buf.ReadString() );
+	auto moralesetbuf = buf.ReadView();
 	const auto* moraleset = MoraleSet::Unserialize( moralesetbuf );
 	const auto name = buf.ReadString();
 	const auto type = (def_type_t)buf.ReadInt();
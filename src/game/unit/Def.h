@@ -4,6 +4,7 @@
 
 #include "Types.h"
 #include "types/Buffer.h"
+#include "types/BufferView.h"
 
 #include "game/map/tile/Types.h"
 #include "gse/Wrappable.h"
@@ -38,7 +39,7 @@ public:
 	virtual const std::string ToString( const std::string& prefix = "" ) const = 0;
 
 	static const types::Buffer Serialize( const Def* def );
-	static Def* Unserialize( types::Buffer& buf );
+	static Def* Unserialize( types::BufferView& buf );
 
 	WRAPDEFS_PTR( Def );
 
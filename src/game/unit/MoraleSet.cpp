@@ -27,7 +27,7 @@ const std::string MoraleSet::ToString( const std::string& prefix ) const {
 
 const types::Buffer MoraleSet::Serialize( const MoraleSet* moraleset ) {
 	ASSERT_NOLOG( MORALE_MIN == 0, "non-zero MORALE_MIN may cause unexpected bugs here" );
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 	buf.WriteString( moraleset->m_id );
 	for ( size_t i = MORALE_MIN ; i <= MORALE_MAX ; i++ ) {
 		buf.WriteString( moraleset->m_morale_values.at( i ).m_name );
@@ -35,7 +35,7 @@ const types::Buffer MoraleSet::Serialize( const MoraleSet* moraleset ) {
 	return buf;
 }
 
-MoraleSet* MoraleSet::Unserialize( types::Buffer& buf ) {
+MoraleSet* MoraleSet::Unserialize( types::BufferView& buf ) {
 	ASSERT_NOLOG( MORALE_MIN == 0, "non-zero MORALE_MIN may cause unexpected bugs here" );
 	const auto id = buf.ReadString();
 	morale_values_t values = {};
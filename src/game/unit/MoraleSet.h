@@ -5,6 +5,7 @@
 
 #include "Morale.h"
 #include "types/Buffer.h"
+#include "types/BufferView.h"
 
 namespace game {
 namespace unit {
@@ -20,7 +21,7 @@ public:
 	const std::string ToString( const std::string& prefix ) const;
 
 	static const types::Buffer Serialize( const MoraleSet* moraleset );
-	static MoraleSet* Unserialize( types::Buffer& buf );
+	static MoraleSet* Unserialize( types::BufferView& buf );
 
 };
 
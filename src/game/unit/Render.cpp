@@ -22,7 +22,7 @@ void Render::Serialize( types::Buffer& buf, const Render* render ) {
 	}
 }
 
-Render* Render::Unserialize( types::Buffer& buf ) {
+Render* Render::Unserialize( types::BufferView& buf ) {
 	const auto render_type = (render_type_t)buf.ReadInt();
 	switch ( render_type ) {
 		case RT_SPRITE:
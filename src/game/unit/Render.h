@@ -3,6 +3,7 @@
 #include <string>
 
 #include "types/Buffer.h"
+#include "types/BufferView.h"
 
 namespace game {
 
@@ -33,7 +34,7 @@ private:
 	friend class StaticDef;
 
 	static void Serialize( types::Buffer& buf, const Render* render );
-	static Render* Unserialize( types::Buffer& buf );
+	static Render* Unserialize( types::BufferView& buf );
 
 };
 
@@ -28,7 +28,7 @@ private:
 	friend class Render;
 
 	static void Serialize( types::Buffer& buf, const SpriteRender* render );
-	static SpriteRender* Unserialize( types::Buffer& buf );
+	static SpriteRender* Unserialize( types::BufferView& buf );
 
 };
 
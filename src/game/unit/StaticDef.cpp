@@ -75,7 +75,7 @@ void StaticDef::Serialize( types::Buffer& buf, const StaticDef* def ) {
 	Render::Serialize( buf, def->m_render );
 }
 
-StaticDef* StaticDef::Unserialize( types::Buffer& buf, const std::string& id, const MoraleSet* moraleset, const std::string& name ) {
+StaticDef* StaticDef::Unserialize( types::BufferView& buf, const std::string& id, const MoraleSet* moraleset, const std::string& name ) {
 	const auto movement_type = (movement_type_t)buf.ReadInt();
 	const auto movement_per_turn = buf.ReadFloat();
 	return new StaticDef( id, moraleset, name, movement_type, movement_per_turn, Render::Unserialize( buf ) );
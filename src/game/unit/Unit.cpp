@@ -79,9 +79,9 @@ void Unit::SetTile( map::tile::Tile* tile ) {
 }
 
 const types::Buffer Unit::Serialize( const Unit* unit ) {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 	buf.WriteInt( unit->m_id );
-	buf.WriteString( Def::Serialize( unit->m_def ).ToString() );
+	buf.WriteBuffer( Def::Serialize( unit->m_def ) );
 	buf.WriteInt( unit->m_owner->GetIndex() );
 	buf.WriteInt( unit->m_tile->coord.x );
 	buf.WriteInt( unit->m_tile->coord.y );
@@ -92,9 +92,9 @@ const types::Buffer Unit::Serialize( const Unit* unit ) {
 	return buf;
 }
 
-Unit* Unit::Unserialize( types::Buffer& buf, Game* game ) {
+Unit* Unit::Unserialize( types::BufferView& buf, Game* game ) {
 	const auto id = buf.ReadInt();
-	auto defbuf = types::Buffer( buf.ReadString() );
+	auto defbuf = buf.ReadView();
 	auto* def = Def::Unserialize( defbuf );
 	auto* slot = game ? &game->GetState()->m_slots->GetSlot( buf.ReadInt() ) : nullptr;
 	const auto pos_x = buf.ReadInt();
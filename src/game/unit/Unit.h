@@ -8,6 +8,7 @@
 #include "Types.h"
 
 #include "types/Buffer.h"
+#include "types/BufferView.h"
 
 namespace game {
 
@@ -60,7 +61,7 @@ public:
 	void SetTile( map::tile::Tile* tile );
 
 	static const types::Buffer Serialize( const Unit* unit );
-	static Unit* Unserialize( types::Buffer& buf, Game* game );
+	static Unit* Unserialize( types::BufferView& buf, Game* game );
 
 	WRAPDEFS_DYNAMIC( Unit );
 
@@ -2,10 +2,12 @@
 
 #include "parser/JS.h"
 #include "runner/Interpreter.h"
+#include "runner/VM.h"
 #include "gse/context/GlobalContext.h"
 #include "Exception.h"
 #include "type/Undefined.h"
 #include "program/Program.h"
+#include "ProgramCache.h"
 
 #include "util/FS.h"
 
@@ -25,6 +27,9 @@ GSE::~GSE() {
 	for ( auto& it : m_include_cache ) {
 		it.second.Cleanup();
 	}
+	if ( m_program_cache ) {
+		DELETE( m_program_cache );
+	}
 }
 
 parser::Parser* GSE::GetParser( const std::string& filename, const std::string& source, const size_t initial_line_num ) const {
@@ -38,8 +43,24 @@ parser::Parser* GSE::GetParser( const std::string& filename, const std::string&
 	return parser;
 }
 
+void GSE::SetRunnerType( const runner::runner_type_t runner_type ) {
+	m_runner_type = runner_type;
+}
+
 runner::Runner* GSE::GetRunner() const {
-	NEWV( runner, runner::Interpreter );
+	runner::Runner* runner = nullptr;
+	switch ( m_runner_type ) {
+		case runner::RT_INTERPRETER: {
+			NEW( runner, runner::Interpreter );
+			break;
+		}
+		case runner::RT_VM: {
+			NEW( runner, runner::VM );
+			break;
+		}
+		default:
+			THROW( "unknown runner type: " + std::to_string( m_runner_type ) );
+	}
 	return runner;
 }
 
@@ -47,6 +68,13 @@ void GSE::AddBindings( Bindings* bindings ) {
 	m_bindings.push_back( bindings );
 }
 
+void GSE::SetProgramCachePath( const std::string& path ) {
+	if ( m_program_cache ) {
+		DELETE( m_program_cache );
+	}
+	NEW( m_program_cache, ProgramCache, path );
+}
+
 context::GlobalContext* GSE::CreateGlobalContext( const std::string& source_path ) {
 	NEWV( context, context::GlobalContext, this, source_path );
 	for ( const auto& it : m_bindings ) {
@@ -113,9 +141,17 @@ const Value GSE::GetInclude( context::Context* ctx, const si_t& si, const std::s
 			cache.context->CreateVariable( "test", ctx->GetVariable( "test", &si ), &si );
 		}
 #endif
-		const auto parser = GetParser( full_path, source );
-		cache.program = parser->Parse();
-		DELETE( parser );
+		if ( m_program_cache ) {
+			cache.program = m_program_cache->Load( full_path, source );
+		}
+		if ( !cache.program ) {
+			const auto parser = GetParser( full_path, source );
+			cache.program = parser->Parse();
+			DELETE( parser );
+			if ( m_program_cache ) {
+				m_program_cache->Save( full_path, source, cache.program );
+			}
+		}
 		cache.runner = GetRunner();
 		cache.context->IncRefs();
 		cache.result = cache.runner->Execute( cache.context, cache.program );
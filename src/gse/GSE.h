@@ -11,6 +11,7 @@
 
 #include "Value.h"
 #include "builtins/Builtins.h"
+#include "runner/Types.h"
 
 namespace gse {
 
@@ -36,6 +37,8 @@ namespace type {
 class Callable;
 }
 
+class ProgramCache;
+
 CLASS( GSE, common::Class )
 	GSE();
 	virtual ~GSE();
@@ -43,10 +46,14 @@ CLASS( GSE, common::Class )
 	static const char PATH_SEPARATOR;
 
 	parser::Parser* GetParser( const std::string& filename, const std::string& source, const size_t initial_line_num = 1 ) const;
+	void SetRunnerType( const runner::runner_type_t runner_type );
 	runner::Runner* GetRunner() const;
 
 	void AddBindings( Bindings* bindings );
 
+	// enables on-disk cache of parsed includes in given directory
+	void SetProgramCachePath( const std::string& path );
+
 	context::GlobalContext* CreateGlobalContext( const std::string& source_path = "" );
 
 	void AddModule( const std::string& path, type::Callable* module );
@@ -72,9 +79,13 @@ private:
 	std::vector< std::string > m_modules_order = {};
 	std::map< std::string, Value > m_globals = {};
 
+	runner::runner_type_t m_runner_type = runner::RT_INTERPRETER;
+
 	std::vector< Bindings* > m_bindings = {};
 	builtins::Builtins m_builtins = {};
 
+	ProgramCache* m_program_cache = nullptr;
+
 	struct include_cache_t {
 		Value result;
 		context::Context* context;
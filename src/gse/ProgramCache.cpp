@@ -0,0 +1,135 @@
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+
+#include "ProgramCache.h"
+
+#include "GSE.h"
+#include "program/Program.h"
+#include "program/Serializer.h"
+#include "program/Resolver.h"
+
+#include "types/Buffer.h"
+#include "types/BufferView.h"
+#include "util/FS.h"
+#include "util/crc32/CRC32.h"
+
+namespace gse {
+
+static const std::string s_entry_extension = ".gspc";
+
+static const int64_t GetModificationTime( const std::string& script_path ) {
+	std::error_code ec;
+	const auto time = std::filesystem::last_write_time( util::FS::NormalizePath( script_path, GSE::PATH_SEPARATOR ), ec );
+	return ec
+		? 0
+		: time.time_since_epoch().count();
+}
+
+ProgramCache::ProgramCache( const std::string& path )
+	: m_path( path ) {
+	//
+}
+
+ProgramCache::~ProgramCache() {
+	if ( m_hits || m_misses ) {
+		Log( "Program cache: " + std::to_string( m_hits ) + " hits, " + std::to_string( m_misses ) + " misses" );
+	}
+}
+
+const program::Program* ProgramCache::Load( const std::string& script_path, const std::string& source ) {
+	const auto path = GetEntryPath( script_path );
+	if ( !util::FS::FileExists( path ) ) {
+		m_misses++;
+		LogResult( "miss", script_path );
+		return nullptr;
+	}
+
+	const program::Program* program = nullptr;
+	try {
+		const auto data = util::FS::ReadFile( path );
+		types::BufferView buf( data );
+		if (
+			buf.ReadInt() == ENTRY_VERSION &&
+				buf.ReadString() == script_path &&
+				buf.ReadInt() == GetModificationTime( script_path ) &&
+				(size_t)buf.ReadInt() == source.size() &&
+				(util::crc32::crc_t)buf.ReadInt() == util::crc32::CRC32::Calculate( source.data(), source.size() )
+			) {
+			program::Serializer serializer;
+			program = serializer.Unserialize( &buf );
+		}
+	}
+	catch ( std::exception& e ) {
+		// corrupted entry can fail in many ways ( including std::bad_alloc ), none of them should prevent parsing script again
+		Log( "Discarding invalid program cache entry: " + (std::string)e.what() );
+	}
+
+	if ( !program ) {
+		// stale or broken entry, it will be overwritten after script is parsed
+		m_misses++;
+		LogResult( "miss", script_path );
+		return nullptr;
+	}
+
+	// parser does it for parsed programs, runners rely on it
+	program::Resolver resolver;
+	resolver.Resolve( program );
+
+	m_hits++;
+	LogResult( "hit", script_path );
+	return program;
+}
+
+void ProgramCache::Save( const std::string& script_path, const std::string& source, const program::Program* program ) {
+	const auto path = GetEntryPath( script_path );
+	const auto tmp_path = path + ".tmp";
+
+	try {
+		types::Buffer buf( types::Buffer::F_COMPACT_CHECKSUMMED );
+		buf.WriteInt( ENTRY_VERSION );
+		buf.WriteString( script_path );
+		buf.WriteInt( GetModificationTime( script_path ) );
+		buf.WriteInt( source.size() );
+		buf.WriteInt( util::crc32::CRC32::Calculate( source.data(), source.size() ) );
+		program::Serializer serializer;
+		serializer.Serialize( &buf, program );
+
+		util::FS::CreateDirectoryIfNotExists( m_path );
+
+		// write to temporary file first so that partially written entry is never picked up
+		{
+			std::ofstream out( util::FS::NormalizePath( tmp_path, util::FS::PATH_SEPARATOR ), std::ios_base::binary | std::ios_base::trunc );
+			if ( !out.is_open() ) {
+				THROW( "failed to open \"" + tmp_path + "\" for writing" );
+			}
+			out.write( (const char*)buf.data, buf.lenw );
+			if ( !out.good() ) {
+				THROW( "failed to write \"" + tmp_path + "\"" );
+			}
+		}
+		std::filesystem::rename(
+			util::FS::NormalizePath( tmp_path, util::FS::PATH_SEPARATOR ),
+			util::FS::NormalizePath( path, util::FS::PATH_SEPARATOR )
+		);
+	}
+	catch ( std::exception& e ) {
+		// cache is optional, failing to write it shouldn't break anything
+		Log( "Failed to write program cache entry: " + (std::string)e.what() );
+		std::error_code ec;
+		std::filesystem::remove( util::FS::NormalizePath( tmp_path, util::FS::PATH_SEPARATOR ), ec );
+	}
+}
+
+const std::string ProgramCache::GetEntryPath( const std::string& script_path ) const {
+	std::stringstream ss;
+	ss << std::hex << std::setw( sizeof( util::crc32::crc_t ) * 2 ) << std::setfill( '0' ) << util::crc32::CRC32::Calculate( script_path.data(), script_path.size() );
+	return m_path + ss.str() + s_entry_extension;
+}
+
+void ProgramCache::LogResult( const std::string& result, const std::string& script_path ) const {
+	Log( "Program cache " + result + ": " + script_path + " ( " + std::to_string( m_hits ) + " hits, " + std::to_string( m_misses ) + " misses )" );
+}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "common/Common.h"
+
+namespace gse {
+
+namespace program {
+class Program;
+}
+
+// persistent on-disk cache of parsed programs, so that unchanged scripts skip tokenizing and parsing
+// entries are keyed by script path and are only valid for same modification time and source hash
+CLASS( ProgramCache, common::Class )
+
+	ProgramCache( const std::string& path );
+	~ProgramCache();
+
+	// returns nullptr if there is no valid entry for script, otherwise returned program is resolved and owned by caller
+	const program::Program* Load( const std::string& script_path, const std::string& source );
+	void Save( const std::string& script_path, const std::string& source, const program::Program* program );
+
+private:
+	static constexpr uint32_t ENTRY_VERSION = 1; // bump when program elements or their serialization change
+
+	const std::string m_path;
+
+	size_t m_hits = 0;
+	size_t m_misses = 0;
+
+	const std::string GetEntryPath( const std::string& script_path ) const;
+	void LogResult( const std::string& result, const std::string& script_path ) const;
+
+};
+
+}
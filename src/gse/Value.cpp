@@ -1,12 +1,9 @@
 #include "Value.h"
 
+#include <cstring>
+
 #include "common/Common.h"
 
-#include "type/Undefined.h"
-#include "type/Null.h"
-#include "type/Bool.h"
-#include "type/Int.h"
-#include "type/Float.h"
 #include "type/String.h"
 #include "type/Array.h"
 #include "type/Object.h"
@@ -16,37 +13,91 @@
 namespace gse {
 
 Value::Value( const std::shared_ptr< type::Type > data )
-	: m_data( data ) {
+	: m_type( data.get() )
+	, m_data( data ) {
 	// nothing
 }
 
+Value::Value( const Value& other ) {
+	CopyFrom( other );
+}
+
+Value::Value( Value&& other ) noexcept {
+	MoveFrom( other );
+}
+
 Value::~Value() {
-	// nothing
+	Release();
 }
 
-const type::Type* Value::Get() const {
-	return m_data.get();
+Value& Value::operator=( const Value& other ) {
+	if ( this != &other ) {
+		// other may be owned by this value ( i.e. be a property of it ), so copy it before releasing
+		Value copy( other );
+		Release();
+		MoveFrom( copy );
+	}
+	return *this;
+}
+
+Value& Value::operator=( Value&& other ) noexcept {
+	if ( this != &other ) {
+		Value moved( std::move( other ) );
+		Release();
+		MoveFrom( moved );
+	}
+	return *this;
+}
+
+void Value::CopyFrom( const Value& other ) {
+	if ( other.IsImmediate() ) {
+		// immediates are plain data without pointers
+		memcpy( m_immediate, other.m_immediate, IMMEDIATE_SIZE );
+		m_type = (type::Type*)m_immediate;
+	}
+	else {
+		new( &m_data ) std::shared_ptr< type::Type >( other.m_data );
+		m_type = other.m_type;
+	}
+}
+
+void Value::MoveFrom( Value& other ) {
+	if ( other.IsImmediate() ) {
+		memcpy( m_immediate, other.m_immediate, IMMEDIATE_SIZE );
+		m_type = (type::Type*)m_immediate;
+	}
+	else {
+		new( &m_data ) std::shared_ptr< type::Type >( std::move( other.m_data ) );
+		m_type = other.m_type;
+		other.m_type = nullptr;
+	}
+}
+
+void Value::Release() {
+	if ( !IsImmediate() ) {
+		m_data.~shared_ptr();
+	}
 }
 
 const std::string& Value::GetTypeString() const {
-	return m_data.get()->GetTypeString( m_data.get()->type );
+	return m_type->GetTypeString( m_type->type );
 }
 
 const std::string Value::ToString() const {
-	return m_data->ToString();
+	return m_type->ToString();
 }
 
 const std::string Value::Dump() const {
-	return m_data->Dump();
+	return m_type->Dump();
 }
 
 const Value Value::Clone() const {
-	return New( m_data.get() );
+	return Clone( m_type );
 }
 
 #define OP( _op ) \
 const bool Value::operator _op( const Value& other ) const { \
-    return *m_data->Deref() _op *other.m_data->Deref(); \
+    return *m_type->Deref() _op *other.m_type->Deref(); \
 }
 OP( == )
 OP( != )
@@ -60,11 +111,11 @@ void Value::Serialize( types::Buffer* buf, const Value& value ) {
 	type::Type::Serialize( buf, value.Get() );
 }
 
-Value Value::Unserialize( types::Buffer* buf ) {
+Value Value::Unserialize( types::BufferView* buf ) {
 	return type::Type::Unserialize( buf );
 }
 
-const Value Value::New( const type::Type* type ) const {
+const Value Value::Clone( const type::Type* type ) const {
 	switch ( type->type ) {
 		case type::Type::T_UNDEFINED:
 			return VALUE( type::Undefined );
@@ -100,7 +151,7 @@ const Value Value::New( const type::Type* type ) const {
 		case type::Type::T_ARRAYRANGEREF:
 		case type::Type::T_OBJECTREF: {
 			// no need to keep ref to old value if it's a copy
-			return New( type->Deref() );
+			return Clone( type->Deref() );
 		}
 		case type::Type::T_RANGE:
 			THROW( "ranges are not supposed to be cloned" );
@@ -1,14 +1,21 @@
 #pragma once
 
 #include <memory>
+#include <type_traits>
+#include <new>
 
 #include "common/Assert.h"
 
 #include "type/Type.h"
+#include "type/Undefined.h"
+#include "type/Null.h"
+#include "type/Bool.h"
+#include "type/Int.h"
+#include "type/Float.h"
 
 namespace gse {
 
-#define VALUE( _type, ... ) gse::Value( std::make_shared<_type>( __VA_ARGS__ ) )
+#define VALUE( _type, ... ) gse::Value::New< _type >( __VA_ARGS__ )
 #ifdef DEBUG
 #define VALUE_DATA( _type, _var ) ( _var.Get()->type == _type::GetType() ? ((_type*)_var.Get()) : THROW( "invalid GSE value type (expected " + type::Type::GetTypeString( _type::GetType() ) + ", got " + type::Type::GetTypeString( _var.Get()->type ) + ")" ) )
 #else
@@ -118,9 +125,32 @@ class Value {
 public:
 	Value() = delete;
 	Value( const std::shared_ptr< type::Type > data );
+	Value( const Value& other );
+	Value( Value&& other ) noexcept;
 	~Value();
 
-	const type::Type* Get() const;
+	Value& operator=( const Value& other );
+	Value& operator=( Value&& other ) noexcept;
+
+	// scalars ( undefined, null, bool, int, float ) are stored inside value itself, everything else is shared on heap
+	// note that scalars are therefore never shared between values, changing one won't change its copies
+	template< class _type, class... _args >
+	static Value New( _args&& ... args ) {
+		if constexpr ( IsImmediate< _type >() ) {
+			static_assert( sizeof( _type ) <= IMMEDIATE_SIZE && alignof( _type ) <= IMMEDIATE_ALIGN, "immediate type doesn't fit" );
+			static_assert( std::is_trivially_destructible< _type >::value, "immediate type must be trivially destructible" );
+			Value value( immediate_tag_t{} );
+			value.m_type = new( value.m_immediate ) _type( std::forward< _args >( args )... );
+			return value;
+		}
+		else {
+			return Value( std::make_shared< _type >( std::forward< _args >( args )... ) );
+		}
+	}
+
+	const type::Type* Get() const {
+		return m_type;
+	}
 	const std::string& GetTypeString() const;
 	const std::string ToString() const;
 	const std::string Dump() const;
@@ -137,12 +167,40 @@ public:
 #undef OP
 
 	static void Serialize( types::Buffer* buffer, const Value& value );
-	static Value Unserialize( types::Buffer* buf );
+	static Value Unserialize( types::BufferView* buf );
 
 private:
-	std::shared_ptr< type::Type > m_data;
-
-	const Value New( const type::Type* type ) const;
+	static constexpr size_t IMMEDIATE_SIZE = 16;
+	static constexpr size_t IMMEDIATE_ALIGN = 8;
+
+	template< class _type >
+	static constexpr bool IsImmediate() {
+		return
+			std::is_same< _type, type::Undefined >::value ||
+				std::is_same< _type, type::Null >::value ||
+				std::is_same< _type, type::Bool >::value ||
+				std::is_same< _type, type::Int >::value ||
+				std::is_same< _type, type::Float >::value;
+	}
+
+	struct immediate_tag_t {};
+	Value( const immediate_tag_t ) {}
+
+	// points either to m_immediate or to m_data contents ( or is nullptr for empty value )
+	type::Type* m_type;
+	union {
+		std::shared_ptr< type::Type > m_data;
+		alignas( IMMEDIATE_ALIGN ) unsigned char m_immediate[ IMMEDIATE_SIZE ];
+	};
+
+	const bool IsImmediate() const {
+		return m_type == (type::Type*)m_immediate;
+	}
+	void CopyFrom( const Value& other );
+	void MoveFrom( Value& other );
+	void Release();
+
+	const Value Clone( const type::Type* type ) const;
 };
 
 }
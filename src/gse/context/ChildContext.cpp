@@ -5,8 +5,8 @@
 namespace gse {
 namespace context {
 
-ChildContext::ChildContext( GSE* gse, Context* parent_context, Context* caller_context, const si_t& si, const bool is_traceable )
-	: Context( gse )
+ChildContext::ChildContext( GSE* gse, Context* parent_context, Context* caller_context, const si_t& si, const bool is_traceable, const program::frame_t* frame )
+	: Context( gse, frame )
 	, m_parent_context( parent_context )
 	, m_caller_context( caller_context )
 	, m_si( si )
@@ -38,6 +38,11 @@ const std::string& ChildContext::GetSourceLine( const size_t line_num ) const {
 }
 
 void ChildContext::JoinContext() const {
+	for ( size_t i = 0 ; i < m_slots.size() ; i++ ) {
+		if ( m_slots[ i ].value.Get() ) {
+			m_parent_context->SetVariable( m_frame->slots[ i ], m_slots[ i ] );
+		}
+	}
 	for ( const auto& it : m_variables ) {
 		m_parent_context->SetVariable( it.first, it.second );
 	}
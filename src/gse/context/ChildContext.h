@@ -13,7 +13,7 @@ namespace context {
 class ChildContext : public Context {
 public:
 
-	ChildContext( GSE* gse, Context* parent_context, Context* caller_context, const si_t& si, const bool is_traceable = true );
+	ChildContext( GSE* gse, Context* parent_context, Context* caller_context, const si_t& si, const bool is_traceable = true, const program::frame_t* frame = nullptr );
 
 	Context* GetParentContext() const override;
 	Context* GetCallerContext() const override;
@@ -8,6 +8,18 @@
 namespace gse {
 namespace context {
 
+Context::Context( GSE* gse, const program::frame_t* frame )
+	: m_gse( gse )
+	, m_frame( frame )
+	, m_slots(
+		frame
+			? frame->slots.size()
+			: 0, var_info_t{
+			Value( nullptr ),
+			false
+		}
+	) {}
+
 GSE* Context::GetGSE() const {
 	return m_gse;
 }
@@ -24,80 +36,70 @@ void Context::DecRefs() {
 }
 
 const bool Context::HasVariable( const std::string& name ) {
-	const auto it = m_variables.find( name );
-	if ( it != m_variables.end() ) {
-		return true;
-	}
-	const auto ref_it = m_ref_contexts.find( name );
-	if ( ref_it != m_ref_contexts.end() ) {
-		return true;
-	}
-	return false;
+	return FindVariable( name ) != nullptr;
 }
 
 const Value Context::GetVariable( const std::string& name, const si_t* si ) {
-	const auto it = m_variables.find( name );
-	if ( it != m_variables.end() ) {
-		return it->second.value;
-	}
-	const auto ref_it = m_ref_contexts.find( name );
-	if ( ref_it != m_ref_contexts.end() ) {
-		ASSERT_NOLOG( ref_it->second != this, "unexpected ref context recursion (was this context freed while in use?)" );
-		return ref_it->second->GetVariable( name, si );
+	const auto* var_info = FindVariable( name );
+	if ( !var_info ) {
+		throw Exception( EC.REFERENCE_ERROR, "Variable '" + name + "' is not defined", this, *si );
 	}
-	throw Exception( EC.REFERENCE_ERROR, "Variable '" + name + "' is not defined", this, *si );
+	return var_info->value;
 }
 
 void Context::SetVariable( const std::string& name, const var_info_t& var_info ) {
-	m_variables.insert_or_assign( name, var_info );
+	auto* slot = GetSlot( name );
+	if ( slot ) {
+		*slot = var_info;
+	}
+	else {
+		m_variables.insert_or_assign( name, var_info );
+	}
 }
 
 void Context::CreateVariable( const std::string& name, const Value& value, const si_t* si ) {
-	if ( m_variables.find( name ) != m_variables.end() ) {
-		throw Exception( EC.INVALID_ASSIGNMENT, "Variable '" + name + "' already exists", this, *si );
-	}
-	m_variables.insert_or_assign(
+	DeclareVariable(
 		name, var_info_t{
 			value,
 			false,
-		}
+		}, si
 	);
 }
 
 void Context::CreateConst( const std::string& name, const Value& value, const si_t* si ) {
-	if ( m_variables.find( name ) != m_variables.end() ) {
-		throw Exception( EC.INVALID_ASSIGNMENT, "Variable '" + name + "' already exists", this, *si );
-	}
-	m_variables.insert_or_assign(
+	DeclareVariable(
 		name, var_info_t{
 			value,
 			true
-		}
+		}, si
 	);
 }
 
 void Context::UpdateVariable( const std::string& name, const Value& value, const si_t* si ) {
-	const auto it = m_variables.find( name );
-	if ( it != m_variables.end() ) {
-		if ( it->second.is_const ) {
-			throw Exception( EC.INVALID_ASSIGNMENT, "Can't change value of const '" + name + "'", this, *si );
-		}
-		it->second.value = value;
-		return;
+	auto* var_info = FindVariable( name );
+	if ( !var_info ) {
+		throw Exception( EC.REFERENCE_ERROR, "Variable '" + name + "' is not defined", this, *si );
 	}
-	const auto ref_it = m_ref_contexts.find( name );
-	if ( ref_it != m_ref_contexts.end() ) {
-		ref_it->second->UpdateVariable( name, value, si );
-		return;
+	if ( var_info->is_const ) {
+		throw Exception( EC.INVALID_ASSIGNMENT, "Can't change value of const '" + name + "'", this, *si );
 	}
-	throw Exception( EC.REFERENCE_ERROR, "Variable '" + name + "' is not defined", this, *si );
+	var_info->value = value;
 }
 
 void Context::DestroyVariable( const std::string& name, const si_t* si ) {
-	const auto it = m_variables.find( name );
-	if ( it != m_variables.end() ) {
-		m_variables.erase( it );
-		return;
+	auto* slot = GetSlot( name );
+	if ( slot ) {
+		if ( slot->value.Get() ) {
+			slot->value = Value( nullptr );
+			return;
+		}
+	}
+	else {
+		const auto it = m_variables.find( name );
+		if ( it != m_variables.end() ) {
+			m_variables.erase( it );
+			return;
+		}
 	}
 	throw Exception( EC.REFERENCE_ERROR, "Variable '" + name + "' is not defined", this, *si );
 }
@@ -138,28 +140,169 @@ void Context::UnpersistValue( const type::Type* type ) {
 	DecRefs();
 }
 
+const Value Context::GetVariable( const std::string& name, const program::variable_address_t& address, const si_t* si ) {
+	const auto* var_info = FindVariable( name, address );
+	if ( !var_info ) {
+		throw Exception( EC.REFERENCE_ERROR, "Variable '" + name + "' is not defined", this, *si );
+	}
+	return var_info->value;
+}
+
+void Context::CreateVariable( const std::string& name, const program::variable_address_t& address, const Value& value, const si_t* si ) {
+	DeclareVariable(
+		name, address, var_info_t{
+			value,
+			false,
+		}, si
+	);
+}
+
+void Context::CreateConst( const std::string& name, const program::variable_address_t& address, const Value& value, const si_t* si ) {
+	DeclareVariable(
+		name, address, var_info_t{
+			value,
+			true
+		}, si
+	);
+}
+
+void Context::UpdateVariable( const std::string& name, const program::variable_address_t& address, const Value& value, const si_t* si ) {
+	auto* var_info = FindVariable( name, address );
+	if ( !var_info ) {
+		throw Exception( EC.REFERENCE_ERROR, "Variable '" + name + "' is not defined", this, *si );
+	}
+	if ( var_info->is_const ) {
+		throw Exception( EC.INVALID_ASSIGNMENT, "Can't change value of const '" + name + "'", this, *si );
+	}
+	var_info->value = value;
+}
+
+void Context::DestroyVariable( const std::string& name, const program::variable_address_t& address, const si_t* si ) {
+	if ( !address.is_resolved ) {
+		DestroyVariable( name, si );
+		return;
+	}
+	ASSERT_NOLOG( !address.depth && address.slot < m_slots.size(), "invalid slot of own variable '" + name + "'" );
+	auto& slot = m_slots[ address.slot ];
+	if ( !slot.value.Get() ) {
+		throw Exception( EC.REFERENCE_ERROR, "Variable '" + name + "' is not defined", this, *si );
+	}
+	slot.value = Value( nullptr );
+}
+
 ChildContext* const Context::ForkContext(
 	Context* caller_context,
 	const si_t& call_si,
 	const bool is_traceable,
-	const std::vector< std::string > parameters,
+	const program::frame_t* frame,
 	const type::function_arguments_t& arguments
 ) {
-	if ( parameters.size() != arguments.size() ) {
-		throw Exception( EC.INVALID_CALL, "Expected " + std::to_string( parameters.size() ) + " arguments, found " + std::to_string( arguments.size() ), this, call_si );
+	const size_t parameters_count = frame
+		? frame->parameters.size()
+		: 0;
+	if ( parameters_count != arguments.size() ) {
+		throw Exception( EC.INVALID_CALL, "Expected " + std::to_string( parameters_count ) + " arguments, found " + std::to_string( arguments.size() ), this, call_si );
 	}
-	NEWV( result, ChildContext, m_gse, this, caller_context, call_si, is_traceable );
-	// functions have access to parent variables
-	for ( auto& it : m_ref_contexts ) {
-		result->m_ref_contexts.insert_or_assign( it.first, it.second );
+	// parent variables aren't copied, they are reached through parent context when needed
+	NEWV( result, ChildContext, m_gse, this, caller_context, call_si, is_traceable, frame );
+	for ( size_t i = 0 ; i < arguments.size() ; i++ ) { // inject passed arguments
+		const auto slot = frame->parameters[ i ];
+		result->DeclareVariable(
+			frame->slots[ slot ], {
+				true,
+				0,
+				slot
+			}, {
+				arguments[ i ],
+				false
+			}, &call_si
+		);
 	}
-	for ( auto& it : m_variables ) {
-		result->m_ref_contexts.insert_or_assign( it.first, this );
+	return result;
+}
+
+Context::var_info_t* Context::GetSlot( const std::string& name ) {
+	if ( m_frame ) {
+		// frames are small, linear search is cheaper than hashing
+		for ( size_t i = 0 ; i < m_frame->slots.size() ; i++ ) {
+			if ( m_frame->slots[ i ] == name ) {
+				return &m_slots[ i ];
+			}
+		}
 	}
-	for ( size_t i = 0 ; i < parameters.size() ; i++ ) { // inject passed arguments
-		result->CreateVariable( parameters[ i ], arguments[ i ], &call_si );
+	return nullptr;
+}
+
+Context::var_info_t* Context::GetOwnVariable( const std::string& name ) {
+	auto* slot = GetSlot( name );
+	if ( slot ) {
+		return slot;
 	}
-	return result;
+	if ( !m_variables.empty() ) {
+		const auto it = m_variables.find( name );
+		if ( it != m_variables.end() ) {
+			return &it->second;
+		}
+	}
+	return nullptr;
+}
+
+Context::var_info_t* Context::FindVariable( const std::string& name ) {
+	Context* ctx = this;
+	while ( ctx ) {
+		auto* var_info = ctx->GetOwnVariable( name );
+		if ( var_info && var_info->value.Get() ) {
+			return var_info;
+		}
+		ctx = ctx->GetParentContext();
+	}
+	return nullptr;
+}
+
+Context::var_info_t* Context::FindVariable( const std::string& name, const program::variable_address_t& address ) {
+	if ( address.is_resolved ) {
+		Context* ctx = this;
+		for ( uint32_t i = 0 ; i < address.depth ; i++ ) {
+			if ( !ctx->m_variables.empty() ) {
+				// variables were added at runtime ( i.e. joined from child scope ), they may shadow resolved one
+				return FindVariable( name );
+			}
+			ctx = ctx->GetParentContext();
+		}
+		ASSERT_NOLOG( address.slot < ctx->m_slots.size(), "invalid slot of variable '" + name + "'" );
+		auto& slot = ctx->m_slots[ address.slot ];
+		if ( slot.value.Get() ) {
+			return &slot;
+		}
+		// not declared yet, so it's same-named variable from outer context ( if any )
+	}
+	return FindVariable( name );
+}
+
+void Context::DeclareVariable( const std::string& name, const var_info_t& var_info, const si_t* si ) {
+	auto* own = GetOwnVariable( name );
+	if ( own ) {
+		if ( own->value.Get() ) {
+			throw Exception( EC.INVALID_ASSIGNMENT, "Variable '" + name + "' already exists", this, *si );
+		}
+		*own = var_info;
+	}
+	else {
+		m_variables.insert_or_assign( name, var_info );
+	}
+}
+
+void Context::DeclareVariable( const std::string& name, const program::variable_address_t& address, const var_info_t& var_info, const si_t* si ) {
+	if ( !address.is_resolved ) {
+		DeclareVariable( name, var_info, si );
+		return;
+	}
+	ASSERT_NOLOG( !address.depth && address.slot < m_slots.size(), "invalid slot of own variable '" + name + "'" );
+	auto& slot = m_slots[ address.slot ];
+	if ( slot.value.Get() ) {
+		throw Exception( EC.INVALID_ASSIGNMENT, "Variable '" + name + "' already exists", this, *si );
+	}
+	slot = var_info;
 }
 
 }
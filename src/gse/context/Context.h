@@ -6,6 +6,7 @@
 
 #include "gse/Types.h"
 #include "gse/type/Types.h"
+#include "gse/program/Types.h"
 
 #include "gse/Value.h"
 
@@ -20,7 +21,7 @@ class ChildContext;
 class Context {
 protected:
 	struct var_info_t {
-		Value value;
+		Value value; // empty in slots of variables that weren't declared yet ( or were destroyed )
 		bool is_const;
 	};
 	struct script_info_t {
@@ -30,8 +31,7 @@ protected:
 	};
 
 public:
-	Context( GSE* gse )
-		: m_gse( gse ) {}
+	Context( GSE* gse, const program::frame_t* frame = nullptr );
 	virtual ~Context() = default;
 
 	GSE* GetGSE() const;
@@ -47,6 +47,14 @@ public:
 	void UpdateVariable( const std::string& name, const Value& value, const si_t* si );
 	void DestroyVariable( const std::string& name, const si_t* si );
 	void CreateBuiltin( const std::string& name, const Value& value );
+
+	// same as above but use address assigned by program::Resolver if variable is resolved
+	const Value GetVariable( const std::string& name, const program::variable_address_t& address, const si_t* si );
+	void CreateVariable( const std::string& name, const program::variable_address_t& address, const Value& value, const si_t* si );
+	void CreateConst( const std::string& name, const program::variable_address_t& address, const Value& value, const si_t* si );
+	void UpdateVariable( const std::string& name, const program::variable_address_t& address, const Value& value, const si_t* si );
+	void DestroyVariable( const std::string& name, const program::variable_address_t& address, const si_t* si );
+
 	void PersistValue( const Value& value );
 	void UnpersistValue( const Value& value );
 	void UnpersistValue( const type::Type* type );
@@ -55,7 +63,7 @@ public:
 		Context* caller_context,
 		const si_t& call_si,
 		const bool is_traceable,
-		const std::vector< std::string > parameters = {},
+		const program::frame_t* frame = nullptr,
 		const type::function_arguments_t& arguments = {}
 	);
 
@@ -70,12 +78,23 @@ protected:
 	GSE* m_gse;
 	size_t m_refs = 0;
 
+	// variables declared in program are stored in slots, parent variables are reached through parent contexts
+	const program::frame_t* const m_frame;
+	std::vector< var_info_t > m_slots;
+
+	// variables that have no slots ( builtins, globals, ones created by native code or joined from child contexts )
 	typedef std::unordered_map< std::string, var_info_t > variables_t;
 	variables_t m_variables = {};
-	typedef std::unordered_map< std::string, Context* > ref_contexts_t;
-	ref_contexts_t m_ref_contexts = {};
 
 	std::unordered_map< const type::Type*, Value > m_persisted_values = {};
+
+private:
+	var_info_t* GetSlot( const std::string& name );
+	var_info_t* GetOwnVariable( const std::string& name ); // may return slot of variable that isn't declared yet
+	var_info_t* FindVariable( const std::string& name ); // searches this and parent contexts
+	var_info_t* FindVariable( const std::string& name, const program::variable_address_t& address );
+	void DeclareVariable( const std::string& name, const var_info_t& var_info, const si_t* si );
+	void DeclareVariable( const std::string& name, const program::variable_address_t& address, const var_info_t& var_info, const si_t* si );
 };
 
 }
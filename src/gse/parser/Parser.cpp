@@ -2,6 +2,8 @@
 
 #include <cstring>
 
+#include "gse/program/Resolver.h"
+
 namespace gse {
 namespace parser {
 
@@ -22,6 +24,8 @@ const program::Program* Parser::Parse() {
 	for ( auto& it : elements ) {
 		delete it;
 	}
+	program::Resolver resolver;
+	resolver.Resolve( program );
 	return program;
 }
 
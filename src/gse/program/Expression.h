@@ -2,6 +2,8 @@
 
 #include "Operand.h"
 
+#include "gse/type/Shape.h"
+
 namespace gse {
 namespace program {
 
@@ -17,6 +19,9 @@ public:
 	const Operator* op;
 	const Operand* b;
 
+	// for OT_CHILD, filled by runner
+	mutable type::property_cache_t child_cache = {};
+
 	const std::string ToString() const override;
 	const std::string Dump( const size_t depth = 0 ) const override;
 };
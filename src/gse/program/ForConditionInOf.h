@@ -2,6 +2,8 @@
 
 #include "ForCondition.h"
 
+#include "Types.h"
+
 namespace gse {
 namespace program {
 
@@ -23,6 +25,8 @@ public:
 	const for_inof_condition_type_t for_inof_type;
 	const Expression* expression;
 
+	mutable frame_t frame = {}; // assigned by Resolver, contains iteration variable
+
 	const std::string ToString() const override;
 	const std::string Dump( const size_t depth = 0 ) const override;
 };
@@ -4,6 +4,8 @@
 
 #include "Operand.h"
 
+#include "Types.h"
+
 namespace gse {
 namespace program {
 
@@ -19,6 +21,8 @@ public:
 	const std::vector< Variable* > parameters;
 	const Scope* body;
 
+	mutable frame_t frame = {}; // assigned by Resolver, contains parameters
+
 	const std::string ToString() const override;
 	const std::string Dump( const size_t depth = 0 ) const override;
 };
@@ -6,6 +6,8 @@
 
 #include "Operand.h"
 
+#include "Types.h"
+
 namespace gse {
 namespace program {
 
@@ -22,6 +24,8 @@ public:
 	properties_t properties = {};
 	const ordered_properties_t ordered_properties;
 
+	mutable frame_t frame = {}; // assigned by Resolver, contains 'this'
+
 	const std::string ToString() const override;
 	const std::string Dump( const size_t depth = 0 ) const override;
 };
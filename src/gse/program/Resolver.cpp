@@ -0,0 +1,265 @@
+#include "Resolver.h"
+
+#include "common/Assert.h"
+
+#include "Program.h"
+#include "Scope.h"
+#include "Control.h"
+#include "Statement.h"
+#include "Conditional.h"
+#include "If.h"
+#include "ElseIf.h"
+#include "Else.h"
+#include "While.h"
+#include "For.h"
+#include "ForCondition.h"
+#include "ForConditionInOf.h"
+#include "ForConditionExpressions.h"
+#include "SimpleCondition.h"
+#include "Try.h"
+#include "Catch.h"
+#include "Expression.h"
+#include "Operator.h"
+#include "Operand.h"
+#include "Variable.h"
+#include "Array.h"
+#include "Object.h"
+#include "Function.h"
+#include "Call.h"
+
+namespace gse {
+namespace program {
+
+void Resolver::Resolve( const Program* program ) {
+	m_frames.clear();
+	m_references.clear();
+
+	// program body is executed in context given by caller ( global context or prompt ), it's not known here
+	ResolveScope( program->body, nullptr );
+
+	for ( const auto& it : m_references ) {
+		uint32_t depth = 0;
+		for ( const auto* frame_info = it.second ; frame_info ; frame_info = frame_info->parent ) {
+			const auto slot_it = frame_info->slots.find( it.first->name );
+			if ( slot_it != frame_info->slots.end() ) {
+				it.first->address = {
+					true,
+					depth,
+					slot_it->second
+				};
+				break;
+			}
+			depth++;
+		}
+	}
+
+	m_frames.clear();
+	m_references.clear();
+}
+
+Resolver::frame_info_t* Resolver::Enter( frame_t* frame, const frame_info_t* parent ) {
+	frame->slots.clear();
+	frame->parameters.clear();
+	m_frames.push_back(
+		{
+			frame,
+			parent,
+			{}
+		}
+	);
+	return &m_frames.back();
+}
+
+const uint32_t Resolver::Declare( frame_info_t* frame_info, const std::string& name ) {
+	const auto it = frame_info->slots.find( name );
+	if ( it != frame_info->slots.end() ) {
+		// redeclaration is reported by context when it happens
+		return it->second;
+	}
+	const uint32_t slot = frame_info->frame->slots.size();
+	frame_info->frame->slots.push_back( name );
+	frame_info->slots.insert(
+		{
+			name,
+			slot
+		}
+	);
+	return slot;
+}
+
+void Resolver::ResolveScope( const Scope* scope, const frame_info_t* parent ) {
+	auto* frame_info = Enter( &scope->frame, parent );
+	for ( const auto& it : scope->body ) {
+		switch ( it->control_type ) {
+			case Control::CT_STATEMENT: {
+				ResolveExpression( ( (Statement*)it )->body, frame_info );
+				break;
+			}
+			case Control::CT_CONDITIONAL: {
+				ResolveConditional( (Conditional*)it, frame_info );
+				break;
+			}
+			default:
+				THROW( "unexpected control type: " + it->Dump() );
+		}
+	}
+}
+
+void Resolver::ResolveConditional( const Conditional* conditional, frame_info_t* frame_info ) {
+	switch ( conditional->conditional_type ) {
+		case Conditional::CT_IF: {
+			const auto* c = (If*)conditional;
+			ResolveExpression( c->condition->expression, frame_info );
+			ResolveScope( c->body, frame_info );
+			if ( c->els ) {
+				ResolveConditional( c->els, frame_info );
+			}
+			break;
+		}
+		case Conditional::CT_ELSEIF: {
+			const auto* c = (ElseIf*)conditional;
+			ResolveExpression( c->condition->expression, frame_info );
+			ResolveScope( c->body, frame_info );
+			if ( c->els ) {
+				ResolveConditional( c->els, frame_info );
+			}
+			break;
+		}
+		case Conditional::CT_ELSE: {
+			ResolveScope( ( (Else*)conditional )->body, frame_info );
+			break;
+		}
+		case Conditional::CT_WHILE: {
+			const auto* c = (While*)conditional;
+			ResolveExpression( c->condition->expression, frame_info );
+			ResolveScope( c->body, frame_info );
+			break;
+		}
+		case Conditional::CT_FOR: {
+			const auto* c = (For*)conditional;
+			switch ( c->condition->for_type ) {
+				case ForCondition::FCT_EXPRESSIONS: {
+					// these are evaluated in enclosing context
+					const auto* condition = (ForConditionExpressions*)c->condition;
+					ResolveExpression( condition->init, frame_info );
+					ResolveExpression( condition->check, frame_info );
+					ResolveExpression( condition->iterate, frame_info );
+					ResolveScope( c->body, frame_info );
+					break;
+				}
+				case ForCondition::FCT_IN_OF: {
+					// iteration variable lives in separate context around body
+					const auto* condition = (ForConditionInOf*)c->condition;
+					ResolveExpression( condition->expression, frame_info );
+					auto* for_frame_info = Enter( &condition->frame, frame_info );
+					condition->variable->address = {
+						true,
+						0,
+						Declare( for_frame_info, condition->variable->name )
+					};
+					ResolveScope( c->body, for_frame_info );
+					break;
+				}
+				default:
+					THROW( "unexpected for condition type: " + std::to_string( c->condition->for_type ) );
+			}
+			break;
+		}
+		case Conditional::CT_TRY: {
+			const auto* c = (Try*)conditional;
+			ResolveScope( c->body, frame_info );
+			// handlers are evaluated in enclosing context, not as object
+			for ( const auto& it : c->handlers->handlers->ordered_properties ) {
+				ResolveExpression( it.second, frame_info );
+			}
+			break;
+		}
+		default: {
+			// other conditionals ( i.e. catch without try ) are reported by runner
+		}
+	}
+}
+
+void Resolver::ResolveExpression( const Expression* expression, frame_info_t* frame_info ) {
+	if ( expression->a ) {
+		ResolveOperand( expression->a, frame_info );
+	}
+	if ( expression->b && !( expression->op && expression->op->op == OT_CHILD ) ) { // child name is not a variable
+		ResolveOperand( expression->b, frame_info );
+	}
+}
+
+void Resolver::ResolveOperand( const Operand* operand, frame_info_t* frame_info ) {
+	switch ( operand->type ) {
+		case Operand::OT_VARIABLE: {
+			const auto* var = (Variable*)operand;
+			if ( var->hints == VH_NONE ) {
+				m_references.push_back(
+					{
+						var,
+						frame_info
+					}
+				);
+			}
+			else {
+				var->address = {
+					true,
+					0,
+					Declare( frame_info, var->name )
+				};
+			}
+			break;
+		}
+		case Operand::OT_ARRAY: {
+			for ( const auto& it : ( (Array*)operand )->elements ) {
+				ResolveExpression( it, frame_info );
+			}
+			break;
+		}
+		case Operand::OT_OBJECT: {
+			const auto* obj = (Object*)operand;
+			auto* object_frame_info = Enter( &obj->frame, frame_info );
+			Declare( object_frame_info, "this" );
+			for ( const auto& it : obj->ordered_properties ) {
+				ResolveExpression( it.second, object_frame_info );
+			}
+			break;
+		}
+		case Operand::OT_SCOPE: {
+			ResolveScope( (Scope*)operand, frame_info );
+			break;
+		}
+		case Operand::OT_EXPRESSION: {
+			ResolveExpression( (Expression*)operand, frame_info );
+			break;
+		}
+		case Operand::OT_FUNCTION: {
+			const auto* func = (Function*)operand;
+			auto* function_frame_info = Enter( &func->frame, frame_info );
+			for ( const auto& it : func->parameters ) {
+				it->address = {
+					true,
+					0,
+					Declare( function_frame_info, it->name )
+				};
+				func->frame.parameters.push_back( it->address.slot );
+			}
+			ResolveScope( func->body, function_frame_info );
+			break;
+		}
+		case Operand::OT_CALL: {
+			const auto* call = (Call*)operand;
+			ResolveExpression( call->callable, frame_info );
+			for ( const auto& it : call->arguments ) {
+				ResolveExpression( it, frame_info );
+			}
+			break;
+		}
+		default: {
+			// values don't reference anything
+		}
+	}
+}
+
+}
+}
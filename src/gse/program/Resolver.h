@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+
+#include "Types.h"
+
+namespace gse {
+namespace program {
+
+class Program;
+class Scope;
+class Conditional;
+class Expression;
+class Operand;
+class Variable;
+
+// assigns slots to declared variables and ( depth, slot ) addresses to references, so that runners don't need to look them up by name
+// frames must mirror contexts that runners create: one per scope, function call, for..in/of loop and object literal
+class Resolver {
+public:
+
+	void Resolve( const Program* program );
+
+private:
+	struct frame_info_t {
+		frame_t* frame;
+		const frame_info_t* parent;
+		std::unordered_map< std::string, uint32_t > slots;
+	};
+	std::deque< frame_info_t > m_frames = {};
+
+	// references are resolved after whole program is walked, because variables may be declared after functions that use them
+	std::vector< std::pair< const Variable*, const frame_info_t* > > m_references = {};
+
+	frame_info_t* Enter( frame_t* frame, const frame_info_t* parent );
+	const uint32_t Declare( frame_info_t* frame_info, const std::string& name );
+
+	void ResolveScope( const Scope* scope, const frame_info_t* parent );
+	void ResolveConditional( const Conditional* conditional, frame_info_t* frame_info );
+	void ResolveExpression( const Expression* expression, frame_info_t* frame_info );
+	void ResolveOperand( const Operand* operand, frame_info_t* frame_info );
+
+};
+
+}
+}
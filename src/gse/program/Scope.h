@@ -4,6 +4,8 @@
 
 #include "Operand.h"
 
+#include "Types.h"
+
 namespace gse {
 namespace program {
 
@@ -17,6 +19,8 @@ public:
 
 	const std::vector< const Control* > body;
 
+	mutable frame_t frame = {}; // assigned by Resolver
+
 	const std::string ToString() const override;
 	const std::string Dump( const size_t depth = 0 ) const override;
 };
@@ -0,0 +1,488 @@
+#include "Serializer.h"
+
+#include "common/Assert.h"
+
+#include "types/Buffer.h"
+#include "types/BufferView.h"
+
+#include "Program.h"
+#include "Scope.h"
+#include "Control.h"
+#include "Statement.h"
+#include "Conditional.h"
+#include "If.h"
+#include "ElseIf.h"
+#include "Else.h"
+#include "While.h"
+#include "For.h"
+#include "ForCondition.h"
+#include "ForConditionInOf.h"
+#include "ForConditionExpressions.h"
+#include "SimpleCondition.h"
+#include "Try.h"
+#include "Catch.h"
+#include "Expression.h"
+#include "Operator.h"
+#include "Operand.h"
+#include "Nothing.h"
+#include "Value.h"
+#include "Variable.h"
+#include "Array.h"
+#include "Object.h"
+#include "Function.h"
+#include "Call.h"
+
+namespace gse {
+namespace program {
+
+void Serializer::Serialize( types::Buffer* buf, const Program* program ) {
+	m_file = program->body->m_si.file;
+	buf->WriteString( m_file );
+	WriteScope( buf, program->body );
+}
+
+const Program* Serializer::Unserialize( types::BufferView* buf ) {
+	m_file = buf->ReadString();
+	return new Program( ReadScope( buf ) );
+}
+
+void Serializer::WriteSi( types::Buffer* buf, const si_t& si ) const {
+	// some elements are generated by parser and don't have file
+	if ( si.file == m_file ) {
+		buf->WriteBool( true );
+	}
+	else {
+		buf->WriteBool( false );
+		buf->WriteString( si.file );
+	}
+	buf->WriteInt( si.from.line );
+	buf->WriteInt( si.from.col );
+	buf->WriteInt( si.to.line );
+	buf->WriteInt( si.to.col );
+}
+
+void Serializer::WriteScope( types::Buffer* buf, const Scope* scope ) const {
+	WriteSi( buf, scope->m_si );
+	buf->WriteInt( scope->body.size() );
+	for ( const auto& it : scope->body ) {
+		WriteControl( buf, it );
+	}
+}
+
+void Serializer::WriteControl( types::Buffer* buf, const Control* control ) const {
+	buf->WriteInt( control->control_type );
+	switch ( control->control_type ) {
+		case Control::CT_STATEMENT: {
+			const auto* statement = (Statement*)control;
+			WriteSi( buf, statement->m_si );
+			WriteExpression( buf, statement->body );
+			break;
+		}
+		case Control::CT_CONDITIONAL: {
+			WriteConditional( buf, (Conditional*)control );
+			break;
+		}
+		default:
+			THROW( "unexpected control type: " + control->Dump() );
+	}
+}
+
+void Serializer::WriteConditional( types::Buffer* buf, const Conditional* conditional ) const {
+	if ( !conditional ) {
+		buf->WriteBool( false );
+		return;
+	}
+	buf->WriteBool( true );
+	buf->WriteInt( conditional->conditional_type );
+	WriteSi( buf, conditional->m_si );
+	switch ( conditional->conditional_type ) {
+		case Conditional::CT_IF: {
+			const auto* c = (If*)conditional;
+			WriteSimpleCondition( buf, c->condition );
+			WriteScope( buf, c->body );
+			WriteConditional( buf, c->els );
+			break;
+		}
+		case Conditional::CT_ELSEIF: {
+			const auto* c = (ElseIf*)conditional;
+			WriteSimpleCondition( buf, c->condition );
+			WriteScope( buf, c->body );
+			WriteConditional( buf, c->els );
+			break;
+		}
+		case Conditional::CT_ELSE: {
+			WriteScope( buf, ( (Else*)conditional )->body );
+			break;
+		}
+		case Conditional::CT_WHILE: {
+			const auto* c = (While*)conditional;
+			WriteSimpleCondition( buf, c->condition );
+			WriteScope( buf, c->body );
+			break;
+		}
+		case Conditional::CT_FOR: {
+			const auto* c = (For*)conditional;
+			WriteSi( buf, c->condition->m_si );
+			buf->WriteInt( c->condition->for_type );
+			switch ( c->condition->for_type ) {
+				case ForCondition::FCT_EXPRESSIONS: {
+					const auto* condition = (ForConditionExpressions*)c->condition;
+					WriteExpression( buf, condition->init );
+					WriteExpression( buf, condition->check );
+					WriteExpression( buf, condition->iterate );
+					break;
+				}
+				case ForCondition::FCT_IN_OF: {
+					const auto* condition = (ForConditionInOf*)c->condition;
+					WriteVariable( buf, condition->variable );
+					buf->WriteInt( condition->for_inof_type );
+					WriteExpression( buf, condition->expression );
+					break;
+				}
+				default:
+					THROW( "unexpected for condition type: " + std::to_string( c->condition->for_type ) );
+			}
+			WriteScope( buf, c->body );
+			break;
+		}
+		case Conditional::CT_TRY: {
+			const auto* c = (Try*)conditional;
+			WriteScope( buf, c->body );
+			WriteSi( buf, c->handlers->m_si );
+			WriteObject( buf, c->handlers->handlers );
+			break;
+		}
+		case Conditional::CT_CATCH: {
+			WriteObject( buf, ( (Catch*)conditional )->handlers );
+			break;
+		}
+		default:
+			THROW( "unexpected conditional type: " + conditional->Dump() );
+	}
+}
+
+void Serializer::WriteSimpleCondition( types::Buffer* buf, const SimpleCondition* condition ) const {
+	WriteSi( buf, condition->m_si );
+	WriteExpression( buf, condition->expression );
+}
+
+void Serializer::WriteExpression( types::Buffer* buf, const Expression* expression ) const {
+	if ( !expression ) {
+		buf->WriteBool( false );
+		return;
+	}
+	buf->WriteBool( true );
+	WriteSi( buf, expression->m_si );
+	WriteOperand( buf, expression->a );
+	if ( expression->op ) {
+		buf->WriteBool( true );
+		WriteSi( buf, expression->op->m_si );
+		buf->WriteInt( expression->op->op );
+	}
+	else {
+		buf->WriteBool( false );
+	}
+	WriteOperand( buf, expression->b );
+}
+
+void Serializer::WriteOperand( types::Buffer* buf, const Operand* operand ) const {
+	if ( !operand ) {
+		buf->WriteBool( false );
+		return;
+	}
+	buf->WriteBool( true );
+	buf->WriteInt( operand->type );
+	switch ( operand->type ) {
+		case Operand::OT_NOTHING: {
+			WriteSi( buf, operand->m_si );
+			break;
+		}
+		case Operand::OT_VALUE: {
+			WriteSi( buf, operand->m_si );
+			gse::Value::Serialize( buf, ( (Value*)operand )->value );
+			break;
+		}
+		case Operand::OT_VARIABLE: {
+			WriteVariable( buf, (Variable*)operand );
+			break;
+		}
+		case Operand::OT_ARRAY: {
+			const auto* arr = (Array*)operand;
+			WriteSi( buf, arr->m_si );
+			buf->WriteInt( arr->elements.size() );
+			for ( const auto& it : arr->elements ) {
+				WriteExpression( buf, it );
+			}
+			break;
+		}
+		case Operand::OT_OBJECT: {
+			WriteObject( buf, (Object*)operand );
+			break;
+		}
+		case Operand::OT_SCOPE: {
+			WriteScope( buf, (Scope*)operand );
+			break;
+		}
+		case Operand::OT_EXPRESSION: {
+			WriteExpression( buf, (Expression*)operand );
+			break;
+		}
+		case Operand::OT_FUNCTION: {
+			const auto* func = (Function*)operand;
+			WriteSi( buf, func->m_si );
+			buf->WriteInt( func->parameters.size() );
+			for ( const auto& it : func->parameters ) {
+				WriteVariable( buf, it );
+			}
+			WriteScope( buf, func->body );
+			break;
+		}
+		case Operand::OT_CALL: {
+			const auto* call = (Call*)operand;
+			WriteSi( buf, call->m_si );
+			WriteExpression( buf, call->callable );
+			buf->WriteInt( call->arguments.size() );
+			for ( const auto& it : call->arguments ) {
+				WriteExpression( buf, it );
+			}
+			break;
+		}
+		default:
+			THROW( "unexpected operand type: " + operand->Dump() );
+	}
+}
+
+void Serializer::WriteVariable( types::Buffer* buf, const Variable* variable ) const {
+	WriteSi( buf, variable->m_si );
+	buf->WriteString( variable->name );
+	buf->WriteInt( variable->hints );
+}
+
+void Serializer::WriteObject( types::Buffer* buf, const Object* object ) const {
+	WriteSi( buf, object->m_si );
+	buf->WriteInt( object->ordered_properties.size() );
+	for ( const auto& it : object->ordered_properties ) {
+		buf->WriteString( it.first );
+		WriteExpression( buf, it.second );
+	}
+}
+
+const si_t Serializer::ReadSi( types::BufferView* buf ) const {
+	si_t si = {};
+	si.file = buf->ReadBool()
+		? m_file
+		: buf->ReadString();
+	si.from.line = buf->ReadInt();
+	si.from.col = buf->ReadInt();
+	si.to.line = buf->ReadInt();
+	si.to.col = buf->ReadInt();
+	return si;
+}
+
+const size_t Serializer::ReadCount( types::BufferView* buf ) const {
+	// checksum doesn't protect from bugs or from entries written by other versions, so count is checked before anything is allocated for it
+	const auto count = buf->ReadInt();
+	if ( count < 0 || (unsigned long long int)count > buf->GetRemainingSize() ) {
+		THROW( "invalid element count: " + std::to_string( count ) );
+	}
+	return count;
+}
+
+const Scope* Serializer::ReadScope( types::BufferView* buf ) const {
+	const auto si = ReadSi( buf );
+	std::vector< const Control* > body = {};
+	const size_t size = ReadCount( buf );
+	body.reserve( size );
+	for ( size_t i = 0 ; i < size ; i++ ) {
+		body.push_back( ReadControl( buf ) );
+	}
+	return new Scope( si, body );
+}
+
+const Control* Serializer::ReadControl( types::BufferView* buf ) const {
+	const auto control_type = (Control::control_type_t)buf->ReadInt();
+	switch ( control_type ) {
+		case Control::CT_STATEMENT: {
+			const auto si = ReadSi( buf );
+			return new Statement( si, ReadExpression( buf ) );
+		}
+		case Control::CT_CONDITIONAL: {
+			const auto* conditional = ReadConditional( buf );
+			if ( !conditional ) {
+				THROW( "conditional is missing" );
+			}
+			return conditional;
+		}
+		default:
+			THROW( "unexpected control type: " + std::to_string( control_type ) );
+	}
+}
+
+const Conditional* Serializer::ReadConditional( types::BufferView* buf ) const {
+	if ( !buf->ReadBool() ) {
+		return nullptr;
+	}
+	const auto conditional_type = (Conditional::conditional_type_t)buf->ReadInt();
+	const auto si = ReadSi( buf );
+	switch ( conditional_type ) {
+		case Conditional::CT_IF: {
+			const auto* condition = ReadSimpleCondition( buf );
+			const auto* body = ReadScope( buf );
+			return new If( si, condition, body, ReadConditional( buf ) );
+		}
+		case Conditional::CT_ELSEIF: {
+			const auto* condition = ReadSimpleCondition( buf );
+			const auto* body = ReadScope( buf );
+			return new ElseIf( si, condition, body, ReadConditional( buf ) );
+		}
+		case Conditional::CT_ELSE: {
+			return new Else( si, ReadScope( buf ) );
+		}
+		case Conditional::CT_WHILE: {
+			const auto* condition = ReadSimpleCondition( buf );
+			return new While( si, condition, ReadScope( buf ) );
+		}
+		case Conditional::CT_FOR: {
+			const auto condition_si = ReadSi( buf );
+			const auto for_type = (ForCondition::for_condition_type_t)buf->ReadInt();
+			const ForCondition* condition = nullptr;
+			switch ( for_type ) {
+				case ForCondition::FCT_EXPRESSIONS: {
+					const auto* init = ReadExpression( buf );
+					const auto* check = ReadExpression( buf );
+					condition = new ForConditionExpressions( condition_si, init, check, ReadExpression( buf ) );
+					break;
+				}
+				case ForCondition::FCT_IN_OF: {
+					const auto* variable = ReadVariable( buf );
+					const auto for_inof_type = (ForConditionInOf::for_inof_condition_type_t)buf->ReadInt();
+					condition = new ForConditionInOf( condition_si, variable, for_inof_type, ReadExpression( buf ) );
+					break;
+				}
+				default:
+					THROW( "unexpected for condition type: " + std::to_string( for_type ) );
+			}
+			return new For( si, condition, ReadScope( buf ) );
+		}
+		case Conditional::CT_TRY: {
+			const auto* body = ReadScope( buf );
+			const auto handlers_si = ReadSi( buf );
+			return new Try( si, body, new Catch( handlers_si, ReadObject( buf ) ) );
+		}
+		case Conditional::CT_CATCH: {
+			return new Catch( si, ReadObject( buf ) );
+		}
+		default:
+			THROW( "unexpected conditional type: " + std::to_string( conditional_type ) );
+	}
+}
+
+const SimpleCondition* Serializer::ReadSimpleCondition( types::BufferView* buf ) const {
+	const auto si = ReadSi( buf );
+	return new SimpleCondition( si, ReadExpression( buf ) );
+}
+
+const Expression* Serializer::ReadExpression( types::BufferView* buf ) const {
+	if ( !buf->ReadBool() ) {
+		return nullptr;
+	}
+	const auto si = ReadSi( buf );
+	const auto* a = ReadOperand( buf );
+	const Operator* op = nullptr;
+	if ( buf->ReadBool() ) {
+		const auto op_si = ReadSi( buf );
+		op = new Operator( op_si, (operator_type_t)buf->ReadInt() );
+	}
+	return new Expression( si, a, op, ReadOperand( buf ) );
+}
+
+const Operand* Serializer::ReadOperand( types::BufferView* buf ) const {
+	if ( !buf->ReadBool() ) {
+		return nullptr;
+	}
+	const auto type = (Operand::operand_type_t)buf->ReadInt();
+	switch ( type ) {
+		case Operand::OT_NOTHING: {
+			return new Nothing( ReadSi( buf ) );
+		}
+		case Operand::OT_VALUE: {
+			const auto si = ReadSi( buf );
+			return new Value( si, gse::Value::Unserialize( buf ) );
+		}
+		case Operand::OT_VARIABLE: {
+			return ReadVariable( buf );
+		}
+		case Operand::OT_ARRAY: {
+			const auto si = ReadSi( buf );
+			Array::elements_t elements = {};
+			const size_t size = ReadCount( buf );
+			elements.reserve( size );
+			for ( size_t i = 0 ; i < size ; i++ ) {
+				elements.push_back( ReadExpression( buf ) );
+			}
+			return new Array( si, elements );
+		}
+		case Operand::OT_OBJECT: {
+			return ReadObject( buf );
+		}
+		case Operand::OT_SCOPE: {
+			return ReadScope( buf );
+		}
+		case Operand::OT_EXPRESSION: {
+			const auto* expression = ReadExpression( buf );
+			if ( !expression ) {
+				THROW( "expression is missing" );
+			}
+			return expression;
+		}
+		case Operand::OT_FUNCTION: {
+			const auto si = ReadSi( buf );
+			std::vector< Variable* > parameters = {};
+			const size_t size = ReadCount( buf );
+			parameters.reserve( size );
+			for ( size_t i = 0 ; i < size ; i++ ) {
+				parameters.push_back( ReadVariable( buf ) );
+			}
+			return new Function( si, parameters, ReadScope( buf ) );
+		}
+		case Operand::OT_CALL: {
+			const auto si = ReadSi( buf );
+			const auto* callable = ReadExpression( buf );
+			std::vector< const Expression* > arguments = {};
+			const size_t size = ReadCount( buf );
+			arguments.reserve( size );
+			for ( size_t i = 0 ; i < size ; i++ ) {
+				arguments.push_back( ReadExpression( buf ) );
+			}
+			return new Call( si, callable, arguments );
+		}
+		default:
+			THROW( "unexpected operand type: " + std::to_string( type ) );
+	}
+}
+
+Variable* Serializer::ReadVariable( types::BufferView* buf ) const {
+	const auto si = ReadSi( buf );
+	const auto name = buf->ReadString();
+	return new Variable( si, name, (variable_hints_t)buf->ReadInt() );
+}
+
+const Object* Serializer::ReadObject( types::BufferView* buf ) const {
+	const auto si = ReadSi( buf );
+	Object::ordered_properties_t ordered_properties = {};
+	const size_t size = ReadCount( buf );
+	ordered_properties.reserve( size );
+	for ( size_t i = 0 ; i < size ; i++ ) {
+		const auto key = buf->ReadString();
+		ordered_properties.push_back(
+			{
+				key,
+				ReadExpression( buf )
+			}
+		);
+	}
+	return new Object( si, ordered_properties );
+}
+
+}
+}
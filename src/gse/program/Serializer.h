@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "gse/Types.h"
+
+namespace types {
+class Buffer;
+class BufferView;
+}
+
+namespace gse {
+namespace program {
+
+class Program;
+class Scope;
+class Control;
+class Conditional;
+class SimpleCondition;
+class Expression;
+class Operand;
+class Variable;
+class Object;
+
+// converts programs to and from buffers, so that scripts don't need to be parsed again if they didn't change
+// frames and addresses aren't stored, unserialized programs must be resolved again before running
+class Serializer {
+public:
+
+	void Serialize( types::Buffer* buf, const Program* program );
+	const Program* Unserialize( types::BufferView* buf );
+
+private:
+	// elements of program normally come from same file, so it's stored only once
+	std::string m_file = "";
+
+	void WriteSi( types::Buffer* buf, const si_t& si ) const;
+	void WriteScope( types::Buffer* buf, const Scope* scope ) const;
+	void WriteControl( types::Buffer* buf, const Control* control ) const;
+	void WriteConditional( types::Buffer* buf, const Conditional* conditional ) const;
+	void WriteSimpleCondition( types::Buffer* buf, const SimpleCondition* condition ) const;
+	void WriteExpression( types::Buffer* buf, const Expression* expression ) const;
+	void WriteOperand( types::Buffer* buf, const Operand* operand ) const;
+	void WriteVariable( types::Buffer* buf, const Variable* variable ) const;
+	void WriteObject( types::Buffer* buf, const Object* object ) const;
+
+	const si_t ReadSi( types::BufferView* buf ) const;
+	const size_t ReadCount( types::BufferView* buf ) const;
+	const Scope* ReadScope( types::BufferView* buf ) const;
+	const Control* ReadControl( types::BufferView* buf ) const;
+	const Conditional* ReadConditional( types::BufferView* buf ) const;
+	const SimpleCondition* ReadSimpleCondition( types::BufferView* buf ) const;
+	const Expression* ReadExpression( types::BufferView* buf ) const;
+	const Operand* ReadOperand( types::BufferView* buf ) const;
+	Variable* ReadVariable( types::BufferView* buf ) const;
+	const Object* ReadObject( types::BufferView* buf ) const;
+
+};
+
+}
+}
@@ -1,10 +1,27 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
+#include <string>
 
 namespace gse {
 namespace program {
 
+// where variable lives at runtime, assigned by Resolver
+// depth is how many parent contexts to go up from current one, slot is index of variable in that context
+// unresolved variables ( builtins, globals, ones created by native code ) are looked up by name instead
+struct variable_address_t {
+	bool is_resolved;
+	uint32_t depth;
+	uint32_t slot;
+};
+
+// variables of context that is created for scope, function call, for loop or object
+struct frame_t {
+	std::vector< std::string > slots; // name of every slot
+	std::vector< uint32_t > parameters; // slot of every function parameter, in order of arguments
+};
+
 enum variable_hints_t : uint8_t {
 	VH_NONE,
 	VH_CREATE_VAR,
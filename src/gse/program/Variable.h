@@ -17,6 +17,8 @@ public:
 	const std::string name;
 	const variable_hints_t hints;
 
+	mutable variable_address_t address = {}; // assigned by Resolver
+
 	const std::string ToString() const override;
 	const std::string Dump( const size_t depth = 0 ) const override;
 };
@@ -54,7 +54,7 @@ const gse::Value Interpreter::Execute( context::Context* ctx, const Program* pro
 
 const gse::Value Interpreter::EvaluateScope( context::Context* ctx, const Scope* scope ) const {
 	ctx->IncRefs(); // TODO: fix/improve context memory management
-	const auto subctx = ctx->ForkContext( ctx, scope->m_si, false );
+	const auto subctx = ctx->ForkContext( ctx, scope->m_si, false, &scope->frame );
 	subctx->IncRefs();
 
 	gse::Value result = VALUE( Undefined );
@@ -164,7 +164,7 @@ const gse::Value Interpreter::EvaluateConditional( context::Context* ctx, const
 				case ForCondition::FCT_IN_OF: {
 					const auto* condition = (ForConditionInOf*)c->condition;
 					const auto target = EvaluateExpression( ctx, condition->expression );
-					const auto forctx = ctx->ForkContext( ctx, condition->m_si, false );
+					const auto forctx = ctx->ForkContext( ctx, condition->m_si, false, &condition->frame );
 					forctx->IncRefs();
 					switch ( target.Get()->type ) {
 						case Type::T_ARRAY: {
@@ -172,9 +172,9 @@ const gse::Value Interpreter::EvaluateConditional( context::Context* ctx, const
 							switch ( condition->for_inof_type ) {
 								case ForConditionInOf::FIC_IN: {
 									for ( size_t i = 0 ; i < arr->value.size() ; i++ ) {
-										forctx->CreateConst( condition->variable->name, VALUE( Int, i ), &condition->m_si );
+										forctx->CreateConst( condition->variable->name, condition->variable->address, VALUE( Int, i ), &condition->m_si );
 										result = EvaluateScope( forctx, c->body );
-										forctx->DestroyVariable( condition->variable->name, &condition->m_si );
+										forctx->DestroyVariable( condition->variable->name, condition->variable->address, &condition->m_si );
 										if ( result.Get()->type != Type::T_UNDEFINED ) {
 											break;
 										}
@@ -183,9 +183,9 @@ const gse::Value Interpreter::EvaluateConditional( context::Context* ctx, const
 								}
 								case ForConditionInOf::FIC_OF: {
 									for ( const auto& v : arr->value ) {
-										forctx->CreateConst( condition->variable->name, v, &condition->m_si );
+										forctx->CreateConst( condition->variable->name, condition->variable->address, v, &condition->m_si );
 										result = EvaluateScope( forctx, c->body );
-										forctx->DestroyVariable( condition->variable->name, &condition->m_si );
+										forctx->DestroyVariable( condition->variable->name, condition->variable->address, &condition->m_si );
 										if ( result.Get()->type != Type::T_UNDEFINED ) {
 											break;
 										}
@@ -204,12 +204,12 @@ const gse::Value Interpreter::EvaluateConditional( context::Context* ctx, const
 							}
 							for ( const auto& v : obj->value ) {
 								forctx->CreateConst(
-									condition->variable->name, condition->for_inof_type == ForConditionInOf::FIC_IN
+									condition->variable->name, condition->variable->address, condition->for_inof_type == ForConditionInOf::FIC_IN
 										? VALUE( String, v.first )
 										: v.second, &condition->m_si
 								);
 								result = EvaluateScope( forctx, c->body );
-								forctx->DestroyVariable( condition->variable->name, &condition->m_si );
+								forctx->DestroyVariable( condition->variable->name, condition->variable->address, &condition->m_si );
 								if ( result.Get()->type != Type::T_UNDEFINED ) {
 									break;
 								}
@@ -325,13 +325,13 @@ const gse::Value Interpreter::EvaluateExpression( context::Context* ctx, const E
 						throw gse::Exception( EC.INVALID_ASSIGNMENT, "Can't assign to builtin: " + var->name, ctx, var->m_si );
 					}
 					if ( var->hints & VH_CREATE_VAR ) {
-						ctx->CreateVariable( var->name, result, &expression->a->m_si );
+						ctx->CreateVariable( var->name, var->address, result, &expression->a->m_si );
 					}
 					else if ( var->hints & VH_CREATE_CONST ) {
-						ctx->CreateConst( var->name, result, &expression->a->m_si );
+						ctx->CreateConst( var->name, var->address, result, &expression->a->m_si );
 					}
 					else {
-						ctx->UpdateVariable( var->name, result, &expression->a->m_si );
+						ctx->UpdateVariable( var->name, var->address, result, &expression->a->m_si );
 					}
 					break;
 				}
@@ -446,22 +446,22 @@ const gse::Value Interpreter::EvaluateExpression( context::Context* ctx, const E
 #define MATH_OP( _op ) \
         if ( expression->a ) { \
             ASSERT( !expression->b, "only one operand required, found two" ); \
-            const auto varname = EvaluateVarName( ctx, expression->a ); \
-            const auto value = ctx->GetVariable( varname, &expression->a->m_si ); \
+            const auto* var = EvaluateVariable( ctx, expression->a ); \
+            const auto value = ctx->GetVariable( var->name, var->address, &expression->a->m_si ); \
             if ( value.Get()->type != Type::T_INT ) { \
                 throw gse::Exception( EC.TYPE_ERROR, "Expected int, found: " + expression->a->ToString(), ctx, expression->a->m_si ); \
             } \
-            ctx->UpdateVariable( varname, VALUE( Int, ( (Int*)value.Get() )->value _op 1 ), &expression->a->m_si ); \
+            ctx->UpdateVariable( var->name, var->address, VALUE( Int, ( (Int*)value.Get() )->value _op 1 ), &expression->a->m_si ); \
             return value; \
         } \
         else if ( expression->b ) { \
-            const auto varname = EvaluateVarName( ctx, expression->b ); \
-            const auto value = ctx->GetVariable( varname, &expression->b->m_si ); \
+            const auto* var = EvaluateVariable( ctx, expression->b ); \
+            const auto value = ctx->GetVariable( var->name, var->address, &expression->b->m_si ); \
             if ( value.Get()->type != Type::T_INT ) { \
                 throw gse::Exception( EC.TYPE_ERROR, "Expected int, found: " + expression->b->ToString(), ctx, expression->b->m_si ); \
             } \
             const auto result = VALUE( Int, ( (Int*)value.Get() )->value _op 1 ); \
-            ctx->UpdateVariable( varname, result, &expression->b->m_si ); \
+            ctx->UpdateVariable( var->name, var->address, result, &expression->b->m_si ); \
             return result; \
         } \
         else { \
@@ -475,8 +475,8 @@ const gse::Value Interpreter::EvaluateExpression( context::Context* ctx, const E
 		}
 #undef MATH_OP
 #define MATH_OP_BEGIN( _op ) \
-        const auto varname = EvaluateVarName( ctx, expression->a ); \
-        const auto av = Deref( ctx, expression->a->m_si, ctx->GetVariable( varname, &expression->a->m_si ) ); \
+        const auto* var = EvaluateVariable( ctx, expression->a ); \
+        const auto av = Deref( ctx, expression->a->m_si, ctx->GetVariable( var->name, var->address, &expression->a->m_si ) ); \
         const auto bv = Deref( ctx, expression->b->m_si, EvaluateOperand( ctx, expression->b ) ); \
         const auto* a = av.Get(); \
         const auto* b = bv.Get(); \
@@ -499,7 +499,7 @@ const gse::Value Interpreter::EvaluateExpression( context::Context* ctx, const E
             default:  \
                 throw operation_not_supported( a->ToString(), b->ToString() ); \
         } \
-        ctx->UpdateVariable( varname, result, &expression->a->m_si ); \
+        ctx->UpdateVariable( var->name, var->address, result, &expression->a->m_si ); \
         return result;
 #define MATH_OP( _op ) \
         MATH_OP_BEGIN_F( _op ) \
@@ -553,18 +553,18 @@ const gse::Value Interpreter::EvaluateExpression( context::Context* ctx, const E
 			};
 			switch ( expression->a->type ) {
 				case Operand::OT_VARIABLE: {
-					const auto objv = ctx->GetVariable( ( (Variable*)expression->a )->name, &expression->a->m_si );
+					const auto objv = ctx->GetVariable( ( (Variable*)expression->a )->name, ( (Variable*)expression->a )->address, &expression->a->m_si );
 					const auto* obj = objv.Get();
 					if ( obj->type != Type::T_OBJECT ) {
 						throw not_an_object( obj->ToString(), expression->a->m_si );
 					}
-					return ( (type::Object*)obj )->GetRef( childname );
+					return ( (type::Object*)obj )->GetRef( childname, &expression->child_cache );
 				}
 				case Operand::OT_OBJECT: {
 					const auto objv = EvaluateOperand( ctx, expression->a );
 					const auto* obj = objv.Get();
 					ASSERT( obj->type == Type::T_OBJECT, "parent is not object: " + obj->Dump() );
-					return ( (type::Object*)obj )->Get( childname );
+					return ( (type::Object*)obj )->Get( childname, &expression->child_cache );
 				}
 				case Operand::OT_EXPRESSION: {
 					const auto objv = Deref( ctx, expression->a->m_si, EvaluateExpression( ctx, (Expression*)expression->a ) );
@@ -572,7 +572,7 @@ const gse::Value Interpreter::EvaluateExpression( context::Context* ctx, const E
 					if ( obj->type != Type::T_OBJECT ) {
 						throw not_an_object( obj->ToString(), expression->a->m_si );
 					}
-					return ( (type::Object*)obj )->GetRef( childname );
+					return ( (type::Object*)obj )->GetRef( childname, &expression->child_cache );
 				}
 				default: {
 					throw not_an_object( expression->a->ToString(), expression->a->m_si );
@@ -613,7 +613,7 @@ const gse::Value Interpreter::EvaluateExpression( context::Context* ctx, const E
 			};
 			switch ( expression->a->type ) {
 				case Operand::OT_VARIABLE: {
-					const auto arrv = ctx->GetVariable( ( (Variable*)expression->a )->name, &expression->a->m_si );
+					const auto arrv = ctx->GetVariable( ( (Variable*)expression->a )->name, ( (Variable*)expression->a )->address, &expression->a->m_si );
 					const auto* arr = arrv.Get();
 					if ( arr->type != Type::T_ARRAY ) {
 						throw not_an_array( arr->ToString(), expression->a->m_si );
@@ -664,7 +664,7 @@ const gse::Value Interpreter::EvaluateExpression( context::Context* ctx, const E
 							}
 						}
 						case Type::T_ARRAYRANGEREF: {
-							THROW( "TODO: T_ARRAYRANGEREF" );
+							throw gse::Exception( EC.OPERATION_NOT_SUPPORTED, "Indexing of array range is not supported", ctx, expression->m_si );
 						}
 						case Type::T_OBJECTREF: {
 							const auto arrv = Deref( ctx, expression->a->m_si, refv );
@@ -690,7 +690,7 @@ const gse::Value Interpreter::EvaluateExpression( context::Context* ctx, const E
 		case OT_APPEND: {
 			switch ( expression->a->type ) {
 				case Operand::OT_VARIABLE: {
-					const auto arrv = ctx->GetVariable( ( (Variable*)expression->a )->name, &expression->a->m_si );
+					const auto arrv = ctx->GetVariable( ( (Variable*)expression->a )->name, ( (Variable*)expression->a )->address, &expression->a->m_si );
 					const auto* arr = arrv.Get();
 					if ( arr->type != Type::T_ARRAY ) {
 						throw operation_not_supported( arr->ToString(), expression->b->ToString() );
@@ -736,7 +736,8 @@ const gse::Value Interpreter::EvaluateOperand( context::Context* ctx, const Oper
 			return ( (program::Value*)operand )->value;
 		}
 		case Operand::OT_VARIABLE: {
-			return ctx->GetVariable( ( (Variable*)operand )->name, &operand->m_si );
+			const auto* var = (Variable*)operand;
+			return ctx->GetVariable( var->name, var->address, &operand->m_si );
 		}
 		case Operand::OT_ARRAY: {
 			auto* arr = (program::Array*)operand;
@@ -747,13 +748,13 @@ const gse::Value Interpreter::EvaluateOperand( context::Context* ctx, const Oper
 			return VALUE( type::Array, elements );
 		}
 		case Operand::OT_OBJECT: {
+			const auto* obj = (program::Object*)operand;
 			ctx->IncRefs(); // TODO: cleanup
-			const auto objctx = ctx->ForkContext( ctx, operand->m_si, false );
+			const auto objctx = ctx->ForkContext( ctx, operand->m_si, false, &obj->frame );
 			objctx->IncRefs();
 			auto result = VALUE( type::Object, object_properties_t{} );
 			auto& properties = ( (type::Object*)result.Get() )->value;
 			objctx->CreateConst( "this", result, &operand->m_si );
-			const auto* obj = (program::Object*)operand;
 			for ( const auto& it : obj->ordered_properties ) {
 				if ( it.first == "this" ) {
 					throw gse::Exception( EC.INVALID_ASSIGNMENT, "'this' can't be overwritten", ctx, it.second->m_si );
@@ -771,12 +772,12 @@ const gse::Value Interpreter::EvaluateOperand( context::Context* ctx, const Oper
 		}
 		case Operand::OT_FUNCTION: {
 			const auto* func = (program::Function*)operand;
-			std::vector< std::string > parameters = {};
+#ifdef DEBUG
 			for ( const auto& it : func->parameters ) {
 				ASSERT( it->hints == VH_NONE, "function parameters can't have modifiers" );
-				parameters.push_back( it->name );
 			}
-			return VALUE( Function, this, ctx, parameters, new Program( func->body ) );
+#endif
+			return VALUE( Function, this, ctx, &func->frame, new Program( func->body ) );
 		}
 		case Operand::OT_CALL: {
 			const auto* call = (Call*)operand;
@@ -824,7 +825,8 @@ const gse::Value Interpreter::EvaluateRange( context::Context* ctx, const Operan
 			return VALUE( Int, get_index( ( (program::Value*)operand )->value ) );
 		}
 		case Operand::OT_VARIABLE: {
-			return VALUE( Int, get_index( ctx->GetVariable( ( (Variable*)operand )->name, &operand->m_si ) ) );
+			const auto* var = (Variable*)operand;
+			return VALUE( Int, get_index( ctx->GetVariable( var->name, var->address, &operand->m_si ) ) );
 		}
 		case Operand::OT_EXPRESSION: {
 			const auto result = Deref( ctx, operand->m_si, EvaluateExpression( ctx, (Expression*)operand ) );
@@ -859,86 +861,24 @@ const Variable* Interpreter::EvaluateVariable( context::Context* ctx, const Oper
 	if ( operand->type != Operand::OT_VARIABLE ) {
 		throw gse::Exception( EC.REFERENCE_ERROR, "Expected variable, found: " + operand->ToString(), ctx, operand->m_si );
 	}
-	return (Variable*)operand;
-}
-
-const std::string Interpreter::EvaluateVarName( context::Context* ctx, const Operand* operand ) const {
-	const auto* var = EvaluateVariable( ctx, operand );
+	const auto* var = (Variable*)operand;
 	ASSERT( var->hints == VH_NONE, "unexpected variable hints" );
-	return var->name;
-}
-
-const gse::Value Interpreter::Deref( context::Context* ctx, const si_t& si, const gse::Value& value ) const {
-	switch ( value.Get()->type ) {
-		case Type::T_ARRAYREF: {
-			const auto* ref = (ArrayRef*)value.Get();
-			return ref->array->Get( ref->index );
-		}
-		case Type::T_ARRAYRANGEREF: {
-			const auto* ref = (ArrayRangeRef*)value.Get();
-			ValidateRange( ctx, si, ref->array, ref->from, ref->to );
-			return ref->array->GetSubArray( ref->from, ref->to );
-		}
-		case Type::T_OBJECTREF: {
-			const auto* ref = (ObjectRef*)value.Get();
-			return ref->object->Get( ref->key );
-		}
-		default:
-			return value;
-	}
+	return var;
 }
 
-void Interpreter::WriteByRef( context::Context* ctx, const si_t& si, const gse::Value& ref, const gse::Value& value ) const {
-	switch ( ref.Get()->type ) {
-		case Type::T_OBJECTREF: {
-			const auto* r = (ObjectRef*)ref.Get();
-			r->object->Set( r->key, value, ctx, si );
-			break;
-		}
-		case Type::T_ARRAYREF: {
-			const auto* r = (ArrayRef*)ref.Get();
-			r->array->Set( r->index, value );
-			break;
-		}
-		case Type::T_ARRAYRANGEREF: {
-			const auto* r = (ArrayRangeRef*)ref.Get();
-			ValidateRange( ctx, si, r->array, r->from, r->to );
-			r->array->SetSubArray( r->from, r->to, value );
-			break;
-		}
-		default:
-			THROW( "reference expected, found " + ref.ToString() );
-	}
-}
-
-void Interpreter::ValidateRange( context::Context* ctx, const si_t& si, const type::Array* array, const std::optional< size_t > from, const std::optional< size_t > to ) const {
-	const auto& max = array->value.size() - 1;
-	if ( from.has_value() ) {
-		if ( from.value() > max ) {
-			throw gse::Exception( EC.INVALID_DEREFERENCE, "Invalid range - opening index is behind last element ( " + std::to_string( from.value() ) + " > " + std::to_string( max ) + " )", ctx, si );
-		}
-	}
-	if ( to.has_value() ) {
-		if ( to.value() > max ) {
-			throw gse::Exception( EC.INVALID_DEREFERENCE, "Invalid range - closing index is behind last element ( " + std::to_string( to.value() ) + " > " + std::to_string( max ) + " )", ctx, si );
-		}
-		if ( from.has_value() ) {
-			if ( from.value() > to.value() ) {
-				throw gse::Exception( EC.INVALID_DEREFERENCE, "Invalid range - opening index is behind closing index ( " + std::to_string( from.value() ) + " > " + std::to_string( to.value() ) + " )", ctx, si );
-			}
-		}
-	}
+const std::string Interpreter::EvaluateVarName( context::Context* ctx, const Operand* operand ) const {
+	return EvaluateVariable( ctx, operand )->name;
 }
 
 Interpreter::Function::Function(
 	const Interpreter* runner,
 	context::Context* context,
-	const std::vector< std::string >& parameters,
+	const program::frame_t* frame,
 	const Program* const program
 )
 	: runner( runner )
 	, context( context )
-	, parameters( parameters )
+	, frame( frame )
 	, program( program ) {
 	context->IncRefs();
 }
@@ -949,7 +889,7 @@ Interpreter::Function::~Function() {
 
 gse::Value Interpreter::Function::Run( context::Context* ctx, const si_t& call_si, const function_arguments_t& arguments ) {
 	ctx->IncRefs();
-	auto* subctx = context->ForkContext( ctx, call_si, true, parameters, arguments );
+	auto* subctx = context->ForkContext( ctx, call_si, true, frame, arguments );
 	subctx->IncRefs();
 	const auto result = runner->Execute( subctx, program );
 	subctx->DecRefs();
@@ -1,11 +1,11 @@
 #pragma once
 
 #include <string>
-#include <optional>
 
 #include "Runner.h"
 
 #include "gse/type/Types.h"
+#include "gse/program/Types.h"
 
 #include "gse/Value.h"
 #include "gse/type/Callable.h"
@@ -22,10 +22,6 @@ class Operand;
 class Variable;
 }
 
-namespace type {
-class Array;
-}
-
 namespace runner {
 
 CLASS( Interpreter, Runner )
@@ -39,7 +35,7 @@ private:
 		Function(
 			const Interpreter* runner,
 			context::Context* context,
-			const std::vector< std::string >& parameters,
+			const program::frame_t* frame,
 			const program::Program* const program
 		);
 		~Function();
@@ -47,7 +43,7 @@ private:
 	private:
 		const Interpreter* runner;
 		context::Context* context;
-		const std::vector< std::string > parameters;
+		const program::frame_t* frame;
 		const program::Program* const program;
 	};
 
@@ -62,10 +58,6 @@ private:
 	const program::Variable* EvaluateVariable( context::Context* ctx, const program::Operand* operand ) const;
 	const std::string EvaluateVarName( context::Context* ctx, const program::Operand* operand ) const;
 
-	const Value Deref( context::Context* ctx, const si_t& si, const Value& value ) const;
-	void WriteByRef( context::Context* ctx, const si_t& si, const Value& ref, const Value& value ) const;
-	void ValidateRange( context::Context* ctx, const si_t& si, const type::Array* array, const std::optional< size_t > from, const std::optional< size_t > to ) const;
-
 };
 
 }
@@ -0,0 +1,79 @@
+#include "Runner.h"
+
+#include "gse/Exception.h"
+#include "gse/type/Array.h"
+#include "gse/type/ArrayRef.h"
+#include "gse/type/ArrayRangeRef.h"
+#include "gse/type/ObjectRef.h"
+#include "gse/type/Object.h"
+
+namespace gse {
+
+using namespace type;
+
+namespace runner {
+
+const gse::Value Runner::Deref( context::Context* ctx, const si_t& si, const gse::Value& value ) const {
+	switch ( value.Get()->type ) {
+		case Type::T_ARRAYREF: {
+			const auto* ref = (ArrayRef*)value.Get();
+			return ref->array->Get( ref->index );
+		}
+		case Type::T_ARRAYRANGEREF: {
+			const auto* ref = (ArrayRangeRef*)value.Get();
+			ValidateRange( ctx, si, ref->array, ref->from, ref->to );
+			return ref->array->GetSubArray( ref->from, ref->to );
+		}
+		case Type::T_OBJECTREF: {
+			const auto* ref = (ObjectRef*)value.Get();
+			return ref->object->Get( ref->key, ref->cache );
+		}
+		default:
+			return value;
+	}
+}
+
+void Runner::WriteByRef( context::Context* ctx, const si_t& si, const gse::Value& ref, const gse::Value& value ) const {
+	switch ( ref.Get()->type ) {
+		case Type::T_OBJECTREF: {
+			const auto* r = (ObjectRef*)ref.Get();
+			r->object->Set( r->key, value, ctx, si, r->cache );
+			break;
+		}
+		case Type::T_ARRAYREF: {
+			const auto* r = (ArrayRef*)ref.Get();
+			r->array->Set( r->index, value );
+			break;
+		}
+		case Type::T_ARRAYRANGEREF: {
+			const auto* r = (ArrayRangeRef*)ref.Get();
+			ValidateRange( ctx, si, r->array, r->from, r->to );
+			r->array->SetSubArray( r->from, r->to, value );
+			break;
+		}
+		default:
+			THROW( "reference expected, found " + ref.ToString() );
+	}
+}
+
+void Runner::ValidateRange( context::Context* ctx, const si_t& si, const type::Array* array, const std::optional< size_t > from, const std::optional< size_t > to ) const {
+	const auto& max = array->value.size() - 1;
+	if ( from.has_value() ) {
+		if ( from.value() > max ) {
+			throw gse::Exception( EC.INVALID_DEREFERENCE, "Invalid range - opening index is behind last element ( " + std::to_string( from.value() ) + " > " + std::to_string( max ) + " )", ctx, si );
+		}
+	}
+	if ( to.has_value() ) {
+		if ( to.value() > max ) {
+			throw gse::Exception( EC.INVALID_DEREFERENCE, "Invalid range - closing index is behind last element ( " + std::to_string( to.value() ) + " > " + std::to_string( max ) + " )", ctx, si );
+		}
+		if ( from.has_value() ) {
+			if ( from.value() > to.value() ) {
+				throw gse::Exception( EC.INVALID_DEREFERENCE, "Invalid range - opening index is behind closing index ( " + std::to_string( from.value() ) + " > " + std::to_string( to.value() ) + " )", ctx, si );
+			}
+		}
+	}
+}
+
+}
+}
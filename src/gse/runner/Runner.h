@@ -1,7 +1,10 @@
 #pragma once
 
+#include <optional>
+
 #include "common/Common.h"
 
+#include "gse/Types.h"
 #include "gse/Value.h"
 
 namespace gse {
@@ -14,6 +17,10 @@ namespace program {
 class Program;
 }
 
+namespace type {
+class Array;
+}
+
 namespace runner {
 
 CLASS( Runner, common::Class )
@@ -32,6 +39,11 @@ protected:
 	bool m_are_scope_context_joins_enabled = false;
 #endif
 
+	// shared by all runners so that references behave same way everywhere
+	const Value Deref( context::Context* ctx, const si_t& si, const Value& value ) const;
+	void WriteByRef( context::Context* ctx, const si_t& si, const Value& ref, const Value& value ) const;
+	void ValidateRange( context::Context* ctx, const si_t& si, const type::Array* array, const std::optional< size_t > from, const std::optional< size_t > to ) const;
+
 };
 
 }
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+namespace gse {
+namespace runner {
+
+enum runner_type_t : uint8_t {
+	RT_INTERPRETER, // walks program tree directly
+	RT_VM, // compiles program to bytecode first
+};
+
+}
+}
@@ -0,0 +1,817 @@
+#include "VM.h"
+
+#include "bytecode/Program.h"
+#include "bytecode/Compiler.h"
+
+#include "gse/context/Context.h"
+#include "gse/context/ChildContext.h"
+#include "gse/program/Types.h"
+#include "gse/program/Variable.h"
+#include "gse/type/Type.h"
+#include "gse/type/Undefined.h"
+#include "gse/type/Bool.h"
+#include "gse/type/Int.h"
+#include "gse/type/Float.h"
+#include "gse/type/String.h"
+#include "gse/type/Array.h"
+#include "gse/type/Object.h"
+#include "gse/type/ArrayRef.h"
+#include "gse/type/ObjectRef.h"
+#include "gse/type/Callable.h"
+#include "gse/type/Range.h"
+#include "gse/type/Exception.h"
+
+namespace gse {
+
+using namespace type;
+using namespace runner::bytecode;
+
+namespace runner {
+
+template< typename T >
+static void Truncate( std::vector< T >& stack, const size_t size ) {
+	while ( stack.size() > size ) {
+		stack.pop_back();
+	}
+}
+
+const gse::Value VM::Execute( context::Context* ctx, const program::Program* program ) const {
+	bytecode::Compiler compiler;
+	const code_t code( compiler.Compile( program ) );
+	return Run( ctx, code, 0 );
+}
+
+const gse::Value VM::Run( context::Context* ctx, const code_t& code, const uint32_t entry ) const {
+	const frame_t frame = {
+		m_values.size(),
+		m_contexts.size(),
+		m_iterators.size(),
+		m_handlers.size(),
+		m_exceptions.size(),
+	};
+	m_contexts.push_back( ctx );
+	uint32_t ip = entry;
+	while ( true ) {
+		try {
+			return Loop( code, ip, frame );
+		}
+		catch ( gse::Exception& e ) {
+			if ( !Catch( code.get(), e, frame, &ip ) ) {
+				Unwind( frame );
+				throw;
+			}
+			// continue from handler
+		}
+		catch ( ... ) {
+			Unwind( frame );
+			throw;
+		}
+	}
+}
+
+const gse::Value VM::Loop( const code_t& code, uint32_t ip, const frame_t& frame ) const {
+	const auto* program = code.get();
+	const auto* instructions = program->instructions.data();
+	const auto& strings = program->strings;
+	const auto& variables = program->variables;
+	auto* property_caches = program->property_caches.data();
+	auto* ctx = m_contexts.back();
+
+	const auto& pop = [ this ]() -> gse::Value {
+		const auto value = m_values.back();
+		m_values.pop_back();
+		return value;
+	};
+	const auto& get_bool = [ &ctx, &strings ]( const bytecode::instruction_t& ins, const gse::Value& value ) -> bool {
+		if ( value.Get()->type != Type::T_BOOL ) {
+			throw gse::Exception( EC.TYPE_ERROR, strings[ ins.b ], ctx, *ins.si );
+		}
+		return ( (Bool*)value.Get() )->value;
+	};
+	const auto& enter_context = [ this, &ctx, &program ]( const si_t& si, const uint32_t frame ) -> void {
+		ctx = ctx->ForkContext( ctx, si, false, program->frames[ frame ] );
+		ctx->IncRefs();
+		m_contexts.push_back( ctx );
+	};
+	const auto& leave_context = [ this, &ctx ]() -> void {
+		ctx->DecRefs();
+		m_contexts.pop_back();
+		ctx = m_contexts.back();
+	};
+
+	while ( true ) {
+		const auto& ins = instructions[ ip++ ];
+		switch ( ins.op ) {
+			case OP_NOOP: {
+				break;
+			}
+			case OP_PUSH: {
+				m_values.push_back( program->constants[ ins.a ] );
+				break;
+			}
+			case OP_PUSH_UNDEFINED: {
+				m_values.push_back( VALUE( Undefined ) );
+				break;
+			}
+			case OP_POP: {
+				m_values.pop_back();
+				break;
+			}
+			case OP_JUMP: {
+				ip = ins.a;
+				break;
+			}
+			case OP_JUMP_UNLESS: {
+				const auto value = Deref( ctx, *ins.si, pop() );
+				if ( !get_bool( ins, value ) ) {
+					ip = ins.a;
+				}
+				break;
+			}
+			case OP_JUMP_IF_RESULT: {
+				if ( m_values.back().Get()->type != Type::T_UNDEFINED ) {
+					// got return statement
+					ip = ins.a;
+				}
+				else {
+					m_values.pop_back();
+				}
+				break;
+			}
+			case OP_JUMP_IF_FALSE_KEEP: {
+				if ( !( (Bool*)m_values.back().Get() )->value ) {
+					ip = ins.a;
+				}
+				break;
+			}
+			case OP_JUMP_IF_TRUE_KEEP: {
+				if ( ( (Bool*)m_values.back().Get() )->value ) {
+					ip = ins.a;
+				}
+				break;
+			}
+			case OP_RETURN: {
+				const auto result = m_values.back();
+				Unwind( frame );
+				return result;
+			}
+			case OP_SCOPE_BEGIN: {
+				// child contexts don't reference their parent, so parent is kept alive for closures that may outlive scope ( same as in interpreter )
+				ctx->IncRefs();
+				enter_context( *ins.si, ins.a );
+				break;
+			}
+			case OP_SCOPE_END: {
+#ifdef DEBUG
+				if ( m_are_scope_context_joins_enabled ) {
+					( (context::ChildContext*)ctx )->JoinContext();
+				}
+#endif
+				leave_context();
+				break;
+			}
+			case OP_GET: {
+				const auto* var = variables[ ins.a ];
+				m_values.push_back( ctx->GetVariable( var->name, var->address, ins.si ) );
+				break;
+			}
+			case OP_CREATE_VAR: {
+				const auto* var = variables[ ins.a ];
+				ctx->CreateVariable( var->name, var->address, m_values.back(), ins.si );
+				break;
+			}
+			case OP_CREATE_CONST: {
+				const auto* var = variables[ ins.a ];
+				ctx->CreateConst( var->name, var->address, m_values.back(), ins.si );
+				break;
+			}
+			case OP_UPDATE: {
+				const auto* var = variables[ ins.a ];
+				ctx->UpdateVariable( var->name, var->address, m_values.back(), ins.si );
+				break;
+			}
+			case OP_INC: {
+				const auto* var = variables[ ins.a ];
+				const auto value = ctx->GetVariable( var->name, var->address, ins.si );
+				if ( value.Get()->type != Type::T_INT ) {
+					throw gse::Exception( EC.TYPE_ERROR, strings[ ins.b ], ctx, *ins.si );
+				}
+				const auto result = VALUE(
+					Int, ( (Int*)value.Get() )->value + ( ins.flags & IF_DEC
+						? -1
+						: 1
+					)
+				);
+				ctx->UpdateVariable( var->name, var->address, result, ins.si );
+				m_values.push_back(
+					ins.flags & IF_POSTFIX
+						? value
+						: result
+				);
+				break;
+			}
+			case OP_DEREF: {
+				auto& top = m_values.back();
+				top = Deref( ctx, *ins.si, top );
+				break;
+			}
+			case OP_DEREF_CLONE: {
+				auto& top = m_values.back();
+				top = Deref( ctx, *ins.si, top ).Clone();
+				break;
+			}
+			case OP_BOOL: {
+				auto& top = m_values.back();
+				top = Deref( ctx, *ins.si, top );
+				get_bool( ins, top );
+				break;
+			}
+			case OP_NOT: {
+				auto& top = m_values.back();
+				top = VALUE( Bool, !get_bool( ins, Deref( ctx, *ins.si, top ) ) );
+				break;
+			}
+			case OP_ARRAY: {
+				const auto begin = m_values.end() - ins.a;
+				const array_elements_t elements( begin, m_values.end() );
+				Truncate( m_values, m_values.size() - ins.a );
+				m_values.push_back( VALUE( type::Array, elements ) );
+				break;
+			}
+			case OP_OBJECT_BEGIN: {
+				ctx->IncRefs(); // see OP_SCOPE_BEGIN
+				enter_context( *ins.si, ins.a );
+				const auto result = VALUE( type::Object, object_properties_t{} );
+				ctx->CreateConst( "this", result, ins.si );
+				m_values.push_back( result );
+				break;
+			}
+			case OP_OBJECT_SET: {
+				const auto value = pop();
+				( (type::Object*)m_values.back().Get() )->value.insert_or_assign( strings[ ins.a ], value );
+				break;
+			}
+			case OP_OBJECT_END: {
+				leave_context();
+				break;
+			}
+			case OP_FUNCTION: {
+				m_values.push_back( VALUE( Function, this, ctx, code, ins.a ) );
+				break;
+			}
+			case OP_CALLABLE: {
+				auto& top = m_values.back();
+				top = Deref( ctx, *ins.si, top );
+				if ( top.Get()->type != Type::T_CALLABLE ) {
+					throw gse::Exception( EC.INVALID_CALL, "Callable expected, found: " + top.ToString(), ctx, *ins.si );
+				}
+				break;
+			}
+			case OP_CALL: {
+				const function_arguments_t arguments( m_values.end() - ins.a, m_values.end() );
+				Truncate( m_values, m_values.size() - ins.a );
+				const auto callable = pop();
+				m_values.push_back( ( (Callable*)callable.Get() )->Run( ctx, *ins.si, arguments ) );
+				break;
+			}
+			case OP_WRITE_REF: {
+				const auto ref = pop();
+				WriteByRef( ctx, *ins.si, ref, m_values.back() );
+				break;
+			}
+			case OP_COMPARE: {
+				const auto b = pop();
+				auto& a = m_values.back();
+				bool result;
+				switch ( ins.flags ) {
+					case program::OT_EQ: {
+						result = a == b;
+						break;
+					}
+					case program::OT_NE: {
+						result = a != b;
+						break;
+					}
+					case program::OT_LT: {
+						result = a < b;
+						break;
+					}
+					case program::OT_LTE: {
+						result = a <= b;
+						break;
+					}
+					case program::OT_GT: {
+						result = a > b;
+						break;
+					}
+					case program::OT_GTE: {
+						result = a >= b;
+						break;
+					}
+					default:
+						THROW( "unexpected comparison operator: " + std::to_string( ins.flags ) );
+				}
+				a = VALUE( Bool, result );
+				break;
+			}
+			case OP_MATH: {
+				const auto b = pop();
+				auto& a = m_values.back();
+				a = Math( ctx, ins, strings[ ins.a ], a, b );
+				break;
+			}
+			case OP_MATH_ASSIGN: {
+				const auto b = pop();
+				auto& a = m_values.back();
+				const bool is_object_append = ins.flags == program::OT_INC_BY && a.Get()->type == Type::T_OBJECT;
+				a = Math( ctx, ins, strings[ ins.a ], a, b );
+				if ( is_object_append ) {
+					ip++; // interpreter doesn't update variable in this case, skip OP_UPDATE to stay compatible
+				}
+				break;
+			}
+			case OP_CHILD: {
+				const auto objv = pop();
+				const auto* obj = objv.Get();
+				const auto& name = strings[ ins.a ];
+				auto* cache = &property_caches[ ins.b ];
+				if ( ins.flags & IF_REF ) {
+					if ( obj->type != Type::T_OBJECT ) {
+						throw gse::Exception( EC.INVALID_DEREFERENCE, "Could not get ." + name + " of non-object: " + obj->ToString(), ctx, *ins.si );
+					}
+					m_values.push_back( ( (type::Object*)obj )->GetRef( name, cache ) );
+				}
+				else {
+					ASSERT( obj->type == Type::T_OBJECT, "parent is not object: " + obj->Dump() );
+					m_values.push_back( ( (type::Object*)obj )->Get( name, cache ) );
+				}
+				break;
+			}
+			case OP_INDEX: {
+				const auto* val = m_values.back().Get();
+				const auto& check_index = [ &ctx, &ins ]( const type::Type* val ) -> void {
+					if ( val->type != Type::T_INT ) {
+						throw gse::Exception( EC.INVALID_DEREFERENCE, "Invalid range - index must be int: " + val->ToString(), ctx, *ins.si );
+					}
+					if ( ( (Int*)val )->value < 0 ) {
+						throw gse::Exception( EC.INVALID_DEREFERENCE, "Invalid range - index must be positive: " + val->ToString(), ctx, *ins.si );
+					}
+				};
+				if ( ins.flags & IF_LITERAL ) {
+					check_index( val );
+					break;
+				}
+				switch ( val->type ) {
+					case Type::T_INT: {
+						check_index( val );
+						break;
+					}
+					case Type::T_RANGE: {
+						ASSERT( !( ins.flags & IF_INT_ONLY ), "range not allowed here" );
+						break;
+					}
+					default:
+						THROW( "unexpected index expression result type: " + val->ToString() );
+				}
+				break;
+			}
+			case OP_AT: {
+				if ( ins.flags == AT_INVALID ) {
+					const auto indexv = pop();
+					m_values.push_back( At( ctx, ins, strings[ ins.b ], indexv, nullptr ) );
+				}
+				else {
+					const auto parentv = pop();
+					const auto indexv = pop();
+					m_values.push_back( At( ctx, ins, "", indexv, &parentv ) );
+				}
+				break;
+			}
+			case OP_APPEND_CHECK: {
+				const auto& arrv = m_values.back();
+				if ( arrv.Get()->type != Type::T_ARRAY ) {
+					throw gse::Exception( EC.OPERATION_NOT_SUPPORTED, strings[ ins.a ] + arrv.ToString() + strings[ ins.b ], ctx, *ins.si );
+				}
+				break;
+			}
+			case OP_APPEND: {
+				const auto value = pop();
+				const auto arrv = pop();
+				( (type::Array*)arrv.Get() )->Append( value );
+				m_values.push_back( value );
+				break;
+			}
+			case OP_RANGE: {
+				std::optional< size_t > from = std::nullopt;
+				std::optional< size_t > to = std::nullopt;
+				if ( ins.flags & RF_TO ) {
+					const auto tov = pop();
+					ASSERT( tov.Get()->type == Type::T_INT, "int expected here" );
+					to = ( (Int*)tov.Get() )->value;
+				}
+				if ( ins.flags & RF_FROM ) {
+					const auto fromv = pop();
+					ASSERT( fromv.Get()->type == Type::T_INT, "int expected here" );
+					from = ( (Int*)fromv.Get() )->value;
+				}
+				m_values.push_back( VALUE( Range, from, to ) );
+				break;
+			}
+			case OP_STRING_CHECK: {
+				if ( m_values.back().Get()->type != Type::T_STRING ) {
+					throw gse::Exception( strings[ ins.a ], strings[ ins.b ], ctx, *ins.si );
+				}
+				break;
+			}
+			case OP_THROW: {
+				const auto reason = pop();
+				throw gse::Exception( strings[ ins.a ], ( (String*)reason.Get() )->value, ctx, *ins.si );
+			}
+			case OP_ERROR: {
+				throw gse::Exception(
+					strings[ ins.a ], strings[ ins.b ], ins.flags & IF_PARENT_CONTEXT
+						? m_contexts[ m_contexts.size() - 2 ]
+						: ctx, *ins.si
+				);
+			}
+			case OP_ASSIGN_ERROR: {
+				throw gse::Exception( EC.INVALID_ASSIGNMENT, "Can't assign " + m_values.back().ToString() + strings[ ins.b ], ctx, *ins.si );
+			}
+			case OP_FAIL: {
+				THROW( strings[ ins.b ] );
+			}
+			case OP_TRY_BEGIN: {
+				m_handlers.push_back(
+					{
+						ins.a,
+						{
+							m_values.size(),
+							m_contexts.size(),
+							m_iterators.size(),
+							m_handlers.size(),
+							m_exceptions.size(),
+						}
+					}
+				);
+				break;
+			}
+			case OP_TRY_END: {
+				m_handlers.pop_back();
+				break;
+			}
+			case OP_CATCH: {
+				const auto f = pop();
+				if ( f.Get()->type != Type::T_CALLABLE ) {
+					throw gse::Exception( EC.PARSE_ERROR, "Expected catch block, found: " + f.ToString(), ctx, *ins.si );
+				}
+				auto e = m_exceptions.back();
+				m_exceptions.pop_back();
+				m_values.push_back(
+					( (Callable*)f.Get() )->Run(
+						ctx,
+						*ins.si,
+						{
+							VALUE( type::Exception, e, e.GetBacktraceAndCleanup( ctx ) )
+						}
+					)
+				);
+				break;
+			}
+			case OP_FOR_BEGIN: {
+				const auto target = pop();
+				enter_context( *ins.si, ins.a );
+				switch ( target.Get()->type ) {
+					case Type::T_ARRAY: {
+						m_iterators.push_back(
+							{
+								target,
+								0,
+								{}
+							}
+						);
+						break;
+					}
+					case Type::T_OBJECT: {
+						m_iterators.push_back(
+							{
+								target,
+								0,
+								( (type::Object*)target.Get() )->value.begin()
+							}
+						);
+						break;
+					}
+					default:
+						THROW( "unexpected type for iteration: " + target.ToString() );
+				}
+				break;
+			}
+			case OP_FOR_NEXT: {
+				auto& it = m_iterators.back();
+				const auto* target = it.target.Get();
+				const bool is_in = ins.flags == FF_IN;
+				const auto* var = variables[ ins.b ];
+				if ( target->type == Type::T_ARRAY ) {
+					const auto* arr = (type::Array*)target;
+					if ( it.index >= arr->value.size() ) {
+						ip = ins.a;
+						break;
+					}
+					ctx->CreateConst(
+						var->name, var->address, is_in
+							? VALUE( Int, it.index )
+							: arr->value[ it.index ], ins.si
+					);
+					it.index++;
+				}
+				else {
+					const auto* obj = (type::Object*)target;
+					if ( it.object_it == obj->value.end() ) {
+						ip = ins.a;
+						break;
+					}
+					ctx->CreateConst(
+						var->name, var->address, is_in
+							? VALUE( String, it.object_it->first )
+							: it.object_it->second, ins.si
+					);
+					it.object_it++;
+				}
+				break;
+			}
+			case OP_FOR_CLEAR: {
+				const auto* var = variables[ ins.b ];
+				ctx->DestroyVariable( var->name, var->address, ins.si );
+				break;
+			}
+			case OP_FOR_END: {
+				leave_context();
+				m_iterators.pop_back();
+				break;
+			}
+			default:
+				THROW( "unexpected opcode: " + std::to_string( ins.op ) );
+		}
+	}
+}
+
+const bool VM::Catch( const bytecode::Program* program, const gse::Exception& e, const frame_t& frame, uint32_t* ip ) const {
+	while ( m_handlers.size() > frame.handlers ) {
+		const auto handler = m_handlers.back();
+		m_handlers.pop_back();
+		const auto& handlers = program->tries.at( handler.try_index ).handlers;
+		auto it = handlers.find( e.class_name );
+		if ( it == handlers.end() ) {
+			it = handlers.find( "" ); // check for default handler too
+		}
+		if ( it != handlers.end() ) {
+			Truncate( m_values, handler.frame.values );
+			Truncate( m_contexts, handler.frame.contexts );
+			Truncate( m_iterators, handler.frame.iterators );
+			Truncate( m_exceptions, handler.frame.exceptions );
+			m_exceptions.push_back( e );
+			*ip = it->second;
+			return true;
+		}
+	}
+	return false;
+}
+
+void VM::Unwind( const frame_t& frame ) const {
+	Truncate( m_values, frame.values );
+	Truncate( m_contexts, frame.contexts );
+	Truncate( m_iterators, frame.iterators );
+	Truncate( m_handlers, frame.handlers );
+	Truncate( m_exceptions, frame.exceptions );
+}
+
+const gse::Value VM::Math( context::Context* ctx, const bytecode::instruction_t& instruction, const std::string& error_prefix, const gse::Value& av, const gse::Value& bv ) const {
+	const auto* a = av.Get();
+	const auto* b = bv.Get();
+	const auto& operation_not_supported = [ &ctx, &instruction, &error_prefix, &a, &b ]() -> gse::Exception {
+		return gse::Exception( EC.OPERATION_NOT_SUPPORTED, error_prefix + a->ToString() + " and " + b->ToString(), ctx, *instruction.si );
+	};
+	const auto& math_error = [ &ctx, &instruction ]( const std::string& reason ) -> gse::Exception {
+		return gse::Exception( EC.MATH_ERROR, reason, ctx, *instruction.si );
+	};
+	if ( a->type != b->type ) {
+		throw operation_not_supported();
+	}
+	// compound assignments ( INC_BY etc ) don't check for division by zero, same as in Interpreter
+	switch ( a->type ) {
+		case Type::T_INT: {
+			const auto aval = ( (Int*)a )->value;
+			const auto bval = ( (Int*)b )->value;
+			switch ( instruction.flags ) {
+				case program::OT_ADD:
+				case program::OT_INC_BY:
+					return VALUE( Int, aval + bval );
+				case program::OT_SUB:
+				case program::OT_DEC_BY:
+					return VALUE( Int, aval - bval );
+				case program::OT_MULT:
+				case program::OT_MULT_BY:
+					return VALUE( Int, aval * bval );
+				case program::OT_DIV:
+				case program::OT_DIV_BY:
+					if ( instruction.flags == program::OT_DIV && bval == 0 ) {
+						throw math_error( "Division by zero" );
+					}
+					return VALUE( Int, aval / bval );
+				case program::OT_MOD:
+				case program::OT_MOD_BY:
+					if ( instruction.flags == program::OT_MOD && bval == 0 ) {
+						throw math_error( "Division by zero" );
+					}
+					return VALUE( Int, aval % bval );
+				default:
+					throw operation_not_supported();
+			}
+		}
+		case Type::T_FLOAT: {
+			const auto aval = ( (Float*)a )->value;
+			const auto bval = ( (Float*)b )->value;
+			switch ( instruction.flags ) {
+				case program::OT_ADD:
+				case program::OT_INC_BY:
+					return VALUE( Float, aval + bval );
+				case program::OT_SUB:
+				case program::OT_DEC_BY:
+					return VALUE( Float, aval - bval );
+				case program::OT_MULT:
+				case program::OT_MULT_BY:
+					return VALUE( Float, aval * bval );
+				case program::OT_DIV:
+				case program::OT_DIV_BY:
+					if ( instruction.flags == program::OT_DIV && bval == 0.0f ) {
+						throw math_error( "Division by zero" );
+					}
+					return VALUE( Float, aval / bval );
+				default:
+					throw operation_not_supported();
+			}
+		}
+		case Type::T_STRING: {
+			if ( instruction.flags != program::OT_ADD && instruction.flags != program::OT_INC_BY ) {
+				throw operation_not_supported();
+			}
+			return VALUE( String, ( (String*)a )->value + ( (String*)b )->value );
+		}
+		case Type::T_ARRAY: {
+			if ( instruction.flags != program::OT_ADD && instruction.flags != program::OT_INC_BY ) {
+				throw operation_not_supported();
+			}
+			array_elements_t elements = ( (type::Array*)a )->value;
+			elements.insert( elements.end(), ( (type::Array*)b )->value.begin(), ( (type::Array*)b )->value.end() );
+			return VALUE( type::Array, elements );
+		}
+		case Type::T_OBJECT: {
+			if ( instruction.flags != program::OT_ADD && instruction.flags != program::OT_INC_BY ) {
+				throw operation_not_supported();
+			}
+			object_properties_t properties = ( (type::Object*)a )->value;
+			for ( const auto& it : ( (type::Object*)b )->value ) {
+				if ( properties.find( it.first ) != properties.end() ) {
+					throw gse::Exception(
+						EC.OPERATION_FAILED, ( instruction.flags == program::OT_ADD
+							? "Can't concatenate objects - duplicate key found: "
+							: "Can't append object - duplicate key found: "
+						) + it.first, ctx, *instruction.si
+					);
+				}
+				properties.insert_or_assign( it.first, it.second );
+			}
+			return VALUE( type::Object, properties );
+		}
+		default:
+			throw operation_not_supported();
+	}
+}
+
+const gse::Value VM::At( context::Context* ctx, const bytecode::instruction_t& instruction, const std::string& parent_text, const gse::Value& indexv, const gse::Value* const parentv ) const {
+	std::optional< size_t > index, from, to;
+	const auto* val = indexv.Get();
+	switch ( val->type ) {
+		case Type::T_INT: {
+			index = ( (Int*)val )->value;
+			from = std::nullopt;
+			to = std::nullopt;
+			break;
+		}
+		case Type::T_RANGE: {
+			const auto* range = (Range*)val;
+			index = std::nullopt;
+			from = range->from;
+			to = range->to;
+			break;
+		}
+		default:
+			THROW( "unexpected index type: " + val->ToString() );
+	}
+	const auto& not_an_array = [ &ctx, &instruction, &index, &from, &to ]( const std::string& what ) -> gse::Exception {
+		return gse::Exception(
+			EC.INVALID_DEREFERENCE, "Could not get " +
+				( index.has_value()
+					? "index " + std::to_string( index.value() )
+					: "range [ " + std::to_string( from.value() ) + " : " + std::to_string( to.value() )
+				) +
+				" of non-array: " + what, ctx, *instruction.si
+		);
+	};
+	const auto& get_ref = [ &index, &from, &to ]( const type::Type* arr ) -> gse::Value {
+		if ( index.has_value() ) {
+			return ( (type::Array*)arr )->GetRef( index.value() );
+		}
+		else {
+			return ( (type::Array*)arr )->GetRangeRef( from, to );
+		}
+	};
+	switch ( instruction.flags ) {
+		case AT_VARIABLE: {
+			const auto* arr = parentv->Get();
+			if ( arr->type != Type::T_ARRAY ) {
+				throw not_an_array( arr->ToString() );
+			}
+			return get_ref( arr );
+		}
+		case AT_LITERAL: {
+			const auto* arr = parentv->Get();
+			ASSERT( arr->type == Type::T_ARRAY, "parent is not array: " + arr->Dump() );
+			if ( index.has_value() ) {
+				return ( (type::Array*)arr )->Get( index.value() );
+			}
+			else {
+				ValidateRange( ctx, *instruction.si, (type::Array*)arr, from, to );
+				return ( (type::Array*)arr )->GetSubArray( from, to );
+			}
+		}
+		case AT_EXPRESSION: {
+			const auto* ref = parentv->Get();
+			switch ( ref->type ) {
+				case Type::T_ARRAY: {
+					if ( index.has_value() ) {
+						return ( (type::Array*)ref )->Get( index.value() );
+					}
+					else {
+						return ( (type::Array*)ref )->GetRangeRef( from, to );
+					}
+				}
+				case Type::T_ARRAYREF: {
+					const auto* r = (ArrayRef*)ref;
+					const auto arrv = r->array->Get( r->index );
+					const auto* arr = arrv.Get();
+					if ( arr->type != Type::T_ARRAY ) {
+						throw not_an_array( arr->ToString() );
+					}
+					return get_ref( arr );
+				}
+				case Type::T_ARRAYRANGEREF: {
+					throw gse::Exception( EC.OPERATION_NOT_SUPPORTED, "Indexing of array range is not supported", ctx, *instruction.si );
+				}
+				case Type::T_OBJECTREF: {
+					const auto arrv = Deref( ctx, *instruction.si, *parentv );
+					const auto* arr = arrv.Get();
+					if ( arr->type != Type::T_ARRAY ) {
+						throw not_an_array( arr->ToString() );
+					}
+					return get_ref( arr );
+				}
+				default:
+					throw not_an_array( ref->ToString() );
+			}
+		}
+		default:
+			throw not_an_array( parent_text );
+	}
+}
+
+VM::Function::Function(
+	const VM* runner,
+	context::Context* context,
+	const code_t& code,
+	const uint32_t index
+)
+	: runner( runner )
+	, context( context )
+	, code( code )
+	, index( index ) {
+	context->IncRefs();
+}
+
+VM::Function::~Function() {
+	context->DecRefs();
+}
+
+gse::Value VM::Function::Run( context::Context* ctx, const si_t& call_si, const function_arguments_t& arguments ) {
+	const auto& function = code->functions.at( index );
+	ctx->IncRefs();
+	auto* subctx = context->ForkContext( ctx, call_si, true, function.frame, arguments );
+	subctx->IncRefs();
+	const auto result = runner->Run( subctx, code, function.entry );
+	subctx->DecRefs();
+	ctx->DecRefs();
+	return result;
+}
+
+}
+}
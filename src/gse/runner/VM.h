@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include "Runner.h"
+
+#include "gse/type/Types.h"
+
+#include "gse/Value.h"
+#include "gse/Exception.h"
+#include "gse/type/Callable.h"
+
+namespace gse {
+
+namespace runner {
+
+namespace bytecode {
+class Program;
+struct instruction_t;
+}
+
+// runs same programs as Interpreter but compiles them to flat bytecode first, to avoid walking ( and recursing through ) program tree
+CLASS( VM, Runner )
+
+	const Value Execute( context::Context* ctx, const program::Program* program ) const override;
+
+private:
+
+	typedef std::shared_ptr< const bytecode::Program > code_t;
+
+	class Function : public type::Callable {
+	public:
+		Function(
+			const VM* runner,
+			context::Context* context,
+			const code_t& code,
+			const uint32_t index
+		);
+		~Function();
+		Value Run( context::Context* ctx, const si_t& call_si, const type::function_arguments_t& arguments ) override;
+	private:
+		const VM* runner;
+		context::Context* context;
+		const code_t code; // shared with other functions of same program, keeps bytecode alive as long as any of them exists
+		const uint32_t index;
+	};
+
+	// stacks are shared between nested runs ( i.e. function calls ), every run only touches part above its frame
+	struct frame_t {
+		size_t values;
+		size_t contexts;
+		size_t iterators;
+		size_t handlers;
+		size_t exceptions;
+	};
+	struct iterator_t {
+		Value target;
+		size_t index;
+		type::object_properties_t::const_iterator object_it;
+	};
+	struct handler_t {
+		uint32_t try_index;
+		frame_t frame;
+	};
+	mutable std::vector< Value > m_values = {};
+	mutable std::vector< context::Context* > m_contexts = {};
+	mutable std::vector< iterator_t > m_iterators = {};
+	mutable std::vector< handler_t > m_handlers = {};
+	mutable std::vector< gse::Exception > m_exceptions = {}; // caught but not passed to handler yet
+
+	const Value Run( context::Context* ctx, const code_t& code, const uint32_t entry ) const;
+	const Value Loop( const code_t& code, uint32_t ip, const frame_t& frame ) const;
+	const bool Catch( const bytecode::Program* program, const gse::Exception& e, const frame_t& frame, uint32_t* ip ) const;
+	void Unwind( const frame_t& frame ) const;
+
+	const Value Math( context::Context* ctx, const bytecode::instruction_t& instruction, const std::string& error_prefix, const Value& av, const Value& bv ) const;
+	const Value At( context::Context* ctx, const bytecode::instruction_t& instruction, const std::string& parent_text, const Value& indexv, const Value* const parentv ) const;
+
+};
+
+}
+}
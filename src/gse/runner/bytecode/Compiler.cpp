@@ -0,0 +1,661 @@
+#include "Compiler.h"
+
+#include "gse/Exception.h"
+#include "gse/program/Program.h"
+#include "gse/program/Scope.h"
+#include "gse/program/Object.h"
+#include "gse/program/Value.h"
+#include "gse/program/Expression.h"
+#include "gse/program/SimpleCondition.h"
+#include "gse/program/ForCondition.h"
+#include "gse/program/ForConditionInOf.h"
+#include "gse/program/ForConditionExpressions.h"
+#include "gse/program/Operator.h"
+#include "gse/program/Operand.h"
+#include "gse/program/Variable.h"
+#include "gse/program/Function.h"
+#include "gse/program/Call.h"
+#include "gse/program/Array.h"
+#include "gse/program/If.h"
+#include "gse/program/Statement.h"
+#include "gse/program/ElseIf.h"
+#include "gse/program/Else.h"
+#include "gse/program/While.h"
+#include "gse/program/For.h"
+#include "gse/program/Try.h"
+#include "gse/program/Catch.h"
+
+namespace gse {
+
+using namespace program;
+
+namespace runner {
+namespace bytecode {
+
+bytecode::Program* Compiler::Compile( const program::Program* program ) {
+	m_program = new bytecode::Program();
+	m_string_indices.clear();
+	m_pending_functions.clear();
+
+	CompileScope( program->body );
+	Emit( OP_RETURN );
+
+	// function bodies go after main body, they may declare more functions
+	for ( size_t i = 0 ; i < m_pending_functions.size() ; i++ ) {
+		const auto pending = m_pending_functions.at( i );
+		m_program->functions.at( pending.first ).entry = Here();
+		CompileScope( pending.second->body );
+		Emit( OP_RETURN );
+	}
+	m_pending_functions.clear();
+
+	auto* result = m_program;
+	m_program = nullptr;
+	return result;
+}
+
+const uint32_t Compiler::Emit( const opcode_t op, const si_t* si, const uint32_t a, const uint32_t b, const uint8_t flags ) {
+	m_program->instructions.push_back(
+		{
+			op,
+			flags,
+			a,
+			b,
+			si
+		}
+	);
+	return m_program->instructions.size() - 1;
+}
+
+const uint32_t Compiler::Here() const {
+	return m_program->instructions.size();
+}
+
+void Compiler::Patch( const uint32_t jump ) {
+	m_program->instructions.at( jump ).a = Here();
+}
+
+const uint32_t Compiler::String( const std::string& value ) {
+	const auto it = m_string_indices.find( value );
+	if ( it != m_string_indices.end() ) {
+		return it->second;
+	}
+	const uint32_t index = m_program->strings.size();
+	m_program->strings.push_back( value );
+	m_string_indices.insert(
+		{
+			value,
+			index
+		}
+	);
+	return index;
+}
+
+const uint32_t Compiler::Constant( const gse::Value& value ) {
+	m_program->constants.push_back( value );
+	return m_program->constants.size() - 1;
+}
+
+const uint32_t Compiler::Reference( const program::Variable* variable ) {
+	m_program->variables.push_back( variable );
+	return m_program->variables.size() - 1;
+}
+
+const uint32_t Compiler::Frame( const program::frame_t* frame ) {
+	m_program->frames.push_back( frame );
+	return m_program->frames.size() - 1;
+}
+
+const uint32_t Compiler::PropertyCache() {
+	m_program->property_caches.push_back( {} );
+	return m_program->property_caches.size() - 1;
+}
+
+void Compiler::Error( const std::string& class_name, const std::string& message, const si_t* si, const uint8_t flags ) {
+	Emit( OP_ERROR, si, String( class_name ), String( message ), flags );
+}
+
+void Compiler::Fail( const std::string& message ) {
+	Emit( OP_FAIL, nullptr, 0, String( message ) );
+}
+
+void Compiler::CompileScope( const Scope* scope ) {
+	Emit( OP_SCOPE_BEGIN, &scope->m_si, Frame( &scope->frame ) );
+	std::vector< uint32_t > returns = {};
+	for ( const auto& it : scope->body ) {
+		switch ( it->control_type ) {
+			case Control::CT_STATEMENT: {
+				const auto* body = ( (Statement*)it )->body;
+				if ( body->op && body->op->op == OT_RETURN ) {
+					ASSERT( !body->a, "unexpected left operand before return" );
+					ASSERT( body->b, "return value or expression expected" );
+					CompileOperand( body->b );
+					Emit( OP_DEREF, &body->b->m_si );
+					returns.push_back( Emit( OP_JUMP_IF_RESULT ) );
+				}
+				else {
+					CompileExpression( body );
+					Emit( OP_POP );
+				}
+				break;
+			}
+			case Control::CT_CONDITIONAL: {
+				CompileConditional( (Conditional*)it );
+				returns.push_back( Emit( OP_JUMP_IF_RESULT ) );
+				break;
+			}
+			default:
+				Fail( "unexpected control type: " + it->Dump() );
+		}
+	}
+	Emit( OP_PUSH_UNDEFINED );
+	for ( const auto& it : returns ) {
+		Patch( it );
+	}
+	Emit( OP_SCOPE_END );
+}
+
+void Compiler::CompileConditional( const Conditional* conditional, const bool is_nested ) {
+	const auto& compile_if = [ this ]( const SimpleCondition* condition, const Scope* body, const Conditional* els ) -> void {
+		const auto skip = CompileJumpUnless( condition->expression );
+		CompileScope( body );
+		const auto end = Emit( OP_JUMP );
+		Patch( skip );
+		if ( els ) {
+			CompileConditional( els, true );
+		}
+		else {
+			Emit( OP_PUSH_UNDEFINED );
+		}
+		Patch( end );
+	};
+	switch ( conditional->conditional_type ) {
+		case Conditional::CT_IF: {
+			const auto* c = (If*)conditional;
+			compile_if( c->condition, c->body, c->els );
+			break;
+		}
+		case Conditional::CT_ELSEIF: {
+			if ( !is_nested ) {
+				Error( EC.PARSE_ERROR, "Unexpected elseif without if", &conditional->m_si );
+				break;
+			}
+			const auto* c = (ElseIf*)conditional;
+			compile_if( c->condition, c->body, c->els );
+			break;
+		}
+		case Conditional::CT_ELSE: {
+			if ( !is_nested ) {
+				Error( EC.PARSE_ERROR, "Unexpected else without if", &conditional->m_si );
+				break;
+			}
+			CompileScope( ( (Else*)conditional )->body );
+			break;
+		}
+		case Conditional::CT_WHILE: {
+			const auto* c = (While*)conditional;
+			const auto loop = Here();
+			const auto done = CompileJumpUnless( c->condition->expression );
+			CompileScope( c->body );
+			const auto result = Emit( OP_JUMP_IF_RESULT );
+			Emit( OP_JUMP, nullptr, loop );
+			Patch( done );
+			Emit( OP_PUSH_UNDEFINED );
+			Patch( result );
+			break;
+		}
+		case Conditional::CT_FOR: {
+			const auto* c = (For*)conditional;
+			switch ( c->condition->for_type ) {
+				case ForCondition::FCT_EXPRESSIONS: {
+					const auto* condition = (ForConditionExpressions*)c->condition;
+					CompileExpression( condition->init );
+					Emit( OP_POP );
+					const auto loop = Here();
+					const auto done = CompileJumpUnless( condition->check );
+					CompileScope( c->body );
+					const auto result = Emit( OP_JUMP_IF_RESULT );
+					CompileExpression( condition->iterate );
+					Emit( OP_POP );
+					Emit( OP_JUMP, nullptr, loop );
+					Patch( done );
+					Emit( OP_PUSH_UNDEFINED );
+					Patch( result );
+					break;
+				}
+				case ForCondition::FCT_IN_OF: {
+					const auto* condition = (ForConditionInOf*)c->condition;
+					CompileExpression( condition->expression );
+					if ( condition->for_inof_type != ForConditionInOf::FIC_IN && condition->for_inof_type != ForConditionInOf::FIC_OF ) {
+						Fail( "unexpected for in_of condition type: " + std::to_string( condition->for_inof_type ) );
+						break;
+					}
+					Emit( OP_FOR_BEGIN, &condition->m_si, Frame( &condition->frame ) );
+					const auto variable = Reference( condition->variable );
+					const auto loop = Here();
+					const auto done = Emit(
+						OP_FOR_NEXT, &condition->m_si, 0, variable, condition->for_inof_type == ForConditionInOf::FIC_IN
+							? FF_IN
+							: FF_OF
+					);
+					CompileScope( c->body );
+					Emit( OP_FOR_CLEAR, &condition->m_si, 0, variable );
+					const auto result = Emit( OP_JUMP_IF_RESULT );
+					Emit( OP_JUMP, nullptr, loop );
+					Patch( done );
+					Emit( OP_PUSH_UNDEFINED );
+					Patch( result );
+					Emit( OP_FOR_END );
+					break;
+				}
+				default:
+					Fail( "unexpected for condition type: " + std::to_string( c->condition->for_type ) );
+			}
+			break;
+		}
+		case Conditional::CT_TRY: {
+			const auto* c = (Try*)conditional;
+			const uint32_t index = m_program->tries.size();
+			m_program->tries.push_back( {} );
+			Emit( OP_TRY_BEGIN, &c->m_si, index );
+			CompileScope( c->body );
+			Emit( OP_TRY_END );
+			std::vector< uint32_t > ends = { Emit( OP_JUMP ) };
+			for ( const auto& it : c->handlers->handlers->properties ) {
+				m_program->tries.at( index ).handlers.insert(
+					{
+						it.first,
+						Here()
+					}
+				);
+				CompileExpression( it.second );
+				Emit( OP_CATCH, &it.second->m_si );
+				ends.push_back( Emit( OP_JUMP ) );
+			}
+			for ( const auto& it : ends ) {
+				Patch( it );
+			}
+			break;
+		}
+		default:
+			Fail( "unexpected conditional type: " + conditional->Dump() );
+	}
+}
+
+void Compiler::CompileExpression( const Expression* expression ) {
+	if ( !expression->op ) {
+		ASSERT( !expression->b, "expression has second operand but no operator" );
+		ASSERT( expression->a, "expression is empty" );
+		CompileOperand( expression->a );
+		return;
+	}
+	const auto* op = expression->op;
+	const auto& operation_not_supported = [ &op ]() -> std::string {
+		return "Operation " + op->ToString() + " is not supported between ";
+	};
+	switch ( op->op ) {
+		case OT_RETURN: {
+			THROW( "return keyword not allowed here" );
+		}
+		case OT_THROW: {
+			ASSERT( !expression->a, "unexpected left operand before throw" );
+			ASSERT( expression->b, "exception expected" );
+			const auto& invalid_error_definition = "Invalid error definition. Expected: ErrorType(reason), found: " + expression->b->ToString();
+			if ( expression->b->type != Operand::OT_CALL ) {
+				Error( EC.INVALID_CALL, invalid_error_definition, &expression->b->m_si );
+				break;
+			}
+			const auto* e = (Call*)expression->b; // it's not a call but it looks like a call
+			if (
+				!e->callable->a ||
+					e->callable->a->type != Operand::OT_VARIABLE ||
+					e->callable->op ||
+					e->callable->b ||
+					e->arguments.size() != 1 ) {
+				Error( EC.INVALID_CALL, invalid_error_definition, &expression->b->m_si );
+				break;
+			}
+			const auto class_name = String( ( (Variable*)e->callable->a )->name );
+			CompileExpression( e->arguments[ 0 ] );
+			Emit( OP_STRING_CHECK, &expression->b->m_si, String( EC.INVALID_CALL ), String( invalid_error_definition ) );
+			Emit( OP_THROW, &op->m_si, class_name );
+			break;
+		}
+		case OT_ASSIGN: {
+			ASSERT( expression->a, "missing assignment target" );
+			CompileOperand( expression->b );
+			Emit( OP_DEREF_CLONE, &expression->b->m_si ); // for now always copy on assignment
+			switch ( expression->a->type ) {
+				case Operand::OT_VARIABLE: {
+					const auto* var = (Variable*)expression->a;
+					if ( var->name[ 0 ] == '#' ) {
+						Error( EC.INVALID_ASSIGNMENT, "Can't assign to builtin: " + var->name, &var->m_si );
+						break;
+					}
+					Emit(
+						var->hints & VH_CREATE_VAR
+							? OP_CREATE_VAR
+							: var->hints & VH_CREATE_CONST
+								? OP_CREATE_CONST
+								: OP_UPDATE, &var->m_si, Reference( var )
+					);
+					break;
+				}
+				case Operand::OT_EXPRESSION: {
+					// property of object?
+					CompileExpression( (Expression*)expression->a );
+					// assign to reference
+					Emit( OP_WRITE_REF, &expression->a->m_si );
+					break;
+				}
+				default:
+					Emit( OP_ASSIGN_ERROR, &expression->a->m_si, 0, String( " to " + expression->a->ToString() ) );
+			}
+			break;
+		}
+		case OT_NOT: {
+			ASSERT( !expression->a, "unary not may not have left operand" );
+			CompileOperand( expression->b );
+			Emit( OP_NOT, &expression->b->m_si, 0, String( "Expected bool, found: " + expression->b->ToString() ) );
+			break;
+		}
+		case OT_EQ:
+		case OT_NE:
+		case OT_LT:
+		case OT_LTE:
+		case OT_GT:
+		case OT_GTE: {
+			CompileOperand( expression->a );
+			Emit( OP_DEREF, &expression->a->m_si );
+			CompileOperand( expression->b );
+			Emit( OP_DEREF, &expression->b->m_si );
+			Emit( OP_COMPARE, &op->m_si, 0, 0, op->op );
+			break;
+		}
+		case OT_AND:
+		case OT_OR: {
+			CompileOperand( expression->a );
+			Emit( OP_BOOL, &expression->a->m_si, 0, String( "Expected bool, found: " + expression->a->ToString() ) );
+			const auto skip = Emit(
+				op->op == OT_AND
+					? OP_JUMP_IF_FALSE_KEEP
+					: OP_JUMP_IF_TRUE_KEEP
+			);
+			Emit( OP_POP );
+			CompileOperand( expression->b );
+			Emit( OP_BOOL, &expression->b->m_si, 0, String( "Expected bool, found: " + expression->b->ToString() ) );
+			Patch( skip );
+			break;
+		}
+		case OT_ADD:
+		case OT_SUB:
+		case OT_MULT:
+		case OT_DIV:
+		case OT_MOD: {
+			CompileOperand( expression->a );
+			Emit( OP_DEREF, &expression->a->m_si );
+			CompileOperand( expression->b );
+			Emit( OP_DEREF, &expression->b->m_si );
+			Emit( OP_MATH, &op->m_si, String( operation_not_supported() ), 0, op->op );
+			break;
+		}
+		case OT_INC:
+		case OT_DEC: {
+			const uint8_t flags = op->op == OT_DEC
+				? IF_DEC
+				: IF_NONE;
+			uint32_t variable;
+			if ( expression->a ) {
+				ASSERT( !expression->b, "only one operand required, found two" );
+				if ( CompileVariable( expression->a, &variable ) ) {
+					Emit( OP_INC, &expression->a->m_si, variable, String( "Expected int, found: " + expression->a->ToString() ), flags | IF_POSTFIX );
+				}
+			}
+			else if ( expression->b ) {
+				if ( CompileVariable( expression->b, &variable ) ) {
+					Emit( OP_INC, &expression->b->m_si, variable, String( "Expected int, found: " + expression->b->ToString() ), flags );
+				}
+			}
+			else {
+				THROW( "operands not found" );
+			}
+			break;
+		}
+		case OT_INC_BY:
+		case OT_DEC_BY:
+		case OT_MULT_BY:
+		case OT_DIV_BY:
+		case OT_MOD_BY: {
+			uint32_t variable;
+			if ( !CompileVariable( expression->a, &variable ) ) {
+				break;
+			}
+			Emit( OP_GET, &expression->a->m_si, variable );
+			Emit( OP_DEREF, &expression->a->m_si );
+			CompileOperand( expression->b );
+			Emit( OP_DEREF, &expression->b->m_si );
+			Emit( OP_MATH_ASSIGN, &op->m_si, String( operation_not_supported() ), 0, op->op );
+			Emit( OP_UPDATE, &expression->a->m_si, variable );
+			break;
+		}
+		case OT_CHILD: {
+			ASSERT( expression->a, "parent object expected" );
+			uint32_t name;
+			if ( !CompileVarName( expression->b, &name ) ) {
+				break;
+			}
+			switch ( expression->a->type ) {
+				case Operand::OT_VARIABLE: {
+					Emit( OP_GET, &expression->a->m_si, Reference( (Variable*)expression->a ) );
+					Emit( OP_CHILD, &op->m_si, name, PropertyCache(), IF_REF );
+					break;
+				}
+				case Operand::OT_OBJECT: {
+					CompileOperand( expression->a );
+					Emit( OP_CHILD, &op->m_si, name, PropertyCache() );
+					break;
+				}
+				case Operand::OT_EXPRESSION: {
+					CompileExpression( (Expression*)expression->a );
+					Emit( OP_DEREF, &expression->a->m_si );
+					Emit( OP_CHILD, &op->m_si, name, PropertyCache(), IF_REF );
+					break;
+				}
+				default: {
+					Error( EC.INVALID_DEREFERENCE, "Could not get ." + m_program->strings.at( name ) + " of non-object: " + expression->a->ToString(), &op->m_si );
+				}
+			}
+			break;
+		}
+		case OT_AT: {
+			ASSERT( expression->a, "parent array expected" );
+			CompileIndex( expression->b );
+			switch ( expression->a->type ) {
+				case Operand::OT_VARIABLE: {
+					Emit( OP_GET, &expression->a->m_si, Reference( (Variable*)expression->a ) );
+					Emit( OP_AT, &expression->a->m_si, 0, 0, AT_VARIABLE );
+					break;
+				}
+				case Operand::OT_ARRAY: {
+					CompileOperand( expression->a );
+					Emit( OP_AT, &expression->b->m_si, 0, 0, AT_LITERAL );
+					break;
+				}
+				case Operand::OT_EXPRESSION: {
+					CompileExpression( (Expression*)expression->a );
+					Emit( OP_AT, &expression->a->m_si, 0, 0, AT_EXPRESSION );
+					break;
+				}
+				default:
+					Emit( OP_AT, &expression->a->m_si, 0, String( expression->a->ToString() ), AT_INVALID );
+			}
+			break;
+		}
+		case OT_APPEND: {
+			switch ( expression->a->type ) {
+				case Operand::OT_VARIABLE: {
+					Emit( OP_GET, &expression->a->m_si, Reference( (Variable*)expression->a ) );
+					Emit( OP_APPEND_CHECK, &op->m_si, String( operation_not_supported() ), String( " and " + expression->b->ToString() ) );
+					CompileOperand( expression->b );
+					Emit( OP_APPEND );
+					break;
+				}
+				default:
+					Error( EC.OPERATION_NOT_SUPPORTED, operation_not_supported() + expression->a->ToString() + " and " + expression->b->ToString(), &op->m_si );
+			}
+			break;
+		}
+		case OT_RANGE: {
+			uint8_t flags = RF_NONE;
+			if ( expression->a ) {
+				CompileIndex( expression->a, true );
+				flags |= RF_FROM;
+			}
+			if ( expression->b ) {
+				CompileIndex( expression->b, true );
+				flags |= RF_TO;
+			}
+			Emit( OP_RANGE, &op->m_si, 0, 0, flags );
+			break;
+		}
+		default: {
+			Fail( "operator " + op->Dump() + " not implemented" );
+		}
+	}
+}
+
+void Compiler::CompileOperand( const Operand* operand ) {
+	ASSERT( operand, "operand is null" );
+	switch ( operand->type ) {
+		case Operand::OT_VALUE: {
+			Emit( OP_PUSH, &operand->m_si, Constant( ( (program::Value*)operand )->value ) );
+			break;
+		}
+		case Operand::OT_VARIABLE: {
+			Emit( OP_GET, &operand->m_si, Reference( (Variable*)operand ) );
+			break;
+		}
+		case Operand::OT_ARRAY: {
+			const auto* arr = (program::Array*)operand;
+			for ( const auto& it : arr->elements ) {
+				CompileExpression( it );
+			}
+			Emit( OP_ARRAY, &operand->m_si, arr->elements.size() );
+			break;
+		}
+		case Operand::OT_OBJECT: {
+			const auto* obj = (program::Object*)operand;
+			Emit( OP_OBJECT_BEGIN, &operand->m_si, Frame( &obj->frame ) );
+			for ( const auto& it : obj->ordered_properties ) {
+				if ( it.first == "this" ) {
+					Error( EC.INVALID_ASSIGNMENT, "'this' can't be overwritten", &it.second->m_si, IF_PARENT_CONTEXT );
+					continue;
+				}
+				CompileExpression( it.second );
+				Emit( OP_OBJECT_SET, &it.second->m_si, String( it.first ) );
+			}
+			Emit( OP_OBJECT_END );
+			break;
+		}
+		case Operand::OT_SCOPE: {
+			CompileScope( (Scope*)operand );
+			break;
+		}
+		case Operand::OT_EXPRESSION: {
+			CompileExpression( (Expression*)operand );
+			break;
+		}
+		case Operand::OT_FUNCTION: {
+			const auto* func = (program::Function*)operand;
+#ifdef DEBUG
+			for ( const auto& it : func->parameters ) {
+				ASSERT( it->hints == VH_NONE, "function parameters can't have modifiers" );
+			}
+#endif
+			const bytecode::Program::function_t function = {
+				&func->frame,
+				0
+			};
+			const uint32_t index = m_program->functions.size();
+			m_program->functions.push_back( function );
+			m_pending_functions.push_back(
+				{
+					index,
+					func
+				}
+			);
+			Emit( OP_FUNCTION, &operand->m_si, index );
+			break;
+		}
+		case Operand::OT_CALL: {
+			const auto* call = (Call*)operand;
+			CompileExpression( call->callable );
+			Emit( OP_CALLABLE, &call->m_si );
+			for ( const auto& it : call->arguments ) {
+				CompileExpression( it );
+				Emit( OP_DEREF, &it->m_si );
+			}
+			Emit( OP_CALL, &call->m_si, call->arguments.size() );
+			break;
+		}
+		default: {
+			Fail( "operand " + operand->ToString() + " not implemented" );
+		}
+	}
+}
+
+const uint32_t Compiler::CompileJumpUnless( const Operand* operand ) {
+	CompileOperand( operand );
+	return Emit( OP_JUMP_UNLESS, &operand->m_si, 0, String( "Expected bool, found: " + operand->ToString() ) );
+}
+
+void Compiler::CompileIndex( const Operand* operand, const bool only_index ) {
+	ASSERT( operand, "index operand missing" );
+	switch ( operand->type ) {
+		case Operand::OT_VALUE:
+		case Operand::OT_VARIABLE: {
+			CompileOperand( operand );
+			Emit( OP_INDEX, &operand->m_si, 0, 0, IF_LITERAL );
+			break;
+		}
+		case Operand::OT_EXPRESSION: {
+			CompileExpression( (Expression*)operand );
+			Emit( OP_DEREF, &operand->m_si );
+			Emit(
+				OP_INDEX, &operand->m_si, 0, 0, only_index
+					? IF_INT_ONLY
+					: IF_NONE
+			);
+			break;
+		}
+		default: {
+			Fail( "unexpected index type: " + operand->ToString() );
+		}
+	}
+}
+
+const bool Compiler::CompileVarName( const Operand* operand, uint32_t* name ) {
+	if ( operand->type != Operand::OT_VARIABLE ) {
+		Error( EC.REFERENCE_ERROR, "Expected variable, found: " + operand->ToString(), &operand->m_si );
+		return false;
+	}
+	const auto* var = (Variable*)operand;
+	ASSERT( var->hints == VH_NONE, "unexpected variable hints" );
+	*name = String( var->name );
+	return true;
+}
+
+const bool Compiler::CompileVariable( const Operand* operand, uint32_t* variable ) {
+	if ( operand->type != Operand::OT_VARIABLE ) {
+		Error( EC.REFERENCE_ERROR, "Expected variable, found: " + operand->ToString(), &operand->m_si );
+		return false;
+	}
+	const auto* var = (Variable*)operand;
+	ASSERT( var->hints == VH_NONE, "unexpected variable hints" );
+	*variable = Reference( var );
+	return true;
+}
+
+}
+}
+}
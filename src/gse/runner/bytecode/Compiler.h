@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "common/Common.h"
+
+#include "Program.h"
+
+namespace gse {
+
+namespace program {
+class Program;
+class Scope;
+class Conditional;
+class Expression;
+class Operand;
+class Function;
+class Variable;
+}
+
+namespace runner {
+namespace bytecode {
+
+CLASS( Compiler, common::Class )
+
+	// source program must outlive result because instructions point to its source infos
+	Program* Compile( const program::Program* program );
+
+private:
+	Program* m_program = nullptr;
+	std::unordered_map< std::string, uint32_t > m_string_indices = {};
+	std::vector< std::pair< uint32_t, const program::Function* > > m_pending_functions = {};
+
+	const uint32_t Emit( const opcode_t op, const si_t* si = nullptr, const uint32_t a = 0, const uint32_t b = 0, const uint8_t flags = IF_NONE );
+	const uint32_t Here() const;
+	void Patch( const uint32_t jump ); // points jump to next instruction
+
+	const uint32_t String( const std::string& value );
+	const uint32_t Constant( const Value& value );
+	const uint32_t Reference( const program::Variable* variable );
+	const uint32_t Frame( const program::frame_t* frame );
+	const uint32_t PropertyCache();
+	void Error( const std::string& class_name, const std::string& message, const si_t* si, const uint8_t flags = IF_NONE );
+	void Fail( const std::string& message );
+
+	void CompileScope( const program::Scope* scope );
+	void CompileConditional( const program::Conditional* conditional, const bool is_nested = false );
+	void CompileExpression( const program::Expression* expression );
+	void CompileOperand( const program::Operand* operand );
+	const uint32_t CompileJumpUnless( const program::Operand* operand ); // returns jump to patch
+	void CompileIndex( const program::Operand* operand, const bool only_index = false );
+	const bool CompileVarName( const program::Operand* operand, uint32_t* name ); // emits error and returns false if operand isn't variable
+	const bool CompileVariable( const program::Operand* operand, uint32_t* variable ); // same but returns variable reference instead of name
+
+};
+
+}
+}
+}
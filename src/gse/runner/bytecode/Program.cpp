@@ -0,0 +1,80 @@
+#include "Program.h"
+
+namespace gse {
+namespace runner {
+namespace bytecode {
+
+const std::string Program::Dump() const {
+	static const std::vector< std::string > s_opcode_names = {
+		"NOOP",
+		"PUSH",
+		"PUSH_UNDEFINED",
+		"POP",
+		"JUMP",
+		"JUMP_UNLESS",
+		"JUMP_IF_RESULT",
+		"JUMP_IF_FALSE_KEEP",
+		"JUMP_IF_TRUE_KEEP",
+		"RETURN",
+		"SCOPE_BEGIN",
+		"SCOPE_END",
+		"GET",
+		"CREATE_VAR",
+		"CREATE_CONST",
+		"UPDATE",
+		"INC",
+		"DEREF",
+		"DEREF_CLONE",
+		"BOOL",
+		"NOT",
+		"ARRAY",
+		"OBJECT_BEGIN",
+		"OBJECT_SET",
+		"OBJECT_END",
+		"FUNCTION",
+		"CALLABLE",
+		"CALL",
+		"WRITE_REF",
+		"COMPARE",
+		"MATH",
+		"MATH_ASSIGN",
+		"CHILD",
+		"INDEX",
+		"AT",
+		"APPEND_CHECK",
+		"APPEND",
+		"RANGE",
+		"STRING_CHECK",
+		"THROW",
+		"ERROR",
+		"ASSIGN_ERROR",
+		"FAIL",
+		"TRY_BEGIN",
+		"TRY_END",
+		"CATCH",
+		"FOR_BEGIN",
+		"FOR_NEXT",
+		"FOR_CLEAR",
+		"FOR_END",
+	};
+	std::string result = "Bytecode(\n";
+	for ( size_t i = 0 ; i < instructions.size() ; i++ ) {
+		const auto& it = instructions.at( i );
+		result += "\t" + std::to_string( i ) + "\t" + s_opcode_names.at( it.op ) +
+			" " + std::to_string( it.a ) +
+			" " + std::to_string( it.b ) +
+			" " + std::to_string( it.flags ) +
+			( it.si
+				? " " + it.si->ToString()
+				: ""
+			) + "\n";
+	}
+	for ( size_t i = 0 ; i < functions.size() ; i++ ) {
+		result += "\tfunction " + std::to_string( i ) + " @" + std::to_string( functions.at( i ).entry ) + "\n";
+	}
+	return result + ")\n";
+}
+
+}
+}
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "gse/Types.h"
+#include "gse/Value.h"
+#include "gse/program/Types.h"
+#include "gse/type/Shape.h"
+
+namespace gse {
+
+namespace program {
+class Variable;
+}
+
+namespace runner {
+namespace bytecode {
+
+// stack machine, every operand and conditional leaves exactly one value on stack
+// control flow, contexts and reference counting mirror what Interpreter does with same program
+enum opcode_t : uint8_t {
+	OP_NOOP,
+
+	// stack
+	OP_PUSH, // a: constant
+	OP_PUSH_UNDEFINED,
+	OP_POP,
+
+	// control flow
+	OP_JUMP, // a: target
+	OP_JUMP_UNLESS, // a: target, b: operand text; pops value that must be bool and jumps if it's false
+	OP_JUMP_IF_RESULT, // a: target; jumps if top is not undefined ( result of scope or conditional, keeps it ), pops it otherwise
+	OP_JUMP_IF_FALSE_KEEP, // a: target; top is already checked bool, it stays on stack
+	OP_JUMP_IF_TRUE_KEEP, // a: target
+	OP_RETURN, // ends function ( or program ), returns top
+
+	// contexts
+	OP_SCOPE_BEGIN, // a: frame
+	OP_SCOPE_END,
+
+	// variables
+	OP_GET, // a: variable
+	OP_CREATE_VAR, // a: variable, keeps value
+	OP_CREATE_CONST, // a: variable, keeps value
+	OP_UPDATE, // a: variable, keeps value
+	OP_INC, // a: variable, b: text for error, flags: IF_*
+
+	// values
+	OP_DEREF,
+	OP_DEREF_CLONE,
+	OP_BOOL, // b: operand text; derefs top and checks that it's bool
+	OP_NOT, // b: operand text
+	OP_ARRAY, // a: elements count
+	OP_OBJECT_BEGIN, // a: frame
+	OP_OBJECT_SET, // a: key
+	OP_OBJECT_END,
+	OP_FUNCTION, // a: function
+	OP_CALLABLE, // derefs top and checks that it's callable
+	OP_CALL, // a: arguments count
+	OP_WRITE_REF, // pops reference and writes value below it into it
+
+	// operators, flags: program::operator_type_t
+	OP_COMPARE,
+	OP_MATH, // a: error prefix
+	OP_MATH_ASSIGN, // a: error prefix; always followed by OP_UPDATE which is skipped for objects ( same as in Interpreter )
+	OP_CHILD, // a: child name, b: property cache, flags: IF_REF if reference should be returned
+	OP_INDEX, // flags: IF_INT_ONLY if range isn't allowed, IF_LITERAL if operand is value or variable
+	OP_AT, // flags: AT_*, b: text of parent operand ( for AT_INVALID )
+	OP_APPEND_CHECK, // a: error prefix, b: error suffix
+	OP_APPEND,
+	OP_RANGE, // flags: RF_*
+
+	// errors
+	OP_STRING_CHECK, // a: exception class, b: message; throws if top is not string
+	OP_THROW, // a: exception class; pops reason
+	OP_ERROR, // a: exception class, b: message, flags: IF_PARENT_CONTEXT if thrown from parent context
+	OP_ASSIGN_ERROR, // b: error suffix
+	OP_FAIL, // b: message of internal error
+
+	// try/catch
+	OP_TRY_BEGIN, // a: try
+	OP_TRY_END,
+	OP_CATCH, // pops handler and calls it with caught exception
+
+	// for ( in/of )
+	OP_FOR_BEGIN, // a: frame; pops iterated value
+	OP_FOR_NEXT, // a: target when finished, b: variable, flags: FF_*
+	OP_FOR_CLEAR, // b: variable
+	OP_FOR_END,
+};
+
+enum instruction_flag_t : uint8_t {
+	IF_NONE = 0,
+	// OP_INC
+	IF_DEC = 1 << 0,
+	IF_POSTFIX = 1 << 1,
+	// OP_CHILD
+	IF_REF = 1 << 0,
+	// OP_INDEX
+	IF_INT_ONLY = 1 << 0,
+	IF_LITERAL = 1 << 1,
+	// OP_ERROR
+	IF_PARENT_CONTEXT = 1 << 0,
+};
+
+enum at_flag_t : uint8_t {
+	AT_VARIABLE,
+	AT_LITERAL,
+	AT_EXPRESSION,
+	AT_INVALID,
+};
+
+enum range_flag_t : uint8_t {
+	RF_NONE = 0,
+	RF_FROM = 1 << 0,
+	RF_TO = 1 << 1,
+};
+
+enum for_flag_t : uint8_t {
+	FF_IN,
+	FF_OF,
+};
+
+struct instruction_t {
+	opcode_t op;
+	uint8_t flags;
+	uint32_t a;
+	uint32_t b;
+	const si_t* si; // points into source program, which must outlive bytecode
+};
+
+class Program {
+public:
+	typedef std::vector< instruction_t > instructions_t;
+	instructions_t instructions = {};
+
+	std::vector< Value > constants = {};
+	std::vector< std::string > strings = {};
+
+	// resolved by program::Resolver, point into source program too
+	std::vector< const program::Variable* > variables = {};
+	std::vector< const program::frame_t* > frames = {};
+
+	struct function_t {
+		const program::frame_t* frame;
+		uint32_t entry;
+	};
+	std::vector< function_t > functions = {};
+
+	struct try_t {
+		std::unordered_map< std::string, uint32_t > handlers; // exception class ( or empty for default handler ) -> entry
+	};
+	std::vector< try_t > tries = {};
+
+	// one per OP_CHILD, updated while running
+	mutable std::vector< type::property_cache_t > property_caches = {};
+
+	const std::string Dump() const;
+};
+
+}
+}
+}
@@ -231,7 +231,7 @@ void AddGSETests( task::gsetests::GSETests* task ) {
 					gse->SetGlobal( "testvar_first", val1 );
 					gse->SetGlobal( "testvar_second", val2 );
 
-					VALUE_SET( type::Int, val1, 10 ); // this should update testvar_first
+					VALUE_SET( type::Int, val1, 10 ); // this should not update testvar_first ( ints are stored by value )
 
 					auto val3 = VALUE_CLONE( type::Int, val2 );
 					VALUE_SET( type::Int, val3, 20 ); // this should not update testvar_second
@@ -253,7 +253,7 @@ void AddGSETests( task::gsetests::GSETests* task ) {
 					};
 					gse->SetGlobal( "testvar_obj3", VALUE( type::Object, properties ) );
 
-					VALUE_SET( type::Int, val3, 30 ); // this should update testvar_third and testvar_obj3.property_int
+					VALUE_SET( type::Int, val3, 30 ); // this should not update testvar_third or testvar_obj3.property_int either
 
 					return VALUE( type::Null );
 				}
@@ -263,9 +263,9 @@ void AddGSETests( task::gsetests::GSETests* task ) {
 
 			gse->Run();
 
-			GT_ASSERT( VALUE_GET( type::Int, gse->GetGlobal( "testvar_first" ) ) == 10 );
+			GT_ASSERT( VALUE_GET( type::Int, gse->GetGlobal( "testvar_first" ) ) == 1 );
 			GT_ASSERT( VALUE_GET( type::Int, gse->GetGlobal( "testvar_second" ) ) == 2 );
-			GT_ASSERT( VALUE_GET( type::Int, gse->GetGlobal( "testvar_third" ) ) == 30 );
+			GT_ASSERT( VALUE_GET( type::Int, gse->GetGlobal( "testvar_third" ) ) == 20 );
 
 			const auto obj1 = VALUE_GET( type::Object, gse->GetGlobal( "testvar_obj1" ) );
 			GT_ASSERT( obj1.empty() );
@@ -277,7 +277,7 @@ void AddGSETests( task::gsetests::GSETests* task ) {
 
 			const auto obj3 = VALUE_GET( type::Object, gse->GetGlobal( "testvar_obj3" ) );
 			GT_ASSERT( obj3.size() == 3 );
-			GT_ASSERT( VALUE_GET( type::Int, obj3.at( "property_int" ) ) == 30 );
+			GT_ASSERT( VALUE_GET( type::Int, obj3.at( "property_int" ) ) == 20 );
 			GT_ASSERT( VALUE_GET( type::String, obj3.at( "property_string" ) ) == "STRING" );
 			const auto sum = VALUE_DATA( type::Callable, obj3.at( "property_sum" ) );
 			std::vector< Value > args = {
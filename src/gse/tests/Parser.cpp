@@ -21,7 +21,10 @@
 #include "gse/program/While.h"
 #include "gse/program/Try.h"
 #include "gse/program/Catch.h"
+#include "gse/program/Serializer.h"
 #include "gse/parser/JS.h"
+#include "types/Buffer.h"
+#include "types/BufferView.h"
 
 namespace gse {
 using namespace program;
@@ -326,6 +329,55 @@ void AddParserTests( task::gsetests::GSETests* task ) {
 		}
 	);
 
+	task->AddTest(
+		"test if serialized programs are unserialized correctly",
+		GT( validate_program ) {
+			parser::JS parser( GetTestFilename(), GetTestSource(), 1 );
+			const auto* parsed_program = parser.Parse();
+			types::Buffer buf( types::Buffer::F_COMPACT_CHECKSUMMED );
+			program::Serializer().Serialize( &buf, parsed_program );
+			DELETE( parsed_program );
+			types::BufferView view( buf );
+			const auto* program = program::Serializer().Unserialize( &view );
+			const auto result = validate_program( program );
+			if ( program ) {
+				DELETE( program );
+			}
+			return result;
+		}
+	);
+
+	task->AddTest(
+		"test if serialized programs with invalid counts are rejected",
+		GT() {
+			// checksum is valid, so only serializer can notice
+			for ( const long long int count : {
+				-1ll,
+				1ll << 40,
+				1000ll,
+			} ) {
+				types::Buffer buf( types::Buffer::F_COMPACT_CHECKSUMMED );
+				buf.WriteString( "test.gls.js" );
+				buf.WriteBool( true );
+				for ( size_t i = 0 ; i < 4 ; i++ ) {
+					buf.WriteInt( 0 );
+				}
+				buf.WriteInt( count );
+				types::BufferView view( buf );
+				std::string error = "";
+				try {
+					const auto* program = program::Serializer().Unserialize( &view );
+					DELETE( program );
+				}
+				catch ( std::runtime_error& e ) {
+					error = e.what();
+				}
+				GT_ASSERT( error.find( "invalid element count" ) != std::string::npos, "for count " + std::to_string( count ) + ", got \"" + error + "\"" );
+			}
+			GT_OK();
+		}
+	);
+
 }
 
 }
@@ -6,6 +6,8 @@
 #include "gse/GSE.h"
 #include "gse/context/GlobalContext.h"
 #include "gse/runner/Interpreter.h"
+#include "gse/runner/VM.h"
+#include "gse/program/Resolver.h"
 
 #include "mocks/Mocks.h"
 
@@ -18,6 +20,10 @@ void AddRunnerTests( task::gsetests::GSETests* task ) {
 
 	const auto& test_program = GetTestProgram();
 
+	// parser does it for parsed programs, runners rely on it
+	program::Resolver resolver;
+	resolver.Resolve( test_program );
+
 	const std::string expected_output = GetExpectedResult();
 
 #define VALIDATE() { \
@@ -46,6 +52,29 @@ void AddRunnerTests( task::gsetests::GSETests* task ) {
 		}
 	);
 
+	task->AddTest(
+		"test if vm executes programs correctly",
+		GT( task, test_program, expected_output ) {
+
+			runner::VM vm;
+
+			context::GlobalContext* context = gse->CreateGlobalContext();
+			context->IncRefs();
+			context->AddSourceLines( util::String::SplitToLines( GetTestSource() ) );
+			mocks::AddMocks( context, {} );
+
+			gse->LogCaptureStart();
+			vm.Execute( context, test_program );
+			const auto actual_output = gse->LogCaptureStopGet();
+
+			VALIDATE();
+
+			context->DecRefs();
+
+			GT_OK();
+		}
+	);
+
 }
 
 }
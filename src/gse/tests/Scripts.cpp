@@ -43,54 +43,69 @@ void AddScriptsTests( task::gsetests::GSETests* task ) {
 	const auto scripts = c->HasDebugFlag( config::Config::DF_GSE_TESTS_SCRIPT )
 		? std::vector< std::string >{ c->GetGSETestsScript() }
 		: util::FS::ListDirectory( tests_path, true, GSE::PATH_SEPARATOR );
+	// every script is run by every runner, so that they are proven to behave same way
+	const std::vector< std::pair< runner::runner_type_t, std::string > > runner_types = {
+		{
+			runner::RT_INTERPRETER,
+			"interpreter"
+		},
+		{
+			runner::RT_VM,
+			"vm"
+		},
+	};
 	for ( const auto& script : scripts ) {
 		if ( script.substr( 0, tests_path.size() + 2 ) == tests_path + GSE::PATH_SEPARATOR + "_" ) {
 			continue; // these should not be tested directly (i.e. includes)
 		}
-		task->AddTest(
-			"testing " + script,
-			GT( task, script ) {
+		for ( const auto& it : runner_types ) {
+			task->AddTest(
+				"testing " + script + " ( " + it.second + " )",
+				GT( task, script, runner_type = it.first ) {
 
-				parser::Parser* parser = nullptr;
-				const runner::Runner* runner = nullptr;
-				const program::Program* program = nullptr;
-				context::GlobalContext* context = nullptr;
+					gse->SetRunnerType( runner_type );
 
-				std::string last_error = "";
-				try {
-					const auto source = util::FS::ReadFile( script, GSE::PATH_SEPARATOR );
-					parser = gse->GetParser( script, source );
-					context = gse->CreateGlobalContext( script );
-					context->IncRefs();
-					mocks::AddMocks( context, { script } );
-					program = parser->Parse();
-					runner = gse->GetRunner();
-					runner->Execute( context, program );
-				}
-				catch ( Exception& e ) {
-					last_error = e.ToStringAndCleanup();
-					context = nullptr;
-				}
-				catch ( std::runtime_error const& e ) {
-					last_error = (std::string)"Internal error: " + e.what();
-				};
+					parser::Parser* parser = nullptr;
+					const runner::Runner* runner = nullptr;
+					const program::Program* program = nullptr;
+					context::GlobalContext* context = nullptr;
 
-				if ( context ) {
-					context->DecRefs();
-				}
-				if ( program ) {
-					DELETE( program );
-				}
-				if ( runner ) {
-					DELETE( runner );
-				}
-				if ( parser ) {
-					DELETE( parser );
-				}
+					std::string last_error = "";
+					try {
+						const auto source = util::FS::ReadFile( script, GSE::PATH_SEPARATOR );
+						parser = gse->GetParser( script, source );
+						context = gse->CreateGlobalContext( script );
+						context->IncRefs();
+						mocks::AddMocks( context, { script } );
+						program = parser->Parse();
+						runner = gse->GetRunner();
+						runner->Execute( context, program );
+					}
+					catch ( Exception& e ) {
+						last_error = e.ToStringAndCleanup();
+						context = nullptr;
+					}
+					catch ( std::runtime_error const& e ) {
+						last_error = (std::string)"Internal error: " + e.what();
+					};
 
-				return last_error;
-			}
-		);
+					if ( context ) {
+						context->DecRefs();
+					}
+					if ( program ) {
+						DELETE( program );
+					}
+					if ( runner ) {
+						DELETE( runner );
+					}
+					if ( parser ) {
+						DELETE( parser );
+					}
+
+					return last_error;
+				}
+			);
+		}
 	}
 }
 
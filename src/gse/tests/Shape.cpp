@@ -0,0 +1,75 @@
+#include "Shape.h"
+
+#include "task/gsetests/GSETests.h"
+#include "gse/type/Properties.h"
+#include "gse/type/Int.h"
+
+namespace gse {
+namespace tests {
+
+using type::Shape;
+using type::Properties;
+
+void AddShapeTests( task::gsetests::GSETests* task ) {
+
+	// shapes are global, so keys are prefixed with something that no other test or script uses
+
+	task->AddTest(
+		"test if objects with same keys share shape",
+		GT() {
+			Properties a = {};
+			Properties b = {};
+			for ( const auto& key : { "shape_same_x", "shape_same_y", "shape_same_z" } ) {
+				a.insert_or_assign( key, VALUE( type::Int, 1 ) );
+				b.insert_or_assign( key, VALUE( type::Int, 2 ) );
+			}
+			GT_ASSERT( a.GetShape()->IsShared() );
+			GT_ASSERT( a.GetShape() == b.GetShape() );
+
+			Properties c = {};
+			c.insert_or_assign( "shape_same_y", VALUE( type::Int, 3 ) );
+			c.insert_or_assign( "shape_same_x", VALUE( type::Int, 3 ) );
+			GT_ASSERT( c.GetShape()->IsShared() );
+			GT_ASSERT( c.GetShape() != a.GetShape(), ", different order of keys must give different shape" );
+
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if shapes fall back to unshared after too many transitions",
+		GT() {
+			// objects built from dynamic keys, each one branches off same shape
+			const size_t count = Shape::MAX_TRANSITIONS * 2;
+			std::vector< Properties > objects( count );
+			for ( size_t i = 0 ; i < count ; i++ ) {
+				auto& properties = objects[ i ];
+				properties.insert_or_assign( "shape_dynamic_base", VALUE( type::Int, i ) );
+				properties.insert_or_assign( "shape_dynamic_" + std::to_string( i ), VALUE( type::Int, i ) );
+				properties.insert_or_assign( "shape_dynamic_next", VALUE( type::Int, i ) );
+			}
+			for ( size_t i = 0 ; i < count ; i++ ) {
+				const auto& properties = objects[ i ];
+				GT_ASSERT( properties.GetShape()->IsShared() == ( i < Shape::MAX_TRANSITIONS ), "for object " + std::to_string( i ) );
+				// unshared objects must behave same way
+				GT_ASSERT( properties.size() == 3 );
+				GT_ASSERT( ( (type::Int*)properties.at( "shape_dynamic_" + std::to_string( i ) ).Get() )->value == (int64_t)i );
+				GT_ASSERT( properties.begin()->first == "shape_dynamic_" + std::to_string( i ), ", got " + properties.begin()->first );
+				GT_ASSERT( properties.count( "shape_dynamic_" + std::to_string( i + 1 ) ) == 0 );
+			}
+
+			// existing transitions keep being shared
+			Properties again = {};
+			again.insert_or_assign( "shape_dynamic_base", VALUE( type::Int, 0 ) );
+			again.insert_or_assign( "shape_dynamic_0", VALUE( type::Int, 0 ) );
+			again.insert_or_assign( "shape_dynamic_next", VALUE( type::Int, 0 ) );
+			GT_ASSERT( again.GetShape() == objects[ 0 ].GetShape() );
+
+			GT_OK();
+		}
+	);
+
+}
+
+}
+}
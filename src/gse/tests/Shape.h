@@ -0,0 +1,13 @@
+#pragma once
+
+namespace task::gsetests {
+class GSETests;
+}
+
+namespace gse {
+namespace tests {
+
+void AddShapeTests( task::gsetests::GSETests* task );
+
+}
+}
@@ -4,6 +4,7 @@
 #include "Parser.h"
 #include "Runner.h"
 #include "Scripts.h"
+#include "Shape.h"
 
 #include "engine/Engine.h"
 #include "config/Config.h"
@@ -47,6 +48,7 @@ void AddTests( task::gsetests::GSETests* task ) {
 		tests::AddGSETests( task );
 		tests::AddParserTests( task );
 		tests::AddRunnerTests( task );
+		tests::AddShapeTests( task );
 	}
 	tests::AddScriptsTests( task );
 
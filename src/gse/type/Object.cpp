@@ -71,25 +71,31 @@ Object::~Object() {
 	}
 }
 
-const Value& Object::Get( const object_key_t& key ) const {
-	const auto& it = value.find( key );
-	return it == value.end()
+const Value& Object::Get( const object_key_t& key, property_cache_t* cache ) const {
+	const auto slot = value.FindSlot( key, cache );
+	return slot == Shape::NO_SLOT
 		? s_undefined
-		: it->second;
+		: value.GetBySlot( slot );
 }
 
-void Object::Set( const object_key_t& key, const Value& new_value, context::Context* ctx, const si_t& si ) {
+void Object::Set( const object_key_t& key, const Value& new_value, context::Context* ctx, const si_t& si, property_cache_t* cache ) {
 	if ( wrapobj ) {
 		if ( !wrapsetter ) {
 			throw gse::Exception( EC.INVALID_ASSIGNMENT, "Property is read-only", ctx, si );
 		}
 		wrapsetter( wrapobj, key, new_value, ctx, si );
 	}
-	value.insert_or_assign( key, new_value );
+	const auto slot = value.FindSlot( key, cache );
+	if ( slot == Shape::NO_SLOT ) {
+		value.insert_or_assign( key, new_value );
+	}
+	else {
+		value.GetBySlot( slot ) = new_value;
+	}
 }
 
-const Value Object::GetRef( const object_key_t& key ) {
-	return VALUE( ObjectRef, this, key );
+const Value Object::GetRef( const object_key_t& key, property_cache_t* cache ) {
+	return VALUE( ObjectRef, this, key, cache );
 }
 
 void Object::Unlink() {
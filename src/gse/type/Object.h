@@ -43,10 +43,11 @@ public:
 	Object( object_properties_t initial_value = {}, const object_class_t object_class = CLASS_NONE, Wrappable* wrapobj = nullptr, wrapsetter_t* wrapsetter = nullptr );
 	~Object();
 
-	const Value& Get( const object_key_t& key ) const;
-	void Set( const object_key_t& key, const Value& value, context::Context* ctx, const si_t& si );
+	// cache is optional, access sites that have it skip key lookup for objects of same shape
+	const Value& Get( const object_key_t& key, property_cache_t* cache = nullptr ) const;
+	void Set( const object_key_t& key, const Value& value, context::Context* ctx, const si_t& si, property_cache_t* cache = nullptr );
 
-	const Value GetRef( const object_key_t& key );
+	const Value GetRef( const object_key_t& key, property_cache_t* cache = nullptr );
 
 	void Unlink();
 
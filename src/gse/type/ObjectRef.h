@@ -6,19 +6,22 @@ namespace gse {
 namespace type {
 
 class Object;
+struct property_cache_t;
 
 class ObjectRef : public Type {
 public:
 
 	static const type_t GetType() { return Type::T_OBJECTREF; }
 
-	ObjectRef( Object* object, const std::string& key )
+	ObjectRef( Object* object, const std::string& key, property_cache_t* cache = nullptr )
 		: Type( GetType() )
 		, object( object )
-		, key( key ) {}
+		, key( key )
+		, cache( cache ) {}
 
 	Object* object;
 	const std::string key;
+	property_cache_t* cache; // of access site that created ref, if any
 
 };
 
@@ -0,0 +1,125 @@
+#include "Properties.h"
+
+#include <stdexcept>
+
+namespace gse {
+namespace type {
+
+Properties::Properties()
+	: m_shape( Shape::GetEmpty() ) {
+	//
+}
+
+Properties::Properties( std::initializer_list< std::pair< const object_key_t, Value > > properties )
+	: Properties() {
+	m_values.reserve( properties.size() );
+	for ( const auto& it : properties ) {
+		insert( it );
+	}
+}
+
+const bool Properties::empty() const {
+	return m_values.empty();
+}
+
+const size_t Properties::size() const {
+	return m_values.size();
+}
+
+Properties::iterator Properties::begin() {
+	return iterator( this, 0, m_shape );
+}
+
+Properties::iterator Properties::end() {
+	return iterator( this, m_values.size() );
+}
+
+Properties::const_iterator Properties::begin() const {
+	return const_iterator( this, 0, m_shape );
+}
+
+Properties::const_iterator Properties::end() const {
+	return const_iterator( this, m_values.size() );
+}
+
+Properties::iterator Properties::find( const object_key_t& key ) {
+	const auto slot = m_shape->Find( key );
+	if ( slot == Shape::NO_SLOT ) {
+		return end();
+	}
+	const auto& order = m_shape->GetOrder();
+	for ( size_t i = 0 ; i < order.size() ; i++ ) {
+		if ( order[ i ] == slot ) {
+			return iterator( this, i );
+		}
+	}
+	return end();
+}
+
+Properties::const_iterator Properties::find( const object_key_t& key ) const {
+	return const_cast< Properties* >( this )->find( key );
+}
+
+const size_t Properties::count( const object_key_t& key ) const {
+	return m_shape->Find( key ) == Shape::NO_SLOT
+		? 0
+		: 1;
+}
+
+Value& Properties::at( const object_key_t& key ) {
+	const auto slot = m_shape->Find( key );
+	if ( slot == Shape::NO_SLOT ) {
+		throw std::out_of_range( "property not found: " + key );
+	}
+	return m_values[ slot ];
+}
+
+const Value& Properties::at( const object_key_t& key ) const {
+	return const_cast< Properties* >( this )->at( key );
+}
+
+void Properties::insert( const std::pair< const object_key_t, Value >& property ) {
+	if ( m_shape->Find( property.first ) == Shape::NO_SLOT ) {
+		Shape::Extend( m_shape, property.first );
+		m_values.push_back( property.second );
+	}
+}
+
+void Properties::insert_or_assign( const object_key_t& key, const Value& value ) {
+	const auto slot = m_shape->Find( key );
+	if ( slot == Shape::NO_SLOT ) {
+		Shape::Extend( m_shape, key );
+		m_values.push_back( value );
+	}
+	else {
+		m_values[ slot ] = value;
+	}
+}
+
+const Shape* Properties::GetShape() const {
+	return m_shape.get();
+}
+
+Value& Properties::GetBySlot( const uint32_t slot ) {
+	return m_values[ slot ];
+}
+
+const Value& Properties::GetBySlot( const uint32_t slot ) const {
+	return m_values[ slot ];
+}
+
+const uint32_t Properties::FindSlot( const object_key_t& key, property_cache_t* cache ) const {
+	if ( cache && cache->shape == m_shape.get() ) {
+		return cache->slot;
+	}
+	const auto slot = m_shape->Find( key );
+	// only shared shapes live long enough to be cached
+	if ( cache && slot != Shape::NO_SLOT && m_shape->IsShared() ) {
+		cache->shape = m_shape.get();
+		cache->slot = slot;
+	}
+	return slot;
+}
+
+}
+}
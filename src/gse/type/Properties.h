@@ -0,0 +1,136 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <initializer_list>
+#include <type_traits>
+
+#include "gse/Value.h"
+
+#include "Shape.h"
+
+namespace gse {
+namespace type {
+
+// object properties: shape ( key -> slot ) and flat vector of values
+// keeps interface of std::map that it replaced, including iteration in order of keys
+class Properties {
+public:
+
+	template< bool _const >
+	class Iterator {
+	public:
+		typedef typename std::conditional< _const, const Properties, Properties >::type properties_t;
+		typedef typename std::conditional< _const, const Value, Value >::type value_t;
+		typedef std::pair< const object_key_t&, value_t& > reference_t;
+		struct pointer_t {
+			reference_t ref;
+			const reference_t* operator->() const {
+				return &ref;
+			}
+		};
+
+		Iterator() = default;
+		Iterator( properties_t* properties, const size_t index, const std::shared_ptr< Shape >& shape = nullptr )
+			: m_properties( properties )
+			, m_index( index )
+			, m_shape( shape ) {}
+		operator Iterator< true >() const {
+			return Iterator< true >( m_properties, m_index, m_shape );
+		}
+
+		const reference_t operator*() const {
+			const auto* shape = GetShape();
+			const auto slot = shape->GetOrder()[ m_index ];
+			return reference_t( shape->GetKey( slot ), m_properties->m_values[ slot ] );
+		}
+		const pointer_t operator->() const {
+			return pointer_t{ **this };
+		}
+		Iterator& operator++() {
+			m_index++;
+			return *this;
+		}
+		const Iterator operator++( int ) {
+			const auto result = *this;
+			m_index++;
+			return result;
+		}
+		// any iterator that went past its keys is end, so that loops stop same way whether end() was taken before or after properties were added
+		const bool operator==( const Iterator& other ) const {
+			return m_properties == other.m_properties && (
+				m_index == other.m_index ||
+					( m_index >= GetShape()->GetSize() && other.m_index >= other.GetShape()->GetSize() )
+			);
+		}
+		const bool operator!=( const Iterator& other ) const {
+			return !( *this == other );
+		}
+
+	private:
+		friend class Iterator< !_const >;
+
+		properties_t* m_properties = nullptr;
+		size_t m_index = 0;
+		// begin() keeps shape it started with, so properties added during iteration don't shift keys that weren't visited yet
+		// ( holding reference also prevents unshared shape from being extended in place )
+		std::shared_ptr< Shape > m_shape = nullptr;
+
+		const Shape* GetShape() const {
+			return m_shape
+				? m_shape.get()
+				: m_properties->m_shape.get();
+		}
+	};
+	typedef Iterator< false > iterator;
+	typedef Iterator< true > const_iterator;
+
+	Properties();
+	Properties( std::initializer_list< std::pair< const object_key_t, Value > > properties );
+	template< class _iterator >
+	Properties( const _iterator& begin, const _iterator& end )
+		: Properties() {
+		insert( begin, end );
+	}
+
+	const bool empty() const;
+	const size_t size() const;
+
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	iterator find( const object_key_t& key );
+	const_iterator find( const object_key_t& key ) const;
+	const size_t count( const object_key_t& key ) const;
+	Value& at( const object_key_t& key );
+	const Value& at( const object_key_t& key ) const;
+
+	// existing properties are kept, same as in std::map
+	void insert( const std::pair< const object_key_t, Value >& property );
+	template< class _iterator >
+	void insert( const _iterator& begin, const _iterator& end ) {
+		for ( auto it = begin ; it != end ; it++ ) {
+			insert( *it );
+		}
+	}
+	void insert_or_assign( const object_key_t& key, const Value& value );
+
+	const Shape* GetShape() const;
+	// for property caches, slot must be valid for current shape
+	Value& GetBySlot( const uint32_t slot );
+	const Value& GetBySlot( const uint32_t slot ) const;
+
+	// finds slot of key, caching it if possible; returns Shape::NO_SLOT if key doesn't exist
+	const uint32_t FindSlot( const object_key_t& key, property_cache_t* cache ) const;
+
+private:
+	std::shared_ptr< Shape > m_shape;
+	std::vector< Value > m_values = {}; // by slot
+
+};
+
+}
+}
@@ -0,0 +1,102 @@
+#include "Shape.h"
+
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+
+#include "common/Assert.h"
+
+namespace gse {
+namespace type {
+
+static std::atomic< size_t > s_shared_shapes_count = 1; // empty shape
+
+const std::shared_ptr< Shape >& Shape::GetEmpty() {
+	static const std::shared_ptr< Shape > s_empty( new Shape( true ) );
+	return s_empty;
+}
+
+void Shape::Extend( std::shared_ptr< Shape >& shape, const object_key_t& key ) {
+	ASSERT_NOLOG( shape->Find( key ) == NO_SLOT, "key already exists in shape: " + key );
+
+	if ( !shape->m_is_shared && shape.use_count() == 1 ) {
+		// nobody else sees this shape, no need to copy it
+		shape->Append( key );
+		return;
+	}
+
+	if ( shape->m_is_shared && shape->GetSize() < MAX_SHARED_KEYS ) {
+		auto* parent = shape.get();
+		{
+			std::shared_lock< std::shared_mutex > guard( parent->m_transitions_mutex );
+			const auto it = parent->m_transitions.find( key );
+			if ( it != parent->m_transitions.end() ) {
+				shape = it->second;
+				return;
+			}
+		}
+		std::unique_lock< std::shared_mutex > guard( parent->m_transitions_mutex );
+		auto& transitions = parent->m_transitions;
+		const auto it = transitions.find( key ); // could have been added while lock was released
+		if ( it != transitions.end() ) {
+			shape = it->second;
+			return;
+		}
+		if ( transitions.size() < MAX_TRANSITIONS && s_shared_shapes_count < MAX_SHARED_SHAPES ) {
+			s_shared_shapes_count++;
+			std::shared_ptr< Shape > transition( new Shape( true ) );
+			transition->m_keys = parent->m_keys;
+			transition->m_slots = parent->m_slots;
+			transition->m_order = parent->m_order;
+			transition->Append( key );
+			transitions.insert(
+				{
+					key,
+					transition
+				}
+			);
+			shape = transition;
+			return;
+		}
+	}
+
+	std::shared_ptr< Shape > unshared( new Shape( false ) );
+	unshared->m_keys = shape->m_keys;
+	unshared->m_slots = shape->m_slots;
+	unshared->m_order = shape->m_order;
+	unshared->Append( key );
+	shape = unshared;
+}
+
+const uint32_t Shape::Find( const object_key_t& key ) const {
+	const auto it = m_slots.find( key );
+	return it == m_slots.end()
+		? NO_SLOT
+		: it->second;
+}
+
+Shape::Shape( const bool is_shared )
+	: m_is_shared( is_shared ) {
+	//
+}
+
+void Shape::Append( const object_key_t& key ) {
+	const uint32_t slot = m_keys.size();
+	m_keys.push_back( key );
+	m_slots.insert(
+		{
+			key,
+			slot
+		}
+	);
+	m_order.insert(
+		std::lower_bound(
+			m_order.begin(), m_order.end(), key, [ this ]( const uint32_t s, const object_key_t& k ) -> bool {
+				return m_keys[ s ] < k;
+			}
+		), slot
+	);
+}
+
+}
+}
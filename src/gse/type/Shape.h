@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <shared_mutex>
+#include <cstdint>
+
+namespace gse {
+namespace type {
+
+typedef std::string object_key_t; // keep it simple for now
+
+// layout of object properties ( key -> slot ), objects that got same keys in same order share it and store only values
+// shared shapes are interned and never freed, so property access sites can cache slots by shape pointer
+// objects that don't fit into limits below ( i.e. used as dictionaries ) get unshared shape instead, which is extended in place while object is its only owner
+class Shape {
+public:
+	static constexpr uint32_t NO_SLOT = UINT32_MAX;
+	static constexpr size_t MAX_SHARED_KEYS = 64;
+	// per shape, objects built from dynamic keys would otherwise add new branch every time
+	static constexpr size_t MAX_TRANSITIONS = 32;
+	// for whole process, so that interned shapes can't grow without bound in long-running server
+	static constexpr size_t MAX_SHARED_SHAPES = 65536;
+
+	static const std::shared_ptr< Shape >& GetEmpty();
+
+	// replaces shape with one that has key added as last slot, key must not exist in shape yet
+	static void Extend( std::shared_ptr< Shape >& shape, const object_key_t& key );
+
+	const uint32_t Find( const object_key_t& key ) const;
+
+	const bool IsShared() const {
+		return m_is_shared;
+	}
+	const size_t GetSize() const {
+		return m_keys.size();
+	}
+	const object_key_t& GetKey( const uint32_t slot ) const {
+		return m_keys[ slot ];
+	}
+	// slots sorted by key, objects are iterated in this order
+	const std::vector< uint32_t >& GetOrder() const {
+		return m_order;
+	}
+
+private:
+	Shape( const bool is_shared );
+
+	const bool m_is_shared;
+	std::vector< object_key_t > m_keys = {};
+	std::unordered_map< object_key_t, uint32_t > m_slots = {};
+	std::vector< uint32_t > m_order = {};
+
+	// shared shapes only, guarded because shapes are shared between threads
+	// transitions are only ever added, so most of extends only need to read
+	std::shared_mutex m_transitions_mutex;
+	std::unordered_map< object_key_t, std::shared_ptr< Shape > > m_transitions = {};
+
+	void Append( const object_key_t& key );
+
+};
+
+// kept by property access sites, remembers where property was found last time so that it isn't looked up again for objects of same shape
+struct property_cache_t {
+	const Shape* shape;
+	uint32_t slot;
+};
+
+}
+}
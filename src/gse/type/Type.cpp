@@ -17,6 +17,7 @@
 #include "Exception.h"
 
 #include "types/Buffer.h"
+#include "types/BufferView.h"
 
 namespace gse {
 namespace type {
@@ -248,7 +249,7 @@ const Type* Type::Deref() const {
 		}
 		case T_OBJECTREF: {
 			const auto* that = (ObjectRef*)this;
-			return that->object->Get( that->key ).Get();
+			return that->object->Get( that->key, that->cache ).Get();
 		}
 		default:
 			return this;
@@ -403,7 +404,7 @@ void Type::Serialize( types::Buffer* buf, const Type* type ) {
 	}
 }
 
-Value Type::Unserialize( types::Buffer* buf ) {
+Value Type::Unserialize( types::BufferView* buf ) {
 	type_t type = (type_t)buf->ReadInt();
 	switch ( type ) {
 		case T_UNDEFINED:
@@ -421,6 +422,9 @@ Value Type::Unserialize( types::Buffer* buf ) {
 		case T_ARRAY: {
 			array_elements_t elements = {};
 			const auto size = buf->ReadInt();
+			if ( size < 0 || (unsigned long long int)size > buf->GetRemainingSize() ) {
+				THROW( "invalid array size: " + std::to_string( size ) );
+			}
 			elements.reserve( size );
 			for ( size_t i = 0 ; i < size ; i++ ) {
 				elements.push_back( Value::Unserialize( buf ) );
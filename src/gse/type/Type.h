@@ -5,6 +5,7 @@
 
 namespace types {
 class Buffer;
+class BufferView;
 }
 
 namespace gse {
@@ -53,7 +54,7 @@ private:
 	friend class gse::Value;
 
 	static void Serialize( types::Buffer* buf, const Type* type );
-	static Value Unserialize( types::Buffer* buf );
+	static Value Unserialize( types::BufferView* buf );
 
 };
 
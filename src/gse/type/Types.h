@@ -1,16 +1,16 @@
 #pragma once
 
 #include <string>
-#include <map>
 #include <vector>
 
 #include "gse/Value.h"
 
+#include "Properties.h"
+
 namespace gse {
 namespace type {
 
-typedef std::string object_key_t; // keep it simple for now
-typedef std::map< object_key_t, Value > object_properties_t;
+typedef Properties object_properties_t;
 
 typedef std::vector< Value > array_elements_t;
 
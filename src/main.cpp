@@ -23,14 +23,16 @@
 #ifdef DEBUG
 
 #include "logger/Stdout.h"
+
+#endif
+
 #include "graphics/Null.h"
 #include "loader/font/Null.h"
 #include "loader/texture/Null.h"
 #include "loader/sound/Null.h"
 #include "input/Null.h"
 #include "audio/Null.h"
-
-#endif
+#include "ui/Null.h"
 
 #include "resource/ResourceManager.h"
 
@@ -57,6 +59,7 @@
 
 #include "task/intro/Intro.h"
 #include "task/mainmenu/MainMenu.h"
+#include "task/dedicatedserver/DedicatedServer.h"
 
 #include "game/Game.h"
 
@@ -83,6 +86,8 @@
 #ifdef DEBUG
 
 #include "util/System.h"
+#include "util/crc32/CRC32.h"
+#include "network/loopback/Loopback.h"
 #include "debug/MemoryWatcher.h"
 #include "debug/DebugOverlay.h"
 
@@ -131,6 +136,20 @@ int main( const int argc, const char* argv[] ) {
 		std::cout << "WARNING: gdb check skipped due to unsupported platform" << std::endl;
 #endif
 	}
+	if ( config.HasDebugFlag( config::Config::DF_BENCHMARK_CHECKSUM ) ) {
+		for ( const size_t size : { 64, 4 * 1024, 1024 * 1024 } ) {
+			const size_t iterations = 256 * 1024 * 1024 / size;
+			std::cout << "CRC32 ( " << size << " byte blocks ): " << util::crc32::CRC32::MeasureThroughput( size, iterations ) << " MB/s" << std::endl;
+		}
+		exit( EXIT_SUCCESS );
+	}
+	if ( config.HasDebugFlag( config::Config::DF_BENCHMARK_NETWORK ) ) {
+		for ( const size_t size : { 64, 4 * 1024, 64 * 1024 } ) {
+			const size_t packets_count = 256 * 1024 * 1024 / size;
+			std::cout << "Loopback ( " << size << " byte packets ): " << network::loopback::Loopback::MeasureThroughput( size, packets_count ) << " MB/s" << std::endl;
+		}
+		exit( EXIT_SUCCESS );
+	}
 	debug::MemoryWatcher memory_watcher( config.HasDebugFlag( config::Config::DF_MEMORYDEBUG ), config.HasDebugFlag( config::Config::DF_QUIET ) );
 #endif
 
@@ -170,7 +189,9 @@ int main( const int argc, const char* argv[] ) {
 #endif
 
 		network::simpletcp::SimpleTCP network;
-		ui::Default ui;
+		if ( config.HasLaunchFlag( config::Config::LF_NETWORK_STATS ) ) {
+			network.SetStatsFile( config.GetNetworkStatsFile() );
+		}
 		scheduler::Simple scheduler;
 
 #ifdef DEBUG
@@ -182,6 +203,7 @@ int main( const int argc, const char* argv[] ) {
 			input::Null input;
 			graphics::Null graphics;
 			audio::Null audio;
+			ui::Default ui;
 
 			if ( config.HasDebugFlag( config::Config::DF_GSE_TESTS ) ) {
 				NEWV( task, task::gsetests::GSETests );
@@ -213,7 +235,40 @@ int main( const int argc, const char* argv[] ) {
 		}
 		else
 #endif
-		{
+		if ( config.HasLaunchFlag( config::Config::LF_DEDICATED_SERVER ) ) {
+			game::Game game;
+
+			loader::font::Null font_loader;
+			loader::texture::Null texture_loader;
+			loader::sound::Null sound_loader;
+			input::Null input;
+			graphics::Null graphics;
+			audio::Null audio;
+			ui::Null ui;
+
+			NEWV( task, task::dedicatedserver::DedicatedServer );
+			scheduler.AddTask( task );
+
+			engine::Engine engine(
+				&config,
+				&error_handler,
+				logger,
+				nullptr,
+				&font_loader,
+				&texture_loader,
+				&sound_loader,
+				&scheduler,
+				&input,
+				&graphics,
+				&audio,
+				&network,
+				&ui,
+				&game
+			);
+
+			result = engine.Run();
+		}
+		else {
 			game::Game game;
 
 			resource::ResourceManager resource_manager;
@@ -244,6 +299,7 @@ int main( const int argc, const char* argv[] ) {
 
 			graphics::opengl::OpenGL graphics( title, window_size.x, window_size.y, vsync, start_fullscreen );
 			audio::sdl2::SDL2 audio;
+			ui::Default ui;
 
 #ifdef DEBUG
 			NEWV( debug_overlay, debug::DebugOverlay );
@@ -134,6 +134,12 @@ const MT_Response Network::ProcessRequest( const MT_Request& request, MT_CANCELA
 			m_events_in.push_back( request.event );
 			return response;
 		}
+		case OP_GETSTATS: {
+			MT_Response response;
+			response.result = R_SUCCESS;
+			response.stats = GetStats();
+			return response;
+		}
 		default: {
 			THROW( "unknown network request " + std::to_string( request.op ) );
 		}
@@ -149,6 +155,11 @@ void Network::DestroyResponse( const MT_Response& response ) {
 
 }
 
+void Network::OnRequestCreated() {
+	// network thread may be waiting for socket activity, new request needs to be processed right away
+	m_impl.Wakeup();
+}
+
 void Network::AddEvent( const Event& event ) {
 	m_events_out.push_back( event );
 }
@@ -182,6 +193,12 @@ const connection_mode_t Network::GetCurrentConnectionMode() const {
 	return m_current_connection_mode;
 }
 
+common::mt_id_t Network::MT_GetStats() {
+	MT_Request request;
+	request.op = OP_GETSTATS;
+	return MT_CreateRequest( request );
+}
+
 MT_Response Network::MT_GetResult( common::mt_id_t mt_id ) {
 	return MT_GetResponse( mt_id );
 }
@@ -189,6 +206,72 @@ MT_Response Network::MT_GetResult( common::mt_id_t mt_id ) {
 void Network::Iterate() {
 	MTModule::Iterate();
 	ProcessEvents();
+	if ( m_stats_dump.file.is_open() && m_stats_dump.timer.HasTicked() ) {
+		DumpStats();
+	}
+}
+
+void Network::SetPendingGameEventsCount( const size_t count ) {
+	m_pending_game_events_count = count;
+}
+
+void Network::SetStatsFile( const std::string& path ) {
+	ASSERT( !m_stats_dump.file.is_open(), "stats file already set" );
+	m_stats_dump.file.open( path, std::ios_base::app );
+	if ( !m_stats_dump.file.is_open() ) {
+		THROW( "failed to open \"" + path + "\" for writing" );
+	}
+	m_stats_dump.path = path;
+	if ( m_stats_dump.file.tellp() == 0 ) {
+		m_stats_dump.file << "time,mode,cid,remote_address,rtt_ms,bytes_in,bytes_out,packets_in,packets_out,queued_packets,queued_bytes,events_in,events_out,pending_game_events" << std::endl;
+	}
+	m_stats_dump.timer.SetInterval( 1000 );
+}
+
+const stats_t Network::GetStats() const {
+	stats_t stats = {};
+	CollectConnectionStats( stats.connections );
+	stats.events_in = m_events_in.size();
+	stats.events_out = m_events_out.size();
+	stats.pending_game_events = m_pending_game_events_count;
+	return stats;
+}
+
+void Network::DumpStats() {
+	if ( m_current_connection_mode == CM_NONE ) {
+		return;
+	}
+	const auto stats = GetStats();
+	const std::string mode = m_current_connection_mode == CM_SERVER
+		? "server"
+		: "client";
+	const std::string suffix = "," + std::to_string( stats.events_in ) + "," + std::to_string( stats.events_out ) + "," + std::to_string( stats.pending_game_events );
+	const auto now = time( nullptr );
+	// one row per connection, counters are cumulative so rates can be derived from consecutive rows
+	for ( const auto& c : stats.connections ) {
+		m_stats_dump.file
+			<< now << ","
+			<< mode << ","
+			<< c.cid << ","
+			<< c.remote_address << ","
+			<< c.rtt_ms << ","
+			<< c.bytes_in << ","
+			<< c.bytes_out << ","
+			<< c.packets_in << ","
+			<< c.packets_out << ","
+			<< c.queued_packets << ","
+			<< c.queued_bytes
+			<< suffix << "\n";
+	}
+	m_stats_dump.file.flush();
+	if ( !m_stats_dump.file.good() ) {
+		Log( "WARNING: failed to write stats to \"" + m_stats_dump.path + "\", disabling stats dump" );
+		m_stats_dump.file.close();
+	}
+}
+
+const bool Network::WaitsForActivity() const {
+	return false;
 }
 
 const MT_Response Network::Error( const std::string& errmsg ) const {
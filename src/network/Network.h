@@ -1,11 +1,17 @@
 #pragma once
 
+#include <deque>
+#include <atomic>
+#include <fstream>
+
 #include "common/MTModule.h"
 
 #include "Types.h"
 
 #include "Event.h"
 
+#include "util/Timer.h"
+
 namespace types {
 class Packet;
 }
@@ -23,16 +29,30 @@ CLASS( Network, MTModule )
 
 	common::mt_id_t MT_SendPacket( const types::Packet* packet, const cid_t cid = 0 );
 
+	common::mt_id_t MT_GetStats();
+
 	MT_Response MT_GetResult( common::mt_id_t mt_id );
 
 	void Iterate() override;
 
+	// true if Iterate() sleeps until there is something to do, so that network thread doesn't need to be throttled
+	virtual const bool WaitsForActivity() const;
+
+	// game connection buffers game events before passing them to network, this makes them visible in stats
+	// can be called from any thread
+	void SetPendingGameEventsCount( const size_t count );
+
+	// append stats of every connection to CSV file once per second ( for offline analysis )
+	// must be called before network thread is started
+	void SetStatsFile( const std::string& path );
+
 protected:
 
 	static const int GLSMAC_PORT = 4888;
 	static const int GLSMAC_MAX_INCOMING_CONNECTIONS = 64;
 
-	// should be sufficient to fit any packet
+	// largest frame on wire ( size + data ), larger packets are split into fragments
+	// receive buffers grow on demand up to this size and are released when connection is idle
 	static const int BUFFER_SIZE = 65536;
 
 	// shared structures to minimize reallocations
@@ -52,21 +72,40 @@ protected:
 		fd_t fd;
 	};
 
+	// every packet is sent as 32-bit size followed by data, zero size means 'bye'
+	// if FRAGMENT_FLAG is set in size then it's not last fragment of packet and next frame continues it
+	static const uint32_t FRAGMENT_FLAG = 0x80000000;
+	static const uint32_t MAX_FRAGMENT_SIZE = BUFFER_SIZE - sizeof( uint32_t );
+	struct outbound_packet_t {
+		uint32_t size;
+		std::string data;
+	};
+
 	struct remote_socket_data_t {
 		std::string remote_address = "";
 		fd_t fd = 0;
 		cid_t cid = 0;
 		struct {
-			char* data1 = nullptr;
-			char* data2 = nullptr;
-			char* data = nullptr;
-			char* ptr = nullptr;
-			size_t len = 0;
+			char* data = nullptr; // allocated on demand
+			size_t capacity = 0; // up to BUFFER_SIZE
+			size_t head = 0; // offset of first unprocessed byte
+			size_t tail = 0; // offset after last received byte
 		} buffer = {};
+		struct {
+			std::string data = ""; // fragments received so far
+			bool is_fragmented = false; // true if last fragment wasn't received yet
+		} in = {};
+		struct {
+			std::deque< outbound_packet_t > packets = {};
+			size_t sent = 0; // bytes of first packet ( including size ) that are already sent
+			size_t queued_bytes = 0; // total of all packets ( including size )
+			bool is_waiting = false; // for socket to become writable
+		} out = {};
 		time_t last_data_at = 0;
-		bool ping_needed = false;
 		bool ping_sent = false;
-		bool pong_needed = false;
+		time_t last_ping_at = 0;
+		connection_stats_t stats = {}; // counters and rtt, rest is filled when collected
+		uint32_t timer_serial = 0;
 	};
 
 	struct {
@@ -89,6 +128,9 @@ protected:
 	public:
 		Impl();
 		~Impl();
+		// owns epoll and eventfd descriptors
+		Impl( const Impl& ) = delete;
+		Impl& operator=( const Impl& ) = delete;
 		void Start();
 		void Stop();
 
@@ -101,7 +143,30 @@ protected:
 		const std::string GetErrorMessage( const ec_t ec ) const;
 		int Receive( const fd_t fd, void* buf, const int len ) const;
 		int Send( const fd_t fd, const void* buf, const int len ) const;
+		struct send_buffer_t {
+			const void* data;
+			size_t len;
+		};
+		// gathers all buffers into single call
+		int Send( const fd_t fd, const send_buffer_t* buffers, const size_t count ) const;
 		void CloseSocket( const fd_t fd ) const;
+
+		// readiness notifications ( epoll on linux )
+		// if not supported then sockets need to be polled on every iteration instead
+		bool HasReadinessEvents() const;
+		void Watch( const fd_t fd ) const;
+		// also report socket when it becomes writable
+		void WatchWrites( const fd_t fd, const bool enabled ) const;
+		// blocks until some of watched sockets become readable, Wakeup() is called or timeout expires
+		void Wait( const int timeout_ms, std::vector< fd_t >& ready_fds ) const;
+		// can be called from any thread
+		void Wakeup() const;
+
+	private:
+#ifdef __linux__
+		int m_epoll_fd = -1;
+		int m_wakeup_fd = -1;
+#endif
 	};
 
 	Impl m_impl = {};
@@ -112,10 +177,12 @@ protected:
 	virtual MT_Response Disconnect() = 0;
 	virtual MT_Response DisconnectClient( const cid_t cid ) = 0;
 	virtual void ProcessEvents() = 0;
+	virtual void CollectConnectionStats( std::vector< connection_stats_t >& connections ) const = 0;
 
 	const MT_Response ProcessRequest( const MT_Request& request, MT_CANCELABLE ) override;
 	void DestroyRequest( const MT_Request& request ) override;
 	void DestroyResponse( const MT_Response& response ) override;
+	void OnRequestCreated() override;
 
 	const MT_Response Error( const std::string& errmsg = "" ) const;
 	const MT_Response Success() const;
@@ -137,6 +204,17 @@ private:
 	events_t m_events_out = {}; // from network to other modules
 	events_t m_events_in = {}; // from other modules to network
 
+	std::atomic< size_t > m_pending_game_events_count = 0;
+
+	const stats_t GetStats() const;
+
+	struct {
+		std::string path = "";
+		std::ofstream file;
+		util::Timer timer;
+	} m_stats_dump = {};
+	void DumpStats();
+
 };
 
 }
@@ -24,6 +24,7 @@ enum op_t {
 	OP_DISCONNECT_CLIENT,
 	OP_GETEVENTS,
 	OP_SENDEVENT, // todo: multiple?
+	OP_GETSTATS,
 };
 
 enum connection_mode_t {
@@ -41,6 +42,26 @@ enum result_t {
 
 typedef std::vector< Event > events_t;
 
+// counters are cumulative since connection was established, rates are up to reader
+struct connection_stats_t {
+	cid_t cid = 0; // 0 for connection to server
+	std::string remote_address = "";
+	int32_t rtt_ms = -1; // from last ping, -1 if not measured yet
+	uint64_t bytes_in = 0; // as seen on wire, including framing
+	uint64_t bytes_out = 0;
+	uint64_t packets_in = 0;
+	uint64_t packets_out = 0;
+	size_t queued_packets = 0; // waiting to be sent
+	size_t queued_bytes = 0;
+};
+
+struct stats_t {
+	std::vector< connection_stats_t > connections = {};
+	size_t events_in = 0; // received from other modules but not processed by network yet
+	size_t events_out = 0; // waiting for other modules to fetch them
+	size_t pending_game_events = 0; // buffered by game connection before they are sent
+};
+
 struct MT_Request {
 	op_t op;
 	struct {
@@ -55,6 +76,7 @@ struct MT_Response {
 	result_t result;
 	std::string message;
 	events_t events;
+	stats_t stats;
 };
 
 typedef common::MTModule< MT_Request, MT_Response > MTModule;
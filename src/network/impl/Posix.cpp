@@ -2,18 +2,38 @@
 
 #include <fcntl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <signal.h>
 #include <thread>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
 namespace network {
 
 Network::Impl::Impl() {
 	signal( SIGPIPE, SIG_IGN );
+#ifdef __linux__
+	m_epoll_fd = epoll_create1( EPOLL_CLOEXEC );
+	if ( m_epoll_fd == -1 ) {
+		THROW( "epoll_create1() failed: " + std::to_string( errno ) );
+	}
+	m_wakeup_fd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+	if ( m_wakeup_fd == -1 ) {
+		THROW( "eventfd() failed: " + std::to_string( errno ) );
+	}
+	Watch( m_wakeup_fd );
+#endif
 }
 
 Network::Impl::~Impl() {
-
+#ifdef __linux__
+	close( m_wakeup_fd );
+	close( m_epoll_fd );
+#endif
 }
 
 void Network::Impl::Start() {
@@ -57,12 +77,88 @@ int Network::Impl::Receive( const fd_t fd, void* buf, const int len ) const {
 }
 
 int Network::Impl::Send( const fd_t fd, const void* buf, const int len ) const {
-	ASSERT( len <= BUFFER_SIZE, "packet size overflow ( " + std::to_string( len ) + " > " + std::to_string( BUFFER_SIZE ) + "), consider increasing BUFFER_SIZE" );
 	return send( fd, buf, len, MSG_NOSIGNAL );
 }
 
+int Network::Impl::Send( const fd_t fd, const send_buffer_t* buffers, const size_t count ) const {
+	struct iovec iov[count];
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		iov[ i ].iov_base = (void*)buffers[ i ].data;
+		iov[ i ].iov_len = buffers[ i ].len;
+	}
+	struct msghdr msg = {};
+	msg.msg_iov = iov;
+	msg.msg_iovlen = count;
+	return sendmsg( fd, &msg, MSG_NOSIGNAL );
+}
+
 void Network::Impl::CloseSocket( const fd_t socket ) const {
 	close( socket );
 }
 
+bool Network::Impl::HasReadinessEvents() const {
+#ifdef __linux__
+	return true;
+#else
+	return false;
+#endif
+}
+
+void Network::Impl::Watch( const fd_t fd ) const {
+#ifdef __linux__
+	// level-triggered, closed sockets are removed from epoll automatically
+	struct epoll_event ev = {};
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+	if ( epoll_ctl( m_epoll_fd, EPOLL_CTL_ADD, fd, &ev ) == -1 ) {
+		THROW( "epoll_ctl() failed: " + std::to_string( errno ) );
+	}
+#endif
+}
+
+void Network::Impl::WatchWrites( const fd_t fd, const bool enabled ) const {
+#ifdef __linux__
+	struct epoll_event ev = {};
+	ev.events = enabled
+		? EPOLLIN | EPOLLOUT
+		: EPOLLIN;
+	ev.data.fd = fd;
+	if ( epoll_ctl( m_epoll_fd, EPOLL_CTL_MOD, fd, &ev ) == -1 ) {
+		THROW( "epoll_ctl() failed: " + std::to_string( errno ) );
+	}
+#endif
+}
+
+void Network::Impl::Wait( const int timeout_ms, std::vector< fd_t >& ready_fds ) const {
+#ifdef __linux__
+	struct epoll_event events[ GLSMAC_MAX_INCOMING_CONNECTIONS ];
+	const int count = epoll_wait( m_epoll_fd, events, GLSMAC_MAX_INCOMING_CONNECTIONS, timeout_ms );
+	for ( int i = 0 ; i < count ; i++ ) {
+		const fd_t fd = events[ i ].data.fd;
+		if ( fd == m_wakeup_fd ) {
+			uint64_t value;
+			while ( read( m_wakeup_fd, &value, sizeof( value ) ) > 0 ) {}
+		}
+		else {
+			ready_fds.push_back( fd );
+		}
+	}
+#endif
+}
+
+void Network::Impl::Wakeup() const {
+#ifdef __linux__
+	const uint64_t value = 1;
+	ssize_t result;
+	do {
+		result = write( m_wakeup_fd, &value, sizeof( value ) );
+	}
+	while ( result == -1 && errno == EINTR );
+	// EAGAIN means counter is saturated, so eventfd is readable already and Wait() will wake up anyway
+	if ( result == -1 && errno != EAGAIN ) {
+		THROW( "eventfd write() failed: " + std::to_string( errno ) );
+	}
+#endif
+}
+
 }
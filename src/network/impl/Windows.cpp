@@ -58,4 +58,33 @@ int Network::Impl::Send( const fd_t fd, const void* buf, const int len ) const {
 	return send( fd, (const char*)buf, len, 0 );
 }
 
+int Network::Impl::Send( const fd_t fd, const send_buffer_t* buffers, const size_t count ) const {
+	std::vector< WSABUF > wsabufs( count );
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		wsabufs[ i ].buf = (char*)buffers[ i ].data;
+		wsabufs[ i ].len = buffers[ i ].len;
+	}
+	DWORD sent = 0;
+	if ( WSASend( fd, wsabufs.data(), count, &sent, 0, nullptr, nullptr ) == SOCKET_ERROR ) {
+		return -1;
+	}
+	return sent;
+}
+
+bool Network::Impl::HasReadinessEvents() const {
+	return false;
+}
+
+void Network::Impl::Watch( const fd_t fd ) const {
+}
+
+void Network::Impl::WatchWrites( const fd_t fd, const bool enabled ) const {
+}
+
+void Network::Impl::Wait( const int timeout_ms, std::vector< fd_t >& ready_fds ) const {
+}
+
+void Network::Impl::Wakeup() const {
+}
+
 }
@@ -0,0 +1,429 @@
+#include <chrono>
+
+#include "Loopback.h"
+
+namespace network {
+namespace loopback {
+
+std::mutex Loopback::s_listeners_mutex;
+std::unordered_map< std::string, std::shared_ptr< Loopback::listener_t > > Loopback::s_listeners = {};
+
+Loopback::Loopback( const std::string& address, const bool is_blocking )
+	: Network()
+	, m_address( address )
+	, m_is_blocking( is_blocking )
+	, m_waker( std::make_shared< Waker >() ) {
+	//
+}
+
+void Loopback::Stop() {
+	switch ( GetCurrentConnectionMode() ) {
+		case CM_CLIENT: {
+			Disconnect();
+			break;
+		}
+		case CM_SERVER: {
+			ListenStop();
+			break;
+		}
+		default: {
+		}
+	}
+}
+
+void Loopback::Iterate() {
+	// process requests and send packets from events
+	Network::Iterate();
+
+	if ( m_is_blocking ) {
+		// sleep until peer sends something ( or there is new request )
+		m_waker->Wait( MAX_WAIT_MS );
+	}
+
+	AcceptConnections();
+	ReceiveFromClients();
+	ReceiveFromServer();
+}
+
+const bool Loopback::WaitsForActivity() const {
+	return m_is_blocking;
+}
+
+const double Loopback::MeasureThroughput( const size_t packet_size, const size_t packets_count ) {
+	// batches keep number of pending requests ( and memory ) bounded
+	const size_t batch_size = 1024;
+
+	Loopback server( "benchmark", false );
+	Loopback client( "benchmark", false );
+	const auto f_execute = [ &server, &client ]( Loopback& network, const common::mt_id_t mt_id ) -> MT_Response {
+		server.Iterate();
+		client.Iterate();
+		return network.MT_GetResult( mt_id );
+	};
+	if ( f_execute( server, server.MT_Connect( CM_SERVER ) ).result != R_SUCCESS ) {
+		THROW( "failed to start loopback server" );
+	}
+	if ( f_execute( client, client.MT_Connect( CM_CLIENT, "benchmark" ) ).result != R_SUCCESS ) {
+		THROW( "failed to connect to loopback server" );
+	}
+
+	Event event;
+	event.type = Event::ET_PACKET;
+	event.data.packet_data = std::string( packet_size, 'x' );
+	std::vector< common::mt_id_t > mt_ids = {};
+	mt_ids.reserve( batch_size );
+
+	const auto start = std::chrono::steady_clock::now();
+	size_t packets_sent = 0;
+	size_t packets_received = 0;
+	size_t bytes_received = 0;
+	while ( packets_received < packets_count ) {
+		while ( packets_sent < packets_count && mt_ids.size() < batch_size ) {
+			mt_ids.push_back( client.MT_SendEvent( event ) );
+			packets_sent++;
+		}
+		const auto response = f_execute( server, server.MT_GetEvents() );
+		for ( const auto mt_id : mt_ids ) {
+			client.MT_GetResult( mt_id );
+		}
+		mt_ids.clear();
+		for ( const auto& it : response.events ) {
+			if ( it.type == Event::ET_PACKET ) {
+				packets_received++;
+				bytes_received += it.data.packet_data.size();
+			}
+		}
+	}
+	const std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - start;
+
+	client.Stop();
+	server.Stop();
+
+	return elapsed.count() > 0
+		? (double)bytes_received / ( 1024 * 1024 ) / elapsed.count()
+		: 0.0;
+}
+
+MT_Response Loopback::ListenStart() {
+	ASSERT( !m_server.listener, "already listening" );
+
+	Log( "Starting loopback server on " + m_address );
+
+	auto listener = std::make_shared< listener_t >();
+	listener->waker = m_waker;
+	{
+		std::lock_guard< std::mutex > guard( s_listeners_mutex );
+		if ( s_listeners.find( m_address ) != s_listeners.end() ) {
+			return Error( "Address " + m_address + " is already in use" );
+		}
+		s_listeners[ m_address ] = listener;
+	}
+	m_server.listener = listener;
+
+	Event event;
+	event.type = Event::ET_LISTEN;
+	event.cid = 0; // server always has cid 0
+	AddEvent( event );
+
+	Log( "Server started" );
+
+	return Success();
+}
+
+MT_Response Loopback::ListenStop() {
+	ASSERT( GetCurrentConnectionMode() == CM_SERVER, "ListenStop() on non-server" );
+
+	if ( m_server.listener ) {
+		{
+			std::lock_guard< std::mutex > guard( s_listeners_mutex );
+			const auto it = s_listeners.find( m_address );
+			if ( it != s_listeners.end() && it->second == m_server.listener ) {
+				s_listeners.erase( it );
+			}
+		}
+		// nobody can connect anymore, refuse whoever didn't get accepted yet
+		{
+			std::lock_guard< std::mutex > guard( m_server.listener->pending_links_mutex );
+			for ( const auto& link : m_server.listener->pending_links ) {
+				Send( *link, false, "" );
+			}
+			m_server.listener->pending_links.clear();
+		}
+		m_server.listener = nullptr;
+	}
+
+	Log( "Closing all connection(s)" );
+	std::vector< cid_t > cids = {};
+	cids.reserve( m_server.links.size() );
+	for ( const auto& it : m_server.links ) {
+		cids.push_back( it.first );
+	}
+	for ( const auto cid : cids ) {
+		CloseClientLink( cid, true );
+	}
+
+	Log( "Server stopped" );
+
+	return Success();
+}
+
+MT_Response Loopback::Connect( const std::string& remote_address, MT_CANCELABLE ) {
+	ASSERT( !m_client.link, "connection already active" );
+
+	Log( "Connecting to loopback server on " + remote_address );
+
+	auto link = std::make_shared< link_t >();
+	link->client_waker = m_waker;
+	{
+		std::lock_guard< std::mutex > guard( s_listeners_mutex );
+		const auto it = s_listeners.find( remote_address );
+		if ( it == s_listeners.end() ) {
+			return Error( "Connection failed: nobody listens on " + remote_address );
+		}
+		auto& listener = it->second;
+		link->server_waker = listener->waker;
+		std::lock_guard< std::mutex > pending_guard( listener->pending_links_mutex );
+		if ( listener->next_cid == UINT32_MAX ) {
+			listener->next_cid = 1;
+		}
+		link->cid = listener->next_cid++;
+		listener->pending_links.push_back( link );
+	}
+	link->server_waker->Signal();
+
+	m_client.link = link;
+	m_client.remote_address = remote_address;
+	m_client.stats = {};
+	m_client.stats.rtt_ms = 0; // no latency in same process
+
+	Log( "Connection successful" );
+
+	return Success();
+}
+
+MT_Response Loopback::Disconnect() {
+	if ( m_client.link ) {
+		// no need to send event if disconnect was initiated by user
+		Send( *m_client.link, true, "" );
+		m_client.link = nullptr;
+	}
+	return Success();
+}
+
+MT_Response Loopback::DisconnectClient( const network::cid_t cid ) {
+	if ( GetCurrentConnectionMode() != CM_SERVER ) {
+		Log( "WARNING: DisconnectClient() on non-server" );
+		return Success();
+	}
+	CloseClientLink( cid, true );
+	return Success();
+}
+
+void Loopback::ProcessEvents() {
+	auto events = GetEvents();
+	for ( auto& event : events ) {
+		switch ( event.type ) {
+			case Event::ET_PACKET: {
+				if ( event.cid ) { // presence of cid means we are server
+					if ( GetCurrentConnectionMode() != CM_SERVER ) {
+						Log( "WARNING: got non-zero cid in packet while not being server, ignoring" );
+						break;
+					}
+					const auto it = m_server.links.find( event.cid );
+					if ( it != m_server.links.end() ) { // if not found it may mean event is old so can be ignored
+						Send( *it->second, false, std::move( event.data.packet_data ), &m_server.stats[ event.cid ] );
+					}
+				}
+				else if ( m_client.link ) {
+					Send( *m_client.link, true, std::move( event.data.packet_data ), &m_client.stats );
+				}
+				break;
+			}
+			case Event::ET_DISCONNECT: {
+				Log( "Disconnect event" );
+				switch ( GetCurrentConnectionMode() ) {
+					case CM_NONE: {
+						// not connected, nothing to do
+						break;
+					}
+					case CM_SERVER: {
+						auto response = ListenStop();
+						ASSERT( response.result == R_SUCCESS, "failed to stop listening" );
+						break;
+					}
+					case CM_CLIENT: {
+						auto response = Disconnect();
+						ASSERT( response.result == R_SUCCESS, "failed to disconnect" );
+						break;
+					}
+					default: {
+						THROW( "invalid mode on disconnect" );
+					}
+				}
+				break;
+			}
+			case Event::ET_CLIENT_DISCONNECT: {
+				Log( "Disconnect client event ( cid = " + std::to_string( event.cid ) + " )" );
+				auto response = DisconnectClient( event.cid );
+				ASSERT( response.result == R_SUCCESS, "failed to disconnect client" );
+				break;
+			}
+			default: {
+				// ignore for now
+			}
+		}
+	}
+}
+
+void Loopback::OnRequestCreated() {
+	m_waker->Signal();
+}
+
+void Loopback::CollectConnectionStats( std::vector< connection_stats_t >& connections ) const {
+	// queues are consumed by other side, there is nothing waiting on this side
+	if ( m_client.link ) {
+		connections.push_back( m_client.stats );
+		connections.back().remote_address = m_client.remote_address;
+	}
+	for ( const auto& it : m_server.stats ) {
+		connections.push_back( it.second );
+		connections.back().cid = it.first;
+		connections.back().remote_address = m_address;
+	}
+}
+
+void Loopback::Send( link_t& link, const bool to_server, std::string packet_data, connection_stats_t* stats ) {
+	if ( stats ) {
+		stats->packets_out++;
+		stats->bytes_out += packet_data.size();
+	}
+	message_t message = {};
+	message.packet_data = std::move( packet_data );
+	if ( to_server ) {
+		link.to_server.Push( std::move( message ) );
+		link.server_waker->Signal();
+	}
+	else {
+		link.to_client.Push( std::move( message ) );
+		link.client_waker->Signal();
+	}
+}
+
+void Loopback::AcceptConnections() {
+	if ( !m_server.listener ) {
+		return;
+	}
+	{
+		std::lock_guard< std::mutex > guard( m_server.listener->pending_links_mutex );
+		if ( m_server.listener->pending_links.empty() ) {
+			return;
+		}
+		m_server.accepted_links.swap( m_server.listener->pending_links );
+	}
+	for ( auto& link : m_server.accepted_links ) {
+		Log( "Accepted loopback connection (cid " + std::to_string( link->cid ) + ")" );
+		ASSERT( m_server.links.find( link->cid ) == m_server.links.end(), "duplicate cid" );
+		m_server.links[ link->cid ] = link;
+		m_server.stats[ link->cid ].rtt_ms = 0; // no latency in same process
+
+		Event event;
+		event.type = Event::ET_CLIENT_CONNECT;
+		event.data.remote_address = m_address;
+		event.cid = link->cid;
+		AddEvent( event );
+	}
+	m_server.accepted_links.clear();
+}
+
+void Loopback::ReceiveFromClients() {
+	message_t message = {};
+	for ( auto& it : m_server.links ) {
+		auto& link = *it.second;
+		while ( link.to_server.Pop( message ) ) {
+			if ( message.packet_data.empty() ) {
+				Log( "Connection closed by client (cid " + std::to_string( link.cid ) + ")" );
+				m_server.closed_cids.push_back( link.cid );
+				break;
+			}
+			auto& stats = m_server.stats[ link.cid ];
+			stats.packets_in++;
+			stats.bytes_in += message.packet_data.size();
+			Event event;
+			event.type = Event::ET_PACKET;
+			event.cid = link.cid;
+			event.data.remote_address = m_address;
+			event.data.packet_data = std::move( message.packet_data );
+			AddEvent( event );
+		}
+	}
+	for ( const auto cid : m_server.closed_cids ) {
+		CloseClientLink( cid, false );
+	}
+	m_server.closed_cids.clear();
+}
+
+void Loopback::ReceiveFromServer() {
+	if ( !m_client.link ) {
+		return;
+	}
+	message_t message = {};
+	while ( m_client.link->to_client.Pop( message ) ) {
+		if ( message.packet_data.empty() ) {
+			Log( "Connection closed by server" );
+			m_client.link = nullptr;
+			Event event;
+			event.type = Event::ET_DISCONNECT;
+			AddEvent( event );
+			break;
+		}
+		m_client.stats.packets_in++;
+		m_client.stats.bytes_in += message.packet_data.size();
+		Event event;
+		event.type = Event::ET_PACKET;
+		event.cid = 0;
+		event.data.remote_address = m_client.remote_address;
+		event.data.packet_data = std::move( message.packet_data );
+		AddEvent( event );
+	}
+}
+
+void Loopback::CloseClientLink( const cid_t cid, const bool send_bye ) {
+	const auto it = m_server.links.find( cid );
+	if ( it == m_server.links.end() ) {
+		// already closed
+		return;
+	}
+	Log( "Closing loopback connection (cid " + std::to_string( cid ) + ")" );
+	if ( send_bye ) {
+		Send( *it->second, false, "" );
+	}
+	m_server.links.erase( it );
+	m_server.stats.erase( cid );
+
+	Event event;
+	event.type = Event::ET_CLIENT_DISCONNECT;
+	event.cid = cid;
+	AddEvent( event );
+	InvalidateEventsForDisconnectedClient( cid );
+}
+
+void Loopback::Waker::Signal() {
+	{
+		std::lock_guard< std::mutex > guard( m_mutex );
+		m_is_signaled = true;
+	}
+	m_cv.notify_one();
+}
+
+void Loopback::Waker::Wait( const int timeout_ms ) {
+	std::unique_lock< std::mutex > lock( m_mutex );
+	m_cv.wait_for(
+		lock, std::chrono::milliseconds( timeout_ms ), [ this ]() -> bool {
+			return m_is_signaled;
+		}
+	);
+	m_is_signaled = false;
+}
+
+}
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <vector>
+
+#include "network/Network.h"
+
+#include "Queue.h"
+
+namespace network {
+namespace loopback {
+
+// connects server and client(s) that live in same process, without sockets
+// every connection is pair of lock-free queues, so packets are delivered in order and without latency
+// there are no pings or timeouts, peer is disconnected only if it says 'bye'
+// server listens on address given to constructor, clients connect to it with same address
+CLASS( Loopback, Network )
+
+	// if is_blocking is false then Iterate() never sleeps, useful when both sides are iterated from same thread ( i.e. in tests )
+	Loopback( const std::string& address = "localhost", const bool is_blocking = true );
+
+	void Stop() override;
+	void Iterate() override;
+
+	const bool WaitsForActivity() const override;
+
+	// sends packets from client to server through whole request and event path of both modules, iterating them from calling thread
+	// returns megabytes per second received by server
+	static const double MeasureThroughput( const size_t packet_size, const size_t packets_count );
+
+protected:
+
+	MT_Response ListenStart() override;
+	MT_Response ListenStop() override;
+	MT_Response Connect( const std::string& remote_address, MT_CANCELABLE ) override;
+	MT_Response Disconnect() override;
+	MT_Response DisconnectClient( const network::cid_t cid ) override;
+	void ProcessEvents() override;
+	void CollectConnectionStats( std::vector< connection_stats_t >& connections ) const override;
+
+	void OnRequestCreated() override;
+
+private:
+	// upper bound for sleeping, so that thread still reacts to stop command in time
+	static const int MAX_WAIT_MS = 100;
+
+	// lets other threads wake network thread when they push something to it
+	class Waker {
+	public:
+		void Signal();
+		void Wait( const int timeout_ms );
+	private:
+		std::mutex m_mutex;
+		std::condition_variable m_cv;
+		bool m_is_signaled = false;
+	};
+
+	struct message_t {
+		std::string packet_data = ""; // empty means 'bye'
+	};
+
+	// one per connection, shared by both sides
+	struct link_t {
+		cid_t cid = 0;
+		Queue< message_t > to_server = {};
+		Queue< message_t > to_client = {};
+		std::shared_ptr< Waker > server_waker = nullptr;
+		std::shared_ptr< Waker > client_waker = nullptr;
+	};
+
+	// published in process-wide registry while server is listening
+	struct listener_t {
+		std::shared_ptr< Waker > waker = nullptr;
+		std::mutex pending_links_mutex;
+		std::vector< std::shared_ptr< link_t > > pending_links = {}; // connected but not accepted yet
+		cid_t next_cid = 1; // 0 is reserved for server
+	};
+	static std::mutex s_listeners_mutex;
+	static std::unordered_map< std::string, std::shared_ptr< listener_t > > s_listeners; // address -> listener
+
+	const std::string m_address;
+	const bool m_is_blocking;
+	const std::shared_ptr< Waker > m_waker;
+
+	struct {
+		std::shared_ptr< listener_t > listener = nullptr;
+		std::unordered_map< cid_t, std::shared_ptr< link_t > > links = {};
+		std::unordered_map< cid_t, connection_stats_t > stats = {};
+		std::vector< std::shared_ptr< link_t > > accepted_links = {};
+		std::vector< cid_t > closed_cids = {};
+	} m_server = {};
+
+	struct {
+		std::shared_ptr< link_t > link = nullptr;
+		std::string remote_address = "";
+		connection_stats_t stats = {};
+	} m_client = {};
+
+	// stats are only counted for packets, not for 'bye'
+	void Send( link_t& link, const bool to_server, std::string packet_data, connection_stats_t* stats = nullptr );
+	void AcceptConnections();
+	void ReceiveFromClients();
+	void ReceiveFromServer();
+	void CloseClientLink( const cid_t cid, const bool send_bye );
+
+};
+
+}
+}
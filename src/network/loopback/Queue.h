@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace network {
+namespace loopback {
+
+// unbounded lock-free queue for exactly one producer thread and one consumer thread
+// consumer owns head ( which is always a dummy node ), producer owns tail, they only meet at 'next' pointer of last node
+template< typename T >
+class Queue {
+public:
+
+	Queue()
+		: m_head( new node_t() )
+		, m_tail( m_head ) {}
+
+	~Queue() {
+		while ( m_head ) {
+			node_t* next = m_head->next.load( std::memory_order_relaxed );
+			delete m_head;
+			m_head = next;
+		}
+	}
+
+	Queue( const Queue& ) = delete;
+	Queue& operator=( const Queue& ) = delete;
+
+	// producer thread only
+	void Push( T value ) {
+		node_t* node = new node_t();
+		node->value = std::move( value );
+		m_tail->next.store( node, std::memory_order_release );
+		m_tail = node;
+	}
+
+	// consumer thread only, false if queue is empty
+	bool Pop( T& value ) {
+		node_t* next = m_head->next.load( std::memory_order_acquire );
+		if ( !next ) {
+			return false;
+		}
+		value = std::move( next->value );
+		delete m_head;
+		m_head = next; // becomes new dummy
+		return true;
+	}
+
+private:
+
+	struct node_t {
+		T value = {};
+		std::atomic< node_t* > next = nullptr;
+	};
+
+	node_t* m_head;
+	node_t* m_tail;
+
+};
+
+}
+}
@@ -1,4 +1,5 @@
 #include <thread>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <ws2tcpip.h>
@@ -27,8 +28,14 @@ namespace simpletcp {
 
 static socklen_t sockaddr_in_size = sizeof( struct sockaddr_in );
 
-SimpleTCP::SimpleTCP()
-	: Network() {
+// for round-trip time only, doesn't need to be comparable between hosts
+static uint64_t GetTimeMs() {
+	return std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+SimpleTCP::SimpleTCP( const size_t max_packet_size )
+	: Network()
+	, m_max_packet_size( max_packet_size ) {
 
 }
 
@@ -124,6 +131,7 @@ MT_Response SimpleTCP::ListenStart() {
 
 		ASSERT( m_server.listening_sockets.find( socket_data.fd ) == m_server.listening_sockets.end(), "duplicate listening socket id" );
 		m_server.listening_sockets[ socket_data.fd ] = socket_data;
+		m_impl.Watch( socket_data.fd );
 	}
 
 	freeaddrinfo( res );
@@ -248,15 +256,8 @@ MT_Response SimpleTCP::Connect( const std::string& remote_address, MT_CANCELABLE
 		return error( "Unsupported IP type: " + remote_address );
 	}
 
-	m_client.socket.buffer.len = 0;
-	m_client.socket.buffer.data1 = (char*)malloc( BUFFER_SIZE );
-	m_client.socket.buffer.data2 = (char*)malloc( BUFFER_SIZE );
-	m_client.socket.buffer.data = m_client.socket.buffer.data1;
-	m_client.socket.buffer.ptr = m_client.socket.buffer.data;
-	m_client.socket.last_data_at = time( nullptr );
-	m_client.socket.ping_needed = false;
-	m_client.socket.pong_needed = false;
-	m_client.socket.ping_sent = false;
+	InitRemoteSocket( m_client.socket );
+	m_impl.Watch( m_client.socket.fd );
 
 	Log( "Connection successful" );
 
@@ -266,9 +267,7 @@ MT_Response SimpleTCP::Connect( const std::string& remote_address, MT_CANCELABLE
 MT_Response SimpleTCP::Disconnect() {
 
 	if ( m_client.socket.fd ) {
-		CloseSocket( m_client.socket.fd, 0, true ); // no need to send event if disconnect was initiated by user
-		free( m_client.socket.buffer.data1 );
-		free( m_client.socket.buffer.data2 );
+		DestroyRemoteSocket( m_client.socket, true ); // no need to send event if disconnect was initiated by user
 		m_client.socket.fd = 0;
 	}
 
@@ -312,19 +311,11 @@ void SimpleTCP::ProcessEvents() {
 					}
 					auto it = m_server.client_sockets.find( fd );
 					if ( it != m_server.client_sockets.end() ) { // if not found it may mean event is old so can be ignored
-						if ( !WriteToSocket( it->second.fd, event.data.packet_data ) ) {
-							CloseClientSocket( it->second );
-							m_server.client_sockets.erase( it );
-						}
+						QueuePacket( it->second, event.data.packet_data );
 					}
 				}
 				else if ( m_client.socket.fd ) {
-					if ( !WriteToSocket( m_client.socket.fd, event.data.packet_data ) ) {
-						CloseSocket( m_client.socket.fd );
-						free( m_client.socket.buffer.data1 );
-						free( m_client.socket.buffer.data2 );
-						m_client.socket.fd = 0;
-					}
+					QueuePacket( m_client.socket, event.data.packet_data );
 				}
 				break;
 			}
@@ -367,317 +358,517 @@ void SimpleTCP::ProcessEvents() {
 void SimpleTCP::Iterate() {
 	Network::Iterate();
 
-	m_tmp.now = time( nullptr );
+	// send packets that were queued by events
+	FlushSockets();
 
-	// accept new connections (server)
-	if ( !m_server.listening_sockets.empty() ) {
-		// Log( "Checking for connections" ); // SPAMMY
-		for ( auto& it : m_server.listening_sockets ) {
+	m_ready_fds.clear();
+	if ( m_impl.HasReadinessEvents() ) {
+		// sleep until some socket is readable or writable ( or there is new request )
+		m_impl.Wait( MAX_WAIT_MS, m_ready_fds );
+	}
+	else {
+		// poll everything
+		for ( const auto& it : m_server.listening_sockets ) {
+			m_ready_fds.push_back( it.first );
+		}
+		if ( m_client.socket.fd ) {
+			m_ready_fds.push_back( m_client.socket.fd );
+		}
+		for ( const auto& it : m_server.client_sockets ) {
+			m_ready_fds.push_back( it.first );
+		}
+	}
 
-			m_server.tmp.newfd = accept( it.first, (sockaddr*)&m_server.tmp.client_addr, &sockaddr_in_size );
-			if ( m_server.tmp.newfd != -1 ) {
+	m_tmp.now = time( nullptr );
 
-				Log( "Accepting connection " + std::to_string( m_server.tmp.newfd ) );
+	for ( const auto fd : m_ready_fds ) {
+		if ( m_server.listening_sockets.find( fd ) != m_server.listening_sockets.end() ) {
+			AcceptConnections( fd );
+			continue;
+		}
+		auto* socket = GetRemoteSocket( fd );
+		if ( !socket ) {
+			// closed in meantime
+			continue;
+		}
+		if ( !socket->out.packets.empty() && !FlushSocket( *socket ) ) {
+			CloseRemoteSocket( fd );
+			continue;
+		}
+		if ( !ReadFromSocket( *socket ) ) {
+			CloseRemoteSocket( fd );
+		}
+	}
 
-				m_impl.ConfigureSocket( m_server.tmp.newfd );
+	ProcessTimers();
 
-				remote_socket_data_t data;
-				data.buffer.len = 0;
-				data.buffer.data1 = (char*)malloc( BUFFER_SIZE );
-				data.buffer.data2 = (char*)malloc( BUFFER_SIZE );
-				data.buffer.data = data.buffer.data1;
-				data.buffer.ptr = data.buffer.data;
-				data.fd = m_server.tmp.newfd;
+	// send pongs and pings
+	FlushSockets();
+}
 
-				data.remote_address = inet_ntoa( ( (struct sockaddr_in*)&m_server.tmp.client_addr )->sin_addr );
+const bool SimpleTCP::WaitsForActivity() const {
+	return m_impl.HasReadinessEvents();
+}
 
-				data.last_data_at = m_tmp.now;
-				data.ping_needed = false;
-				data.pong_needed = false;
-				data.ping_sent = false;
-				if ( m_server.next_cid == UINT32_MAX ) {
-					m_server.next_cid = 1;
-				}
-				data.cid = m_server.next_cid++;
-				m_server.cid_to_fd[ data.cid ] = data.fd;
+void SimpleTCP::AcceptConnections( const fd_t listening_fd ) {
+	// Log( "Checking for connections" ); // SPAMMY
+	while ( ( m_server.tmp.newfd = accept( listening_fd, (sockaddr*)&m_server.tmp.client_addr, &sockaddr_in_size ) ) != -1 ) {
 
-				ASSERT( m_server.client_sockets.find( data.fd ) == m_server.client_sockets.end(), "client socket already added" );
-				m_server.client_sockets[ data.fd ] = data;
+		Log( "Accepting connection " + std::to_string( m_server.tmp.newfd ) );
 
-				Log( "Accepted connection from " + data.remote_address + " (cid " + std::to_string( data.cid ) + ")" );
+		m_impl.ConfigureSocket( m_server.tmp.newfd );
 
-				m_tmp.event.Clear();
-				m_tmp.event.type = Event::ET_CLIENT_CONNECT;
-				m_tmp.event.data.remote_address = data.remote_address;
-				m_tmp.event.cid = data.cid;
+		remote_socket_data_t data;
+		data.fd = m_server.tmp.newfd;
 
-				AddEvent( m_tmp.event );
-			}
+		data.remote_address = inet_ntoa( ( (struct sockaddr_in*)&m_server.tmp.client_addr )->sin_addr );
+
+		if ( m_server.next_cid == UINT32_MAX ) {
+			m_server.next_cid = 1;
 		}
+		data.cid = m_server.next_cid++;
+		m_server.cid_to_fd[ data.cid ] = data.fd;
+
+		InitRemoteSocket( data );
+
+		ASSERT( m_server.client_sockets.find( data.fd ) == m_server.client_sockets.end(), "client socket already added" );
+		m_server.client_sockets[ data.fd ] = data;
+		m_impl.Watch( data.fd );
+
+		Log( "Accepted connection from " + data.remote_address + " (cid " + std::to_string( data.cid ) + ")" );
+
+		m_tmp.event.Clear();
+		m_tmp.event.type = Event::ET_CLIENT_CONNECT;
+		m_tmp.event.data.remote_address = data.remote_address;
+		m_tmp.event.cid = data.cid;
+
+		AddEvent( m_tmp.event );
 	}
+}
 
-	// process pings
-	for ( auto it = m_server.client_sockets.begin() ; it != m_server.client_sockets.end() ; ) {
-		if ( !MaybePingDo( it->second ) ) {
-			CloseClientSocket( it->second );
-			m_server.client_sockets.erase( it++ );
-		}
-		else {
-			++it;
-		}
+void SimpleTCP::InitRemoteSocket( remote_socket_data_t& socket ) {
+	// buffer is allocated when first data arrives
+	socket.buffer.data = nullptr;
+	socket.buffer.capacity = 0;
+	socket.buffer.head = 0;
+	socket.buffer.tail = 0;
+	socket.in.data.clear();
+	socket.in.is_fragmented = false;
+	socket.out.packets.clear();
+	socket.out.sent = 0;
+	socket.out.queued_bytes = 0;
+	socket.out.is_waiting = false;
+	socket.last_data_at = time( nullptr );
+	socket.ping_sent = false;
+	socket.last_ping_at = socket.last_data_at;
+	socket.stats = {};
+	socket.timer_serial = m_timers.next_serial++;
+	ScheduleTimer( socket );
+}
+
+Network::remote_socket_data_t* SimpleTCP::GetRemoteSocket( const fd_t fd ) {
+	if ( m_client.socket.fd && m_client.socket.fd == fd ) {
+		return &m_client.socket;
 	}
-	if ( m_client.socket.fd ) {
-		if ( !MaybePingDo( m_client.socket ) ) {
-			CloseSocket( m_client.socket.fd );
-			free( m_client.socket.buffer.data1 );
-			free( m_client.socket.buffer.data2 );
-			m_client.socket.fd = 0;
-		}
+	auto it = m_server.client_sockets.find( fd );
+	if ( it != m_server.client_sockets.end() ) {
+		return &it->second;
 	}
+	return nullptr;
+}
 
-	// read from connection (client)
-	if ( m_client.socket.fd ) {
-		if ( !ReadFromSocket( m_client.socket ) ) {
-			CloseSocket( m_client.socket.fd );
-			free( m_client.socket.buffer.data1 );
-			free( m_client.socket.buffer.data2 );
-			m_client.socket.fd = 0;
-		}
+void SimpleTCP::CloseRemoteSocket( const fd_t fd ) {
+	if ( m_client.socket.fd && m_client.socket.fd == fd ) {
+		DestroyRemoteSocket( m_client.socket );
+		m_client.socket.fd = 0;
+		return;
 	}
-
-	// read from connections (server)
-	for ( auto it = m_server.client_sockets.begin() ; it != m_server.client_sockets.end() ; ) {
-		if ( !ReadFromSocket( it->second ) ) {
-			CloseClientSocket( it->second );
-			m_server.client_sockets.erase( it++ );
-		}
-		else {
-			++it;
-		}
+	auto it = m_server.client_sockets.find( fd );
+	if ( it != m_server.client_sockets.end() ) {
+		CloseClientSocket( it->second );
+		m_server.client_sockets.erase( it );
 	}
 }
 
 bool SimpleTCP::ReadFromSocket( remote_socket_data_t& socket ) {
-
-	// max allowed size to read
-	m_tmp.tmpint = ( BUFFER_SIZE - socket.buffer.len );
-
-	//Log( "Reading up to " + std::to_string( m_tmp.tmpint ) + " bytes from " + std::to_string( socket.fd ) + " (buffer=" + std::to_string( (long int) socket.buffer.ptr ) + ", BUFFER_SIZE=" + std::to_string( BUFFER_SIZE ) + " buffer len = " + std::to_string( socket.buffer.len ) + ")" );
-	m_tmp.tmpint2 = m_impl.Receive( socket.fd, socket.buffer.ptr, m_tmp.tmpint );
-
-	if ( m_tmp.tmpint2 < 0 ) {
-		m_tmp.tmpint = m_impl.GetLastErrorCode();
-		if ( m_impl.IsConnectionIdle( m_tmp.tmpint ) ) {
-			// no pending data
-			if ( !MaybePing( socket ) ) {
-				return false;
+	auto& buffer = socket.buffer;
+
+	// read everything that is pending ( or as much as fits )
+	bool is_eof = false;
+	while ( ReserveBuffer( socket ) ) {
+		const size_t len = buffer.capacity - buffer.tail;
+		m_tmp.tmpint2 = m_impl.Receive( socket.fd, buffer.data + buffer.tail, len );
+		if ( m_tmp.tmpint2 < 0 ) {
+			m_tmp.tmpint = m_impl.GetLastErrorCode();
+			if ( m_impl.IsConnectionIdle( m_tmp.tmpint ) ) {
+				// no pending data
+				break;
 			}
-		}
-		else {
 			Log( "Connection failed (result=" + std::to_string( m_tmp.tmpint2 ) + " code=" + std::to_string( m_tmp.tmpint ) + ")" );
 			return false;
 		}
+		if ( m_tmp.tmpint2 == 0 ) {
+			// end of stream, otherwise socket would stay readable forever
+			is_eof = true;
+			break;
+		}
+		Log( "Read " + std::to_string( m_tmp.tmpint2 ) + " bytes (size=" + std::to_string( buffer.tail - buffer.head ) + ")" );
+		socket.last_data_at = m_tmp.now;
+		socket.stats.bytes_in += m_tmp.tmpint2;
+		buffer.tail += m_tmp.tmpint2;
+		if ( (size_t)m_tmp.tmpint2 < len ) {
+			// nothing more to read
+			break;
+		}
 	}
 
-	if ( m_tmp.tmpint2 == 0 ) {
-		// no pending data
-		if ( !MaybePing( socket ) ) {
+	// process every complete frame
+	// full buffer always contains at least one, because frame can't be larger than BUFFER_SIZE
+	uint32_t size;
+	bool is_fragment;
+	while ( buffer.tail - buffer.head >= sizeof( size ) ) {
+		memcpy( &size, buffer.data + buffer.head, sizeof( size ) );
+		if ( size == 0 ) {
+			// zero length means 'bye'
+			Log( "Connection closed by remote host" );
+			return false;
+		}
+		is_fragment = size & FRAGMENT_FLAG;
+		size &= ~FRAGMENT_FLAG;
+		if ( size == 0 || size > MAX_FRAGMENT_SIZE ) {
+			Log( "Invalid frame size ( " + std::to_string( size ) + " bytes )" );
 			return false;
 		}
+		if ( buffer.tail - buffer.head < sizeof( size ) + size ) {
+			// not received fully yet
+			break;
+		}
+		const char* data = buffer.data + buffer.head + sizeof( size );
+		buffer.head += sizeof( size ) + size;
+		if ( is_fragment || socket.in.is_fragmented ) {
+			// reassemble
+			if ( socket.in.data.size() + size > m_max_packet_size ) {
+				Log( "Packet is too large ( more than " + std::to_string( m_max_packet_size ) + " bytes )" );
+				return false;
+			}
+			socket.in.data.append( data, size );
+			socket.in.is_fragmented = is_fragment;
+			if ( is_fragment ) {
+				continue;
+			}
+			m_tmp.event.Clear();
+			m_tmp.event.data.packet_data.swap( socket.in.data );
+			socket.in.data.clear();
+		}
+		else {
+			m_tmp.event.Clear();
+			m_tmp.event.data.packet_data.assign( data, size );
+		}
+		Log( "Received packet of " + std::to_string( m_tmp.event.data.packet_data.size() ) + " bytes" );
+		ProcessPacket( socket );
 	}
-
-	if ( m_tmp.tmpint2 > 0 ) {
-
-		Log( "Read " + std::to_string( m_tmp.tmpint2 ) + " bytes into buffer " + std::to_string( (long long)socket.buffer.ptr ) + " (size=" + std::to_string( socket.buffer.len ) + ")" );
-
-		socket.last_data_at = m_tmp.now;
-		socket.ping_needed = false;
-		socket.pong_needed = false;
-
-		socket.buffer.len += m_tmp.tmpint2;
-		socket.buffer.ptr += m_tmp.tmpint2;
-
+	if ( buffer.head == buffer.tail ) {
+		// start from beginning so that next read is contiguous
+		buffer.head = buffer.tail = 0;
 	}
 
-	{
-
-		if ( socket.buffer.len == 0 ) {
-			return true; // no new data
-		}
-
-		//Log( "Trying to process buffer " + to_string( (long int) socket.buffer.data ) + " ( size=" + to_string( socket.buffer.len ) + " )" );
-		if ( socket.buffer.len < sizeof( m_tmp.tmpint ) ) {
-			//Log( "Buffer " + to_string( (long int) socket.buffer.data ) + " does not contain full size field yet ( " + to_string( socket.buffer.len ) + " < " + to_string( sizeof( m_tmp.tmpint ) ) + " )" );
-			return true;
-		}
+	if ( is_eof ) {
+		Log( "Connection closed by remote host" );
+		return false;
+	}
 
-		m_tmp.ptr = socket.buffer.data;
-		memcpy( &m_tmp.tmpint, m_tmp.ptr, sizeof( m_tmp.tmpint ) );
-		m_tmp.tmpint2 = sizeof( m_tmp.tmpint ) + m_tmp.tmpint;
+	return true;
+}
 
-		if ( socket.buffer.len < m_tmp.tmpint2 ) {
-			//Log( "Buffer " + std::to_string( (long int) socket.buffer.data ) + " does not contain all data yet ( " + std::to_string( socket.buffer.len ) + " < " + std::to_string( m_tmp.tmpint2 ) + " )" );
-			return true;
+void SimpleTCP::ProcessPacket( remote_socket_data_t& socket ) {
+	//Log( "Read packet (" + std::to_string( m_tmp.event.data.packet_data.size() ) + " bytes)" );
+	m_tmp.event.cid = socket.cid;
+	m_tmp.event.data.remote_address = socket.remote_address;
+	socket.stats.packets_in++;
+	try {
+		types::Packet p( types::Packet::PT_NONE );
+		p.Unserialize( types::BufferView( m_tmp.event.data.packet_data ) );
+		// quick hack to respond to pings without escalating events outside
+		// TODO: refactor
+		if ( p.type == types::Packet::PT_PING ) {
+			Log( "Ping received, sending pong to " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ")" );
+			types::Packet packet( types::Packet::PT_PONG );
+			packet.udata.ping.sent_at = p.udata.ping.sent_at;
+			QueuePacket( socket, packet.Serialize().ToString() );
+		}
+		else if ( p.type == types::Packet::PT_PONG ) {
+			const uint64_t now = GetTimeMs();
+			if ( p.udata.ping.sent_at <= now ) {
+				socket.stats.rtt_ms = now - p.udata.ping.sent_at;
+			}
+			Log( "Pong received (rtt=" + std::to_string( socket.stats.rtt_ms ) + "ms)" );
+			socket.ping_sent = false;
 		}
 		else {
-			//Log( "Buffer " + std::to_string( (long int) socket.buffer.data ) + " contains enough data ( " + std::to_string( socket.buffer.len ) + " >= " + std::to_string( m_tmp.tmpint2 ) + " )" );
+			//Log( "Sending event" );
+			m_tmp.event.type = Event::ET_PACKET;
+			AddEvent( m_tmp.event );
 		}
+	}
+	catch ( std::runtime_error& err ) {
+		m_tmp.event.type = Event::ET_ERROR;
+		m_tmp.event.data.packet_data = err.what();
+		AddEvent( m_tmp.event );
+	}
+}
 
-		//Log( "Processing buffer " + to_string( (long int) m_tmp.ptr ) + " ( size=" + to_string( m_tmp.tmpint2 ) + " )" );
-
-		if ( m_tmp.tmpint == 0 && m_tmp.tmpint2 == sizeof( m_tmp.tmpint ) ) {
-			// zero length means 'bye'
-			Log( "Connection closed by remote host" );
-			return false;
-		}
+bool SimpleTCP::ReserveBuffer( remote_socket_data_t& socket ) {
+	auto& buffer = socket.buffer;
+	if ( buffer.tail < buffer.capacity ) {
+		return true;
+	}
+	if ( buffer.head > 0 ) {
+		// move unprocessed part to beginning
+		memmove( buffer.data, buffer.data + buffer.head, buffer.tail - buffer.head );
+		buffer.tail -= buffer.head;
+		buffer.head = 0;
+		return true;
+	}
+	if ( buffer.capacity >= BUFFER_SIZE ) {
+		return false;
+	}
+	buffer.capacity = buffer.capacity
+		? std::min( buffer.capacity * 2, (size_t)BUFFER_SIZE )
+		: INITIAL_BUFFER_SIZE;
+	buffer.data = (char*)realloc( buffer.data, buffer.capacity );
+	ASSERT( buffer.data, "failed to allocate receive buffer" );
+	return true;
+}
 
-		m_tmp.ptr += sizeof( m_tmp.tmpint );
+void SimpleTCP::ReleaseBuffer( remote_socket_data_t& socket ) {
+	free( socket.buffer.data );
+	socket.buffer.data = nullptr;
+	socket.buffer.capacity = 0;
+	socket.buffer.head = 0;
+	socket.buffer.tail = 0;
+}
 
-		{
-			//Log( "Read packet (" + std::to_string( m_tmp.tmpint ) + " bytes)" );
-			m_tmp.event.Clear();
-			m_tmp.event.cid = socket.cid;
-			m_tmp.event.data.remote_address = socket.remote_address;
-			m_tmp.event.data.packet_data = std::string( m_tmp.ptr, m_tmp.tmpint );
-			try {
-				types::Packet p( types::Packet::PT_NONE );
-				p.Unserialize( types::Buffer( m_tmp.event.data.packet_data ) );
-				// quick hack to respond to pings without escalating events outside
-				// TODO: refactor
-				if ( p.type == types::Packet::PT_PING ) {
-					Log( "Ping received" );
-					socket.pong_needed = true;
-				}
-				else if ( p.type == types::Packet::PT_PONG ) {
-					Log( "Pong received" );
-					socket.ping_sent = false;
-				}
-				else {
-					//Log( "Sending event" );
-					m_tmp.event.type = Event::ET_PACKET;
-					AddEvent( m_tmp.event );
-				}
+void SimpleTCP::QueuePacket( remote_socket_data_t& socket, const std::string& data ) {
+	ASSERT( data.size() <= m_max_packet_size, "packet size overflow ( " + std::to_string( data.size() ) + " > " + std::to_string( m_max_packet_size ) + " )" );
+	ASSERT( !data.empty(), "empty packet" ); // would mean 'bye'
+	if ( socket.out.packets.empty() ) {
+		m_unflushed_fds.push_back( socket.fd );
+	}
+	socket.stats.packets_out++;
+	socket.out.queued_bytes += data.size() + sizeof( uint32_t ) * ( ( data.size() + MAX_FRAGMENT_SIZE - 1 ) / MAX_FRAGMENT_SIZE );
+	if ( data.size() <= MAX_FRAGMENT_SIZE ) {
+		socket.out.packets.push_back(
+			{
+				(uint32_t)data.size(),
+				data
 			}
-			catch ( std::runtime_error& err ) {
-				m_tmp.event.type = Event::ET_ERROR;
-				m_tmp.event.data.packet_data = err.what();
-				AddEvent( m_tmp.event );
+		);
+		return;
+	}
+	for ( size_t offset = 0 ; offset < data.size() ; offset += MAX_FRAGMENT_SIZE ) {
+		const uint32_t size = std::min( data.size() - offset, (size_t)MAX_FRAGMENT_SIZE );
+		socket.out.packets.push_back(
+			{
+				offset + size < data.size()
+					? size | FRAGMENT_FLAG
+					: size,
+				data.substr( offset, size )
 			}
+		);
+	}
+}
 
+bool SimpleTCP::FlushSocket( remote_socket_data_t& socket ) {
+	auto& out = socket.out;
+	Impl::send_buffer_t buffers[MAX_SEND_BUFFERS];
+	size_t count;
+	size_t total;
+	size_t skip;
+	const auto add = [ &buffers, &count, &total, &skip ]( const void* data, const size_t len ) {
+		if ( skip >= len ) {
+			// already sent
+			skip -= len;
+			return;
+		}
+		buffers[ count++ ] = {
+			(const char*)data + skip,
+			len - skip
+		};
+		total += len - skip;
+		skip = 0;
+	};
+	while ( !out.packets.empty() ) {
+
+		// coalesce as many packets as possible into single call
+		count = 0;
+		total = 0;
+		skip = out.sent;
+		for ( auto it = out.packets.begin() ; it != out.packets.end() && count + 2 <= MAX_SEND_BUFFERS ; it++ ) {
+			add( &it->size, sizeof( it->size ) );
+			add( it->data.data(), it->data.size() );
+		}
+		ASSERT( count > 0, "nothing to send" );
+
+		m_tmp.tmpint2 = m_impl.Send( socket.fd, buffers, count );
+		if ( m_tmp.tmpint2 < 0 ) {
+			m_tmp.tmpint = m_impl.GetLastErrorCode();
+			if ( m_impl.IsConnectionIdle( m_tmp.tmpint ) ) {
+				// socket buffer is full, continue when it's writable
+				break;
+			}
+			Log( "Error writing to socket (errno=" + std::to_string( m_tmp.tmpint ) + " reqsize=" + std::to_string( total ) + ")" );
+			return false;
 		}
 
-		Log( "Processed " + std::to_string( m_tmp.tmpint2 ) + " bytes" );
+		socket.stats.bytes_out += m_tmp.tmpint2;
+		out.queued_bytes -= m_tmp.tmpint2;
 
-		if ( m_tmp.tmpint2 > 0 ) {
-			ASSERT( socket.buffer.len >= m_tmp.tmpint2, "processed more than total" );
-			socket.buffer.len -= m_tmp.tmpint2;
-			if ( socket.buffer.len > 0 ) {
-				if ( socket.buffer.data == socket.buffer.data1 ) {
-					//Log( "SWAP data1 -> data2" );
-					memcpy( socket.buffer.data2, socket.buffer.data + m_tmp.tmpint2, socket.buffer.len );
-					socket.buffer.data = socket.buffer.data2;
-				}
-				else {
-					//Log( "SWAP data2 -> data1" );
-					memcpy( socket.buffer.data1, socket.buffer.data + m_tmp.tmpint2, socket.buffer.len );
-					socket.buffer.data = socket.buffer.data1;
-				}
+		// forget packets that were sent fully, remember how much of next one was sent
+		size_t sent = out.sent + m_tmp.tmpint2;
+		while ( !out.packets.empty() ) {
+			const size_t packet_len = sizeof( uint32_t ) + out.packets.front().data.size();
+			if ( sent < packet_len ) {
+				break;
 			}
-			socket.buffer.ptr = socket.buffer.data + socket.buffer.len;
-
-			//Log( "Buffer size changed to " + to_string( socket.buffer.len ) );
+			sent -= packet_len;
+			out.packets.pop_front();
 		}
+		out.sent = sent;
 
-		return true;
+		if ( (size_t)m_tmp.tmpint2 < total ) {
+			// partial write, socket buffer is full
+			break;
+		}
+	}
 
+	const bool need_wait = !out.packets.empty();
+	if ( need_wait != out.is_waiting ) {
+		m_impl.WatchWrites( socket.fd, need_wait );
+		out.is_waiting = need_wait;
 	}
-	THROW( "?" );
-	return false;
+
+	return true;
 }
 
-bool SimpleTCP::WriteToSocket( int fd, const std::string& data ) {
-	//Log( "WriteToSocket( " + to_string( fd ) + " )" ); // SPAMMY
-	m_tmp.tmpint2 = data.size();
-	//Log( "Writing " + to_string( m_tmp.tmpint2 ) + " bytes" );
-	// send size
-	m_tmp.tmpint = m_impl.Send( fd, &m_tmp.tmpint2, sizeof( m_tmp.tmpint2 ) );
-	if ( m_tmp.tmpint <= 0 ) {
-		m_tmp.tmpint = m_impl.GetLastErrorCode();
-		if ( m_impl.IsConnectionIdle( m_tmp.tmpint ) ) {
-			return true; // no data but connection is alive
+void SimpleTCP::FlushSockets() {
+	for ( const auto fd : m_unflushed_fds ) {
+		auto* socket = GetRemoteSocket( fd );
+		if ( !socket ) {
+			// closed in meantime
+			continue;
 		}
-		Log( "Error writing size to socket (errno=" + std::to_string( m_tmp.tmpint ) + " size=" + std::to_string( m_tmp.tmpint ) + " reqsize=" + std::to_string( m_tmp.tmpint2 ) + ")" );
-
-		return false;
-	}
-	// send data
-	m_tmp.tmpint = m_impl.Send( fd, data.data(), data.size() );
-	if ( m_tmp.tmpint2 <= 0 ) {
-		if ( errno == EAGAIN ) {
-			return true; // no data but connection is alive
+		if ( !FlushSocket( *socket ) ) {
+			CloseRemoteSocket( fd );
 		}
-		Log( "Error writing data to socket" );
-		return false;
 	}
-	//Log( "Write successful" );
-	return true;
+	m_unflushed_fds.clear();
 }
 
-bool SimpleTCP::MaybePing( remote_socket_data_t& socket ) {
+void SimpleTCP::ScheduleTimer( const remote_socket_data_t& socket ) {
 #ifdef DEBUG
 	if ( !m_need_pings ) {
-		return true;
+		return;
 	}
 #endif
+	// earliest moment when socket may need ping or may time out
+	time_t at = socket.last_data_at + (
+		socket.ping_sent
+			? DISCONNECT_AFTER
+			: SEND_PING_AFTER
+	) + 1;
+	if ( !socket.ping_sent ) {
+		at = std::min( at, socket.last_ping_at + MEASURE_RTT_EVERY );
+	}
+	if ( at <= m_timers.last_processed_at ) {
+		at = m_timers.last_processed_at + 1;
+	}
+	m_timers.slots[ at % TIMER_WHEEL_SLOTS ].push_back(
+		{
+			socket.fd,
+			socket.timer_serial
+		}
+	);
+}
 
-	m_tmp.time = m_tmp.now - socket.last_data_at;
-
-	if ( m_tmp.time > SEND_PING_AFTER && !socket.ping_sent ) {
-		Log( "Need ping" );
-		socket.ping_needed = true;
+void SimpleTCP::ProcessTimers() {
+	if ( m_tmp.now <= m_timers.last_processed_at ) {
+		return;
+	}
+	// if thread was stalled for longer than whole wheel turn then every slot is checked just once
+	time_t t = std::max( m_timers.last_processed_at + 1, m_tmp.now - (time_t)TIMER_WHEEL_SLOTS + 1 );
+	m_timers.last_processed_at = m_tmp.now;
+	for ( ; t <= m_tmp.now ; t++ ) {
+		auto& slot = m_timers.slots[ t % TIMER_WHEEL_SLOTS ];
+		if ( slot.empty() ) {
+			continue;
+		}
+		ASSERT( m_timers.expired.empty(), "expired timers not empty" );
+		m_timers.expired.swap( slot );
+		for ( const auto& timer : m_timers.expired ) {
+			auto* socket = GetRemoteSocket( timer.fd );
+			if ( !socket || socket->timer_serial != timer.serial ) {
+				// socket was closed
+				continue;
+			}
+			if ( !ProcessTimer( *socket ) ) {
+				CloseRemoteSocket( timer.fd );
+			}
+		}
+		m_timers.expired.clear();
 	}
-
-	return true;
 }
 
-bool SimpleTCP::MaybePingDo( remote_socket_data_t& socket ) {
-
-#ifdef DEBUG
-	if ( !m_need_pings ) {
-		return true;
-	}
-#endif
+bool SimpleTCP::ProcessTimer( remote_socket_data_t& socket ) {
 
 	m_tmp.time = m_tmp.now - socket.last_data_at;
 
 	if ( m_tmp.time > DISCONNECT_AFTER ) {
 		Log( "Ping timeout on " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ")" );
-
 		return false;
 	}
 
-	if ( socket.ping_needed && !socket.ping_sent ) {
-		Log( "Sending ping to " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ")" );
-		types::Packet packet( types::Packet::PT_PING );
-		std::string data = packet.Serialize().ToString();
-		socket.ping_sent = true;
-		return WriteToSocket( socket.fd, data );
+	if ( m_tmp.time > SEND_PING_AFTER && socket.buffer.head == socket.buffer.tail && !socket.in.is_fragmented ) {
+		// nothing is pending, don't keep memory for idle connection
+		ReleaseBuffer( socket );
+		socket.in.data.shrink_to_fit();
 	}
-	if ( socket.pong_needed ) {
-		Log( "Ping received, sending pong to " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ")" );
-		types::Packet packet( types::Packet::PT_PONG );
-		socket.pong_needed = false;
-		std::string data = packet.Serialize().ToString();
-		return WriteToSocket( socket.fd, data );
+
+	if ( !socket.ping_sent && ( m_tmp.time > SEND_PING_AFTER || m_tmp.now - socket.last_ping_at >= MEASURE_RTT_EVERY ) ) {
+		SendPing( socket );
 	}
 
+	ScheduleTimer( socket );
 	return true;
 }
 
+void SimpleTCP::SendPing( remote_socket_data_t& socket ) {
+	Log( "Sending ping to " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ")" );
+	types::Packet packet( types::Packet::PT_PING );
+	packet.udata.ping.sent_at = GetTimeMs();
+	socket.ping_sent = true;
+	socket.last_ping_at = m_tmp.now;
+	QueuePacket( socket, packet.Serialize().ToString() );
+}
+
+void SimpleTCP::CollectConnectionStats( std::vector< connection_stats_t >& connections ) const {
+	const auto add = [ &connections ]( const remote_socket_data_t& socket ) -> void {
+		connections.push_back( socket.stats );
+		auto& stats = connections.back();
+		stats.cid = socket.cid;
+		stats.remote_address = socket.remote_address;
+		stats.queued_packets = socket.out.packets.size();
+		stats.queued_bytes = socket.out.queued_bytes;
+	};
+	if ( m_client.socket.fd ) {
+		add( m_client.socket );
+	}
+	for ( const auto& it : m_server.client_sockets ) {
+		add( it.second );
+	}
+}
+
 void SimpleTCP::CloseSocket( int fd, cid_t cid, bool skip_event ) {
 	Log( "Closing socket " + std::to_string( fd ) );
-	uint32_t bye = 0;
-	m_impl.Send( fd, &bye, sizeof( bye ) );
 	m_impl.CloseSocket( fd );
 	if ( !skip_event ) {
 		m_tmp.event.Clear();
@@ -692,16 +883,30 @@ void SimpleTCP::CloseSocket( int fd, cid_t cid, bool skip_event ) {
 	}
 }
 
-void SimpleTCP::CloseClientSocket( const remote_socket_data_t& socket ) {
+void SimpleTCP::CloseClientSocket( remote_socket_data_t& socket ) {
 	ASSERT( GetCurrentConnectionMode() == CM_SERVER, "can't close client socket as non-server" );
 	ASSERT( socket.cid != 0, "client socket can't have cid 0" );
 	Log( "Closing connection to " + socket.remote_address + " ( cid " + std::to_string( socket.cid ) + " )" );
-	CloseSocket( socket.fd, socket.cid );
-	free( socket.buffer.data1 );
-	free( socket.buffer.data2 );
+	DestroyRemoteSocket( socket );
 	InvalidateEventsForDisconnectedClient( socket.cid );
 	m_server.cid_to_fd.erase( socket.cid );
 }
 
+void SimpleTCP::DestroyRemoteSocket( remote_socket_data_t& socket, const bool skip_event ) {
+	// whatever doesn't fit into socket buffer right now is lost
+	socket.out.packets.push_back(
+		{
+			0,
+			""
+		}
+	);
+	socket.out.queued_bytes += sizeof( uint32_t );
+	FlushSocket( socket );
+	CloseSocket( socket.fd, socket.cid, skip_event );
+	ReleaseBuffer( socket );
+	socket.in.data.clear();
+	socket.out.packets.clear();
+}
+
 }
 }
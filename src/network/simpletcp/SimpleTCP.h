@@ -2,6 +2,7 @@
 
 #include <sys/types.h>
 #include <memory.h>
+#include <vector>
 
 #include "network/Network.h"
 
@@ -10,18 +11,23 @@
 #define WAIT_PONG_FOR 6
 
 #define DISCONNECT_AFTER ( SEND_PING_AFTER + WAIT_PONG_FOR )
+// even busy connection is pinged this often, to keep round-trip time up to date
+#define MEASURE_RTT_EVERY 5
 
 namespace network {
 namespace simpletcp {
 
 CLASS( SimpleTCP, Network )
 
-	SimpleTCP();
+	// packets larger than max_packet_size are rejected, on both sides
+	SimpleTCP( const size_t max_packet_size = DEFAULT_MAX_PACKET_SIZE );
 
 	void Start() override;
 	void Stop() override;
 	void Iterate() override;
 
+	const bool WaitsForActivity() const override;
+
 protected:
 
 	MT_Response ListenStart() override;
@@ -30,15 +36,66 @@ protected:
 	MT_Response Disconnect() override;
 	MT_Response DisconnectClient( const network::cid_t cid ) override;
 	void ProcessEvents() override;
+	void CollectConnectionStats( std::vector< connection_stats_t >& connections ) const override;
 
 private:
+	static const size_t DEFAULT_MAX_PACKET_SIZE = 64 * 1024 * 1024;
+	const size_t m_max_packet_size;
+
+	// upper bound for waiting on sockets, so that thread still reacts to stop command and timers in time
+	static const int MAX_WAIT_MS = 100;
+
+	void AcceptConnections( const fd_t listening_fd );
+	void InitRemoteSocket( remote_socket_data_t& socket );
+	remote_socket_data_t* GetRemoteSocket( const fd_t fd );
+	void CloseRemoteSocket( const fd_t fd );
+
 	// true on success, false on error
 	bool ReadFromSocket( remote_socket_data_t& socket );
-	bool WriteToSocket( int fd, const std::string& data );
-	bool MaybePing( remote_socket_data_t& socket );
-	bool MaybePingDo( remote_socket_data_t& socket );
+	void ProcessPacket( remote_socket_data_t& socket );
+	void SendPing( remote_socket_data_t& socket );
 	void CloseSocket( int fd, network::cid_t cid = 0, bool skip_event = false );
-	void CloseClientSocket( const remote_socket_data_t& socket );
+	void CloseClientSocket( remote_socket_data_t& socket );
+	// says 'bye' if it can be done without blocking, then closes socket and frees its buffers
+	void DestroyRemoteSocket( remote_socket_data_t& socket, const bool skip_event = false );
+
+	// receive buffer starts small and doubles when it's full, until it reaches BUFFER_SIZE
+	static const size_t INITIAL_BUFFER_SIZE = 4096;
+	// false if buffer is full already
+	bool ReserveBuffer( remote_socket_data_t& socket );
+	void ReleaseBuffer( remote_socket_data_t& socket );
+
+	std::vector< fd_t > m_ready_fds = {};
+
+	// packets are queued and sent later in batches, as many as socket accepts
+	// rest is sent when socket becomes writable again
+	// large packets are queued as sequence of fragments, nothing else can get between them because queue is per socket
+	static const size_t MAX_SEND_BUFFERS = 64; // 2 per packet
+	void QueuePacket( remote_socket_data_t& socket, const std::string& data );
+	// true on success, false on error
+	bool FlushSocket( remote_socket_data_t& socket );
+	void FlushSockets();
+	std::vector< fd_t > m_unflushed_fds = {};
+
+	// ping and timeout bookkeeping, one slot per second
+	// incoming data doesn't touch the wheel, instead expired entries are checked against last_data_at of socket and rescheduled if needed
+	static const size_t TIMER_WHEEL_SLOTS = 32;
+	static_assert( TIMER_WHEEL_SLOTS > DISCONNECT_AFTER + 1, "timer wheel is too small" );
+	static_assert( MEASURE_RTT_EVERY < SEND_PING_AFTER, "rtt pings would never be sent" );
+	struct timer_entry_t {
+		fd_t fd;
+		uint32_t serial; // to skip entries of closed sockets
+	};
+	struct {
+		std::vector< timer_entry_t > slots[TIMER_WHEEL_SLOTS] = {};
+		std::vector< timer_entry_t > expired = {};
+		time_t last_processed_at = 0;
+		uint32_t next_serial = 1;
+	} m_timers = {};
+	void ScheduleTimer( const remote_socket_data_t& socket );
+	void ProcessTimers();
+	// false if socket timed out
+	bool ProcessTimer( remote_socket_data_t& socket );
 
 #ifdef DEBUG
 	bool m_need_pings = true;
@@ -0,0 +1,164 @@
+#include "Loopback.h"
+
+#include "task/gsetests/GSETests.h"
+#include "network/loopback/Loopback.h"
+
+namespace network {
+namespace tests {
+
+// server and client in same thread, so every request is processed during first iteration after it was created
+// and every message is delivered during next one, which makes order of events deterministic
+class Peers {
+public:
+	Peers( const std::string& address )
+		: server( address, false )
+		, client( address, false ) {}
+	~Peers() {
+		// listener must be unregistered even if test failed halfway
+		client.Stop();
+		server.Stop();
+	}
+
+	loopback::Loopback server;
+	loopback::Loopback client;
+
+	const MT_Response Execute( loopback::Loopback& network, const common::mt_id_t mt_id ) {
+		server.Iterate();
+		client.Iterate();
+		return network.MT_GetResult( mt_id );
+	}
+
+	// delivers everything that was sent so far before asking for events
+	const events_t GetEvents( loopback::Loopback& network ) {
+		server.Iterate();
+		client.Iterate();
+		return Execute( network, network.MT_GetEvents() ).events;
+	}
+
+	const MT_Response Send( loopback::Loopback& network, const std::string& packet_data, const cid_t cid = 0 ) {
+		Event event;
+		event.type = Event::ET_PACKET;
+		event.cid = cid;
+		event.data.packet_data = packet_data;
+		return Execute( network, network.MT_SendEvent( event ) );
+	}
+};
+
+void AddLoopbackTests( task::gsetests::GSETests* task ) {
+
+	task->AddTest(
+		"test if loopback client connects and disconnects",
+		GT() {
+			Peers peers( "test_connect" );
+			GT_ASSERT( peers.Execute( peers.server, peers.server.MT_Connect( CM_SERVER ) ).result == R_SUCCESS );
+			auto events = peers.GetEvents( peers.server );
+			GT_ASSERT( events.size() == 1 );
+			GT_ASSERT( events[ 0 ].type == Event::ET_LISTEN );
+
+			GT_ASSERT( peers.Execute( peers.client, peers.client.MT_Connect( CM_CLIENT, "test_connect" ) ).result == R_SUCCESS );
+			events = peers.GetEvents( peers.server );
+			GT_ASSERT( events.size() == 1 );
+			GT_ASSERT( events[ 0 ].type == Event::ET_CLIENT_CONNECT );
+			GT_ASSERT( events[ 0 ].cid == 1 );
+
+			GT_ASSERT( peers.Execute( peers.client, peers.client.MT_Disconnect() ).result == R_SUCCESS );
+			events = peers.GetEvents( peers.server );
+			GT_ASSERT( events.size() == 1 );
+			GT_ASSERT( events[ 0 ].type == Event::ET_CLIENT_DISCONNECT );
+			GT_ASSERT( events[ 0 ].cid == 1 );
+			GT_ASSERT( peers.GetEvents( peers.client ).empty() );
+
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if loopback connection to missing server fails",
+		GT() {
+			Peers peers( "test_missing" );
+			GT_ASSERT( peers.Execute( peers.client, peers.client.MT_Connect( CM_CLIENT, "test_missing" ) ).result == R_ERROR );
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if loopback delivers packets in order",
+		GT() {
+			Peers peers( "test_order" );
+			GT_ASSERT( peers.Execute( peers.server, peers.server.MT_Connect( CM_SERVER ) ).result == R_SUCCESS );
+			GT_ASSERT( peers.Execute( peers.client, peers.client.MT_Connect( CM_CLIENT, "test_order" ) ).result == R_SUCCESS );
+			peers.GetEvents( peers.server ); // listen and connect
+
+			const size_t count = 1000;
+			for ( size_t i = 0 ; i < count ; i++ ) {
+				GT_ASSERT( peers.Send( peers.client, "to server " + std::to_string( i ) ).result == R_SUCCESS );
+			}
+			auto events = peers.GetEvents( peers.server );
+			GT_ASSERT( events.size() == count, ", got " + std::to_string( events.size() ) + " events" );
+			for ( size_t i = 0 ; i < count ; i++ ) {
+				GT_ASSERT( events[ i ].type == Event::ET_PACKET );
+				GT_ASSERT( events[ i ].cid == 1 );
+				GT_ASSERT( events[ i ].data.packet_data == "to server " + std::to_string( i ), ", got " + events[ i ].data.packet_data );
+			}
+
+			for ( size_t i = 0 ; i < count ; i++ ) {
+				GT_ASSERT( peers.Send( peers.server, "to client " + std::to_string( i ), 1 ).result == R_SUCCESS );
+			}
+			events = peers.GetEvents( peers.client );
+			GT_ASSERT( events.size() == count, ", got " + std::to_string( events.size() ) + " events" );
+			for ( size_t i = 0 ; i < count ; i++ ) {
+				GT_ASSERT( events[ i ].type == Event::ET_PACKET );
+				GT_ASSERT( events[ i ].cid == 0 );
+				GT_ASSERT( events[ i ].data.packet_data == "to client " + std::to_string( i ), ", got " + events[ i ].data.packet_data );
+			}
+
+			const auto stats = peers.Execute( peers.client, peers.client.MT_GetStats() ).stats;
+			GT_ASSERT( stats.connections.size() == 1 );
+			GT_ASSERT( stats.connections[ 0 ].packets_out == count );
+			GT_ASSERT( stats.connections[ 0 ].packets_in == count );
+
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if loopback server disconnects client",
+		GT() {
+			Peers peers( "test_kick" );
+			GT_ASSERT( peers.Execute( peers.server, peers.server.MT_Connect( CM_SERVER ) ).result == R_SUCCESS );
+			GT_ASSERT( peers.Execute( peers.client, peers.client.MT_Connect( CM_CLIENT, "test_kick" ) ).result == R_SUCCESS );
+			peers.GetEvents( peers.server ); // listen and connect
+
+			GT_ASSERT( peers.Execute( peers.server, peers.server.MT_DisconnectClient( 1 ) ).result == R_SUCCESS );
+			auto events = peers.GetEvents( peers.server );
+			GT_ASSERT( events.size() == 1 );
+			GT_ASSERT( events[ 0 ].type == Event::ET_CLIENT_DISCONNECT );
+			GT_ASSERT( events[ 0 ].cid == 1 );
+			events = peers.GetEvents( peers.client );
+			GT_ASSERT( events.size() == 1 );
+			GT_ASSERT( events[ 0 ].type == Event::ET_DISCONNECT );
+
+			// packets sent after disconnect go nowhere
+			GT_ASSERT( peers.Send( peers.server, "late", 1 ).result == R_SUCCESS );
+			GT_ASSERT( peers.GetEvents( peers.client ).empty() );
+
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test loopback throughput",
+		GT( task ) {
+			for ( const size_t size : { 64, 4 * 1024 } ) {
+				const auto mbps = loopback::Loopback::MeasureThroughput( size, 16 * 1024 );
+				GT_ASSERT( mbps > 0.0 );
+				GT_LOG( "    " + std::to_string( size ) + " byte packets: " + std::to_string( (size_t)mbps ) + " MB/s" );
+			}
+			GT_OK();
+		}
+	);
+
+}
+
+}
+}
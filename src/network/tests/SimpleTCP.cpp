@@ -0,0 +1,241 @@
+#include "SimpleTCP.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "task/gsetests/GSETests.h"
+#include "network/simpletcp/SimpleTCP.h"
+#include "types/Packet.h"
+
+namespace network {
+namespace tests {
+
+// gives access to framing, so that tests can put arbitrary bytes on wire
+class TCPPeer : public simpletcp::SimpleTCP {
+public:
+	using SimpleTCP::FRAGMENT_FLAG;
+	using SimpleTCP::MAX_FRAGMENT_SIZE;
+
+	// writes directly to client socket, bypassing packet queue
+	const bool SendRaw( const char* data, const size_t size ) {
+		size_t sent = 0;
+		while ( sent < size ) {
+			const auto result = m_impl.Send( m_client.socket.fd, data + sent, size - sent );
+			if ( result <= 0 ) {
+				return false;
+			}
+			sent += result;
+		}
+		return true;
+	}
+};
+
+// real sockets on localhost, server and client in same thread
+// unlike loopback, delivery takes unknown number of iterations, so everything waits for expected result with timeout
+class TCPPeers {
+public:
+	TCPPeers() {
+		server.Start();
+		client.Start();
+	}
+	~TCPPeers() {
+		// sockets must be closed even if test failed halfway, otherwise next test can't listen
+		client.Stop();
+		server.Stop();
+	}
+
+	TCPPeer server;
+	TCPPeer client;
+
+	void Iterate() {
+		server.Iterate();
+		client.Iterate();
+	}
+
+	const MT_Response Execute( TCPPeer& network, const common::mt_id_t mt_id ) {
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds( TIMEOUT_SECONDS );
+		auto response = network.MT_GetResult( mt_id );
+		while ( response.result == R_NONE && std::chrono::steady_clock::now() < deadline ) {
+			Iterate();
+			response = network.MT_GetResult( mt_id );
+		}
+		return response;
+	}
+
+	// iterates until network has at least count events ( or until timeout )
+	const events_t WaitForEvents( TCPPeer& network, const size_t count ) {
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds( TIMEOUT_SECONDS );
+		events_t events = {};
+		while ( events.size() < count && std::chrono::steady_clock::now() < deadline ) {
+			for ( const auto& event : Execute( network, network.MT_GetEvents() ).events ) {
+				events.push_back( event );
+			}
+		}
+		return events;
+	}
+
+	const bool Connect() {
+		if ( Execute( server, server.MT_Connect( CM_SERVER ) ).result != R_SUCCESS ) {
+			return false;
+		}
+		if ( Execute( client, client.MT_Connect( CM_CLIENT, "127.0.0.1" ) ).result != R_SUCCESS ) {
+			return false;
+		}
+		const auto events = WaitForEvents( server, 2 );
+		return events.size() == 2 && events[ 0 ].type == Event::ET_LISTEN && events[ 1 ].type == Event::ET_CLIENT_CONNECT;
+	}
+
+private:
+	static constexpr size_t TIMEOUT_SECONDS = 10;
+};
+
+static const std::string SerializeMessage( const std::string& message ) {
+	types::Packet packet( types::Packet::PT_MESSAGE );
+	packet.data.str = message;
+	return packet.Serialize().ToString();
+}
+
+// returns message or error
+static const std::string UnserializeMessage( const Event& event ) {
+	if ( event.type != Event::ET_PACKET ) {
+		return "<event type " + std::to_string( event.type ) + ": " + event.data.packet_data + ">";
+	}
+	types::Packet packet( types::Packet::PT_NONE );
+	packet.Unserialize( types::BufferView( event.data.packet_data ) );
+	return packet.data.str;
+}
+
+static const std::string GenerateMessage( const size_t size, uint32_t seed ) {
+	std::string message( size, ' ' );
+	for ( auto& c : message ) {
+		seed = seed * 1664525 + 1013904223;
+		c = (char)( seed >> 24 );
+	}
+	return message;
+}
+
+void AddSimpleTCPTests( task::gsetests::GSETests* task ) {
+
+	// small packets between large ones check that fragments of one packet never mix with other packets
+	std::vector< std::string > messages = {};
+	uint32_t seed = 1;
+	for ( const size_t size : {
+		(size_t)1,
+		(size_t)TCPPeer::MAX_FRAGMENT_SIZE - 64, // packet fits into one frame
+		(size_t)TCPPeer::MAX_FRAGMENT_SIZE, // packet is just above frame size because of serialization overhead
+		(size_t)3,
+		(size_t)TCPPeer::MAX_FRAGMENT_SIZE * 3 + 17,
+		(size_t)5,
+	} ) {
+		messages.push_back( GenerateMessage( size, seed++ ) );
+	}
+
+	task->AddTest(
+		"test if simpletcp reassembles packets larger than frame",
+		GT( messages ) {
+			TCPPeers peers;
+			GT_ASSERT( peers.Connect(), ": could not connect to localhost" );
+
+			// all requests are queued first, so that they are processed during same iteration
+			std::vector< common::mt_id_t > mt_ids = {};
+			for ( const auto& message : messages ) {
+				types::Packet packet( types::Packet::PT_MESSAGE );
+				packet.data.str = message;
+				mt_ids.push_back( peers.client.MT_SendPacket( &packet ) );
+			}
+			for ( const auto& mt_id : mt_ids ) {
+				GT_ASSERT( peers.Execute( peers.client, mt_id ).result == R_SUCCESS );
+			}
+			auto events = peers.WaitForEvents( peers.server, messages.size() );
+			GT_ASSERT( events.size() == messages.size(), ", got " + std::to_string( events.size() ) + " events" );
+			for ( size_t i = 0 ; i < messages.size() ; i++ ) {
+				GT_ASSERT( events[ i ].cid == 1 );
+				const auto message = UnserializeMessage( events[ i ] );
+				GT_ASSERT( message == messages[ i ], "for packet " + std::to_string( i ) + ", got " + std::to_string( message.size() ) + " bytes instead of " + std::to_string( messages[ i ].size() ) );
+			}
+
+			mt_ids.clear();
+			for ( const auto& message : messages ) {
+				types::Packet packet( types::Packet::PT_MESSAGE );
+				packet.data.str = message;
+				mt_ids.push_back( peers.server.MT_SendPacket( &packet, 1 ) );
+			}
+			for ( const auto& mt_id : mt_ids ) {
+				GT_ASSERT( peers.Execute( peers.server, mt_id ).result == R_SUCCESS );
+			}
+			events = peers.WaitForEvents( peers.client, messages.size() );
+			GT_ASSERT( events.size() == messages.size(), ", got " + std::to_string( events.size() ) + " events" );
+			for ( size_t i = 0 ; i < messages.size() ; i++ ) {
+				const auto message = UnserializeMessage( events[ i ] );
+				GT_ASSERT( message == messages[ i ], "for packet " + std::to_string( i ) + ", got " + std::to_string( message.size() ) + " bytes instead of " + std::to_string( messages[ i ].size() ) );
+			}
+
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if simpletcp reassembles frames split across reads",
+		GT() {
+			TCPPeers peers;
+			GT_ASSERT( peers.Connect(), ": could not connect to localhost" );
+
+			// frames are written in small pieces, so that sizes and data of frames are cut at every possible point
+			for ( const auto& it : std::vector< std::pair< size_t, size_t > >{
+				// message size, fragment size
+				{
+					300,
+					7
+				},
+				{
+					300,
+					100
+				},
+				{
+					300,
+					1000
+				},
+				{
+					TCPPeer::MAX_FRAGMENT_SIZE * 2,
+					TCPPeer::MAX_FRAGMENT_SIZE
+				},
+			} ) {
+				const auto message = GenerateMessage( it.first, it.second );
+				const auto serialized = SerializeMessage( message );
+				std::string frames = "";
+				for ( size_t offset = 0 ; offset < serialized.size() ; offset += it.second ) {
+					const uint32_t size = std::min( it.second, serialized.size() - offset );
+					const uint32_t header = offset + size < serialized.size()
+						? size | TCPPeer::FRAGMENT_FLAG
+						: size;
+					frames.append( (const char*)&header, sizeof( header ) );
+					frames.append( serialized, offset, size );
+				}
+				// unfragmented packet right after last fragment
+				const auto tail = SerializeMessage( "tail" );
+				const uint32_t tail_header = tail.size();
+				frames.append( (const char*)&tail_header, sizeof( tail_header ) );
+				frames += tail;
+
+				const size_t chunk_size = frames.size() > 10000
+					? 4093
+					: 3;
+				// client isn't iterated meanwhile, otherwise it could send ping between raw bytes
+				for ( size_t offset = 0 ; offset < frames.size() ; offset += chunk_size ) {
+					GT_ASSERT( peers.client.SendRaw( frames.data() + offset, std::min( chunk_size, frames.size() - offset ) ) );
+					peers.server.Iterate();
+				}
+				const auto events = peers.WaitForEvents( peers.server, 2 );
+				GT_ASSERT( events.size() == 2, "for fragment size " + std::to_string( it.second ) + ", got " + std::to_string( events.size() ) + " events" );
+				GT_ASSERT( UnserializeMessage( events[ 0 ] ) == message, "for fragment size " + std::to_string( it.second ) );
+				GT_ASSERT( UnserializeMessage( events[ 1 ] ) == "tail", "for fragment size " + std::to_string( it.second ) );
+			}
+
+			GT_OK();
+		}
+	);
+
+}
+
+}
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace task::gsetests {
+class GSETests;
+}
+
+namespace network {
+namespace tests {
+
+void AddSimpleTCPTests( task::gsetests::GSETests* task );
+
+}
+}
@@ -0,0 +1,15 @@
+#include "Tests.h"
+
+#include "Loopback.h"
+#include "SimpleTCP.h"
+
+namespace network {
+namespace tests {
+
+void AddTests( task::gsetests::GSETests* task ) {
+	tests::AddLoopbackTests( task );
+	tests::AddSimpleTCPTests( task );
+}
+
+}
+}
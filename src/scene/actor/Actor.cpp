@@ -87,7 +87,7 @@ const types::Buffer Actor::Serialize() const {
 	return buf;
 }
 
-void Actor::Unserialize( types::Buffer buf ) {
+void Actor::Unserialize( types::BufferView buf ) {
 	Entity::Unserialize( buf );
 	// HACK! TODO: refactor
 	buf.ReadVec3();
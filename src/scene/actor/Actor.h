@@ -65,7 +65,7 @@ CLASS( Actor, Entity )
 	const render_flag_t GetRenderFlags() const;
 
 	virtual const types::Buffer Serialize() const override;
-	virtual void Unserialize( types::Buffer buf ) override;
+	virtual void Unserialize( types::BufferView buf ) override;
 
 protected:
 	const type_t m_type;
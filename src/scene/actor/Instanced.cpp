@@ -214,12 +214,12 @@ const types::Buffer Instanced::Serialize() const {
 
 	buf.WriteInt( m_next_instance_id );
 
-	buf.WriteString( m_actor->Serialize().ToString() );
+	buf.WriteBuffer( m_actor->Serialize() );
 
 	return buf;
 }
 
-void Instanced::Unserialize( types::Buffer buf ) {
+void Instanced::Unserialize( types::BufferView buf ) {
 	Actor::Unserialize( buf );
 
 	// HACK! TODO: refactor
@@ -243,7 +243,7 @@ void Instanced::Unserialize( types::Buffer buf ) {
 
 	m_next_instance_id = buf.ReadInt();
 
-	m_actor->Unserialize( buf.ReadString() );
+	m_actor->Unserialize( buf.ReadView() );
 
 	m_need_world_matrix_update = true;
 }
@@ -0,0 +1,272 @@
+#include "DedicatedServer.h"
+
+#include "engine/Engine.h"
+#include "game/Game.h"
+#include "game/State.h"
+#include "game/Player.h"
+#include "game/FrontendRequest.h"
+#include "game/connection/Server.h"
+#include "game/slot/Slots.h"
+#include "game/event/CompleteTurn.h"
+
+namespace task {
+namespace dedicatedserver {
+
+void DedicatedServer::Start() {
+	ASSERT( !m_state, "state already set" );
+	NEW( m_state, ::game::State );
+
+	auto& settings = m_state->m_settings;
+	settings.local.game_mode = ::game::settings::LocalSettings::GM_MULTIPLAYER;
+	settings.local.network_type = ::game::settings::LocalSettings::NT_SIMPLETCP;
+	settings.local.network_role = ::game::settings::LocalSettings::NR_SERVER;
+	settings.local.player_name = PLAYER_NAME;
+	settings.global.game_name = GAME_NAME;
+
+	NEW( m_connection, ::game::connection::Server, &settings.local );
+	m_state->SetConnection( m_connection );
+
+	m_connection->m_on_connect = [ this ]() -> void {
+		Log( "Waiting for players" );
+		m_state->InitBindings();
+		m_state->Configure();
+		m_connection->SetGameState( ::game::connection::Connection::GS_LOBBY );
+	};
+	m_connection->m_on_listen = [ this ]() -> void {
+		auto& slot = m_state->m_slots->GetSlot( m_connection->GetSlotNum() );
+		slot.SetPlayerFlag( ::game::slot::PF_READY );
+		m_connection->UpdateSlot( m_connection->GetSlotNum(), &slot, true );
+	};
+	m_connection->m_on_error = [ this ]( const std::string& message ) -> bool {
+		Quit( message );
+		return false;
+	};
+	m_connection->m_on_disconnect = [ this ]() -> bool {
+		Quit( "Connection closed" );
+		return false;
+	};
+	m_connection->m_on_player_join = [ this ]( const size_t slot_num, ::game::slot::Slot* slot, const ::game::Player* player ) -> void {
+		if ( slot_num != m_connection->GetSlotNum() ) {
+			m_connection->GlobalMessage( "Player \"" + player->GetPlayerName() + "\" joined." );
+		}
+	};
+	m_connection->m_on_player_leave = [ this ]( const size_t slot_num, ::game::slot::Slot* slot, const ::game::Player* player ) -> void {
+		m_connection->GlobalMessage( "Player \"" + player->GetPlayerName() + "\" left." );
+		ManageCountdown();
+	};
+	m_connection->m_on_flags_update = [ this ]( const size_t slot_num, ::game::slot::Slot* slot, const ::game::slot::player_flag_t old_flags, const ::game::slot::player_flag_t new_flags ) -> void {
+		if ( slot_num == m_connection->GetSlotNum() ) {
+			if ( !slot->HasPlayerFlag( ::game::slot::PF_READY ) ) {
+				// readiness is reset every time somebody joins or leaves
+				slot->SetPlayerFlag( ::game::slot::PF_READY );
+				m_connection->UpdateSlot( slot_num, slot, true );
+			}
+			return;
+		}
+		ManageCountdown();
+	};
+
+	m_connection->Connect();
+}
+
+void DedicatedServer::Stop() {
+	if ( m_state ) {
+		DELETE( m_state );
+		m_state = nullptr;
+	}
+}
+
+void DedicatedServer::Iterate() {
+	auto* game = g_engine->GetGame();
+
+	if ( m_state ) {
+		// lobby
+		m_state->Iterate();
+
+		while ( m_countdown_timer.HasTicked() ) {
+			m_countdown--;
+			if ( m_countdown <= 0 ) {
+				m_countdown_timer.Stop();
+				StartGame();
+				break;
+			}
+		}
+	}
+
+	if ( m_mt_ids.init ) {
+		auto response = game->MT_GetResponse( m_mt_ids.init );
+		if ( response.result != ::game::R_NONE ) {
+			m_mt_ids.init = 0;
+			if ( response.result == ::game::R_SUCCESS ) {
+				m_slot_index = response.data.init.slot_index;
+				m_mt_ids.get_map_data = game->MT_GetMapData();
+			}
+			else {
+				Quit(
+					response.result == ::game::R_ERROR
+						? *response.data.error.error_text
+						: "Game initialization aborted"
+				);
+			}
+			game->MT_DestroyResponse( response );
+		}
+	}
+
+	if ( m_mt_ids.get_map_data ) {
+		// there is no map data to display, it's only polled to know when initialization is finished
+		auto response = game->MT_GetResponse( m_mt_ids.get_map_data );
+		if ( response.result != ::game::R_NONE ) {
+			if ( response.result == ::game::R_PENDING ) {
+				m_mt_ids.get_map_data = game->MT_GetMapData();
+			}
+			else {
+				m_mt_ids.get_map_data = 0;
+				if ( response.result == ::game::R_SUCCESS ) {
+					Log( "Game started" );
+					m_is_running = true;
+				}
+				else {
+					Quit(
+						response.result == ::game::R_ERROR
+							? *response.data.error.error_text
+							: "Game initialization aborted"
+					);
+				}
+			}
+			game->MT_DestroyResponse( response );
+		}
+	}
+
+	if ( m_is_running ) {
+
+		if ( m_mt_ids.send_backend_requests ) {
+			auto response = game->MT_GetResponse( m_mt_ids.send_backend_requests );
+			if ( response.result != ::game::R_NONE ) {
+				ASSERT( response.result == ::game::R_SUCCESS, "backend requests result not successful" );
+				m_mt_ids.send_backend_requests = 0;
+			}
+		}
+
+		if ( !m_mt_ids.send_backend_requests && !m_pending_backend_requests.empty() ) {
+			m_mt_ids.send_backend_requests = game->MT_SendBackendRequests( m_pending_backend_requests );
+			m_pending_backend_requests.clear();
+		}
+
+		// requested after backend requests so that game thread processes both in same iteration
+		if ( !m_mt_ids.get_frontend_requests ) {
+			m_mt_ids.get_frontend_requests = game->MT_GetFrontendRequests();
+		}
+
+		// nothing is rendered here, so it's cheaper to block than to pick response up on next iteration
+		auto response = game->MT_WaitResponse( m_mt_ids.get_frontend_requests, FRONTEND_REQUESTS_WAIT_MS );
+		if ( response.result != ::game::R_NONE ) {
+			ASSERT( response.result == ::game::R_SUCCESS, "unexpected frontend requests response" );
+			m_mt_ids.get_frontend_requests = 0;
+			const auto* requests = response.data.get_frontend_requests.requests;
+			if ( requests ) {
+				for ( const auto& request : *requests ) {
+					ProcessRequest( &request );
+					if ( !m_is_running ) {
+						break; // exiting
+					}
+				}
+			}
+			game->MT_DestroyResponse( response );
+		}
+
+	}
+}
+
+void DedicatedServer::ManageCountdown() {
+	bool is_everyone_ready = true;
+	size_t players_count = 0;
+	const auto& slots = m_state->m_slots->GetSlots();
+	for ( size_t num = 0 ; num < slots.size() ; num++ ) {
+		const auto& slot = slots.at( num );
+		if ( num == m_connection->GetSlotNum() || slot.GetState() != ::game::slot::Slot::SS_PLAYER ) {
+			continue;
+		}
+		players_count++;
+		if ( !slot.HasPlayerFlag( ::game::slot::PF_READY ) ) {
+			is_everyone_ready = false;
+			break;
+		}
+	}
+	const bool can_start = is_everyone_ready && players_count > 0;
+	if ( can_start && !m_countdown_timer.IsRunning() ) {
+		m_connection->GlobalMessage( "Everyone is ready. Starting game in " + std::to_string( COUNTDOWN_SECONDS ) + " seconds..." );
+		m_countdown = COUNTDOWN_SECONDS;
+		m_countdown_timer.SetInterval( 1000 );
+	}
+	else if ( m_countdown_timer.IsRunning() && !can_start ) {
+		m_connection->GlobalMessage( "Somebody is not ready. Game start canceled." );
+		m_countdown_timer.Stop();
+	}
+}
+
+void DedicatedServer::StartGame() {
+	ASSERT( m_state, "state not set" );
+	ASSERT( !m_mt_ids.init, "game already starting" );
+	Log( "Starting game" );
+	m_mt_ids.init = g_engine->GetGame()->MT_Init( m_state );
+	// detach state because game thread will own it now
+	m_state = nullptr;
+}
+
+void DedicatedServer::ProcessRequest( const ::game::FrontendRequest* request ) {
+	switch ( request->type ) {
+		case ::game::FrontendRequest::FR_QUIT: {
+			Quit(
+				request->data.quit.reason
+					? *request->data.quit.reason
+					: ""
+			);
+			break;
+		}
+		case ::game::FrontendRequest::FR_ERROR: {
+			Log( *request->data.error.stacktrace );
+			Quit( *request->data.error.what );
+			break;
+		}
+		case ::game::FrontendRequest::FR_GLOBAL_MESSAGE: {
+			Log( *request->data.global_message.message );
+			break;
+		}
+		case ::game::FrontendRequest::FR_TURN_ADVANCE: {
+			// turn is already active in game thread, server has nothing to do in it
+			const auto event = ::game::event::CompleteTurn( m_slot_index, request->data.turn_advance.turn_id );
+			g_engine->GetGame()->MT_AddEvent( &event );
+			break;
+		}
+		case ::game::FrontendRequest::FR_ANIMATION_SHOW: {
+			AcknowledgeAnimation( request->data.animation_show.running_animation_id );
+			break;
+		}
+		case ::game::FrontendRequest::FR_UNIT_MOVE: {
+			AcknowledgeAnimation( request->data.unit_move.running_animation_id );
+			break;
+		}
+		default: {
+			// nothing to display
+		}
+	}
+}
+
+void DedicatedServer::AcknowledgeAnimation( const size_t running_animation_id ) {
+	// game thread waits for animations to finish, there is nothing to wait for here
+	auto br = ::game::BackendRequest( ::game::BackendRequest::BR_ANIMATION_FINISHED );
+	br.data.animation_finished.animation_id = running_animation_id;
+	m_pending_backend_requests.push_back( br );
+}
+
+void DedicatedServer::Quit( const std::string& reason ) {
+	Log( "Shutting down" + ( reason.empty()
+		? ""
+		: ": " + reason
+	) );
+	m_is_running = false;
+	g_engine->ShutDown();
+}
+
+}
+}
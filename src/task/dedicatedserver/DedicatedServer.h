@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include "common/Task.h"
+
+#include "common/MTTypes.h"
+#include "util/Timer.h"
+#include "game/BackendRequest.h"
+
+namespace game {
+class State;
+class FrontendRequest;
+namespace connection {
+class Server;
+}
+}
+
+namespace task {
+namespace dedicatedserver {
+
+// hosts multiplayer game without any rendering, sound or input
+// server takes slot 0 as host player ( because game needs one ), it's always ready and ends its turns immediately
+// game starts when at least one player connected and everyone is ready, process exits when game ends
+CLASS( DedicatedServer, common::Task )
+	void Start() override;
+	void Stop() override;
+	void Iterate() override;
+
+private:
+	static const char COUNTDOWN_SECONDS = 5;
+	// game thread runs at same rate as server task, so response is normally ready within one tick
+	static const size_t FRONTEND_REQUESTS_WAIT_MS = 20;
+
+	const std::string PLAYER_NAME = "Server";
+	const std::string GAME_NAME = "Dedicated server";
+
+	::game::State* m_state = nullptr; // until game thread takes it
+	::game::connection::Server* m_connection = nullptr;
+
+	util::Timer m_countdown_timer;
+	char m_countdown = COUNTDOWN_SECONDS;
+
+	struct {
+		common::mt_id_t init = 0;
+		common::mt_id_t get_map_data = 0;
+		common::mt_id_t get_frontend_requests = 0;
+		common::mt_id_t send_backend_requests = 0;
+	} m_mt_ids = {};
+
+	bool m_is_running = false;
+	size_t m_slot_index = 0;
+	std::vector< ::game::BackendRequest > m_pending_backend_requests = {};
+
+	void ManageCountdown();
+	void StartGame();
+	void ProcessRequest( const ::game::FrontendRequest* request );
+	void AcknowledgeAnimation( const size_t running_animation_id );
+	void Quit( const std::string& reason );
+
+};
+
+}
+}
@@ -966,7 +966,7 @@ void Game::ProcessRequest( const ::game::FrontendRequest* request ) {
 			break;
 		}
 		case ::game::FrontendRequest::FR_ANIMATION_DEFINE: {
-			types::Buffer buf( *request->data.unit_define.serialized_unitdef );
+			types::BufferView buf( *request->data.unit_define.serialized_unitdef );
 			const auto* animationdef = ::game::animation::Def::Unserialize( buf );
 			DefineAnimation( animationdef );
 			delete animationdef;
@@ -991,7 +991,7 @@ void Game::ProcessRequest( const ::game::FrontendRequest* request ) {
 			break;
 		}
 		case ::game::FrontendRequest::FR_UNIT_DEFINE: {
-			types::Buffer buf( *request->data.unit_define.serialized_unitdef );
+			types::BufferView buf( *request->data.unit_define.serialized_unitdef );
 			const auto* unitdef = ::game::unit::Def::Unserialize( buf );
 			m_um->DefineUnit( unitdef );
 			delete unitdef;
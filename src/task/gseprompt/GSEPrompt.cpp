@@ -13,6 +13,7 @@
 
 #include "gse/Exception.h"
 #include "engine/Engine.h"
+#include "config/Config.h"
 #include "util/String.h"
 #include "gse/GSE.h"
 #include "gse/context/GlobalContext.h"
@@ -41,6 +42,7 @@ GSEPrompt::~GSEPrompt() {
 void GSEPrompt::Start() {
 	Log( "Starting GSE prompt (syntax: " + m_syntax + ")" );
 
+	m_gse->SetRunnerType( g_engine->GetConfig()->GetGSERunnerType() );
 	m_runner = m_gse->GetRunner();
 	if ( m_is_tty ) {
 		m_runner->EnableScopeContextJoins();
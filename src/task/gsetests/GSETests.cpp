@@ -4,7 +4,11 @@
 
 #include "gse/GSE.h"
 #include "gse/tests/Tests.h"
+#include "types/tests/Tests.h"
+#include "util/tests/Tests.h"
+#include "network/tests/Tests.h"
 #include "engine/Engine.h"
+#include "config/Config.h"
 
 namespace task {
 namespace gsetests {
@@ -12,6 +16,11 @@ namespace gsetests {
 void GSETests::Start() {
 	Log( "Loading tests" );
 	gse::tests::AddTests( this );
+	if ( !g_engine->GetConfig()->HasDebugFlag( config::Config::DF_GSE_TESTS_SCRIPT ) ) {
+		types::tests::AddTests( this );
+		util::tests::AddTests( this );
+		network::tests::AddTests( this );
+	}
 }
 
 void GSETests::Stop() {
@@ -29,6 +38,7 @@ void GSETests::Stop() {
 void GSETests::Iterate() {
 	if ( current_test_index < m_tests.size() ) {
 		gse::GSE gse;
+		gse.SetRunnerType( g_engine->GetConfig()->GetGSERunnerType() );
 		const auto& it = m_tests[ current_test_index++ ];
 		LogTest( "  " + it.first + "..." );
 		const auto errmsg = it.second( &gse );
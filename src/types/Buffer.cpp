@@ -5,34 +5,45 @@
 namespace types {
 
 Buffer::Buffer() {
+	format = F_TAGGED;
 	allocated_len = 0;
 	lenw = 0;
-	lenr = 0;
 	data = nullptr;
 	dw = nullptr;
-	dr = nullptr;
+}
+
+Buffer::Buffer( const format_t format ) {
+	allocated_len = 0;
+	lenw = 0;
+	data = nullptr;
+	dw = nullptr;
+	InitFormat( format );
 }
 
 Buffer::Buffer( const std::string& val ) {
+	if ( val.size() >= COMPACT_HEADER_SIZE && (data_t)val[ 0 ] == COMPACT_MAGIC ) {
+		format = ( val[ 2 ] & COMPACT_FLAG_CHECKSUM )
+			? F_COMPACT_CHECKSUMMED
+			: F_COMPACT;
+	}
+	else {
+		format = F_TAGGED;
+	}
 	allocated_len = val.size();
 	lenw = val.size();
-	lenr = 0;
 	data = (data_t*)malloc( lenw );
 	memcpy( ptr( data, 0, lenw ), val.data(), lenw );
 	dw = data + lenw;
-	dr = data;
 }
 
 Buffer::~Buffer() {
-	if ( data ) {
-		free( data );
-	}
+	Free();
 }
 
 Buffer::Buffer( const Buffer& other ) {
-	allocated_len = other.allocated_len;
+	format = other.format;
+	allocated_len = other.lenw;
 	lenw = other.lenw;
-	lenr = other.lenr;
 	if ( other.data ) {
 		data_t* newptr = (data_t*)malloc( lenw );
 		data = newptr;
@@ -42,15 +53,67 @@ Buffer::Buffer( const Buffer& other ) {
 		data = nullptr;
 	}
 	dw = data + lenw;
-	dr = data + lenr;
+}
+
+Buffer::Buffer( Buffer&& other ) noexcept {
+	format = other.format;
+	allocated_len = other.allocated_len;
+	lenw = other.lenw;
+	data = other.data;
+	dw = other.dw;
+	other.allocated_len = 0;
+	other.lenw = 0;
+	other.data = nullptr;
+	other.dw = nullptr;
+}
+
+Buffer& Buffer::operator=( const Buffer& other ) {
+	if ( this != &other ) {
+		Free();
+		format = other.format;
+		allocated_len = other.lenw;
+		lenw = other.lenw;
+		if ( other.data ) {
+			data = (data_t*)malloc( lenw );
+			memcpy( ptr( data, 0, lenw ), ptr( other.data, 0, other.lenw ), lenw );
+		}
+		dw = data + lenw;
+	}
+	return *this;
+}
+
+Buffer& Buffer::operator=( Buffer&& other ) noexcept {
+	if ( this != &other ) {
+		Free();
+		format = other.format;
+		allocated_len = other.allocated_len;
+		lenw = other.lenw;
+		data = other.data;
+		dw = other.dw;
+		other.allocated_len = 0;
+		other.lenw = 0;
+		other.data = nullptr;
+		other.dw = nullptr;
+	}
+	return *this;
 }
 
 void Buffer::Alloc( uint32_t size ) {
-	const uint32_t new_size = lenw + size;
+	const uint64_t new_size = (uint64_t)lenw + size;
+	if ( new_size > UINT32_MAX ) {
+		THROW( "buffer size overflow ( " + std::to_string( new_size ) + " )" );
+	}
 	if ( new_size > allocated_len ) {
-		while ( new_size > allocated_len ) {
-			allocated_len += BUFFER_ALLOC_CHUNK;
+		// grow geometrically so that writing large buffers needs only O(log n) reallocations
+		uint64_t new_allocated_len = allocated_len > BUFFER_ALLOC_CHUNK
+			? allocated_len
+			: BUFFER_ALLOC_CHUNK;
+		while ( new_size > new_allocated_len ) {
+			new_allocated_len *= 2;
 		}
+		allocated_len = new_allocated_len > UINT32_MAX
+			? UINT32_MAX
+			: new_allocated_len;
 		if ( data ) {
 			//Log( "Reallocating " + to_string( allocated_len ) + " bytes" );
 			data = (data_t*)realloc( data, allocated_len );
@@ -60,14 +123,47 @@ void Buffer::Alloc( uint32_t size ) {
 			data = (data_t*)malloc( allocated_len );
 		}
 		dw = ptr( data, lenw, 0 );
-		dr = ptr( data, lenr, 0 );
 	}
 	lenw = new_size;
 }
 
+void Buffer::InitFormat( const format_t format ) {
+	this->format = format;
+	if ( format != F_TAGGED ) {
+		const bool has_checksum = format == F_COMPACT_CHECKSUMMED;
+		Alloc(
+			COMPACT_HEADER_SIZE + ( has_checksum
+				? COMPACT_CHECKSUM_SIZE
+				: 0
+			)
+		);
+		*( dw++ ) = COMPACT_MAGIC;
+		*( dw++ ) = COMPACT_VERSION;
+		*( dw++ ) = has_checksum
+			? COMPACT_FLAG_CHECKSUM
+			: 0;
+		if ( has_checksum ) {
+			const block_checksum_t checksum = BLOCK_CHECKSUM_INITIAL;
+			memcpy( dw, &checksum, sizeof( checksum ) );
+			dw += sizeof( checksum );
+		}
+	}
+}
+
+void Buffer::Free() {
+	if ( data ) {
+		free( data );
+		data = nullptr;
+	}
+}
+
 // note: mostly THROWs instead of ASSERTs, because we need that validation in release mode too to prevent buffer overflows
 void Buffer::WriteImpl( type_t type, const char* s, const uint32_t sz ) {
 	ASSERT( type > T_NONE && type < T_MAX, "invalid buffer write type " + std::to_string( type ) );
+	if ( format != F_TAGGED ) {
+		WriteCompactImpl( type, s, sz );
+		return;
+	}
 	//Log( "Writing " + to_string( sz ) + " bytes (type=" + to_string( type ) + ")" );
 	checksum_t c = 0;
 	Alloc( sizeof( type ) + sizeof( sz ) + sz + sizeof( c ) );
@@ -87,162 +183,114 @@ void Buffer::WriteImpl( type_t type, const char* s, const uint32_t sz ) {
 	//Log( "Written successfully" );
 }
 
-char* Buffer::ReadImpl( type_t need_type, char* s, uint32_t* sz, const uint32_t need_sz ) {
-	ASSERT( need_type > T_NONE && need_type < T_MAX, "invalid buffer read type " + std::to_string( need_type ) );
-	type_t type = T_NONE;
-	if ( lenw < lenr + sizeof( type ) + sizeof( *sz ) ) {
-		THROW( "buffer ends prematurely (while reading header)" );
-	}
-	memcpy( &type, dr, sizeof( type ) );
-	dr += sizeof( type );
-	if ( type != need_type ) {
-		THROW( "unexpected type on buffer read ( " + std::to_string( need_type ) + " != " + std::to_string( type ) + " )" );
-	}
-	memcpy( sz, dr, sizeof( *sz ) );
-	dr += sizeof( *sz );
-	if ( need_sz && ( need_sz != *sz ) ) {
-		THROW( "buffer read size mismatch ( " + std::to_string( need_sz ) + " != " + std::to_string( *sz ) + " )" );
+void Buffer::WriteCompactImpl( const type_t type, const char* s, const uint32_t sz ) {
+	// only strings and raw data have variable size, everything else is either fixed-size or self-delimiting
+	data_t sz_varint[VARINT_MAX_SIZE];
+	const uint32_t sz_varint_len = ( type == T_STRING || type == T_DATA )
+		? EncodeVarInt( sz, sz_varint )
+		: 0;
+	Alloc( sizeof( type ) + sz_varint_len + sz );
+	data_t* const from = dw;
+	*( dw++ ) = type;
+	if ( sz_varint_len ) {
+		memcpy( dw, sz_varint, sz_varint_len );
+		dw += sz_varint_len;
 	}
-	checksum_t need_c = 0;
-	lenr += sizeof( type ) + sizeof( *sz ) + *sz + sizeof( need_c );
-	if ( lenw < lenr ) {
-		THROW( "buffer ends prematurely (while reading data)" );
+	if ( sz ) {
+		memcpy( dw, s, sz );
+		dw += sz;
 	}
-	//Log( "Reading " + std::to_string( *sz ) + " bytes (type=" + std::to_string( type ) + ")" );
+	UpdateBlockChecksum( from, dw - from );
+	ASSERT( dw - data == lenw, "buffer write bytes count mismatch ( " + std::to_string( dw - data ) + " != " + std::to_string( lenw ) + " )" );
+}
 
-	if ( s == nullptr && *sz > 0 ) {
-		s = (char*)malloc( *sz );
+void Buffer::UpdateBlockChecksum( const data_t* from, const uint32_t sz ) {
+	if ( format == F_COMPACT_CHECKSUMMED ) {
+		block_checksum_t checksum;
+		memcpy( &checksum, data + COMPACT_HEADER_SIZE, sizeof( checksum ) );
+		checksum = CalculateBlockChecksum( checksum, from, sz );
+		memcpy( data + COMPACT_HEADER_SIZE, &checksum, sizeof( checksum ) );
 	}
+}
 
-	char* s_ptr = s;
-
-	for ( uint32_t i = 0 ; i < *sz ; i++ ) {
-		need_c ^= ( *( s_ptr++ ) = *( dr++ ) );
+const uint32_t Buffer::EncodeVarInt( uint64_t val, data_t* out ) {
+	uint32_t len = 0;
+	while ( val >= 0x80 ) {
+		out[ len++ ] = (data_t)( val | 0x80 );
+		val >>= 7;
 	}
+	out[ len++ ] = (data_t)val;
+	return len;
+}
 
-	//Log( "Checking checksum (" + to_string( need_c ) + ")" );
-	checksum_t c = *( dr++ );
-	if ( need_c != c ) {
-		THROW( "buffer read checksum mismatch ( " + std::to_string( need_c ) + " != " + std::to_string( c ) + " )" );
+const Buffer::block_checksum_t Buffer::CalculateBlockChecksum( block_checksum_t checksum, const data_t* from, const uint32_t sz ) {
+	for ( uint32_t i = 0 ; i < sz ; i++ ) {
+		checksum = ( checksum ^ from[ i ] ) * BLOCK_CHECKSUM_PRIME;
 	}
-	ASSERT( dr - data == lenr, "buffer read bytes count mismatch ( " + std::to_string( dr - data ) + " != " + std::to_string( lenr ) + " )" );
-	//Log( "Read successfully" );
-
-	return s;
+	return checksum;
 }
 
 void Buffer::WriteBool( const bool val ) {
+	if ( format != F_TAGGED ) {
+		WriteCompactImpl(
+			(type_t)( T_BOOL | ( val
+				? COMPACT_BOOL_TRUE
+				: 0
+			) ), nullptr, 0
+		);
+		return;
+	}
 	const uint8_t bval = val
 		? 1
 		: 0;
 	WriteImpl( T_BOOL, (const char*)&bval, sizeof( bval ) );
 }
 
-const bool Buffer::ReadBool() {
-	bool boolval = false;
-	uint32_t sz = 0;
-	ReadImpl( T_BOOL, (char*)&boolval, &sz, sizeof( boolval ) );
-	return boolval;
-}
-
 void Buffer::WriteInt( const long long int val ) {
+	if ( format != F_TAGGED ) {
+		// zig-zag, so that small negative values stay small too
+		data_t varint[VARINT_MAX_SIZE];
+		const uint64_t zigzag = ( (uint64_t)val << 1 ) ^ (uint64_t)( val >> 63 );
+		WriteCompactImpl( T_INT, (const char*)varint, EncodeVarInt( zigzag, varint ) );
+		return;
+	}
 	WriteImpl( T_INT, (const char*)&val, sizeof( val ) );
 }
 
-const long long int Buffer::ReadInt() {
-	long long int val = 0;
-	uint32_t sz = 0;
-	ReadImpl( T_INT, (char*)&val, &sz, sizeof( val ) );
-	return val;
-}
-
 void Buffer::WriteFloat( const float val ) {
 	WriteImpl( T_FLOAT, (const char*)&val, sizeof( val ) );
 }
 
-const float Buffer::ReadFloat() {
-	float val = 0;
-	uint32_t sz = 0;
-	ReadImpl( T_FLOAT, (char*)&val, &sz, sizeof( val ) );
-	return val;
-}
-
 void Buffer::WriteString( const std::string& val ) {
 	WriteImpl( T_STRING, val.data(), val.size() );
 }
 
-const std::string Buffer::ReadString() {
-	uint32_t sz = 0;
-	char* res_data = ReadImpl( T_STRING, nullptr, &sz );
-	if ( sz > 0 ) {
-		std::string result = std::string( res_data, sz );
-		free( res_data );
-		return result;
-	}
-	else {
-		return "";
-	}
+void Buffer::WriteString( const char* val, const uint32_t len ) {
+	WriteImpl( T_STRING, val, len );
 }
 
 void Buffer::WriteVec2u( const Vec2< uint32_t > val ) {
 	WriteImpl( T_VEC2U, (const char*)&val, sizeof( val ) );
 }
 
-const Vec2< uint32_t > Buffer::ReadVec2u() {
-	types::Vec2< uint32_t > val = {
-		0,
-		0
-	};
-	uint32_t sz = 0;
-	ReadImpl( T_VEC2U, (char*)&val, &sz, sizeof( val ) );
-	return val;
-}
-
 void Buffer::WriteVec2f( const Vec2< float > val ) {
 	WriteImpl( T_VEC2F, (const char*)&val, sizeof( val ) );
 }
 
-const Vec2< float > Buffer::ReadVec2f() {
-	types::Vec2< float > val = {
-		0,
-		0
-	};
-	uint32_t sz = 0;
-	ReadImpl( T_VEC2F, (char*)&val, &sz, sizeof( val ) );
-	return val;
-}
-
 void Buffer::WriteVec3( const types::Vec3 val ) {
 	WriteImpl( T_VEC3, (const char*)&val, sizeof( val ) );
 }
 
-const types::Vec3 Buffer::ReadVec3() {
-	types::Vec3 val;
-	uint32_t sz = 0;
-	ReadImpl( T_VEC3, (char*)&val, &sz, sizeof( val ) );
-	return val;
-}
-
 void Buffer::WriteColor( const Color val ) {
 	WriteImpl( T_COLOR, (const char*)&val, sizeof( val ) );
 }
 
-const Color Buffer::ReadColor() {
-	Color val;
-	uint32_t sz = 0;
-	ReadImpl( T_COLOR, (char*)&val, &sz, sizeof( val ) );
-	return val;
-}
-
 void Buffer::WriteData( const void* data, const uint32_t len ) {
 	WriteImpl( T_DATA, (const char*)data, len );
 }
 
-const void* Buffer::ReadData( const uint32_t len ) {
-	uint32_t sz = 0;
-	const void* val = ReadImpl( T_DATA, nullptr, &sz );
-	ASSERT( sz == len, "buffer data read size mismatch" );
-	return val;
+void Buffer::WriteBuffer( const Buffer& other ) {
+	WriteImpl( T_STRING, (const char*)other.data, other.lenw );
 }
 
 const std::string Buffer::ToString() const {
@@ -8,48 +8,71 @@
 
 namespace types {
 
+class BufferView;
+
 CLASS( Buffer, common::Class )
 
 	static constexpr uint32_t BUFFER_ALLOC_CHUNK = 1024;
 
 	typedef uint8_t data_t;
 	typedef uint8_t checksum_t;
+	typedef uint32_t block_checksum_t;
+
+	enum format_t : uint8_t {
+		F_TAGGED, // legacy: type, size, payload and checksum for every field
+		F_COMPACT, // type byte and varint/packed payload, no checksums
+		F_COMPACT_CHECKSUMMED, // same as F_COMPACT but with single checksum for whole buffer
+	};
+
+	// compact buffers start with header that can't be confused with legacy type byte
+	static constexpr data_t COMPACT_MAGIC = 0xC5;
+	static constexpr data_t COMPACT_VERSION = 1;
+	static constexpr data_t COMPACT_FLAG_CHECKSUM = 1 << 0;
+	static constexpr uint32_t COMPACT_HEADER_SIZE = 3; // magic, version, flags
+	static constexpr uint32_t COMPACT_CHECKSUM_SIZE = sizeof( block_checksum_t );
 
 	Buffer();
+	Buffer( const format_t format );
 	Buffer( const std::string& strval );
 	~Buffer();
 
 	Buffer( const Buffer& other );
+	Buffer( Buffer&& other ) noexcept;
+	Buffer& operator=( const Buffer& other );
+	Buffer& operator=( Buffer&& other ) noexcept;
 
+	format_t format;
 	data_t* data;
 	data_t* dw;
-	data_t* dr;
 	uint32_t allocated_len;
 	uint32_t lenw;
-	uint32_t lenr;
 
 	void WriteBool( const bool val );
-	const bool ReadBool();
 	void WriteInt( const long long int val );
-	const long long int ReadInt();
 	void WriteFloat( const float val );
-	const float ReadFloat();
 	void WriteString( const std::string& val );
-	const std::string ReadString();
+	void WriteString( const char* val, const uint32_t len );
 	void WriteVec2u( const Vec2< uint32_t > val );
-	const Vec2< uint32_t > ReadVec2u();
 	void WriteVec2f( const Vec2< float > val );
-	const Vec2< float > ReadVec2f();
 	void WriteVec3( const types::Vec3 val );
-	const types::Vec3 ReadVec3();
 	void WriteColor( const Color val );
-	const Color ReadColor();
 	void WriteData( const void* data, const uint32_t len );
-	const void* ReadData( const uint32_t len );
+
+	// writes other buffer as nested field, readable with BufferView::ReadString() or BufferView::ReadView()
+	void WriteBuffer( const Buffer& other );
 
 	const std::string ToString() const;
 
 private:
+	friend class BufferView;
+
+	static constexpr data_t COMPACT_BOOL_TRUE = 0x80; // bool value is packed into type byte in compact format
+	static constexpr uint32_t VARINT_MAX_SIZE = 10;
+	static constexpr block_checksum_t BLOCK_CHECKSUM_INITIAL = 2166136261u; // FNV-1a
+	static constexpr block_checksum_t BLOCK_CHECKSUM_PRIME = 16777619u;
+
+	static const uint32_t EncodeVarInt( uint64_t val, data_t* out );
+	static const block_checksum_t CalculateBlockChecksum( block_checksum_t checksum, const data_t* from, const uint32_t sz );
 
 	enum type_t : uint8_t {
 
@@ -68,8 +91,11 @@ private:
 	};
 
 	void WriteImpl( const type_t type, const char* s, const uint32_t sz );
-	char* ReadImpl( const type_t need_type, char* s, uint32_t* sz, const uint32_t need_sz = 0 );
+	void WriteCompactImpl( const type_t type, const char* s, const uint32_t sz );
+	void UpdateBlockChecksum( const data_t* from, const uint32_t sz );
+	void InitFormat( const format_t format );
 	void Alloc( uint32_t size );
+	void Free();
 
 };
 
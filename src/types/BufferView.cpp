@@ -0,0 +1,276 @@
+#include <cstring>
+
+#include "BufferView.h"
+
+namespace types {
+
+BufferView::BufferView()
+	: m_data( nullptr )
+	, m_len( 0 )
+	, m_pos( 0 ) {
+	DetectFormat();
+}
+
+BufferView::BufferView( const Buffer& buffer )
+	: m_data( buffer.data )
+	, m_len( buffer.lenw )
+	, m_pos( 0 ) {
+	DetectFormat();
+}
+
+BufferView::BufferView( const std::string& strval )
+	: m_data( (const data_t*)strval.data() )
+	, m_len( strval.size() )
+	, m_pos( 0 ) {
+	DetectFormat();
+}
+
+BufferView::BufferView( const data_t* data, const uint32_t len )
+	: m_data( data )
+	, m_len( len )
+	, m_pos( 0 ) {
+	DetectFormat();
+}
+
+void BufferView::DetectFormat() {
+	if ( m_len >= Buffer::COMPACT_HEADER_SIZE && m_data[ 0 ] == Buffer::COMPACT_MAGIC ) {
+		// validation is postponed to first read so that errors are thrown from where reading is expected to fail
+		m_format = ( m_data[ 2 ] & Buffer::COMPACT_FLAG_CHECKSUM )
+			? Buffer::F_COMPACT_CHECKSUMMED
+			: Buffer::F_COMPACT;
+		m_is_validated = false;
+	}
+	else {
+		m_format = Buffer::F_TAGGED;
+		m_is_validated = true;
+	}
+}
+
+void BufferView::Validate() {
+	if ( m_data[ 1 ] != Buffer::COMPACT_VERSION ) {
+		THROW( "unsupported buffer version ( " + std::to_string( m_data[ 1 ] ) + " != " + std::to_string( Buffer::COMPACT_VERSION ) + " )" );
+	}
+	m_pos = Buffer::COMPACT_HEADER_SIZE;
+	if ( m_format == Buffer::F_COMPACT_CHECKSUMMED ) {
+		if ( m_len < m_pos + Buffer::COMPACT_CHECKSUM_SIZE ) {
+			THROW( "buffer ends prematurely (while reading checksum)" );
+		}
+		Buffer::block_checksum_t c;
+		memcpy( &c, m_data + m_pos, sizeof( c ) );
+		m_pos += sizeof( c );
+		const auto need_c = Buffer::CalculateBlockChecksum( Buffer::BLOCK_CHECKSUM_INITIAL, m_data + m_pos, m_len - m_pos );
+		if ( need_c != c ) {
+			THROW( "buffer block checksum mismatch ( " + std::to_string( need_c ) + " != " + std::to_string( c ) + " )" );
+		}
+	}
+	m_is_validated = true;
+}
+
+// note: THROWs instead of ASSERTs, because we need that validation in release mode too to prevent buffer overflows
+const BufferView::data_t* BufferView::ReadImpl( const Buffer::type_t need_type, uint32_t* sz, const uint32_t need_sz ) {
+	ASSERT_NOLOG( need_type > Buffer::T_NONE && need_type < Buffer::T_MAX, "invalid buffer read type " + std::to_string( need_type ) );
+	if ( !m_is_validated ) {
+		Validate();
+	}
+	if ( m_format != Buffer::F_TAGGED ) {
+		return ReadCompactImpl( need_type, sz, need_sz );
+	}
+	Buffer::type_t type = Buffer::T_NONE;
+	if ( m_len < m_pos + sizeof( type ) + sizeof( *sz ) ) {
+		THROW( "buffer ends prematurely (while reading header)" );
+	}
+	memcpy( &type, m_data + m_pos, sizeof( type ) );
+	if ( type != need_type ) {
+		THROW( "unexpected type on buffer read ( " + std::to_string( need_type ) + " != " + std::to_string( type ) + " )" );
+	}
+	memcpy( sz, m_data + m_pos + sizeof( type ), sizeof( *sz ) );
+	if ( need_sz && ( need_sz != *sz ) ) {
+		THROW( "buffer read size mismatch ( " + std::to_string( need_sz ) + " != " + std::to_string( *sz ) + " )" );
+	}
+	checksum_t need_c = 0;
+	const uint64_t new_pos = (uint64_t)m_pos + sizeof( type ) + sizeof( *sz ) + *sz + sizeof( need_c );
+	if ( m_len < new_pos ) {
+		THROW( "buffer ends prematurely (while reading data)" );
+	}
+
+	const data_t* const s = m_data + m_pos + sizeof( type ) + sizeof( *sz );
+	for ( uint32_t i = 0 ; i < *sz ; i++ ) {
+		need_c ^= s[ i ];
+	}
+
+	const checksum_t c = s[ *sz ];
+	if ( need_c != c ) {
+		THROW( "buffer read checksum mismatch ( " + std::to_string( need_c ) + " != " + std::to_string( c ) + " )" );
+	}
+
+	m_pos = new_pos;
+	return s;
+}
+
+const BufferView::data_t* BufferView::ReadCompactImpl( const Buffer::type_t need_type, uint32_t* sz, const uint32_t need_sz ) {
+	ReadCompactType( need_type );
+	if ( need_type == Buffer::T_STRING || need_type == Buffer::T_DATA ) {
+		const auto varsz = ReadVarInt();
+		if ( varsz > UINT32_MAX ) {
+			THROW( "buffer read size overflow ( " + std::to_string( varsz ) + " )" );
+		}
+		*sz = varsz;
+		if ( need_sz && ( need_sz != *sz ) ) {
+			THROW( "buffer read size mismatch ( " + std::to_string( need_sz ) + " != " + std::to_string( *sz ) + " )" );
+		}
+	}
+	else {
+		*sz = need_sz;
+	}
+	if ( m_len < (uint64_t)m_pos + *sz ) {
+		THROW( "buffer ends prematurely (while reading data)" );
+	}
+	const data_t* const s = m_data + m_pos;
+	m_pos += *sz;
+	return s;
+}
+
+const BufferView::data_t BufferView::ReadCompactType( const Buffer::type_t need_type ) {
+	if ( m_pos >= m_len ) {
+		THROW( "buffer ends prematurely (while reading header)" );
+	}
+	const data_t type = m_data[ m_pos++ ];
+	const data_t base_type = need_type == Buffer::T_BOOL
+		? type & ~Buffer::COMPACT_BOOL_TRUE
+		: type;
+	if ( base_type != need_type ) {
+		THROW( "unexpected type on buffer read ( " + std::to_string( need_type ) + " != " + std::to_string( type ) + " )" );
+	}
+	return type;
+}
+
+const uint64_t BufferView::ReadVarInt() {
+	uint64_t val = 0;
+	for ( uint32_t i = 0 ; i < Buffer::VARINT_MAX_SIZE ; i++ ) {
+		if ( m_pos >= m_len ) {
+			THROW( "buffer ends prematurely (while reading varint)" );
+		}
+		const data_t b = m_data[ m_pos++ ];
+		val |= (uint64_t)( b & 0x7f ) << ( i * 7 );
+		if ( !( b & 0x80 ) ) {
+			return val;
+		}
+	}
+	THROW( "buffer varint is too long" );
+}
+
+const bool BufferView::ReadBool() {
+	if ( m_format != Buffer::F_TAGGED ) {
+		if ( !m_is_validated ) {
+			Validate();
+		}
+		return ( ReadCompactType( Buffer::T_BOOL ) & Buffer::COMPACT_BOOL_TRUE ) != 0;
+	}
+	uint32_t sz = 0;
+	return *ReadImpl( Buffer::T_BOOL, &sz, sizeof( uint8_t ) ) != 0;
+}
+
+const long long int BufferView::ReadInt() {
+	if ( m_format != Buffer::F_TAGGED ) {
+		if ( !m_is_validated ) {
+			Validate();
+		}
+		ReadCompactType( Buffer::T_INT );
+		const uint64_t zigzag = ReadVarInt();
+		return (long long int)( zigzag >> 1 ) ^ -(long long int)( zigzag & 1 );
+	}
+	long long int val = 0;
+	uint32_t sz = 0;
+	memcpy( &val, ReadImpl( Buffer::T_INT, &sz, sizeof( val ) ), sizeof( val ) );
+	return val;
+}
+
+const float BufferView::ReadFloat() {
+	float val = 0;
+	uint32_t sz = 0;
+	memcpy( &val, ReadImpl( Buffer::T_FLOAT, &sz, sizeof( val ) ), sizeof( val ) );
+	return val;
+}
+
+const std::string BufferView::ReadString() {
+	uint32_t sz = 0;
+	const auto* s = ReadImpl( Buffer::T_STRING, &sz );
+	return std::string( (const char*)s, sz );
+}
+
+const Vec2< uint32_t > BufferView::ReadVec2u() {
+	types::Vec2< uint32_t > val = {
+		0,
+		0
+	};
+	uint32_t sz = 0;
+	memcpy( (void*)&val, ReadImpl( Buffer::T_VEC2U, &sz, sizeof( val ) ), sizeof( val ) );
+	return val;
+}
+
+const Vec2< float > BufferView::ReadVec2f() {
+	types::Vec2< float > val = {
+		0,
+		0
+	};
+	uint32_t sz = 0;
+	memcpy( (void*)&val, ReadImpl( Buffer::T_VEC2F, &sz, sizeof( val ) ), sizeof( val ) );
+	return val;
+}
+
+const types::Vec3 BufferView::ReadVec3() {
+	types::Vec3 val;
+	uint32_t sz = 0;
+	memcpy( (void*)&val, ReadImpl( Buffer::T_VEC3, &sz, sizeof( val ) ), sizeof( val ) );
+	return val;
+}
+
+const Color BufferView::ReadColor() {
+	Color val;
+	uint32_t sz = 0;
+	memcpy( (void*)&val, ReadImpl( Buffer::T_COLOR, &sz, sizeof( val ) ), sizeof( val ) );
+	return val;
+}
+
+const void* BufferView::ReadData( const uint32_t len ) {
+	uint32_t sz = 0;
+	const auto* s = ReadImpl( Buffer::T_DATA, &sz, len );
+	if ( !sz ) {
+		return nullptr;
+	}
+	void* val = malloc( sz );
+	memcpy( val, s, sz );
+	return val;
+}
+
+const BufferView BufferView::ReadView() {
+	uint32_t sz = 0;
+	const auto* s = ReadImpl( Buffer::T_STRING, &sz );
+	return BufferView( s, sz );
+}
+
+const Buffer::format_t BufferView::GetFormat() const {
+	return m_format;
+}
+
+const BufferView::data_t* BufferView::GetData() const {
+	return m_data;
+}
+
+const uint32_t BufferView::GetSize() const {
+	return m_len;
+}
+
+const uint32_t BufferView::GetRemainingSize() const {
+	return m_pos < m_len
+		? m_len - m_pos
+		: 0;
+}
+
+const std::string BufferView::ToString() const {
+	return m_data
+		? std::string( (const char*)m_data, m_len )
+		: "";
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+
+#include "Buffer.h"
+
+namespace types {
+
+// non-owning read cursor over serialized data
+// underlying Buffer (or string) must outlive the view and must not be modified while view is in use
+class BufferView {
+public:
+
+	typedef Buffer::data_t data_t;
+	typedef Buffer::checksum_t checksum_t;
+
+	BufferView();
+	BufferView( const Buffer& buffer );
+	BufferView( const std::string& strval );
+	BufferView( const data_t* data, const uint32_t len );
+
+	const bool ReadBool();
+	const long long int ReadInt();
+	const float ReadFloat();
+	const std::string ReadString();
+	const Vec2< uint32_t > ReadVec2u();
+	const Vec2< float > ReadVec2f();
+	const types::Vec3 ReadVec3();
+	const Color ReadColor();
+	const void* ReadData( const uint32_t len ); // returned data is malloc()ed and owned by caller
+
+	// reads nested buffer (written with WriteString() or WriteBuffer()) without copying it
+	const BufferView ReadView();
+
+	const std::string ToString() const;
+
+	const Buffer::format_t GetFormat() const;
+
+	// raw access to underlying data, for formats that are not made with Buffer
+	const data_t* GetData() const;
+	const uint32_t GetSize() const;
+
+	// bytes that weren't read yet, every serialized value takes at least one
+	const uint32_t GetRemainingSize() const;
+
+private:
+
+	const data_t* m_data;
+	uint32_t m_len;
+	uint32_t m_pos;
+
+	Buffer::format_t m_format;
+	bool m_is_validated;
+
+	void DetectFormat();
+	void Validate();
+
+	const data_t* ReadImpl( const Buffer::type_t need_type, uint32_t* sz, const uint32_t need_sz = 0 );
+	const data_t* ReadCompactImpl( const Buffer::type_t need_type, uint32_t* sz, const uint32_t need_sz );
+	const data_t ReadCompactType( const Buffer::type_t need_type );
+	const uint64_t ReadVarInt();
+
+};
+
+}
@@ -8,14 +8,21 @@ Packet::Packet( const packet_type_t type )
 }
 
 const types::Buffer Packet::Serialize() const {
-	types::Buffer buf;
+	types::Buffer buf( types::Buffer::F_COMPACT );
 
 	buf.WriteInt( type );
 
 	switch ( type ) {
+		case PT_PING:
+		case PT_PONG: {
+			buf.WriteInt( udata.ping.sent_at );
+			break;
+		}
 		case PT_AUTH: {
 			buf.WriteString( data.vec[ 0 ] ); // gsid
 			buf.WriteString( data.vec[ 1 ] ); // player name
+			buf.WriteInt( udata.events.seq );
+			buf.WriteInt( udata.events.hash );
 			break;
 		}
 		case PT_PLAYERS: {
@@ -57,11 +64,14 @@ const types::Buffer Packet::Serialize() const {
 			break;
 		}
 		case PT_DOWNLOAD_REQUEST: {
-			// no data
+			buf.WriteInt( udata.download.size ); // max chunk size that client wants
+			buf.WriteInt( udata.download.codecs ); // codecs that client can decode
 			break;
 		}
 		case PT_DOWNLOAD_RESPONSE: {
-			buf.WriteInt( data.num ); // total size of serialized data
+			buf.WriteInt( data.num ); // total size of serialized ( and possibly compressed ) data
+			buf.WriteInt( udata.download.size ); // chunk size chosen by server
+			buf.WriteInt( udata.download.codecs ); // codec of data
 			break;
 		}
 		case PT_DOWNLOAD_NEXT_CHUNK_REQUEST: {
@@ -72,11 +82,23 @@ const types::Buffer Packet::Serialize() const {
 		case PT_DOWNLOAD_NEXT_CHUNK_RESPONSE: {
 			buf.WriteInt( udata.download.offset );
 			buf.WriteInt( udata.download.size );
-			buf.WriteString( data.str ); // serialized chunk
+			if ( download_source ) {
+				ASSERT( udata.download.offset + udata.download.size <= download_source->size(), "download chunk out of range" );
+				buf.WriteString( download_source->data() + udata.download.offset, udata.download.size ); // serialized chunk
+			}
+			else {
+				buf.WriteString( data.str ); // serialized chunk
+			}
 			break;
 		}
 		case PT_GAME_EVENTS: {
 			buf.WriteString( data.str ); // serialized game events
+			buf.WriteInt( udata.events.seq );
+			buf.WriteInt( udata.events.hash );
+			break;
+		}
+		case PT_RESUME: {
+			buf.WriteBool( data.boolean ); // false if client needs to rejoin
 			break;
 		}
 		default: {
@@ -87,18 +109,25 @@ const types::Buffer Packet::Serialize() const {
 	return buf;
 }
 
-void Packet::Unserialize( types::Buffer buf ) {
+void Packet::Unserialize( types::BufferView buf ) {
 
 	ASSERT( type == PT_NONE, "unserializing into existing packet" );
 
 	type = (packet_type_t)buf.ReadInt();
 
 	switch ( type ) {
+		case PT_PING:
+		case PT_PONG: {
+			udata.ping.sent_at = buf.ReadInt();
+			break;
+		}
 		case PT_AUTH: {
 			data.vec = {
 				buf.ReadString(), // gsid
 				buf.ReadString(), // player name
 			};
+			udata.events.seq = buf.ReadInt();
+			udata.events.hash = buf.ReadInt();
 			break;
 		}
 		case PT_PLAYERS: {
@@ -141,11 +170,14 @@ void Packet::Unserialize( types::Buffer buf ) {
 			break;
 		}
 		case PT_DOWNLOAD_REQUEST: {
-			// no data
+			udata.download.size = buf.ReadInt(); // max chunk size that client wants
+			udata.download.codecs = buf.ReadInt(); // codecs that client can decode
 			break;
 		}
 		case PT_DOWNLOAD_RESPONSE: {
-			data.num = buf.ReadInt(); // total size of serialized data
+			data.num = buf.ReadInt(); // total size of serialized ( and possibly compressed ) data
+			udata.download.size = buf.ReadInt(); // chunk size chosen by server
+			udata.download.codecs = buf.ReadInt(); // codec of data
 			break;
 		}
 		case PT_DOWNLOAD_NEXT_CHUNK_REQUEST: {
@@ -161,6 +193,12 @@ void Packet::Unserialize( types::Buffer buf ) {
 		}
 		case PT_GAME_EVENTS: {
 			data.str = buf.ReadString(); // serialized game events
+			udata.events.seq = buf.ReadInt();
+			udata.events.hash = buf.ReadInt();
+			break;
+		}
+		case PT_RESUME: {
+			data.boolean = buf.ReadBool(); // false if client needs to rejoin
 			break;
 		}
 		default: {
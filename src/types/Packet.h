@@ -26,9 +26,10 @@ CLASS( Packet, Serializable )
 		PT_GAME_STATE, // S->C
 		PT_DOWNLOAD_REQUEST, // C->S
 		PT_DOWNLOAD_RESPONSE, // S->C
-		PT_DOWNLOAD_NEXT_CHUNK_REQUEST, // C->S
+		PT_DOWNLOAD_NEXT_CHUNK_REQUEST, // C->S ( cumulative acknowledgement, allows server to send more chunks )
 		PT_DOWNLOAD_NEXT_CHUNK_RESPONSE, // S->C
 		PT_GAME_EVENTS, // *->*
+		PT_RESUME, // S->C ( answer to PT_AUTH of reconnecting client, missed game events follow if it's successful )
 	};
 
 	Packet( const packet_type_t type );
@@ -38,7 +39,7 @@ CLASS( Packet, Serializable )
 	union {
 		time_t time;
 		struct {
-			size_t id;
+			uint64_t sent_at; // ms on sender's monotonic clock, echoed back in pong to measure round-trip time
 		} ping;
 		struct {
 			size_t slot_num;
@@ -50,7 +51,14 @@ CLASS( Packet, Serializable )
 		struct {
 			size_t offset;
 			size_t size;
+			uint8_t codecs; // PT_DOWNLOAD_REQUEST: bitmask of supported codecs, PT_DOWNLOAD_RESPONSE: codec chosen by server
 		} download;
+		struct {
+			// PT_GAME_EVENTS: sequence number and hash of server's event stream after these events
+			// PT_AUTH: last ones that client applied before it lost connection, 0 if it's not reconnecting
+			uint64_t seq;
+			uint32_t hash;
+		} events;
 	} udata;
 
 	// TODO: move this into udata
@@ -61,8 +69,12 @@ CLASS( Packet, Serializable )
 		std::vector< std::string > vec;
 	} data;
 
+	// PT_DOWNLOAD_NEXT_CHUNK_RESPONSE: if set, chunk is serialized directly from this buffer ( from udata.download.offset ) instead of data.str
+	// must stay valid until packet is serialized
+	const std::string* download_source = nullptr;
+
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buffer ) override;
+	void Unserialize( types::BufferView buffer ) override;
 };
 
 }
@@ -3,6 +3,7 @@
 #include "common/Common.h"
 
 #include "Buffer.h"
+#include "BufferView.h"
 
 namespace types {
 
@@ -14,7 +15,7 @@ public:
 
 	virtual const types::Buffer Serialize() const = 0;
 
-	virtual void Unserialize( types::Buffer buffer ) = 0;
+	virtual void Unserialize( types::BufferView buffer ) = 0;
 
 	virtual void operator=( const Serializable& other ) {
 		// not super efficient, but convenient
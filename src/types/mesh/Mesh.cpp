@@ -158,7 +158,7 @@ const types::Buffer Mesh::Serialize() const {
 	return buf;
 }
 
-void Mesh::Unserialize( types::Buffer buf ) {
+void Mesh::Unserialize( types::BufferView buf ) {
 
 	auto mesh_type = (mesh_type_t)buf.ReadInt();
 	ASSERT( m_mesh_type == mesh_type, "mesh type mismatch" );
@@ -166,6 +166,9 @@ void Mesh::Unserialize( types::Buffer buf ) {
 	size_t vertex_count = buf.ReadInt();
 	ASSERT( vertex_count == m_vertex_count, "mesh read vertex count mismatch ( " + std::to_string( vertex_count ) + " != " + std::to_string( m_vertex_count ) + " )" );
 	m_vertex_i = buf.ReadInt();
+	if ( m_vertex_data ) {
+		free( m_vertex_data );
+	}
 	m_vertex_data = (uint8_t*)buf.ReadData( GetVertexDataSize() );
 
 	size_t index_count = buf.ReadInt();
@@ -175,6 +178,9 @@ void Mesh::Unserialize( types::Buffer buf ) {
 	ASSERT( surface_count == m_surface_count, "mesh read surface count mismatch ( " + std::to_string( surface_count ) + " != " + std::to_string( m_surface_count ) + " )" );
 
 	m_surface_i = buf.ReadInt();
+	if ( m_index_data ) {
+		free( m_index_data );
+	}
 	m_index_data = (uint8_t*)buf.ReadData( GetIndexDataSize() );
 
 	m_is_final = buf.ReadBool();
@@ -85,7 +85,11 @@ const types::Vec3 Render::GetVertexNormal( const index_t index ) const {
 }
 
 void Render::CombineNormals( const std::vector< index_t >& indices ) {
-	ASSERT( !indices.empty(), "normals list empty" );
+	CombineNormals( indices.data(), indices.size() );
+}
+
+void Render::CombineNormals( const index_t* const indices, const size_t count ) {
+	ASSERT( count, "normals list empty" );
 /*#ifdef DEBUG
 	std::string logstr = "";
 	for ( auto i : indices ) {
@@ -98,12 +102,12 @@ void Render::CombineNormals( const std::vector< index_t >& indices ) {
 		0.0f,
 		0.0f
 	};
-	for ( auto i : indices ) {
-		normal += GetVertexNormal( i );
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		normal += GetVertexNormal( indices[ i ] );
 	}
-	normal /= indices.size();
-	for ( auto i : indices ) {
-		SetVertexNormal( i, normal );
+	normal /= count;
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		SetVertexNormal( indices[ i ], normal );
 	}
 }
 
@@ -114,12 +118,19 @@ void Render::Finalize() {
 void Render::UpdateNormals( const std::vector< surface_id_t >& surfaces ) {
 	//Log( "Updating normals for " + std::to_string( surfaces.size() ) + " surface(s)" );
 
+	CalculateNormals( surfaces.data(), surfaces.size() );
+
+	Update();
+}
+
+void Render::CalculateNormals( const surface_id_t* const surfaces, const size_t count ) {
 	const surface_t* surface;
 	types::Vec3* a, * b, * c;
 	types::Vec3 n;
 	const size_t vo = VERTEX_COORD_SIZE + VERTEX_TEXCOORD_SIZE + VERTEX_TINT_SIZE;
 
-	for ( surface_id_t surface_id : surfaces ) {
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		const surface_id_t surface_id = surfaces[ i ];
 		surface = (surface_t*)ptr( m_index_data, surface_id * SURFACE_SIZE * sizeof( index_t ), sizeof( surface_t ) );
 
 		memset( ptr( m_vertex_data, ( surface->v1 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) ), 0, sizeof( types::Vec3 ) );
@@ -146,8 +157,6 @@ void Render::UpdateNormals( const std::vector< surface_id_t >& surfaces ) {
 			=
 			util::Math::Normalize( *(Vec3*)ptr( m_vertex_data, ( surface->v3 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) ) );
 	}
-
-	Update();
 }
 
 void Render::UpdateAllNormals() {
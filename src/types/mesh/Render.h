@@ -80,9 +80,13 @@ CLASS( Render, Mesh )
 	const types::Vec3 GetVertexNormal( const index_t index ) const;
 
 	void CombineNormals( const std::vector< index_t >& indices );
+	void CombineNormals( const index_t* const indices, const size_t count );
 
 	void Finalize() override;
 	void UpdateNormals( const std::vector< surface_id_t >& surfaces );
+	// same as UpdateNormals() but without Update(), so it can be called from multiple threads for surfaces that don't share vertices
+	// call Update() when done
+	void CalculateNormals( const surface_id_t* const surfaces, const size_t count );
 	void UpdateAllNormals();
 
 	static Render* Rectangle(
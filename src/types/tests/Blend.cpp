@@ -0,0 +1,135 @@
+#include "Blend.h"
+
+#include <vector>
+
+#include "task/gsetests/GSETests.h"
+#include "types/texture/Blend.h"
+
+namespace types {
+namespace tests {
+
+using texture::Blend;
+
+// random pixels and weights, with exact 0.0f and 1.0f weights mixed in because kernels have to treat them as identities
+struct blend_input_t {
+	std::vector< Blend::pixel_t > a;
+	std::vector< Blend::pixel_t > b;
+	std::vector< float > alpha;
+};
+static const blend_input_t GenerateBlendInput( const size_t count, uint32_t seed ) {
+	const auto f_next = [ &seed ]() -> uint32_t {
+		seed = seed * 1664525 + 1013904223;
+		return seed;
+	};
+	blend_input_t input = {};
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		input.a.push_back( f_next() );
+		input.b.push_back( f_next() );
+		switch ( f_next() % 4 ) {
+			case 0: {
+				input.alpha.push_back( 0.0f );
+				break;
+			}
+			case 1: {
+				input.alpha.push_back( 1.0f );
+				break;
+			}
+			default: {
+				input.alpha.push_back( (float)( f_next() % 1000001 ) / 1000000 );
+			}
+		}
+	}
+	return input;
+}
+
+void AddBlendTests( task::gsetests::GSETests* task ) {
+
+	// every length up to 37 covers all combinations of vector bodies and scalar tails, longer rows are what terrain textures use
+	std::vector< size_t > counts = {};
+	for ( size_t count = 0 ; count <= 37 ; count++ ) {
+		counts.push_back( count );
+	}
+	counts.push_back( 1023 );
+	counts.push_back( 4096 );
+
+	task->AddTest(
+		"test if blend kernels are supported",
+		GT( task ) {
+			const auto& kernels = Blend::GetSupportedKernels();
+			GT_ASSERT( !kernels.empty() );
+			GT_ASSERT( kernels.front().name == "scalar" );
+			GT_ASSERT( kernels.back().name == Blend::GetKernelName() );
+			for ( const auto& k : kernels ) {
+				GT_LOG( "    " + k.name );
+			}
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if blend mix kernels match scalar output",
+		GT( counts ) {
+			for ( const auto& kernels : Blend::GetSupportedKernels() ) {
+				for ( const auto& count : counts ) {
+					for ( uint32_t seed = 1 ; seed <= 16 ; seed++ ) {
+						const auto input = GenerateBlendInput( count, seed );
+						std::vector< Blend::pixel_t > out( count );
+						kernels.mix( input.a.data(), input.b.data(), input.alpha.data(), out.data(), count );
+						for ( size_t i = 0 ; i < count ; i++ ) {
+							const auto expected = Blend::MixPixel( input.a[ i ], input.b[ i ], input.alpha[ i ] );
+							GT_ASSERT( out[ i ] == expected, "for " + kernels.name + " kernel, count " + std::to_string( count ) + ", pixel " + std::to_string( i ) + ": " + std::to_string( out[ i ] ) + " != " + std::to_string( expected ) );
+						}
+					}
+				}
+			}
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if blend mix color kernels match scalar output",
+		GT( counts ) {
+			for ( const auto& kernels : Blend::GetSupportedKernels() ) {
+				for ( const auto& count : counts ) {
+					for ( uint32_t seed = 1 ; seed <= 16 ; seed++ ) {
+						const auto input = GenerateBlendInput( count, seed );
+						const Blend::pixel_t color = 0x80ff4020 + seed;
+						std::vector< Blend::pixel_t > out( count );
+						kernels.mix_color( color, input.b.data(), input.alpha.data(), out.data(), count );
+						for ( size_t i = 0 ; i < count ; i++ ) {
+							const auto expected = Blend::MixPixel( color, input.b[ i ], input.alpha[ i ] );
+							GT_ASSERT( out[ i ] == expected, "for " + kernels.name + " kernel, count " + std::to_string( count ) + ", pixel " + std::to_string( i ) + ": " + std::to_string( out[ i ] ) + " != " + std::to_string( expected ) );
+						}
+					}
+				}
+			}
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if blend kernels work in place",
+		GT( counts ) {
+			// Texture::AddFrom mixes into its first row buffer
+			for ( const auto& kernels : Blend::GetSupportedKernels() ) {
+				for ( const auto& count : counts ) {
+					auto input = GenerateBlendInput( count, count + 1 );
+					std::vector< Blend::pixel_t > expected( count );
+					for ( size_t i = 0 ; i < count ; i++ ) {
+						expected[ i ] = Blend::MixPixel( input.b[ i ], input.a[ i ], input.alpha[ i ] );
+						expected[ i ] = Blend::MixPixel( expected[ i ], input.b[ i ], input.alpha[ i ] );
+					}
+					auto& row = input.a;
+					kernels.mix( input.b.data(), row.data(), input.alpha.data(), row.data(), count );
+					kernels.mix( row.data(), input.b.data(), input.alpha.data(), row.data(), count );
+					GT_ASSERT( row == expected, "for " + kernels.name + " kernel, count " + std::to_string( count ) );
+				}
+			}
+			GT_OK();
+		}
+	);
+
+}
+
+}
+}
@@ -0,0 +1,405 @@
+#include "Buffer.h"
+
+#include <vector>
+#include <climits>
+#include <cstring>
+#include <functional>
+
+#include "task/gsetests/GSETests.h"
+#include "types/Buffer.h"
+#include "types/BufferView.h"
+
+namespace types {
+namespace tests {
+
+// zig-zag varints are 1 byte up to 63, then grow by 1 byte per 7 bits
+static const std::vector< long long int > s_buffer_ints = {
+	0,
+	1,
+	-1,
+	63,
+	-64,
+	64,
+	-65,
+	127,
+	128,
+	8191,
+	-8192,
+	8192,
+	INT_MAX,
+	INT_MIN,
+	(long long int)UINT_MAX + 1,
+	LLONG_MAX,
+	LLONG_MIN,
+};
+
+static void WriteBufferFields( Buffer& buf ) {
+	for ( const auto& v : s_buffer_ints ) {
+		buf.WriteInt( v );
+	}
+	buf.WriteBool( true );
+	buf.WriteBool( false );
+	buf.WriteFloat( -1.5f );
+	buf.WriteString( "" );
+	buf.WriteString( std::string( 200, 's' ) ); // size doesn't fit into 1 byte varint
+	buf.WriteVec2u(
+		{
+			1,
+			UINT_MAX
+		}
+	);
+	buf.WriteVec2f(
+		{
+			0.25f,
+			-2.0f
+		}
+	);
+	buf.WriteVec3(
+		{
+			1.0f,
+			2.0f,
+			3.0f
+		}
+	);
+	buf.WriteColor(
+		{
+			0.1f,
+			0.2f,
+			0.3f,
+			0.4f
+		}
+	);
+	buf.WriteData( "\x00\x01\x02", 3 );
+	Buffer nested( Buffer::F_COMPACT );
+	nested.WriteInt( -12345 );
+	nested.WriteString( "nested" );
+	buf.WriteBuffer( nested );
+	buf.WriteBool( true );
+}
+
+// returns error or empty string
+static const std::string ReadBufferFields( BufferView buf ) {
+	for ( const auto& v : s_buffer_ints ) {
+		const auto read = buf.ReadInt();
+		if ( read != v ) {
+			return "int " + std::to_string( read ) + " != " + std::to_string( v );
+		}
+	}
+	if ( !buf.ReadBool() || buf.ReadBool() ) {
+		return "bool mismatch";
+	}
+	if ( buf.ReadFloat() != -1.5f ) {
+		return "float mismatch";
+	}
+	if ( buf.ReadString() != "" || buf.ReadString() != std::string( 200, 's' ) ) {
+		return "string mismatch";
+	}
+	if ( !( buf.ReadVec2u() == Vec2< uint32_t >{ 1, UINT_MAX } ) ) {
+		return "vec2u mismatch";
+	}
+	if ( !( buf.ReadVec2f() == Vec2< float >{ 0.25f, -2.0f } ) ) {
+		return "vec2f mismatch";
+	}
+	if ( !( buf.ReadVec3() == Vec3( 1.0f, 2.0f, 3.0f ) ) ) {
+		return "vec3 mismatch";
+	}
+	auto color = buf.ReadColor();
+	if ( !( Color( 0.1f, 0.2f, 0.3f, 0.4f ) == color ) ) {
+		return "color mismatch";
+	}
+	const auto* data = buf.ReadData( 3 );
+	const bool is_data_valid = !memcmp( data, "\x00\x01\x02", 3 );
+	free( (void*)data );
+	if ( !is_data_valid ) {
+		return "data mismatch";
+	}
+	auto nested = buf.ReadView();
+	if ( nested.GetFormat() != Buffer::F_COMPACT || nested.ReadInt() != -12345 || nested.ReadString() != "nested" ) {
+		return "nested buffer mismatch";
+	}
+	if ( !buf.ReadBool() ) {
+		return "last bool mismatch";
+	}
+	return "";
+}
+
+// returns error message that was thrown, or empty string if nothing was thrown
+static const std::string GetBufferError( const std::function< void() >& f ) {
+	try {
+		f();
+	}
+	catch ( const std::runtime_error& e ) {
+		return e.what();
+	}
+	return "";
+}
+
+void AddBufferTests( task::gsetests::GSETests* task ) {
+
+	const std::vector< Buffer::format_t > formats = {
+		Buffer::F_TAGGED,
+		Buffer::F_COMPACT,
+		Buffer::F_COMPACT_CHECKSUMMED,
+	};
+
+	task->AddTest(
+		"test if buffer reads back what was written",
+		GT( formats ) {
+			for ( const auto& format : formats ) {
+				Buffer buf( format );
+				WriteBufferFields( buf );
+				GT_ASSERT( BufferView( buf ).GetFormat() == format, "for format " + std::to_string( format ) );
+				auto errmsg = ReadBufferFields( BufferView( buf ) );
+				GT_ASSERT( errmsg.empty(), "for format " + std::to_string( format ) + ": " + errmsg );
+
+				// same after going through network or file
+				const auto str = buf.ToString();
+				GT_ASSERT( Buffer( str ).format == format, "for format " + std::to_string( format ) );
+				GT_ASSERT( BufferView( str ).GetFormat() == format, "for format " + std::to_string( format ) );
+				errmsg = ReadBufferFields( BufferView( str ) );
+				GT_ASSERT( errmsg.empty(), "for format " + std::to_string( format ) + ": " + errmsg );
+			}
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if compact buffer encoding is compact",
+		GT() {
+			const auto f_encode = []( const std::function< void( Buffer& ) >& f ) -> std::string {
+				Buffer buf( Buffer::F_COMPACT );
+				f( buf );
+				return buf.ToString().substr( Buffer::COMPACT_HEADER_SIZE );
+			};
+
+			// header is magic, version and flags
+			GT_ASSERT( Buffer( Buffer::F_COMPACT ).ToString() == std::string( "\xc5\x01\x00", 3 ) );
+			GT_ASSERT( Buffer( Buffer::F_COMPACT_CHECKSUMMED ).ToString().substr( 0, 3 ) == std::string( "\xc5\x01\x01", 3 ) );
+
+			// type byte and zig-zag varint
+			const std::vector< std::pair< long long int, std::string > > ints = {
+				{
+					0,
+					std::string( "\x02\x00", 2 )
+				},
+				{
+					-1,
+					std::string( "\x02\x01", 2 )
+				},
+				{
+					1,
+					std::string( "\x02\x02", 2 )
+				},
+				{
+					63,
+					std::string( "\x02\x7e", 2 )
+				},
+				{
+					-64,
+					std::string( "\x02\x7f", 2 )
+				},
+				{
+					64,
+					std::string( "\x02\x80\x01", 3 )
+				},
+				{
+					LLONG_MAX,
+					std::string( "\x02\xfe\xff\xff\xff\xff\xff\xff\xff\xff\x01", 11 )
+				},
+				{
+					LLONG_MIN,
+					std::string( "\x02\xff\xff\xff\xff\xff\xff\xff\xff\xff\x01", 11 )
+				},
+			};
+			for ( const auto& it : ints ) {
+				const auto encoded = f_encode(
+					[ &it ]( Buffer& buf ) {
+						buf.WriteInt( it.first );
+					}
+				);
+				GT_ASSERT( encoded == it.second, "for " + std::to_string( it.first ) + ", got " + std::to_string( encoded.size() ) + " bytes" );
+			}
+
+			// bool value is packed into type byte
+			GT_ASSERT( f_encode( []( Buffer& buf ) { buf.WriteBool( false ); } ) == "\x01" );
+			GT_ASSERT( f_encode( []( Buffer& buf ) { buf.WriteBool( true ); } ) == "\x81" );
+
+			// only strings and data have size
+			GT_ASSERT( f_encode( []( Buffer& buf ) { buf.WriteString( "abc" ); } ) == "\x04\x03" "abc" );
+			GT_ASSERT( f_encode( []( Buffer& buf ) { buf.WriteString( std::string( 128, 'x' ) ); } ) == "\x04\x80\x01" + std::string( 128, 'x' ) );
+			GT_ASSERT( f_encode( []( Buffer& buf ) { buf.WriteFloat( 0.0f ); } ) == std::string( "\x03\x00\x00\x00\x00", 5 ) );
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if compact buffer checksum is verified",
+		GT() {
+			Buffer buf( Buffer::F_COMPACT_CHECKSUMMED );
+			WriteBufferFields( buf );
+			const auto str = buf.ToString();
+
+			// fnv-1a of everything after header and checksum
+			Buffer::block_checksum_t expected = 2166136261u;
+			for ( size_t i = Buffer::COMPACT_HEADER_SIZE + Buffer::COMPACT_CHECKSUM_SIZE ; i < str.size() ; i++ ) {
+				expected = ( expected ^ (uint8_t)str[ i ] ) * 16777619u;
+			}
+			Buffer::block_checksum_t checksum;
+			memcpy( &checksum, str.data() + Buffer::COMPACT_HEADER_SIZE, sizeof( checksum ) );
+			GT_ASSERT( checksum == expected, ", got " + std::to_string( checksum ) + " instead of " + std::to_string( expected ) );
+
+			// every corrupted byte after header is detected on first read, before any data is returned
+			for ( size_t i = Buffer::COMPACT_HEADER_SIZE ; i < str.size() ; i++ ) {
+				auto corrupted = str;
+				corrupted[ i ] ^= 0x10;
+				const auto errmsg = GetBufferError(
+					[ &corrupted ]() {
+						BufferView( corrupted ).ReadInt();
+					}
+				);
+				GT_ASSERT( errmsg.find( "checksum mismatch" ) != std::string::npos, "at byte " + std::to_string( i ) + ", got '" + errmsg + "'" );
+			}
+
+			// compact buffer without checksum doesn't validate payload, only structure
+			Buffer unchecked( Buffer::F_COMPACT );
+			unchecked.WriteInt( 5 );
+			auto corrupted = unchecked.ToString();
+			corrupted[ Buffer::COMPACT_HEADER_SIZE + 1 ] = 0x0c;
+			GT_ASSERT( BufferView( corrupted ).ReadInt() == 6 );
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if legacy buffer format is detected",
+		GT() {
+			GT_ASSERT( Buffer().format == Buffer::F_TAGGED );
+			GT_ASSERT( BufferView().GetFormat() == Buffer::F_TAGGED );
+			GT_ASSERT( BufferView( "" ).GetFormat() == Buffer::F_TAGGED );
+
+			Buffer buf;
+			WriteBufferFields( buf );
+			const auto str = buf.ToString();
+			GT_ASSERT( (uint8_t)str[ 0 ] != Buffer::COMPACT_MAGIC );
+			GT_ASSERT( Buffer( str ).format == Buffer::F_TAGGED );
+			GT_ASSERT( BufferView( str ).GetFormat() == Buffer::F_TAGGED );
+
+			// legacy data nested in compact buffer and other way around
+			Buffer compact( Buffer::F_COMPACT_CHECKSUMMED );
+			compact.WriteBuffer( buf );
+			Buffer tagged;
+			tagged.WriteBuffer( compact );
+			auto view = BufferView( tagged ).ReadView();
+			GT_ASSERT( view.GetFormat() == Buffer::F_COMPACT_CHECKSUMMED );
+			view = view.ReadView();
+			GT_ASSERT( view.GetFormat() == Buffer::F_TAGGED );
+			const auto errmsg = ReadBufferFields( view );
+			GT_ASSERT( errmsg.empty(), ": " + errmsg );
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if truncated or invalid compact buffer is rejected",
+		GT( formats ) {
+			const auto f_header = []( const uint8_t version ) -> std::string {
+				return std::string( "\xc5", 1 ) + (char)version + std::string( "\x00", 1 );
+			};
+
+			// all reads have to fail somewhere, without reading outside of buffer
+			for ( const auto& format : formats ) {
+				Buffer buf( format );
+				WriteBufferFields( buf );
+				const auto str = buf.ToString();
+				for ( size_t size = 0 ; size < str.size() ; size++ ) {
+					const auto truncated = str.substr( 0, size );
+					std::string errmsg = "";
+					const auto thrown = GetBufferError(
+						[ &truncated, &errmsg ]() {
+							errmsg = ReadBufferFields( BufferView( truncated ) );
+						}
+					);
+					GT_ASSERT( !thrown.empty(), "for format " + std::to_string( format ) + ", truncated to " + std::to_string( size ) + ( errmsg.empty()
+						? ""
+						: ": " + errmsg
+					) );
+					if ( format == Buffer::F_COMPACT_CHECKSUMMED && size >= Buffer::COMPACT_HEADER_SIZE + Buffer::COMPACT_CHECKSUM_SIZE ) {
+						GT_ASSERT( thrown.find( "checksum mismatch" ) != std::string::npos, "truncated to " + std::to_string( size ) + ", got '" + thrown + "'" );
+					}
+				}
+			}
+
+			const std::vector< std::pair< std::string, std::string > > invalid = {
+				{
+					f_header( Buffer::COMPACT_VERSION + 1 ) + std::string( "\x02\x00", 2 ),
+					"unsupported buffer version"
+				},
+				{
+					f_header( 0 ) + std::string( "\x02\x00", 2 ),
+					"unsupported buffer version"
+				},
+				{
+					std::string( "\xc5\x01\x01\x00\x00", 5 ),
+					"ends prematurely (while reading checksum)"
+				},
+				{
+					f_header( Buffer::COMPACT_VERSION ),
+					"ends prematurely (while reading header)"
+				},
+				{
+					f_header( Buffer::COMPACT_VERSION ) + "\x02",
+					"ends prematurely (while reading varint)"
+				},
+				{
+					f_header( Buffer::COMPACT_VERSION ) + "\x02" + std::string( 11, '\xff' ),
+					"varint is too long"
+				},
+				{
+					f_header( Buffer::COMPACT_VERSION ) + std::string( "\x04\x00", 2 ),
+					"unexpected type"
+				},
+				{
+					f_header( Buffer::COMPACT_VERSION ) + "\x81",
+					"unexpected type"
+				},
+			};
+			for ( const auto& it : invalid ) {
+				const auto errmsg = GetBufferError(
+					[ &it ]() {
+						BufferView( it.first ).ReadInt();
+					}
+				);
+				GT_ASSERT( errmsg.find( it.second ) != std::string::npos, "expected '" + it.second + "', got '" + errmsg + "'" );
+			}
+
+			// sizes that point outside of buffer
+			const std::vector< std::pair< std::string, std::string > > invalid_strings = {
+				{
+					f_header( Buffer::COMPACT_VERSION ) + "\x04\x64" "abc",
+					"ends prematurely (while reading data)"
+				},
+				{
+					f_header( Buffer::COMPACT_VERSION ) + "\x04\xff\xff\xff\xff\x7f" "abc",
+					"size overflow"
+				},
+				{
+					f_header( Buffer::COMPACT_VERSION ) + "\x04\xff\xff\xff\xff\x0f" "abc",
+					"ends prematurely (while reading data)"
+				},
+			};
+			for ( const auto& it : invalid_strings ) {
+				const auto errmsg = GetBufferError(
+					[ &it ]() {
+						BufferView( it.first ).ReadString();
+					}
+				);
+				GT_ASSERT( errmsg.find( it.second ) != std::string::npos, "expected '" + it.second + "', got '" + errmsg + "'" );
+			}
+			GT_OK();
+		}
+	);
+
+}
+
+}
+}
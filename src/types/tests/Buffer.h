@@ -0,0 +1,13 @@
+#pragma once
+
+namespace task::gsetests {
+class GSETests;
+}
+
+namespace types {
+namespace tests {
+
+void AddBufferTests( task::gsetests::GSETests* task );
+
+}
+}
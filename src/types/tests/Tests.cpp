@@ -0,0 +1,15 @@
+#include "Tests.h"
+
+#include "Blend.h"
+#include "Buffer.h"
+
+namespace types {
+namespace tests {
+
+void AddTests( task::gsetests::GSETests* task ) {
+	tests::AddBlendTests( task );
+	tests::AddBufferTests( task );
+}
+
+}
+}
@@ -0,0 +1,250 @@
+#include "Blend.h"
+
+// on 32-bit x86 scalar float math may use x87 with extended precision, vectorized kernels wouldn't match it there
+#if defined( __x86_64__ ) || defined( _M_X64 ) || ( defined( __i386__ ) && defined( __SSE2_MATH__ ) ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define BLEND_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// kernels are compiled for their instruction sets regardless of global flags, dispatch makes sure they are only called when supported
+#if defined( BLEND_X86 ) && defined( __GNUC__ )
+#define BLEND_TARGET( _target ) __attribute__(( target( _target ) ))
+#else
+#define BLEND_TARGET( _target )
+#endif
+
+namespace types {
+namespace texture {
+
+static void MixScalar( const Blend::pixel_t* a, const Blend::pixel_t* b, const float* alpha, Blend::pixel_t* out, const size_t count ) {
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		out[ i ] = Blend::MixPixel( a[ i ], b[ i ], alpha[ i ] );
+	}
+}
+
+static void MixColorScalar( const Blend::pixel_t color, const Blend::pixel_t* b, const float* alpha, Blend::pixel_t* out, const size_t count ) {
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		out[ i ] = Blend::MixPixel( color, b[ i ], alpha[ i ] );
+	}
+}
+
+#ifdef BLEND_X86
+
+// 4 pixels per iteration, one pixel ( 4 channels ) per float vector
+
+BLEND_TARGET( "sse2" )
+static inline __m128i Mix4SSE2( const __m128i a, const __m128i b, const __m128 alpha ) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128i low_byte = _mm_set1_epi32( 0xff );
+
+	const __m128i a_lo = _mm_unpacklo_epi8( a, zero );
+	const __m128i a_hi = _mm_unpackhi_epi8( a, zero );
+	const __m128i b_lo = _mm_unpacklo_epi8( b, zero );
+	const __m128i b_hi = _mm_unpackhi_epi8( b, zero );
+
+	__m128i r[ 4 ];
+#define x( _i, _a, _b, _unpack, _shuffle ) { \
+        const __m128 w = _mm_shuffle_ps( alpha, alpha, _shuffle ); \
+        const __m128 fa = _mm_cvtepi32_ps( _unpack( _a, zero ) ); \
+        const __m128 fb = _mm_cvtepi32_ps( _unpack( _b, zero ) ); \
+        /* same operations in same order as in MixPixel */ \
+        const __m128 f = _mm_add_ps( _mm_mul_ps( fa, w ), _mm_mul_ps( fb, _mm_sub_ps( one, w ) ) ); \
+        /* truncate to int32 and keep low byte, like scalar cast does */ \
+        r[ _i ] = _mm_and_si128( _mm_cvttps_epi32( f ), low_byte ); \
+    }
+	x( 0, a_lo, b_lo, _mm_unpacklo_epi16, 0x00 );
+	x( 1, a_lo, b_lo, _mm_unpackhi_epi16, 0x55 );
+	x( 2, a_hi, b_hi, _mm_unpacklo_epi16, 0xaa );
+	x( 3, a_hi, b_hi, _mm_unpackhi_epi16, 0xff );
+#undef x
+
+	return _mm_packus_epi16( _mm_packs_epi32( r[ 0 ], r[ 1 ] ), _mm_packs_epi32( r[ 2 ], r[ 3 ] ) );
+}
+
+BLEND_TARGET( "sse2" )
+static void MixSSE2( const Blend::pixel_t* a, const Blend::pixel_t* b, const float* alpha, Blend::pixel_t* out, const size_t count ) {
+	size_t i = 0;
+	for ( ; i + 4 <= count ; i += 4 ) {
+		_mm_storeu_si128(
+			(__m128i*)( out + i ), Mix4SSE2(
+				_mm_loadu_si128( (const __m128i*)( a + i ) ),
+				_mm_loadu_si128( (const __m128i*)( b + i ) ),
+				_mm_loadu_ps( alpha + i )
+			)
+		);
+	}
+	MixScalar( a + i, b + i, alpha + i, out + i, count - i );
+}
+
+BLEND_TARGET( "sse2" )
+static void MixColorSSE2( const Blend::pixel_t color, const Blend::pixel_t* b, const float* alpha, Blend::pixel_t* out, const size_t count ) {
+	const __m128i a = _mm_set1_epi32( (int32_t)color );
+	size_t i = 0;
+	for ( ; i + 4 <= count ; i += 4 ) {
+		_mm_storeu_si128(
+			(__m128i*)( out + i ), Mix4SSE2(
+				a,
+				_mm_loadu_si128( (const __m128i*)( b + i ) ),
+				_mm_loadu_ps( alpha + i )
+			)
+		);
+	}
+	MixColorScalar( color, b + i, alpha + i, out + i, count - i );
+}
+
+// 8 pixels per iteration, two pixels ( one per 128-bit lane ) per float vector
+
+BLEND_TARGET( "avx2" )
+static inline __m256i Mix2AVX2( const __m128i a2, const __m128i b2, const __m256 w ) {
+	const __m256 one = _mm256_set1_ps( 1.0f );
+	const __m256 fa = _mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( a2 ) );
+	const __m256 fb = _mm256_cvtepi32_ps( _mm256_cvtepu8_epi32( b2 ) );
+	// same operations in same order as in MixPixel
+	const __m256 f = _mm256_add_ps( _mm256_mul_ps( fa, w ), _mm256_mul_ps( fb, _mm256_sub_ps( one, w ) ) );
+	// truncate to int32 and keep low byte of every channel, like scalar cast does
+	return _mm256_shuffle_epi8(
+		_mm256_cvttps_epi32( f ), _mm256_setr_epi8(
+			0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+		)
+	);
+}
+
+BLEND_TARGET( "avx2" )
+static inline void Mix8AVX2( const __m128i a_lo, const __m128i a_hi, const __m128i b_lo, const __m128i b_hi, const float* alpha, Blend::pixel_t* out ) {
+	const __m256 alpha8 = _mm256_loadu_ps( alpha );
+	__m256i r;
+#define x( _i, _a, _b ) \
+    r = Mix2AVX2( _a, _b, _mm256_permutevar8x32_ps( alpha8, _mm256_setr_epi32( _i, _i, _i, _i, _i + 1, _i + 1, _i + 1, _i + 1 ) ) ); \
+    out[ _i ] = (Blend::pixel_t)_mm_cvtsi128_si32( _mm256_castsi256_si128( r ) ); \
+    out[ _i + 1 ] = (Blend::pixel_t)_mm_cvtsi128_si32( _mm256_extracti128_si256( r, 1 ) );
+	x( 0, a_lo, b_lo );
+	x( 2, _mm_srli_si128( a_lo, 8 ), _mm_srli_si128( b_lo, 8 ) );
+	x( 4, a_hi, b_hi );
+	x( 6, _mm_srli_si128( a_hi, 8 ), _mm_srli_si128( b_hi, 8 ) );
+#undef x
+}
+
+BLEND_TARGET( "avx2" )
+static void MixAVX2( const Blend::pixel_t* a, const Blend::pixel_t* b, const float* alpha, Blend::pixel_t* out, const size_t count ) {
+	size_t i = 0;
+	for ( ; i + 8 <= count ; i += 8 ) {
+		Mix8AVX2(
+			_mm_loadu_si128( (const __m128i*)( a + i ) ),
+			_mm_loadu_si128( (const __m128i*)( a + i + 4 ) ),
+			_mm_loadu_si128( (const __m128i*)( b + i ) ),
+			_mm_loadu_si128( (const __m128i*)( b + i + 4 ) ),
+			alpha + i,
+			out + i
+		);
+	}
+	MixSSE2( a + i, b + i, alpha + i, out + i, count - i );
+}
+
+BLEND_TARGET( "avx2" )
+static void MixColorAVX2( const Blend::pixel_t color, const Blend::pixel_t* b, const float* alpha, Blend::pixel_t* out, const size_t count ) {
+	const __m128i a = _mm_set1_epi32( (int32_t)color );
+	size_t i = 0;
+	for ( ; i + 8 <= count ; i += 8 ) {
+		Mix8AVX2(
+			a,
+			a,
+			_mm_loadu_si128( (const __m128i*)( b + i ) ),
+			_mm_loadu_si128( (const __m128i*)( b + i + 4 ) ),
+			alpha + i,
+			out + i
+		);
+	}
+	MixColorSSE2( color, b + i, alpha + i, out + i, count - i );
+}
+
+static const bool IsCPUFeatureSupported( const std::string& feature ) {
+#if defined( __GNUC__ )
+	__builtin_cpu_init();
+	if ( feature == "avx2" ) {
+		return __builtin_cpu_supports( "avx2" );
+	}
+	if ( feature == "sse2" ) {
+		return __builtin_cpu_supports( "sse2" );
+	}
+	return false;
+#elif defined( _MSC_VER )
+	int info[4];
+	if ( feature == "sse2" ) {
+		__cpuid( info, 1 );
+		return ( info[ 3 ] & ( 1 << 26 ) ) != 0;
+	}
+	if ( feature == "avx2" ) {
+		__cpuid( info, 1 );
+		const bool has_osxsave = ( info[ 2 ] & ( 1 << 27 ) ) != 0;
+		if ( !has_osxsave || ( _xgetbv( 0 ) & 0x6 ) != 0x6 ) {
+			return false; // os doesn't save ymm registers
+		}
+		__cpuidex( info, 7, 0 );
+		return ( info[ 1 ] & ( 1 << 5 ) ) != 0;
+	}
+	return false;
+#else
+	return false;
+#endif
+}
+
+#endif
+
+const std::vector< Blend::kernels_t >& Blend::GetSupportedKernels() {
+	static const std::vector< kernels_t > s_kernels = []() -> std::vector< kernels_t > {
+		std::vector< kernels_t > kernels = {
+			{
+				"scalar",
+				MixScalar,
+				MixColorScalar
+			}
+		};
+#ifdef BLEND_X86
+		if ( IsCPUFeatureSupported( "sse2" ) ) {
+			kernels.push_back(
+				{
+					"sse2",
+					MixSSE2,
+					MixColorSSE2
+				}
+			);
+		}
+		if ( IsCPUFeatureSupported( "avx2" ) ) {
+			kernels.push_back(
+				{
+					"avx2",
+					MixAVX2,
+					MixColorAVX2
+				}
+			);
+		}
+#endif
+		return kernels;
+	}();
+	return s_kernels;
+}
+
+static const Blend::kernels_t& GetKernels() {
+	static const Blend::kernels_t& s_kernels = Blend::GetSupportedKernels().back();
+	return s_kernels;
+}
+
+void Blend::Mix( const pixel_t* a, const pixel_t* b, const float* alpha, pixel_t* out, const size_t count ) {
+	GetKernels().mix( a, b, alpha, out, count );
+}
+
+void Blend::MixColor( const pixel_t color, const pixel_t* b, const float* alpha, pixel_t* out, const size_t count ) {
+	GetKernels().mix_color( color, b, alpha, out, count );
+}
+
+const std::string& Blend::GetKernelName() {
+	return GetKernels().name;
+}
+
+}
+}
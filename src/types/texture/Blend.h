@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace types {
+namespace texture {
+
+// row kernels for blending RGBA pixels, used by Texture::AddFrom
+// vectorized variant is picked at runtime depending on cpu features, scalar one is used as fallback and as reference
+// all variants produce exactly same pixels ( per channel: (uint8_t)( a * alpha + b * ( 1.0f - alpha ) ) )
+class Blend {
+public:
+
+	typedef uint32_t pixel_t;
+
+	// reference implementation for single pixel
+	static inline const pixel_t MixPixel( const pixel_t a, const pixel_t b, const float alpha ) {
+		const float ialpha = 1.0f - alpha;
+		return
+			(pixel_t)(uint8_t)(int32_t)( (float)( a & 0xff ) * alpha + (float)( b & 0xff ) * ialpha ) |
+				(pixel_t)(uint8_t)(int32_t)( (float)( a >> 8 & 0xff ) * alpha + (float)( b >> 8 & 0xff ) * ialpha ) << 8 |
+				(pixel_t)(uint8_t)(int32_t)( (float)( a >> 16 & 0xff ) * alpha + (float)( b >> 16 & 0xff ) * ialpha ) << 16 |
+				(pixel_t)(uint8_t)(int32_t)( (float)( a >> 24 & 0xff ) * alpha + (float)( b >> 24 & 0xff ) * ialpha ) << 24;
+	}
+
+	// out[ i ] = MixPixel( a[ i ], b[ i ], alpha[ i ] )
+	static void Mix( const pixel_t* a, const pixel_t* b, const float* alpha, pixel_t* out, const size_t count );
+
+	// out[ i ] = MixPixel( color, b[ i ], alpha[ i ] )
+	// ( alpha 0.0f keeps b[ i ] as is )
+	static void MixColor( const pixel_t color, const pixel_t* b, const float* alpha, pixel_t* out, const size_t count );
+
+	// name of kernels that were chosen for this cpu
+	static const std::string& GetKernelName();
+
+	struct kernels_t {
+		std::string name;
+		void (* mix)( const pixel_t* a, const pixel_t* b, const float* alpha, pixel_t* out, const size_t count );
+		void (* mix_color)( const pixel_t color, const pixel_t* b, const float* alpha, pixel_t* out, const size_t count );
+	};
+	// every variant that can run on this cpu, scalar one first and chosen one last ( used by tests to compare them )
+	static const std::vector< kernels_t >& GetSupportedKernels();
+
+};
+
+}
+}
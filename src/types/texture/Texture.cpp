@@ -8,6 +8,7 @@
 #include "graphics/Graphics.h"
 #include "util/random/Random.h"
 #include "util/Perlin.h"
+#include "Blend.h"
 
 // TODO: refactor, remove map dependency
 #include "game/map/Consts.h"
@@ -120,6 +121,66 @@ void Texture::Fill( const size_t x1, const size_t y1, const size_t x2, const siz
 }
 
 void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags, const size_t x1, const size_t y1, const size_t x2, const size_t y2, const size_t dest_x, const size_t dest_y, const rotate_t rotate, const float alpha, util::random::Random* rng, util::Perlin* perlin ) {
+
+	if ( flags & types::texture::AM_RANDOM_STRETCH_SHUFFLE ) {
+		flags |= types::texture::AM_RANDOM_STRETCH | types::texture::AM_RANDOM_STRETCH_SHRINK | types::texture::AM_RANDOM_STRETCH_SHIFT;
+	}
+
+	// flag combinations used by map generation get their own variants with per-pixel flag checks optimized out
+	// everything else goes to generic variant
+	static constexpr add_flag_t STRETCH_SHUFFLE = types::texture::AM_RANDOM_STRETCH | types::texture::AM_RANDOM_STRETCH_SHRINK | types::texture::AM_RANDOM_STRETCH_SHIFT | types::texture::AM_RANDOM_STRETCH_SHUFFLE;
+	static constexpr add_flag_t RANDOM_MIRROR = types::texture::AM_RANDOM_MIRROR_X | types::texture::AM_RANDOM_MIRROR_Y;
+	static constexpr add_flag_t MOISTURE_BLEND = types::texture::AM_MERGE | types::texture::AM_GRADIENT_TIGHTER | types::texture::AM_RANDOM_STRETCH;
+	static constexpr add_flag_t WATER_OVERLAY = types::texture::AM_MERGE | types::texture::AM_KEEP_TRANSPARENCY | types::texture::AM_INVERT;
+
+#define x( _flags ) \
+    case ( _flags ): { \
+        AddFromImpl< ( _flags ), false >( source, flags, x1, y1, x2, y2, dest_x, dest_y, rotate, alpha, rng, perlin ); \
+        break; \
+    }
+	switch ( flags ) {
+		// plain copies
+		x( types::texture::AM_DEFAULT )
+		x( types::texture::AM_MERGE )
+		// tile textures ( see Map::GetTileTextureInfo )
+		x( types::texture::AM_RANDOM_STRETCH )
+		x( RANDOM_MIRROR | STRETCH_SHUFFLE )
+		x( STRETCH_SHUFFLE )
+		x( types::texture::AM_MERGE | types::texture::AM_RANDOM_STRETCH )
+		x( types::texture::AM_MERGE | RANDOM_MIRROR | STRETCH_SHUFFLE )
+		// rocks
+		x( types::texture::AM_MERGE | types::texture::AM_RANDOM_STRETCH | types::texture::AM_RANDOM_STRETCH_SHRINK | types::texture::AM_RANDOM_STRETCH_SHIFT )
+		x( types::texture::AM_MERGE | types::texture::AM_RANDOM_STRETCH | types::texture::AM_RANDOM_STRETCH_SHRINK )
+		// coastlines
+		x( types::texture::AM_MERGE | types::texture::AM_INVERT )
+		x( types::texture::AM_MERGE | types::texture::AM_COASTLINE_BORDER )
+		// moisture blending between neighbours
+		x( MOISTURE_BLEND | types::texture::AM_GRADIENT_LEFT | types::texture::AM_MIRROR_X )
+		x( MOISTURE_BLEND | types::texture::AM_GRADIENT_LEFT | types::texture::AM_GRADIENT_TOP | types::texture::AM_MIRROR_X | types::texture::AM_MIRROR_Y )
+		x( MOISTURE_BLEND | types::texture::AM_GRADIENT_TOP | types::texture::AM_MIRROR_Y )
+		x( MOISTURE_BLEND | types::texture::AM_GRADIENT_TOP | types::texture::AM_GRADIENT_RIGHT | types::texture::AM_MIRROR_X | types::texture::AM_MIRROR_Y )
+		x( MOISTURE_BLEND | types::texture::AM_GRADIENT_RIGHT | types::texture::AM_MIRROR_X )
+		x( MOISTURE_BLEND | types::texture::AM_GRADIENT_RIGHT | types::texture::AM_GRADIENT_BOTTOM | types::texture::AM_MIRROR_X | types::texture::AM_MIRROR_Y )
+		x( MOISTURE_BLEND | types::texture::AM_GRADIENT_BOTTOM | types::texture::AM_MIRROR_Y )
+		x( MOISTURE_BLEND | types::texture::AM_GRADIENT_BOTTOM | types::texture::AM_GRADIENT_LEFT | types::texture::AM_MIRROR_X | types::texture::AM_MIRROR_Y )
+		// water fungus
+		x( WATER_OVERLAY | types::texture::AM_RANDOM_STRETCH )
+		x( WATER_OVERLAY | RANDOM_MIRROR | STRETCH_SHUFFLE )
+		default: {
+			AddFromImpl< types::texture::AM_DEFAULT, true >( source, flags, x1, y1, x2, y2, dest_x, dest_y, rotate, alpha, rng, perlin );
+		}
+	}
+#undef x
+}
+
+template< add_flag_t FLAGS, bool IS_GENERIC >
+void Texture::AddFromImpl( const types::texture::Texture* source, const add_flag_t runtime_flags, const size_t x1, const size_t y1, const size_t x2, const size_t y2, const size_t dest_x, const size_t dest_y, const rotate_t rotate, const float alpha, util::random::Random* rng, util::Perlin* perlin ) {
+	// known at compile time in specialized variants, so compiler can drop all flag checks and branches that aren't needed
+	const add_flag_t flags = IS_GENERIC
+		? runtime_flags
+		: FLAGS;
+	ASSERT( flags == runtime_flags, "flags mismatch ( " + std::to_string( flags ) + " != " + std::to_string( runtime_flags ) + " )" );
+
 	ASSERT( x2 >= x1, "invalid source x size ( " + std::to_string( x2 ) + " < " + std::to_string( x1 ) + " )" );
 	ASSERT( y2 >= y1, "invalid source y size ( " + std::to_string( y2 ) + " < " + std::to_string( y1 ) + " )" );
 	ASSERT( dest_x + ( x2 - x1 ) < m_width, "destination x overflow ( " + std::to_string( dest_x + ( x2 - x1 ) ) + " >= " + std::to_string( m_width ) + " )" );
@@ -127,13 +188,6 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 	ASSERT( alpha >= 0, "invalid alpha value ( " + std::to_string( alpha ) + " < 0 )" );
 	ASSERT( alpha <= 1, "invalid alpha value ( " + std::to_string( alpha ) + " > 1 )" );
 
-#define MIX_COLORS( _a, _b, _alpha ) ( \
-        (uint8_t)( (float)( (_a) & 0xff ) * (_alpha) + (float)( (_b) & 0xff ) * ( 1.0f - (_alpha) ) ) | \
-        (uint8_t)( (float)( (_a) >> 8 & 0xff ) * (_alpha) + (float)( (_b) >> 8 & 0xff ) * ( 1.0f - (_alpha) ) ) << 8 | \
-        (uint8_t)( (float)( (_a) >> 16 & 0xff ) * (_alpha) + (float)( (_b) >> 16 & 0xff ) * ( 1.0f - (_alpha) ) ) << 16 | \
-        (uint8_t)( (float)( (_a) >> 24 & 0xff ) * (_alpha) + (float)( (_b) >> 24 & 0xff ) * ( 1.0f - (_alpha) ) ) << 24 \
-    )
-
 #define COASTLINES_BORDER_RND ( (float)( perlin->Noise( x * 4, y * 4, 1.5f ) + 1.0f ) / 2 * game::map::s_consts.coastlines.border_size )
 
 	// +1 because it's inclusive on both sides
@@ -189,17 +243,21 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 		}
 	}
 
+	// flags can't be changed here because they may be compile-time constant
+	bool is_mirror_x = flags & types::texture::AM_MIRROR_X;
+	bool is_mirror_y = flags & types::texture::AM_MIRROR_Y;
+
 	if ( flags & types::texture::AM_RANDOM_MIRROR_X ) {
 		ASSERT( rng, "no rng provided for random mirror" );
 		if ( rng->IsLucky( 2 ) ) {
-			flags ^= types::texture::AM_MIRROR_X;
+			is_mirror_x = !is_mirror_x;
 		}
 	}
 
 	if ( flags & types::texture::AM_RANDOM_MIRROR_Y ) {
 		ASSERT( rng, "no rng provided for random mirror" );
 		if ( rng->IsLucky( 2 ) ) {
-			flags ^= types::texture::AM_MIRROR_Y;
+			is_mirror_y = !is_mirror_y;
 		}
 	}
 
@@ -224,6 +282,69 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 	bool is_pixel_needed;
 	Color::rgba_t mix_color;
 
+	// blended pixels are collected per row and mixed by vectorized kernels at the end of it
+	// every destination pixel is processed only once, so deferring writes doesn't change result
+	// ( unless texture copies onto itself with overlap, then every pixel is flushed immediately )
+	const Color::rgba_t border_color = game::map::s_consts.coastlines.border_color.GetRGBA();
+	const float border_alpha = game::map::s_consts.coastlines.border_alpha;
+	const bool is_overlapping = source == this &&
+		x1 < dest_x + std::max( w, h ) && dest_x <= x2 &&
+		y1 < dest_y + std::max( w, h ) && dest_y <= y2;
+	Blend::pixel_t blend_a_buf[w];
+	Blend::pixel_t blend_b_buf[w];
+	float blend_premix_alpha_buf[w];
+	float blend_alpha_buf[w];
+	bool blend_is_self_buf[w];
+	void* blend_to_buf[w];
+	// lambdas can't capture arrays of variable size
+	Blend::pixel_t* const blend_a = blend_a_buf;
+	Blend::pixel_t* const blend_b = blend_b_buf;
+	float* const blend_premix_alpha = blend_premix_alpha_buf;
+	float* const blend_alpha = blend_alpha_buf;
+	bool* const blend_is_self = blend_is_self_buf;
+	void** const blend_to = blend_to_buf;
+	size_t blend_count = 0;
+	bool blend_need_premix = false;
+
+	// queues to = mix( premixed( src ), dst, alpha ), where premix means mixing with border color ( if need_premix is set )
+	// dst == nullptr means mixing premixed src with itself
+	const auto f_blend = [ blend_a, blend_b, blend_premix_alpha, blend_alpha, blend_is_self, blend_to, &blend_count, &blend_need_premix, border_alpha ]( void* const to, const uint32_t src, const bool need_premix, const uint32_t* const dst, const float alpha ) -> void {
+		blend_a[ blend_count ] = src;
+		blend_premix_alpha[ blend_count ] = need_premix
+			? border_alpha
+			: 0.0f;
+		if ( need_premix ) {
+			blend_need_premix = true;
+		}
+		blend_is_self[ blend_count ] = !dst;
+		blend_b[ blend_count ] = dst
+			? *dst
+			: 0;
+		blend_alpha[ blend_count ] = alpha;
+		blend_to[ blend_count ] = to;
+		blend_count++;
+	};
+	const auto f_flush_blend = [ this, blend_a, blend_b, blend_premix_alpha, blend_alpha, blend_is_self, blend_to, &blend_count, &blend_need_premix, border_color ]() -> void {
+		if ( !blend_count ) {
+			return;
+		}
+		if ( blend_need_premix ) {
+			// alpha 0.0f leaves pixels that don't need premix untouched
+			Blend::MixColor( border_color, blend_a, blend_premix_alpha, blend_a, blend_count );
+		}
+		for ( size_t i = 0 ; i < blend_count ; i++ ) {
+			if ( blend_is_self[ i ] ) {
+				blend_b[ i ] = blend_a[ i ];
+			}
+		}
+		Blend::Mix( blend_a, blend_b, blend_alpha, blend_a, blend_count );
+		for ( size_t i = 0 ; i < blend_count ; i++ ) {
+			memcpy( blend_to[ i ], &blend_a[ i ], m_bpp );
+		}
+		blend_count = 0;
+		blend_need_premix = false;
+	};
+
 	if ( flags & ( types::texture::AM_PERLIN_LEFT | types::texture::AM_PERLIN_TOP | types::texture::AM_PERLIN_RIGHT | types::texture::AM_PERLIN_BOTTOM ) ) {
 
 		ASSERT( rng, "no rng provided for perlin edge" );
@@ -299,10 +420,6 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 		}
 	}
 
-	if ( flags & types::texture::AM_RANDOM_STRETCH_SHUFFLE ) {
-		flags |= types::texture::AM_RANDOM_STRETCH | types::texture::AM_RANDOM_STRETCH_SHRINK | types::texture::AM_RANDOM_STRETCH_SHIFT;
-	}
-
 	if ( flags & types::texture::AM_RANDOM_STRETCH ) {
 		ASSERT( rng, "no rng provided for random mirror" );
 		// randomize random ratio ranges (per-tile)
@@ -527,14 +644,14 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 					sy = y;
 				}
 
-				if ( flags & types::texture::AM_MIRROR_X ) {
+				if ( is_mirror_x ) {
 					sx = x2 - sx;
 				}
 				else {
 					sx = sx + x1;
 				}
 
-				if ( flags & types::texture::AM_MIRROR_Y ) {
+				if ( is_mirror_y ) {
 					sy = y2 - sy;
 				}
 				else {
@@ -574,6 +691,9 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 
 				if ( ( !( flags & types::texture::AM_MERGE ) ) || ( *(uint32_t*)from & 0x000000ff ) ) {
 
+					uint32_t pixel_color;
+					memcpy( &pixel_color, from, m_bpp );
+
 					if (
 						( flags & types::texture::AM_GRADIENT_LEFT ) ||
 							( flags & types::texture::AM_GRADIENT_TOP ) ||
@@ -581,12 +701,6 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 							( flags & types::texture::AM_GRADIENT_BOTTOM )
 						) {
 
-						uint32_t pixel_color;
-						memcpy( &pixel_color, from, m_bpp );
-						if ( mix_color ) {
-							pixel_color = MIX_COLORS( mix_color, pixel_color, game::map::s_consts.coastlines.border_alpha );
-						}
-
 						uint32_t dst_pixel_color;
 						memcpy( &dst_pixel_color, to, m_bpp );
 
@@ -645,41 +759,33 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 							p *= pixel_alpha;
 						}
 
-						pixel_color = MIX_COLORS( pixel_color, dst_pixel_color, p );
-						memcpy( to, &pixel_color, m_bpp );
+						f_blend( to, pixel_color, mix_color != 0, &dst_pixel_color, p );
 					}
-					else {
-						if ( mix_color ) {
-							uint32_t pixel_color;
-							memcpy( &pixel_color, from, m_bpp );
-							pixel_color = MIX_COLORS( mix_color, pixel_color, game::map::s_consts.coastlines.border_alpha );
+					else if ( pixel_alpha < 1.0f && ( flags & types::texture::AM_MERGE ) ) {
+						// TODO: refactor
+						// source is mixed with itself here, not with destination ( this is how it always worked and textures depend on it )
+						f_blend( to, pixel_color, mix_color != 0, nullptr, pixel_alpha );
+					}
+					else if ( mix_color ) {
+						if ( pixel_alpha < 1.0f ) {
+							pixel_color = Blend::MixPixel( mix_color, pixel_color, border_alpha );
 							memcpy( to, &pixel_color, m_bpp );
+							*( (uint8_t*)( to ) + 3 ) = (uint8_t)floor( pixel_alpha * 0xff );
 						}
 						else {
-							memcpy( to, from, m_bpp );
+							f_blend( to, pixel_color, true, nullptr, 1.0f );
 						}
+					}
+					else {
+						memcpy( to, from, m_bpp );
 						if ( pixel_alpha < 1.0f ) {
-							if ( flags & types::texture::AM_MERGE ) {
-
-								// TODO: refactor
-
-								uint32_t pixel_color;
-								memcpy( &pixel_color, from, m_bpp );
-								if ( mix_color ) {
-									pixel_color = MIX_COLORS( mix_color, pixel_color, game::map::s_consts.coastlines.border_alpha );
-								}
-								uint32_t dst_pixel_color;
-								memcpy( &dst_pixel_color, to, m_bpp );
-
-								pixel_color = MIX_COLORS( pixel_color, dst_pixel_color, pixel_alpha );
-
-								memcpy( to, &pixel_color, m_bpp );
-							}
-							else {
-								*( (uint8_t*)( to ) + 3 ) = (uint8_t)floor( pixel_alpha * 0xff );
-							}
+							*( (uint8_t*)( to ) + 3 ) = (uint8_t)floor( pixel_alpha * 0xff );
 						}
 					}
+
+					if ( is_overlapping ) {
+						f_flush_blend();
+					}
 				}
 			}
 #ifdef DEBUG
@@ -693,6 +799,7 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 				ssx += rng->GetFloat( 1.0f - srx.first, 1.0f + srx.second );
 			}
 		}
+		f_flush_blend();
 		if ( flags & types::texture::AM_RANDOM_STRETCH ) {
 			ssx = ssx_start + rng->GetFloat( -srx.first, srx.second );
 			ssy += rng->GetFloat( 1.0f - sry.first, 1.0f + sry.second );
@@ -711,7 +818,6 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 	// spammy
 	//Log( "Texture processing end" );
 
-#undef MIX_COLORS
 #undef COASTLINES_BORDER_RND
 
 	Update(
@@ -840,6 +946,7 @@ Texture* Texture::FromColor( const Color& color ) {
 
 void Texture::Update( const updated_area_t updated_area ) {
 	//Log( "Need texture update [ "+ std::to_string( updated_area.left ) + " " + std::to_string( updated_area.top ) + " " + std::to_string( updated_area.right ) + " " + std::to_string( updated_area.bottom ) + " ]" );
+	std::lock_guard< std::mutex > guard( m_update_mutex );
 	m_updated_areas.push_back( updated_area );
 	m_update_counter++;
 }
@@ -912,7 +1019,7 @@ const types::Buffer Texture::Serialize() const {
 	return buf;
 }
 
-void Texture::Unserialize( types::Buffer buf ) {
+void Texture::Unserialize( types::BufferView buf ) {
 
 	m_name = buf.ReadString();
 	size_t width = buf.ReadInt();
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <mutex>
 
 #include "types/Serializable.h"
 
@@ -109,10 +110,16 @@ CLASS( Texture, Serializable )
 	unsigned char* CopyBitmap( const size_t x1, const size_t y1, const size_t x2, const size_t y2 ) const;
 
 	const types::Buffer Serialize() const override;
-	void Unserialize( types::Buffer buf ) override;
+	void Unserialize( types::BufferView buf ) override;
 
 private:
+	// see AddFrom()
+	// specialized variants have FLAGS fixed at compile time, generic one uses runtime_flags
+	template< add_flag_t FLAGS, bool IS_GENERIC >
+	void AddFromImpl( const types::texture::Texture* source, const add_flag_t runtime_flags, const size_t x1, const size_t y1, const size_t x2, const size_t y2, const size_t dest_x, const size_t dest_y, const rotate_t rotate, const float alpha, util::random::Random* rng, util::Perlin* perlin );
+
 	size_t m_update_counter = 0;
+	std::mutex m_update_mutex; // different areas of same texture may be drawn from multiple threads
 };
 
 }
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "UI.h"
+
+namespace ui {
+
+// for headless mode, there is nobody to show loaders or errors to
+CLASS( Null, UI )
+
+	void ShowError( const std::string& text, const ui_handler_t on_close = UH() {} ) const override {}
+	void HideError() const override {}
+
+	void ShowLoader( const std::string& text, const loader_cancel_handler_t on_cancel = 0 ) const override {}
+	void SetLoaderText( const std::string& text, bool is_cancelable = true ) const override {}
+	void HideLoader() const override {}
+
+};
+
+}
@@ -95,13 +95,13 @@ CLASS( UI, common::Module )
 
 	// no direct access to ui modules because they may have been already destroyed while other thread tries to call them
 
-	void ShowError( const std::string& text, const ui_handler_t on_close = UH() {} ) const;
-	void HideError() const;
+	virtual void ShowError( const std::string& text, const ui_handler_t on_close = UH() {} ) const;
+	virtual void HideError() const;
 
 	typedef std::function< bool() > loader_cancel_handler_t;
-	void ShowLoader( const std::string& text, const loader_cancel_handler_t on_cancel = 0 ) const;
-	void SetLoaderText( const std::string& text, bool is_cancelable = true ) const;
-	void HideLoader() const;
+	virtual void ShowLoader( const std::string& text, const loader_cancel_handler_t on_cancel = 0 ) const;
+	virtual void SetLoaderText( const std::string& text, bool is_cancelable = true ) const;
+	virtual void HideLoader() const;
 
 	void BlockEvents();
 	void UnblockEvents();
@@ -0,0 +1,89 @@
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+#include "FS.h"
+
+namespace util {
+
+MappedFile::MappedFile( const std::string& path ) {
+	const auto normalized_path = FS::NormalizePath( path, FS::PATH_SEPARATOR );
+#ifdef _WIN32
+	m_file = CreateFileA( normalized_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+	if ( m_file == INVALID_HANDLE_VALUE ) {
+		THROW( "failed to open file \"" + path + "\"" );
+	}
+	LARGE_INTEGER size;
+	if ( !GetFileSizeEx( m_file, &size ) ) {
+		CloseHandle( m_file );
+		THROW( "failed to get size of file \"" + path + "\"" );
+	}
+	m_size = size.QuadPart;
+	if ( m_size ) {
+		m_mapping = CreateFileMappingA( m_file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+		if ( !m_mapping ) {
+			CloseHandle( m_file );
+			THROW( "failed to map file \"" + path + "\"" );
+		}
+		m_data = (const uint8_t*)MapViewOfFile( m_mapping, FILE_MAP_READ, 0, 0, 0 );
+		if ( !m_data ) {
+			CloseHandle( m_mapping );
+			CloseHandle( m_file );
+			THROW( "failed to map view of file \"" + path + "\"" );
+		}
+	}
+#else
+	m_fd = open( normalized_path.c_str(), O_RDONLY );
+	if ( m_fd < 0 ) {
+		THROW( "failed to open file \"" + path + "\"" );
+	}
+	struct stat st = {};
+	if ( fstat( m_fd, &st ) < 0 ) {
+		close( m_fd );
+		THROW( "failed to stat file \"" + path + "\"" );
+	}
+	m_size = st.st_size;
+	if ( m_size ) {
+		void* data = mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0 );
+		if ( data == MAP_FAILED ) {
+			close( m_fd );
+			THROW( "failed to map file \"" + path + "\"" );
+		}
+		// whole file is going to be read sequentially
+		madvise( data, m_size, MADV_SEQUENTIAL );
+		m_data = (const uint8_t*)data;
+	}
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+	if ( m_data ) {
+		UnmapViewOfFile( m_data );
+	}
+	if ( m_mapping ) {
+		CloseHandle( m_mapping );
+	}
+	CloseHandle( m_file );
+#else
+	if ( m_data ) {
+		munmap( (void*)m_data, m_size );
+	}
+	close( m_fd );
+#endif
+}
+
+const uint8_t* MappedFile::GetData() const {
+	return m_data;
+}
+
+const size_t MappedFile::GetSize() const {
+	return m_size;
+}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "Util.h"
+
+namespace util {
+
+// read-only memory-mapped file, mapping lives as long as object does
+CLASS( MappedFile, Util )
+
+	MappedFile( const std::string& path );
+	~MappedFile();
+
+	const uint8_t* GetData() const;
+	const size_t GetSize() const;
+
+private:
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+
+#ifdef _WIN32
+	HANDLE m_file = INVALID_HANDLE_VALUE;
+	HANDLE m_mapping = nullptr;
+#else
+	int m_fd = -1;
+#endif
+
+};
+
+}
@@ -1,10 +1,89 @@
+#include <chrono>
+#include <vector>
+
 #include "CRC32.h"
 
 namespace util {
 namespace crc32 {
 
-const crc_t CRC32::CalculateFromBuffer( const types::Buffer& buf ) {
-	return 0;
+static constexpr crc_t POLYNOMIAL = 0xEDB88320; // reversed 0x04C11DB7
+
+typedef crc_t tables_t[8][256];
+
+static const tables_t& GetTables() {
+	static const struct tables_holder_t {
+		tables_t tables;
+		tables_holder_t() {
+			for ( crc_t i = 0 ; i < 256 ; i++ ) {
+				crc_t crc = i;
+				for ( uint8_t bit = 0 ; bit < 8 ; bit++ ) {
+					crc = ( crc >> 1 ) ^ ( POLYNOMIAL & ( 0 - ( crc & 1 ) ) );
+				}
+				tables[ 0 ][ i ] = crc;
+			}
+			// every next table advances crc by one more zero byte
+			for ( crc_t i = 0 ; i < 256 ; i++ ) {
+				for ( uint8_t t = 1 ; t < 8 ; t++ ) {
+					tables[ t ][ i ] = ( tables[ t - 1 ][ i ] >> 8 ) ^ tables[ 0 ][ tables[ t - 1 ][ i ] & 0xff ];
+				}
+			}
+		}
+	} s_holder;
+	return s_holder.tables;
+}
+
+const crc_t CRC32::Calculate( const void* data, const size_t size, const crc_t crc ) {
+	const auto& t = GetTables();
+	const uint8_t* p = (const uint8_t*)data;
+	const uint8_t* const end = p + size;
+	crc_t c = ~crc;
+
+	// 8 bytes per iteration, read byte by byte so that it doesn't depend on endianness or alignment ( compiler merges it into plain loads )
+	while ( end - p >= 8 ) {
+		const crc_t one = c ^ ( (crc_t)p[ 0 ] | (crc_t)p[ 1 ] << 8 | (crc_t)p[ 2 ] << 16 | (crc_t)p[ 3 ] << 24 );
+		const crc_t two = (crc_t)p[ 4 ] | (crc_t)p[ 5 ] << 8 | (crc_t)p[ 6 ] << 16 | (crc_t)p[ 7 ] << 24;
+		c =
+			t[ 7 ][ one & 0xff ] ^
+				t[ 6 ][ ( one >> 8 ) & 0xff ] ^
+				t[ 5 ][ ( one >> 16 ) & 0xff ] ^
+				t[ 4 ][ one >> 24 ] ^
+				t[ 3 ][ two & 0xff ] ^
+				t[ 2 ][ ( two >> 8 ) & 0xff ] ^
+				t[ 1 ][ ( two >> 16 ) & 0xff ] ^
+				t[ 0 ][ two >> 24 ];
+		p += 8;
+	}
+
+	while ( p < end ) {
+		c = ( c >> 8 ) ^ t[ 0 ][ ( c ^ *( p++ ) ) & 0xff ];
+	}
+
+	return ~c;
+}
+
+const crc_t CRC32::CalculateFromBuffer( const types::Buffer& buf, const crc_t crc ) {
+	return Calculate( buf.data, buf.lenw, crc );
+}
+
+const double CRC32::MeasureThroughput( const size_t size, const size_t iterations ) {
+	std::vector< uint8_t > data( size );
+	uint32_t seed = 1;
+	for ( auto& b : data ) {
+		seed = seed * 1664525 + 1013904223;
+		b = seed >> 24;
+	}
+	crc_t crc = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for ( size_t i = 0 ; i < iterations ; i++ ) {
+		crc = Calculate( data.data(), data.size(), crc );
+	}
+	const std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - start;
+	// so that loop isn't optimized out
+	volatile crc_t result = crc;
+	(void)result;
+	return elapsed.count() > 0
+		? (double)size * iterations / ( 1024 * 1024 ) / elapsed.count()
+		: 0.0;
 }
 
 }
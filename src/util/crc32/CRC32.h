@@ -8,9 +8,16 @@
 namespace util {
 namespace crc32 {
 
+// standard CRC-32 ( IEEE 802.3, same as zlib ), slice-by-8
+// hardware CRC32C isn't used because checksums are compared between different machines and it's a different polynomial
 CLASS( CRC32, Util )
 
-	static const crc_t CalculateFromBuffer( const types::Buffer& buf );
+	// pass previous result as crc to continue calculation ( Calculate( b, Calculate( a ) ) == Calculate( a + b ) )
+	static const crc_t Calculate( const void* data, const size_t size, const crc_t crc = 0 );
+	static const crc_t CalculateFromBuffer( const types::Buffer& buf, const crc_t crc = 0 );
+
+	// hashes random data of given size few times, returns MB/s
+	static const double MeasureThroughput( const size_t size, const size_t iterations );
 
 };
 
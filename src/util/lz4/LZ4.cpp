@@ -0,0 +1,300 @@
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#include "LZ4.h"
+
+namespace util {
+namespace lz4 {
+
+// format constraints ( see lz4 block format description )
+static constexpr size_t MIN_MATCH = 4;
+static constexpr size_t LAST_LITERALS = 5; // last 5 bytes are always literals
+static constexpr size_t MF_LIMIT = 12; // last match must start at least 12 bytes before end of block
+static constexpr size_t MAX_OFFSET = 65535;
+
+static constexpr uint8_t HASH_LOG = 14;
+static constexpr size_t BLOCK_HEADER_SIZE = 8;
+
+static inline const uint32_t Read32( const uint8_t* p ) {
+	uint32_t v;
+	memcpy( &v, p, sizeof( v ) );
+	return v;
+}
+
+static inline const uint32_t Hash( const uint32_t v ) {
+	return ( v * 2654435761u ) >> ( 32 - HASH_LOG );
+}
+
+static inline void WriteLength( uint8_t*& op, size_t len ) {
+	while ( len >= 255 ) {
+		*op++ = 255;
+		len -= 255;
+	}
+	*op++ = (uint8_t)len;
+}
+
+static inline void WriteSequence( uint8_t*& op, const uint8_t* literals, const size_t literals_len, const size_t offset, const size_t match_len ) {
+	uint8_t* token = op++;
+	*token = ( literals_len >= 15
+		? 15
+		: literals_len ) << 4;
+	if ( literals_len >= 15 ) {
+		WriteLength( op, literals_len - 15 );
+	}
+	memcpy( op, literals, literals_len );
+	op += literals_len;
+	if ( match_len ) {
+		*op++ = offset & 0xff;
+		*op++ = offset >> 8;
+		const size_t len = match_len - MIN_MATCH;
+		*token |= len >= 15
+			? 15
+			: len;
+		if ( len >= 15 ) {
+			WriteLength( op, len - 15 );
+		}
+	}
+}
+
+static inline void Write32( std::string& out, const uint32_t v ) {
+	out.append( (const char*)&v, sizeof( v ) );
+}
+
+const size_t LZ4::CompressBound( const size_t size ) {
+	return size + size / 255 + 16;
+}
+
+const size_t LZ4::CompressBlock( const void* src, const size_t size, void* dst ) {
+	const uint8_t* const base = (const uint8_t*)src;
+	uint8_t* op = (uint8_t*)dst;
+
+	const uint8_t* anchor = base;
+	if ( size > MF_LIMIT ) {
+		// positions + 1, so that 0 means empty
+		uint32_t table[1 << HASH_LOG];
+		memset( table, 0, sizeof( table ) );
+
+		const uint8_t* ip = base;
+		const uint8_t* const match_start_limit = base + size - MF_LIMIT;
+		const uint8_t* const match_end_limit = base + size - LAST_LITERALS;
+
+		while ( ip < match_start_limit ) {
+			const uint32_t seq = Read32( ip );
+			const uint32_t h = Hash( seq );
+			const uint32_t ref_pos = table[ h ];
+			table[ h ] = ip - base + 1;
+			if ( ref_pos ) {
+				const uint8_t* ref = base + ref_pos - 1;
+				if ( (size_t)( ip - ref ) <= MAX_OFFSET && Read32( ref ) == seq ) {
+					const uint8_t* match_end = ip + MIN_MATCH;
+					ref += MIN_MATCH;
+					while ( match_end < match_end_limit && *match_end == *ref ) {
+						match_end++;
+						ref++;
+					}
+					WriteSequence( op, anchor, ip - anchor, match_end - ref, match_end - ip );
+					ip = match_end;
+					anchor = ip;
+					continue;
+				}
+			}
+			// skip faster through data that doesn't compress
+			ip += 1 + ( ( ip - anchor ) >> 6 );
+		}
+	}
+
+	WriteSequence( op, anchor, base + size - anchor, 0, 0 );
+	return op - (uint8_t*)dst;
+}
+
+const bool LZ4::DecompressBlock( const void* src, const size_t size, void* dst, const size_t dst_size ) {
+	const uint8_t* ip = (const uint8_t*)src;
+	const uint8_t* const iend = ip + size;
+	uint8_t* const obase = (uint8_t*)dst;
+	uint8_t* op = obase;
+	uint8_t* const oend = op + dst_size;
+	uint8_t b;
+
+#define READ_LENGTH( _len ) \
+	do { \
+		if ( ip >= iend ) { \
+			return false; \
+		} \
+		b = *ip++; \
+		_len += b; \
+	} while ( b == 255 );
+
+	while ( ip < iend ) {
+		const uint8_t token = *ip++;
+
+		size_t literals_len = token >> 4;
+		if ( literals_len == 15 ) {
+			READ_LENGTH( literals_len )
+		}
+		if ( literals_len > (size_t)( iend - ip ) || literals_len > (size_t)( oend - op ) ) {
+			return false;
+		}
+		memcpy( op, ip, literals_len );
+		ip += literals_len;
+		op += literals_len;
+
+		if ( ip == iend ) {
+			// last sequence has no match
+			break;
+		}
+
+		if ( iend - ip < 2 ) {
+			return false;
+		}
+		const size_t offset = ip[ 0 ] | ( ip[ 1 ] << 8 );
+		ip += 2;
+		if ( offset == 0 || offset > (size_t)( op - obase ) ) {
+			return false;
+		}
+
+		size_t match_len = token & 15;
+		if ( match_len == 15 ) {
+			READ_LENGTH( match_len )
+		}
+		match_len += MIN_MATCH;
+		if ( match_len > (size_t)( oend - op ) ) {
+			return false;
+		}
+		const uint8_t* ref = op - offset;
+		if ( offset >= match_len ) {
+			memcpy( op, ref, match_len );
+			op += match_len;
+		}
+		else {
+			// overlapping copy repeats last offset bytes
+			for ( size_t i = 0 ; i < match_len ; i++ ) {
+				*op++ = *ref++;
+			}
+		}
+	}
+
+#undef READ_LENGTH
+
+	return op == oend;
+}
+
+const bool LZ4::IsCompressed( const void* data, const size_t size ) {
+	return size >= sizeof( MAGIC ) && !memcmp( data, MAGIC, sizeof( MAGIC ) );
+}
+
+const std::string LZ4::Compress( const void* data, const size_t size ) {
+	std::string out;
+	out.reserve( sizeof( MAGIC ) + size / 2 );
+	out.append( MAGIC, sizeof( MAGIC ) );
+	std::vector< uint8_t > block( CompressBound( BLOCK_SIZE ) );
+	const uint8_t* p = (const uint8_t*)data;
+	const uint8_t* const end = p + size;
+	while ( p < end ) {
+		const size_t raw_size = std::min( BLOCK_SIZE, (size_t)( end - p ) );
+		const size_t compressed_size = CompressBlock( p, raw_size, block.data() );
+		Write32( out, raw_size );
+		if ( compressed_size < raw_size ) {
+			Write32( out, compressed_size );
+			out.append( (const char*)block.data(), compressed_size );
+		}
+		else {
+			// incompressible, store as is
+			Write32( out, raw_size );
+			out.append( (const char*)p, raw_size );
+		}
+		p += raw_size;
+	}
+	Write32( out, 0 );
+	Write32( out, 0 );
+	return out;
+}
+
+const std::string LZ4::Compress( const std::string& data ) {
+	return Compress( data.data(), data.size() );
+}
+
+const bool LZ4::Decompress( const void* data, const size_t size, std::string& out ) {
+	Decoder decoder;
+	return decoder.Feed( data, size, out ) && decoder.IsFinished();
+}
+
+const bool Decoder::Feed( const void* data, const size_t size, std::string& out ) {
+	if ( m_is_finished ) {
+		return size == 0;
+	}
+	m_pending.append( (const char*)data, size );
+	const uint8_t* p = (const uint8_t*)m_pending.data() + m_pending_offset;
+	const uint8_t* const end = (const uint8_t*)m_pending.data() + m_pending.size();
+
+	if ( !m_is_header_read ) {
+		if ( end - p < (ptrdiff_t)sizeof( LZ4::MAGIC ) ) {
+			return true;
+		}
+		if ( !LZ4::IsCompressed( p, end - p ) ) {
+			return false;
+		}
+		p += sizeof( LZ4::MAGIC );
+		m_is_header_read = true;
+	}
+
+	while ( end - p >= (ptrdiff_t)BLOCK_HEADER_SIZE ) {
+		const uint32_t raw_size = Read32( p );
+		const uint32_t compressed_size = Read32( p + 4 );
+		if ( raw_size == 0 ) {
+			if ( compressed_size != 0 || end - p != BLOCK_HEADER_SIZE ) {
+				// garbage after end of stream
+				return false;
+			}
+			p += BLOCK_HEADER_SIZE;
+			m_is_finished = true;
+			break;
+		}
+		if ( raw_size > LZ4::BLOCK_SIZE || compressed_size > raw_size ) {
+			return false;
+		}
+		if ( (size_t)( end - p ) < BLOCK_HEADER_SIZE + compressed_size ) {
+			// wait for rest of block
+			break;
+		}
+		p += BLOCK_HEADER_SIZE;
+		const size_t out_pos = out.size();
+		if ( compressed_size == raw_size ) {
+			out.append( (const char*)p, raw_size );
+		}
+		else {
+			out.resize( out_pos + raw_size );
+			if ( !LZ4::DecompressBlock( p, compressed_size, &out[ out_pos ], raw_size ) ) {
+				out.resize( out_pos );
+				return false;
+			}
+		}
+		p += compressed_size;
+	}
+
+	// drop consumed data once in a while instead of on every call
+	m_pending_offset = p - (const uint8_t*)m_pending.data();
+	if ( m_pending_offset == m_pending.size() ) {
+		m_pending.clear();
+		m_pending_offset = 0;
+	}
+	else if ( m_pending_offset >= LZ4::BLOCK_SIZE ) {
+		m_pending.erase( 0, m_pending_offset );
+		m_pending_offset = 0;
+	}
+	return true;
+}
+
+const bool Decoder::IsFinished() const {
+	return m_is_finished;
+}
+
+void Decoder::Reset() {
+	m_pending.clear();
+	m_pending_offset = 0;
+	m_is_header_read = false;
+	m_is_finished = false;
+}
+
+}
+}
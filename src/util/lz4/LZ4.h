@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "util/Util.h"
+
+namespace util {
+namespace lz4 {
+
+// blocks are in standard LZ4 block format, so they can be inspected with any LZ4 tool
+// stream is sequence of independently compressed blocks, so it can be decoded as it arrives:
+//   magic, then for every block: raw size ( 4 bytes ), compressed size ( 4 bytes ), data
+//   block with equal sizes is stored as is, block with zero raw size marks end of stream
+CLASS( LZ4, Util )
+
+	static constexpr char MAGIC[ 4 ] = { 'G', 'L', 'Z', '1' };
+	static constexpr size_t BLOCK_SIZE = 256 * 1024;
+
+	// max compressed size of block
+	static const size_t CompressBound( const size_t size );
+	// returns compressed size, dst must have at least CompressBound( size ) bytes
+	static const size_t CompressBlock( const void* src, const size_t size, void* dst );
+	// false if data is malformed or doesn't decode to exactly dst_size bytes
+	static const bool DecompressBlock( const void* src, const size_t size, void* dst, const size_t dst_size );
+
+	static const bool IsCompressed( const void* data, const size_t size );
+	static const std::string Compress( const void* data, const size_t size );
+	static const std::string Compress( const std::string& data );
+	// false if stream is malformed or incomplete
+	static const bool Decompress( const void* data, const size_t size, std::string& out );
+
+};
+
+// decodes stream part by part
+CLASS( Decoder, Util )
+
+	// appends decoded blocks to out, returns false if stream is malformed
+	const bool Feed( const void* data, const size_t size, std::string& out );
+	// true if end of stream was reached
+	const bool IsFinished() const;
+	void Reset();
+
+private:
+	std::string m_pending = ""; // data of incomplete header or block
+	size_t m_pending_offset = 0;
+	bool m_is_header_read = false;
+	bool m_is_finished = false;
+};
+
+}
+}
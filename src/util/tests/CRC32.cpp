@@ -0,0 +1,101 @@
+#include "CRC32.h"
+
+#include <vector>
+
+#include "task/gsetests/GSETests.h"
+#include "util/crc32/CRC32.h"
+
+namespace util {
+namespace tests {
+
+using crc32::CRC32;
+using crc32::crc_t;
+
+// bit by bit, without tables
+static const crc_t CalculateCRC32Reference( const uint8_t* data, const size_t size ) {
+	crc_t crc = ~0u;
+	for ( size_t i = 0 ; i < size ; i++ ) {
+		crc ^= data[ i ];
+		for ( uint8_t bit = 0 ; bit < 8 ; bit++ ) {
+			crc = ( crc >> 1 ) ^ ( 0xEDB88320 & ( 0 - ( crc & 1 ) ) );
+		}
+	}
+	return ~crc;
+}
+
+void AddCRC32Tests( task::gsetests::GSETests* task ) {
+
+	task->AddTest(
+		"test if crc32 matches known values",
+		GT() {
+			const std::vector< std::pair< std::string, crc_t > > vectors = {
+				{
+					"",
+					0x00000000
+				},
+				{
+					"a",
+					0xE8B7BE43
+				},
+				{
+					"123456789",
+					0xCBF43926
+				},
+				{
+					"The quick brown fox jumps over the lazy dog",
+					0x414FA339
+				},
+			};
+			for ( const auto& it : vectors ) {
+				const auto crc = CRC32::Calculate( it.first.data(), it.first.size() );
+				GT_ASSERT( crc == it.second, "for '" + it.first + "', got " + std::to_string( crc ) + " instead of " + std::to_string( it.second ) );
+			}
+
+			types::Buffer buf;
+			buf.WriteString( "123456789" );
+			GT_ASSERT( CRC32::CalculateFromBuffer( buf ) == CRC32::Calculate( buf.data, buf.lenw ) );
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if crc32 slice-by-8 matches byte-wise calculation",
+		GT() {
+			std::vector< uint8_t > data( 1024 + 8 );
+			uint32_t seed = 1;
+			for ( auto& b : data ) {
+				seed = seed * 1664525 + 1013904223;
+				b = seed >> 24;
+			}
+
+			// every start alignment, and every length that leaves different tail after 8-byte chunks
+			for ( size_t offset = 0 ; offset < 8 ; offset++ ) {
+				for ( size_t size = 0 ; size <= 1024 ; size += size < 80
+					? 1
+					: 61 ) {
+					const auto* p = data.data() + offset;
+					const auto expected = CalculateCRC32Reference( p, size );
+					const auto crc = CRC32::Calculate( p, size );
+					GT_ASSERT( crc == expected, "for offset " + std::to_string( offset ) + ", size " + std::to_string( size ) + ": " + std::to_string( crc ) + " != " + std::to_string( expected ) );
+
+					// continuing one byte at a time never reaches 8-byte loop
+					crc_t bytewise = 0;
+					for ( size_t i = 0 ; i < size ; i++ ) {
+						bytewise = CRC32::Calculate( p + i, 1, bytewise );
+					}
+					GT_ASSERT( bytewise == expected, "for offset " + std::to_string( offset ) + ", size " + std::to_string( size ) + ": " + std::to_string( bytewise ) + " != " + std::to_string( expected ) );
+
+					// split at unaligned point
+					const size_t split = size / 3;
+					const auto continued = CRC32::Calculate( p + split, size - split, CRC32::Calculate( p, split ) );
+					GT_ASSERT( continued == expected, "for offset " + std::to_string( offset ) + ", size " + std::to_string( size ) + ", split " + std::to_string( split ) + ": " + std::to_string( continued ) + " != " + std::to_string( expected ) );
+				}
+			}
+			GT_OK();
+		}
+	);
+
+}
+
+}
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace task::gsetests {
+class GSETests;
+}
+
+namespace util {
+namespace tests {
+
+void AddCRC32Tests( task::gsetests::GSETests* task );
+
+}
+}
@@ -0,0 +1,293 @@
+#include "LZ4.h"
+
+#include <vector>
+#include <cstring>
+
+#include "task/gsetests/GSETests.h"
+#include "util/lz4/LZ4.h"
+
+namespace util {
+namespace tests {
+
+using lz4::LZ4;
+
+static const std::string GenerateLZ4Input( const size_t size, uint32_t seed, const bool is_compressible ) {
+	const auto f_next = [ &seed ]() -> uint32_t {
+		seed = seed * 1664525 + 1013904223;
+		return seed >> 8;
+	};
+	std::string input = "";
+	input.reserve( size );
+	if ( is_compressible ) {
+		// repeated words with occasional noise, similar to serialized game state
+		const std::vector< std::string > words = {
+			"tile",
+			"unit",
+			"base",
+			"\0\0\0\0\0\0\0\0",
+			"\x01\x02\x03",
+			"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+		};
+		while ( input.size() < size ) {
+			if ( f_next() % 8 == 0 ) {
+				input += (char)f_next();
+			}
+			else {
+				input += words[ f_next() % words.size() ];
+			}
+		}
+		input.resize( size );
+	}
+	else {
+		for ( size_t i = 0 ; i < size ; i++ ) {
+			input += (char)f_next();
+		}
+	}
+	return input;
+}
+
+static void WriteLZ4Header( std::string& out, const uint32_t raw_size, const uint32_t compressed_size ) {
+	out.append( (const char*)&raw_size, sizeof( raw_size ) );
+	out.append( (const char*)&compressed_size, sizeof( compressed_size ) );
+}
+
+static const std::string LZ4Stream( const std::string& blocks ) {
+	return std::string( LZ4::MAGIC, sizeof( LZ4::MAGIC ) ) + blocks;
+}
+
+void AddLZ4Tests( task::gsetests::GSETests* task ) {
+
+	// block boundaries, sizes below minimum match distance, multiple blocks, and data that doesn't compress at all
+	std::vector< std::string > inputs = {};
+	uint32_t seed = 1;
+	for ( const auto& size : std::vector< size_t >{
+		1,
+		5,
+		12,
+		13,
+		64,
+		1000,
+		LZ4::BLOCK_SIZE - 1,
+		LZ4::BLOCK_SIZE,
+		LZ4::BLOCK_SIZE + 1,
+		LZ4::BLOCK_SIZE * 2 + 777,
+	} ) {
+		inputs.push_back( GenerateLZ4Input( size, seed++, true ) );
+		inputs.push_back( GenerateLZ4Input( size, seed++, false ) );
+	}
+	inputs.push_back( std::string( 100000, 'x' ) ); // overlapping matches
+
+	task->AddTest(
+		"test if lz4 stream decompresses to original data",
+		GT( inputs ) {
+			for ( const auto& input : inputs ) {
+				const auto compressed = LZ4::Compress( input );
+				GT_ASSERT( LZ4::IsCompressed( compressed.data(), compressed.size() ), "for size " + std::to_string( input.size() ) );
+				std::string output = "";
+				GT_ASSERT( LZ4::Decompress( compressed.data(), compressed.size(), output ), "for size " + std::to_string( input.size() ) );
+				GT_ASSERT( output == input, "for size " + std::to_string( input.size() ) );
+			}
+			const auto& compressible = inputs[ 10 ];
+			GT_ASSERT( LZ4::Compress( compressible ).size() < compressible.size() / 2, ", got " + std::to_string( LZ4::Compress( compressible ).size() ) + " out of " + std::to_string( compressible.size() ) );
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if lz4 stream decodes when fed in parts",
+		GT( inputs ) {
+			for ( const auto& chunk_size : std::vector< size_t >{
+				1,
+				3,
+				8,
+				4096,
+				65537,
+			} ) {
+				for ( const auto& input : inputs ) {
+					if ( chunk_size < 8 && input.size() > LZ4::BLOCK_SIZE ) {
+						continue; // too slow and nothing new
+					}
+					const auto compressed = LZ4::Compress( input );
+					lz4::Decoder decoder;
+					std::string output = "";
+					for ( size_t offset = 0 ; offset < compressed.size() ; offset += chunk_size ) {
+						GT_ASSERT( !decoder.IsFinished(), "for size " + std::to_string( input.size() ) + ", chunk size " + std::to_string( chunk_size ) );
+						GT_ASSERT( decoder.Feed( compressed.data() + offset, std::min( chunk_size, compressed.size() - offset ), output ), "for size " + std::to_string( input.size() ) + ", chunk size " + std::to_string( chunk_size ) );
+					}
+					GT_ASSERT( decoder.IsFinished(), "for size " + std::to_string( input.size() ) + ", chunk size " + std::to_string( chunk_size ) );
+					GT_ASSERT( output == input, "for size " + std::to_string( input.size() ) + ", chunk size " + std::to_string( chunk_size ) );
+				}
+			}
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if empty lz4 input is handled",
+		GT() {
+			const auto compressed = LZ4::Compress( "" );
+			std::string end_marker = "";
+			WriteLZ4Header( end_marker, 0, 0 );
+			GT_ASSERT( compressed == LZ4Stream( end_marker ) );
+
+			std::string output = "";
+			GT_ASSERT( LZ4::Decompress( compressed.data(), compressed.size(), output ) );
+			GT_ASSERT( output.empty() );
+
+			// no data at all is not a stream
+			GT_ASSERT( !LZ4::Decompress( compressed.data(), 0, output ) );
+			GT_ASSERT( !LZ4::IsCompressed( compressed.data(), 0 ) );
+
+			lz4::Decoder decoder;
+			GT_ASSERT( decoder.Feed( compressed.data(), 0, output ) );
+			GT_ASSERT( !decoder.IsFinished() );
+			GT_ASSERT( decoder.Feed( compressed.data(), compressed.size(), output ) );
+			GT_ASSERT( decoder.IsFinished() );
+			GT_ASSERT( decoder.Feed( compressed.data(), 0, output ) );
+			GT_ASSERT( !decoder.Feed( compressed.data(), 1, output ) ); // nothing can follow end of stream
+			GT_ASSERT( output.empty() );
+
+			decoder.Reset();
+			GT_ASSERT( !decoder.IsFinished() );
+			GT_ASSERT( decoder.Feed( compressed.data(), compressed.size(), output ) );
+			GT_ASSERT( decoder.IsFinished() );
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if truncated lz4 stream is rejected",
+		GT( inputs ) {
+			for ( const auto& input : {
+				inputs[ 8 ],
+				inputs[ 9 ],
+				inputs[ 18 ],
+				inputs[ 19 ],
+			} ) {
+				const auto compressed = LZ4::Compress( input );
+				for ( size_t size = 0 ; size < compressed.size() ; size += size < 64
+					? 1
+					: 997 ) {
+					std::string output = "";
+					GT_ASSERT( !LZ4::Decompress( compressed.data(), size, output ), "for size " + std::to_string( input.size() ) + ", truncated to " + std::to_string( size ) );
+				}
+				std::string output = "";
+				GT_ASSERT( !LZ4::Decompress( compressed.data(), compressed.size() - 1, output ), "for size " + std::to_string( input.size() ) );
+			}
+			GT_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if malformed lz4 stream is rejected",
+		GT() {
+			std::string output = "";
+			std::string end_marker = "";
+			WriteLZ4Header( end_marker, 0, 0 );
+
+			const auto f_rejects = [ &output ]( const std::string& stream ) -> bool {
+				output.clear();
+				return !LZ4::Decompress( stream.data(), stream.size(), output );
+			};
+
+			GT_ASSERT( !f_rejects( LZ4Stream( end_marker ) ) );
+			GT_ASSERT( f_rejects( "GLZ2" + end_marker ), ": wrong magic" );
+			GT_ASSERT( f_rejects( LZ4Stream( end_marker + "x" ) ), ": data after end of stream" );
+			{
+				std::string blocks = "";
+				WriteLZ4Header( blocks, 0, 1 );
+				GT_ASSERT( f_rejects( LZ4Stream( blocks ) ), ": end marker with data" );
+			}
+			{
+				std::string blocks = "";
+				WriteLZ4Header( blocks, LZ4::BLOCK_SIZE + 1, LZ4::BLOCK_SIZE + 1 );
+				blocks += std::string( LZ4::BLOCK_SIZE + 1, 'x' ) + end_marker;
+				GT_ASSERT( f_rejects( LZ4Stream( blocks ) ), ": block larger than block size" );
+			}
+			{
+				std::string blocks = "";
+				WriteLZ4Header( blocks, 4, 5 );
+				blocks += "xxxxx" + end_marker;
+				GT_ASSERT( f_rejects( LZ4Stream( blocks ) ), ": compressed size larger than raw size" );
+			}
+			{
+				std::string blocks = "";
+				WriteLZ4Header( blocks, 0xffffffff, 16 );
+				blocks += std::string( 16, 'x' ) + end_marker;
+				GT_ASSERT( f_rejects( LZ4Stream( blocks ) ), ": huge raw size" );
+			}
+
+			// sequences that point outside of input or output
+			const std::vector< std::pair< std::string, std::string > > blocks = {
+				{
+					"literals past end of input",
+					std::string( "\x20" "a", 2 )
+				},
+				{
+					"missing literal length",
+					std::string( "\xf0", 1 )
+				},
+				{
+					"missing offset",
+					std::string( "\x10" "a" "\x00", 3 )
+				},
+				{
+					"zero offset",
+					std::string( "\x10" "a" "\x00\x00", 4 )
+				},
+				{
+					"offset before start of output",
+					std::string( "\x10" "a" "\x02\x00", 4 )
+				},
+				{
+					"missing match length",
+					std::string( "\x1f" "a" "\x01\x00", 4 )
+				},
+				{
+					"match past end of output",
+					std::string( "\x1f" "a" "\x01\x00\xff\xff\x00", 7 )
+				},
+			};
+			for ( const auto& it : blocks ) {
+				char dst[ 16 ];
+				GT_ASSERT( !LZ4::DecompressBlock( it.second.data(), it.second.size(), dst, sizeof( dst ) ), ": " + it.first );
+				std::string stream = "";
+				WriteLZ4Header( stream, sizeof( dst ), it.second.size() );
+				stream += it.second + end_marker;
+				GT_ASSERT( f_rejects( LZ4Stream( stream ) ), ": " + it.first );
+			}
+
+			// block must decode to exactly raw size
+			const auto input = GenerateLZ4Input( 1000, 1, true );
+			std::vector< char > block( LZ4::CompressBound( input.size() ) );
+			const auto block_size = LZ4::CompressBlock( input.data(), input.size(), block.data() );
+			std::vector< char > dst( input.size() + 1 );
+			GT_ASSERT( LZ4::DecompressBlock( block.data(), block_size, dst.data(), input.size() ) );
+			GT_ASSERT( !memcmp( dst.data(), input.data(), input.size() ) );
+			GT_ASSERT( !LZ4::DecompressBlock( block.data(), block_size, dst.data(), input.size() - 1 ) );
+			GT_ASSERT( !LZ4::DecompressBlock( block.data(), block_size, dst.data(), input.size() + 1 ) );
+
+			// corrupted block can decode to garbage, but never to more or less than raw size ( and never outside of output, when running with sanitizers )
+			uint32_t seed = 1;
+			for ( size_t i = 0 ; i < 10000 ; i++ ) {
+				auto corrupted = std::string( block.data(), block_size );
+				for ( size_t j = 0 ; j <= i % 3 ; j++ ) {
+					seed = seed * 1664525 + 1013904223;
+					corrupted[ ( seed >> 8 ) % corrupted.size() ] ^= (char)( 1 << ( seed % 8 ) );
+				}
+				std::string stream = "";
+				WriteLZ4Header( stream, input.size(), corrupted.size() );
+				stream += corrupted + end_marker;
+				if ( !f_rejects( LZ4Stream( stream ) ) ) {
+					GT_ASSERT( output.size() == input.size(), ", got " + std::to_string( output.size() ) );
+				}
+			}
+
+			GT_OK();
+		}
+	);
+
+}
+
+}
+}
@@ -0,0 +1,15 @@
+#include "Tests.h"
+
+#include "CRC32.h"
+#include "LZ4.h"
+
+namespace util {
+namespace tests {
+
+void AddTests( task::gsetests::GSETests* task ) {
+	tests::AddCRC32Tests( task );
+	tests::AddLZ4Tests( task );
+}
+
+}
+}